@@ -643,6 +643,126 @@ void NormalElement::render(int cameraX, int cameraY, const Graphics::Bitmap &bmp
     bmp.setClipRect(0, 0,bmp.getWidth(),bmp.getHeight());
 }
 
+static bool staticSin(const Sin & sin){
+    return sin.amp == 0 || sin.period == 0;
+}
+
+bool NormalElement::isStatic(){
+    return getVisible() && !!sprite &&
+           getVelocityX() == 0 && getVelocityY() == 0 &&
+           staticSin(getSinX()) && staticSin(getSinY()) &&
+           getTile().x != 1 && getTile().y != 1 &&
+           getWindowDeltaX() == 0 && getWindowDeltaY() == 0 &&
+           /* translucent elements blend with whatever is under them and
+            * elements without a mask draw their mask color, neither of
+            * which survives being drawn into a bitmap first
+            */
+           getTrans() == None && getMask();
+}
+
+void NormalElement::getStaticBounds(int & x1, int & y1, int & x2, int & y2) const {
+    const int addw = sprite->getWidth() + getTileSpacing().x;
+    const int addh = sprite->getHeight() + getTileSpacing().y;
+    const int xTiles = getTile().x <= 0 ? 1 : getTile().x;
+    const int yTiles = getTile().y <= 0 ? 1 : getTile().y;
+    const int left = (int) getCurrentX() - sprite->getX();
+    const int top = (int) getCurrentY() - sprite->getY();
+    const int lastX = left + (xTiles - 1) * addw;
+    const int lastY = top + (yTiles - 1) * addh;
+    x1 = std::min(left, lastX);
+    y1 = std::min(top, lastY);
+    x2 = std::max(left, lastX) + sprite->getWidth();
+    y2 = std::max(top, lastY) + sprite->getHeight();
+}
+
+void NormalElement::renderStatic(int x, int y, const Graphics::Bitmap & bmp){
+    const int addw = sprite->getWidth() + getTileSpacing().x;
+    const int addh = sprite->getHeight() + getTileSpacing().y;
+    const int currentX = x + (int) getCurrentX();
+    const int currentY = y + (int) getCurrentY();
+
+    Tiler tiler(getTile(), currentX, currentY, addw, addh, sprite->getX(), sprite->getY(), sprite->getWidth(), sprite->getHeight(), bmp.getWidth(), bmp.getHeight());
+
+    Effects effects = getEffects();
+    while (tiler.hasMore()){
+        Point where = tiler.nextPoint();
+        sprite->render(where.x, where.y, bmp, effects);
+    }
+}
+
+/* True if the two elements move with the camera the same way */
+static bool sameLayer(const NormalElement * first, const NormalElement * second){
+    const Gui::RectArea & window1 = first->getWindow();
+    const Gui::RectArea & window2 = second->getWindow();
+    return first->getDeltaX() == second->getDeltaX() &&
+           first->getDeltaY() == second->getDeltaY() &&
+           window1.x == window2.x && window1.y == window2.y &&
+           window1.width == window2.width && window1.height == window2.height;
+}
+
+/* Bigger layers are drawn element by element instead */
+static const int MAX_STATIC_AREA = 2048 * 1024;
+
+StaticLayer::StaticLayer(const vector<NormalElement*> & elements):
+elements(elements),
+x(0),
+y(0){
+    build();
+}
+
+void StaticLayer::build(){
+    int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    for (vector<NormalElement*>::const_iterator it = elements.begin(); it != elements.end(); it++){
+        int left, top, right, bottom;
+        (*it)->getStaticBounds(left, top, right, bottom);
+        if (it == elements.begin()){
+            x1 = left;
+            y1 = top;
+            x2 = right;
+            y2 = bottom;
+        } else {
+            x1 = std::min(x1, left);
+            y1 = std::min(y1, top);
+            x2 = std::max(x2, right);
+            y2 = std::max(y2, bottom);
+        }
+    }
+
+    const int width = x2 - x1;
+    const int height = y2 - y1;
+    if (width <= 0 || height <= 0 || width * height > MAX_STATIC_AREA){
+        return;
+    }
+
+    x = x1;
+    y = y1;
+    cache = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(width, height));
+    cache->clearToMask();
+    for (vector<NormalElement*>::const_iterator it = elements.begin(); it != elements.end(); it++){
+        (*it)->renderStatic(-x, -y, *cache);
+    }
+}
+
+void StaticLayer::render(int cameraX, int cameraY, const Graphics::Bitmap & work){
+    if (cache == NULL){
+        for (vector<NormalElement*>::const_iterator it = elements.begin(); it != elements.end(); it++){
+            (*it)->render(cameraX, cameraY, work);
+        }
+        return;
+    }
+
+    /* same placement as NormalElement::render, the sprite offsets and tile
+     * positions are already part of the cache
+     */
+    const NormalElement * first = elements.front();
+    const int currentX = (int)(work.getWidth()/2 + x - cameraX + cameraX * (1 - first->getDeltaX()));
+    const int currentY = (int)(y - cameraY + cameraY * (1 - first->getDeltaY()));
+    const Gui::RectArea & window = first->getWindow();
+    work.setClipRect(window.x, window.y, window.getX2(), window.getY2());
+    cache->draw(currentX, currentY, work);
+    work.setClipRect(0, 0, work.getWidth(), work.getHeight());
+}
+
 AnimationElement::AnimationElement(const AstRef & parse, const string & name, Ast::Section * data, const Mugen::SpriteMap & sprites):
 BackgroundElement(name, data),
 animation(0){
@@ -1721,7 +1841,8 @@ Background::Background(const Filesystem::AbsolutePath &file, const std::string &
 file(file),
 header(header),
 debug(false),
-clearColor(Graphics::MaskColor()){
+clearColor(Graphics::MaskColor()),
+itemsBuilt(false){
     TimeDifference diff;
     diff.startTime();
     AstRef parsed(Mugen::Util::parseDef(file));
@@ -1933,7 +2054,8 @@ clearColor(Graphics::MaskColor()){
 Background::Background(const AstRef & parsed, const string & header, const Mugen::SpriteMap & sprites):
 header(header),
 debug(false),
-clearColor(Graphics::MaskColor()){
+clearColor(Graphics::MaskColor()),
+itemsBuilt(false){
     // for linked position in backgrounds
     BackgroundElement * priorElement = NULL;
     /* use the sprites that are passed in unless the background has a def
@@ -2122,6 +2244,9 @@ Background::~Background(){
             delete controller;
         }
     }
+
+    destroyItems(backgroundItems);
+    destroyItems(foregroundItems);
 }
 void Background::act(){
     // Backgrounds
@@ -2151,6 +2276,13 @@ void Background::renderBackground(int x, int y, const Graphics::Bitmap &bmp, Gra
 	bmp.fill(Graphics::MaskColor());
     }
 
+    /* the static layers are drawn without a filter */
+    if (filter == NULL){
+        buildItems();
+        renderItems(backgroundItems, x, y, bmp);
+        return;
+    }
+
     for( vector< BackgroundElement *>::iterator i = backgrounds.begin(); i != backgrounds.end(); ++i ){
 	BackgroundElement *element = *i;
 	element->render(x, y, bmp, filter);
@@ -2158,12 +2290,97 @@ void Background::renderBackground(int x, int y, const Graphics::Bitmap &bmp, Gra
 }
 
 void Background::renderForeground(int x, int y, const Graphics::Bitmap &bmp, Graphics::Bitmap::Filter * filter){
+    if (filter == NULL){
+        buildItems();
+        renderItems(foregroundItems, x, y, bmp);
+        return;
+    }
+
     for( vector< BackgroundElement *>::iterator i = foregrounds.begin(); i != foregrounds.end(); ++i ){
 	BackgroundElement *element = *i;
 	element->render(x, y, bmp, filter);
     }
 }
 
+/* Done on the first render so linked positions and controllers are all set up */
+void Background::buildItems(){
+    if (itemsBuilt){
+        return;
+    }
+    itemsBuilt = true;
+
+    /* elements governed by a controller can change at any time so they are
+     * always drawn on their own
+     */
+    vector<BackgroundElement*> controlled;
+    for (vector<BackgroundController*>::iterator it = controllers.begin(); it != controllers.end(); it++){
+        const vector<Controller*> & subControllers = (*it)->getControllers();
+        for (vector<Controller*>::const_iterator sub = subControllers.begin(); sub != subControllers.end(); sub++){
+            const vector<BackgroundElement*> & elements = (*sub)->getElements();
+            controlled.insert(controlled.end(), elements.begin(), elements.end());
+        }
+    }
+    std::sort(controlled.begin(), controlled.end());
+
+    buildItems(backgrounds, controlled, backgroundItems);
+    buildItems(foregrounds, controlled, foregroundItems);
+}
+
+void Background::buildItems(const vector<BackgroundElement*> & elements, const vector<BackgroundElement*> & controlled, vector<RenderItem> & items){
+    vector<NormalElement*> run;
+    for (vector<BackgroundElement*>::const_iterator it = elements.begin(); it != elements.end(); it++){
+        BackgroundElement * element = *it;
+        NormalElement * normal = dynamic_cast<NormalElement*>(element);
+        bool isStatic = normal != NULL &&
+                        !std::binary_search(controlled.begin(), controlled.end(), element) &&
+                        normal->isStatic();
+
+        if (!run.empty() && !(isStatic && sameLayer(run.front(), normal))){
+            addRun(run, items);
+        }
+
+        if (isStatic){
+            run.push_back(normal);
+        } else {
+            items.push_back(RenderItem(element));
+        }
+    }
+
+    addRun(run, items);
+}
+
+void Background::addRun(vector<NormalElement*> & run, vector<RenderItem> & items){
+    if (run.empty()){
+        return;
+    }
+
+    /* a single untiled sprite is one blit either way */
+    if (run.size() == 1 && run.front()->getTile().x <= 1 && run.front()->getTile().y <= 1){
+        items.push_back(RenderItem(run.front()));
+    } else {
+        items.push_back(RenderItem(new StaticLayer(run)));
+    }
+
+    run.clear();
+}
+
+void Background::renderItems(const vector<RenderItem> & items, int x, int y, const Graphics::Bitmap & bmp){
+    for (vector<RenderItem>::const_iterator it = items.begin(); it != items.end(); it++){
+        if (it->layer != NULL){
+            it->layer->render(x, y, bmp);
+        } else {
+            it->element->render(x, y, bmp);
+        }
+    }
+}
+
+void Background::destroyItems(vector<RenderItem> & items){
+    for (vector<RenderItem>::iterator it = items.begin(); it != items.end(); it++){
+        delete it->layer;
+    }
+    items.clear();
+}
+
 //! Returns a vector of Elements by given ID usefull for when assigning elements to a background controller
 std::vector< BackgroundElement * > Background::getIDList(int ID){
     std::vector< BackgroundElement *> ourElements;
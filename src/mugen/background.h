@@ -263,11 +263,49 @@ class NormalElement : public BackgroundElement {
 	virtual inline void setSprite(PaintownUtil::ReferenceCount<Mugen::Sprite> sprite){
 	    this->sprite = sprite;
 	}
+
+        /*! True if the element will look the same every frame apart from
+         * following the camera: no velocity, no sin movement, no infinite
+         * tiling, no window movement and drawn with a plain mask.
+         */
+        virtual bool isStatic();
+
+        /*! Area covered by the sprite and its tiles with the camera at 0,0,
+         * not counting the half screen offset that render() adds.
+         */
+        virtual void getStaticBounds(int & x1, int & y1, int & x2, int & y2) const;
+
+        //! Draw with the camera at 0,0 and the position moved by x, y
+        virtual void renderStatic(int x, int y, const Graphics::Bitmap & bmp);
+
     private:
 	//! Sprite Based
 	PaintownUtil::ReferenceCount<Mugen::Sprite> sprite;
 };
 
+/*! Consecutive static normal elements that share the same delta and window,
+ * drawn once into a bitmap. The bitmap follows the camera the same way the
+ * elements would so the whole run costs a single blit per frame.
+ */
+class StaticLayer{
+public:
+    StaticLayer(const std::vector<NormalElement*> & elements);
+
+    void render(int cameraX, int cameraY, const Graphics::Bitmap & work);
+
+    inline const std::vector<NormalElement*> & getElements() const {
+        return elements;
+    }
+
+protected:
+    void build();
+
+    std::vector<NormalElement*> elements;
+    PaintownUtil::ReferenceCount<Graphics::Bitmap> cache;
+    /* upper left corner of the cache with the camera at 0,0 */
+    int x, y;
+};
+
 /*! Animation Element */
 class AnimationElement: public BackgroundElement {
 public:
@@ -354,6 +392,10 @@ class Controller {
 	    this->elements.insert(this->elements.end(), elements.begin(), elements.end());
 	}
 
+        virtual inline const std::vector<BackgroundElement *> & getElements() const {
+            return this->elements;
+        }
+
     protected:
         /*! Name of controller */
         std::string name;
@@ -395,6 +437,10 @@ class BackgroundController{
         virtual inline void addController(Controller * controller){
             this->controllers.push_back(controller);
         }
+
+        virtual inline const std::vector<Controller *> & getControllers() const {
+            return this->controllers;
+        }
     private:
         /*! Name of controller */
         std::string name;
@@ -470,6 +516,34 @@ class Background{
 
         //! Controllers
         std::vector< BackgroundController *> controllers;
+
+        /*! What renderBackground/renderForeground draw when there is no filter.
+         * Each item is either a single element or a layer of static elements.
+         */
+        struct RenderItem{
+            RenderItem(BackgroundElement * element):
+                element(element),
+                layer(NULL){
+                }
+
+            RenderItem(StaticLayer * layer):
+                element(NULL),
+                layer(layer){
+                }
+
+            BackgroundElement * element;
+            StaticLayer * layer;
+        };
+
+        std::vector<RenderItem> backgroundItems;
+        std::vector<RenderItem> foregroundItems;
+        bool itemsBuilt;
+
+        void buildItems();
+        void buildItems(const std::vector<BackgroundElement*> & elements, const std::vector<BackgroundElement*> & controlled, std::vector<RenderItem> & items);
+        void addRun(std::vector<NormalElement*> & run, std::vector<RenderItem> & items);
+        void renderItems(const std::vector<RenderItem> & items, int cameraX, int cameraY, const Graphics::Bitmap & work);
+        void destroyItems(std::vector<RenderItem> & items);
 };
     
 }
@@ -161,19 +161,19 @@ RandomAIBehavior::RandomAIBehavior(){
 void RandomAIBehavior::flip(){
 }
 
-static string randomCommand(const vector<Command2*> & commands){
+static string randomCommand(const Mugen::Stage & stage, const vector<Command2*> & commands){
     if (commands.size() == 0){
         return "";
     }
 
-    int choice = Mugen::random(commands.size());
+    int choice = Mugen::random(stage.getRandom(), commands.size());
     return commands[choice]->getName();
 }
 
 vector<string> RandomAIBehavior::currentCommands(const Mugen::Stage & stage, Character * owner, const vector<Command2*> & commands, bool reversed){
     vector<string> out;
-    if (Mugen::random(100) > 90){
-        out.push_back(randomCommand(commands));
+    if (Mugen::random(stage.getRandom(), 100) > 90){
+        out.push_back(randomCommand(stage, commands));
     }
     return out;
 }
@@ -213,7 +213,7 @@ dontMove(0){
  *  - subtract points based on the number of times the move has been tried
  *  - subtract points if the move has been done recently
  */
-string LearningAIBehavior::selectBestCommand(int distance, const vector<Command2*> & commands){
+string LearningAIBehavior::selectBestCommand(const Mugen::Stage & stage, int distance, const vector<Command2*> & commands){
     Move * currentMove = NULL;
     string what = "";
     double points = 0;
@@ -230,7 +230,7 @@ string LearningAIBehavior::selectBestCommand(int distance, const vector<Command2
         }
 
         Move & move = moves[name];
-        double morePoints = move.points + Mugen::random(10);
+        double morePoints = move.points + Mugen::random(stage.getRandom(), 10);
         if (move.minimumDistance != -1){
             if (distance < move.maximumDistance + 10 && distance > move.minimumDistance - 10){
                 morePoints += 2;
@@ -269,8 +269,8 @@ string LearningAIBehavior::selectBestCommand(int distance, const vector<Command2
 void LearningAIBehavior::flip(){
 }
 
-static LearningAIBehavior::Direction randomDirection(){
-    int what = Mugen::random(100);
+static LearningAIBehavior::Direction randomDirection(const Mugen::Stage & stage){
+    int what = Mugen::random(stage.getRandom(), 100);
     if (what > 70){
         return LearningAIBehavior::Forward;
     } else if (what > 40){
@@ -287,10 +287,10 @@ vector<string> LearningAIBehavior::currentCommands(const Mugen::Stage & stage, C
     vector<string> out;
 
     /* maybe attack */
-    if ((int) Mugen::random(200) < difficulty * 2){
+    if ((int) Mugen::random(stage.getRandom(), 200) < difficulty * 2){
         const Character * enemy = stage.getEnemy(owner);
         int xDistance = (int) fabs(owner->getX() - enemy->getX());
-        string command = selectBestCommand(xDistance, commands);
+        string command = selectBestCommand(stage, xDistance, commands);
         out.push_back(command);
         lastCommand = command;
         lastDistance = xDistance;
@@ -307,13 +307,13 @@ vector<string> LearningAIBehavior::currentCommands(const Mugen::Stage & stage, C
         }
             
         /* after keeping a direction for 40 ticks, maybe change directions */
-        if (dontMove > 40 && Mugen::random(10) > 8){
-            direction = randomDirection();
+        if (dontMove > 40 && Mugen::random(stage.getRandom(), 10) > 8){
+            direction = randomDirection(stage);
             dontMove = 0;
         }
 
         /* make the AI jump sometimes */
-        if (Mugen::random(100) == 0){
+        if (Mugen::random(stage.getRandom(), 100) == 0){
             out.push_back("holdup");
         }
     }
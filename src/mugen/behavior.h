@@ -148,7 +148,7 @@ public:
     };
 
 protected:
-    std::string selectBestCommand(int distance, const std::vector<Command2*> & commands);
+    std::string selectBestCommand(const Mugen::Stage & stage, int distance, const std::vector<Command2*> & commands);
 
     std::map<std::string, Move> moves;
 
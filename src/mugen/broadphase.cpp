@@ -0,0 +1,139 @@
+#include "broadphase.h"
+#include "animation.h"
+#include <algorithm>
+
+using std::vector;
+using std::pair;
+
+namespace Mugen{
+
+Bounds::Bounds():
+empty(true),
+x1(0),
+y1(0),
+x2(0),
+y2(0){
+}
+
+Bounds::Bounds(const vector<Area> & boxes, int x, int y):
+empty(true),
+x1(0),
+y1(0),
+x2(0),
+y2(0){
+    for (vector<Area>::const_iterator it = boxes.begin(); it != boxes.end(); it++){
+        const Area & area = *it;
+        /* boxes can have their corners in any order, especially after being flipped */
+        int left = std::min(area.x1, area.x2) + x;
+        int right = std::max(area.x1, area.x2) + x;
+        int top = std::min(area.y1, area.y2) + y;
+        int bottom = std::max(area.y1, area.y2) + y;
+        if (empty){
+            x1 = left;
+            x2 = right;
+            y1 = top;
+            y2 = bottom;
+            empty = false;
+        } else {
+            x1 = std::min(x1, left);
+            x2 = std::max(x2, right);
+            y1 = std::min(y1, top);
+            y2 = std::max(y2, bottom);
+        }
+    }
+}
+
+void Bounds::add(const Bounds & him){
+    if (him.empty){
+        return;
+    }
+
+    if (empty){
+        *this = him;
+        return;
+    }
+
+    x1 = std::min(x1, him.x1);
+    x2 = std::max(x2, him.x2);
+    y1 = std::min(y1, him.y1);
+    y2 = std::max(y2, him.y2);
+}
+
+bool Bounds::overlaps(const Bounds & him) const {
+    if (empty || him.empty){
+        return false;
+    }
+
+    return !(x2 < him.x1 || x1 > him.x2 ||
+             y2 < him.y1 || y1 > him.y2);
+}
+
+SweepAndPrune::SweepAndPrune():
+sorted(true){
+}
+
+void SweepAndPrune::clear(){
+    entries.clear();
+    sorted = true;
+}
+
+void SweepAndPrune::add(int index, const Bounds & bounds){
+    if (bounds.isEmpty()){
+        return;
+    }
+
+    Entry entry;
+    entry.index = index;
+    entry.bounds = bounds;
+    entries.push_back(entry);
+    sorted = false;
+}
+
+bool SweepAndPrune::lessX(const Entry & a, const Entry & b){
+    if (a.bounds.x1 == b.bounds.x1){
+        return a.index < b.index;
+    }
+    return a.bounds.x1 < b.bounds.x1;
+}
+
+void SweepAndPrune::sort() const {
+    if (!sorted){
+        std::sort(entries.begin(), entries.end(), lessX);
+        sorted = true;
+    }
+}
+
+void SweepAndPrune::query(const Bounds & bounds, vector<int> & out) const {
+    if (bounds.isEmpty()){
+        return;
+    }
+
+    sort();
+    for (vector<Entry>::const_iterator it = entries.begin(); it != entries.end() && it->bounds.x1 <= bounds.x2; it++){
+        if (it->bounds.overlaps(bounds)){
+            out.push_back(it->index);
+        }
+    }
+}
+
+void SweepAndPrune::pairs(vector<pair<int, int> > & out) const {
+    sort();
+    for (unsigned int i = 0; i < entries.size(); i++){
+        const Entry & first = entries[i];
+        /* everything after `first' starts at or to the right of it so stop
+         * as soon as one starts past its right edge
+         */
+        for (unsigned int j = i + 1; j < entries.size() && entries[j].bounds.x1 <= first.bounds.x2; j++){
+            const Entry & second = entries[j];
+            if (first.bounds.overlaps(second.bounds)){
+                if (first.index < second.index){
+                    out.push_back(pair<int, int>(first.index, second.index));
+                } else {
+                    out.push_back(pair<int, int>(second.index, first.index));
+                }
+            }
+        }
+    }
+}
+
+}
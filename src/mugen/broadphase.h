@@ -0,0 +1,96 @@
+#ifndef _paintown_mugen_broadphase_h
+#define _paintown_mugen_broadphase_h
+
+#include <vector>
+
+namespace Mugen{
+
+class Area;
+
+/* Box in stage coordinates that covers every collision box of one object.
+ * Two objects whose bounds don't overlap can't have any colliding boxes so
+ * there is no need to test their boxes against each other.
+ */
+class Bounds{
+public:
+    Bounds();
+    Bounds(const std::vector<Area> & boxes, int x, int y);
+
+    /* grow to also cover `him' */
+    void add(const Bounds & him);
+
+    /* true if the bounds touch. Uses the same inclusive edges as Area::collision */
+    bool overlaps(const Bounds & him) const;
+
+    inline bool isEmpty() const {
+        return empty;
+    }
+
+    bool empty;
+    int x1, y1, x2, y2;
+};
+
+/* Sweep and prune along the x axis. Objects are added with their bounds and
+ * an index that means something to the caller (like a position in a vector),
+ * then queries return the indexes of objects that might collide.
+ */
+class SweepAndPrune{
+public:
+    SweepAndPrune();
+
+    void clear();
+
+    /* objects with empty bounds are ignored */
+    void add(int index, const Bounds & bounds);
+
+    /* adds the index of every object whose bounds overlap `bounds' */
+    void query(const Bounds & bounds, std::vector<int> & out) const;
+
+    /* adds every overlapping pair of objects, lower index first */
+    void pairs(std::vector<std::pair<int, int> > & out) const;
+
+    /* number of objects with non-empty bounds */
+    inline unsigned int size() const {
+        return entries.size();
+    }
+
+protected:
+    void sort() const;
+
+    struct Entry{
+        int index;
+        Bounds bounds;
+    };
+
+    static bool lessX(const Entry & a, const Entry & b);
+
+    /* sorted lazily by x1 on the first query after an add */
+    mutable std::vector<Entry> entries;
+    mutable bool sorted;
+};
+
+/* Counters for the collision code, reset every tick. `pairsTested' is the
+ * number of object pairs whose boxes were actually compared, `pairsSkipped'
+ * is the number of pairs the broadphase threw out.
+ */
+struct CollisionStatistics{
+    CollisionStatistics():
+        pairsTested(0),
+        pairsSkipped(0),
+        boxTests(0){
+        }
+
+    void reset(){
+        pairsTested = 0;
+        pairsSkipped = 0;
+        boxTests = 0;
+    }
+
+    unsigned int pairsTested;
+    unsigned int pairsSkipped;
+    unsigned int boxTests;
+};
+
+}
+
+#endif
@@ -1,6 +1,6 @@
 
-#ifndef _serialize_Mugen_cb7dd6790d2fd9ec77e1f7defc9715c3
-#define _serialize_Mugen_cb7dd6790d2fd9ec77e1f7defc9715c3
+#ifndef _serialize_Mugen_a7b01b0ecf90821ab06aa2c0e5e690be
+#define _serialize_Mugen_a7b01b0ecf90821ab06aa2c0e5e690be
 
 #include "common.h"
 #include "compiler.h"
@@ -491,6 +491,71 @@ Token * serialize(const ReversalData & data);
 ReversalData deserializeReversalData(const Token * data);
 
 
+struct TickData{
+    TickData(){
+        virtualx = 0;
+        virtualy = 0;
+        virtualz = 0;
+        velocity_x = 0;
+        velocity_y = 0;
+        health = 0;
+        power = 0;
+        defenseMultiplier = 0;
+        attackMultiplier = 0;
+        drawAngle = 0;
+        currentState = 0;
+        previousState = 0;
+        currentAnimation = 0;
+        stateTime = 0;
+        currentPhysics = defaultPhysicsType();
+        facing = defaultFacing();
+        juggleRemaining = 0;
+        currentJuggle = 0;
+        combo = 0;
+        hitCount = 0;
+        wasHitCounter = 0;
+        pushPlayer = 0;
+        spritePriority = 0;
+        has_control = false;
+        blocking = false;
+        guarding = false;
+        frozen = false;
+        reversalActive = false;
+    }
+
+    double virtualx;
+    double virtualy;
+    double virtualz;
+    double velocity_x;
+    double velocity_y;
+    double health;
+    double power;
+    double defenseMultiplier;
+    double attackMultiplier;
+    double drawAngle;
+    int currentState;
+    int previousState;
+    int currentAnimation;
+    int stateTime;
+    Physics::Type currentPhysics;
+    Facing facing;
+    int juggleRemaining;
+    int currentJuggle;
+    int combo;
+    int hitCount;
+    uint32_t wasHitCounter;
+    int pushPlayer;
+    int spritePriority;
+    bool has_control;
+    bool blocking;
+    bool guarding;
+    bool frozen;
+    bool reversalActive;
+};
+Token * serialize(const TickData & data);
+TickData deserializeTickData(const Token * data);
+
+
 
 struct WidthOverride{
     WidthOverride(){
@@ -609,82 +674,27 @@ DrawAngleEffect deserializeDrawAngleEffect(const Token * data);
 
 struct StateData{
     StateData(){
-        juggleRemaining = 0;
-        currentJuggle = 0;
-        currentState = 0;
-        previousState = 0;
-        currentAnimation = 0;
-        velocity_x = 0;
-        velocity_y = 0;
-        has_control = false;
-        stateTime = 0;
-        currentPhysics = defaultPhysicsType();
-        combo = 0;
-        hitCount = 0;
-        blocking = false;
-        guarding = false;
-        defenseMultiplier = 0;
-        attackMultiplier = 0;
-        frozen = false;
-        reversalActive = false;
-        pushPlayer = 0;
-        health = 0;
-        spritePriority = 0;
-        wasHitCounter = 0;
-        drawAngle = 0;
-        virtualx = 0;
-        virtualy = 0;
-        virtualz = 0;
-        facing = defaultFacing();
-        power = 0;
+        
     }
 
-    int juggleRemaining;
-    int currentJuggle;
-    int currentState;
-    int previousState;
-    int currentAnimation;
-    double velocity_x;
-    double velocity_y;
-    bool has_control;
-    int stateTime;
     std::map<int, RuntimeValue > variables;
     std::map<int, RuntimeValue > floatVariables;
     std::map<int, RuntimeValue > systemVariables;
-    Physics::Type currentPhysics;
     std::string stateType;
     std::string moveType;
     HitDefinition hit;
     HitState hitState;
-    int combo;
-    int hitCount;
-    bool blocking;
-    bool guarding;
     WidthOverride widthOverride;
     HitByOverride hitByOverride[2];
-    double defenseMultiplier;
-    double attackMultiplier;
-    bool frozen;
     ReversalData reversal;
-    bool reversalActive;
     TransOverride transOverride;
-    int pushPlayer;
     SpecialStuff special;
-    double health;
     Bind bind;
     std::map<int, std::vector<CharacterId > > targets;
-    int spritePriority;
-    uint32_t wasHitCounter;
     CharacterData characterData;
-    double drawAngle;
     DrawAngleEffect drawAngleData;
     std::vector<std::string > active;
     std::map<int, HitOverride > hitOverrides;
-    double virtualx;
-    double virtualy;
-    double virtualz;
-    Facing facing;
-    double power;
     std::map<std::string, std::string > commandState;
 };
 Token * serialize(const StateData & data);
@@ -6,6 +6,7 @@
 #include <string>
 #include <cstring>
 #include <vector>
+#include <new>
 #include <ostream>
 #include <sstream>
 #include <iostream>
@@ -22,6 +23,7 @@
 #include "util/timedifference.h"
 #include "util/debug.h"
 #include "util/message-queue.h"
+#include "util/thread.h"
 #include "factory/font_render.h"
 
 #include "animation.h"
@@ -42,6 +44,8 @@
 #include "behavior.h"
 #include "state-controller.h"
 #include "helper.h"
+#include "palette-filter.h"
+#include "pool.h"
 
 #include "util/input/input-map.h"
 #include "util/input/input-manager.h"
@@ -479,27 +483,27 @@ void Object::setAlliance(int alliance){
 }
     
 void Character::setZ(double what){
-    getStateData().virtualz = what;
+    getTickData().virtualz = what;
 }
     
 void Character::setX(double what){
-    getStateData().virtualx = what;
+    getTickData().virtualx = what;
 }
 
 void Character::setY(double what){
-    getStateData().virtualy = what;
+    getTickData().virtualy = what;
 }
 
 double Character::getY() const {
-    return getStateData().virtualy;
+    return getTickData().virtualy;
 }
 
 double Character::getX() const {
-    return getStateData().virtualx;
+    return getTickData().virtualx;
 }
 
 double Character::getZ() const {
-    return getStateData().virtualz;
+    return getTickData().virtualz;
 }
     
 double Character::getRY() const {
@@ -539,11 +543,11 @@ void Character::moveRightForce(double x){
 }
 
 Facing Character::getFacing() const {
-    return getStateData().facing;
+    return getTickData().facing;
 }
 
 void Character::setFacing(Facing what){
-    this->getStateData().facing = what;
+    this->getTickData().facing = what;
 }
 
 Facing Character::getOppositeFacing() const {
@@ -558,14 +562,42 @@ void Character::reverseFacing(){
     setFacing(getOppositeFacing());
 }
 
+/* The TickData of every character and helper is a block from this pool, so
+ * the tick state of everyone on the stage sits in a few contiguous chunks
+ * instead of being spread across the characters between their containers.
+ * Characters are loaded on other threads too.
+ */
+static BlockPool * tickPool = NULL;
+static PaintownUtil::Thread::LockObject tickPoolLock;
+
+static TickData * createTickData(const TickData & copy){
+    void * memory = NULL;
+    {
+        PaintownUtil::Thread::ScopedLock scoped(tickPoolLock);
+        if (tickPool == NULL){
+            tickPool = new BlockPool(sizeof(TickData), 64);
+        }
+        memory = tickPool->allocate();
+    }
+    return new (memory) TickData(copy);
+}
+
+static void destroyTickData(TickData * data){
+    data->~TickData();
+    PaintownUtil::Thread::ScopedLock scoped(tickPoolLock);
+    tickPool->release(data);
+}
+
 Character::Character(const Filesystem::AbsolutePath & s, int alliance):
-Object(alliance){
+Object(alliance),
+tickData(createTickData(TickData())){
     getLocalData().location = s;
     initialize();
 }
 
 Character::Character(const Filesystem::AbsolutePath & s, const int x, const int y, int alliance):
-Object(alliance){
+Object(alliance),
+tickData(createTickData(TickData())){
     getLocalData().location = s;
     initialize();
 }
@@ -574,7 +606,18 @@ Character::Character(const Character & copy):
 Object(copy),
 stateControllerId(copy.stateControllerId),
 localData(copy.localData),
-stateData(copy.stateData){
+stateData(copy.stateData),
+tickData(createTickData(copy.getTickData())){
+}
+
+Character::Definition & Character::editDefinition(){
+    /* someone else (a helper or the owner of this helper) is looking at the
+     * same definition so make our own copy before changing it
+     */
+    if (getLocalData().definition.shared()){
+        getLocalData().definition = PaintownUtil::ReferenceCount<Definition>(new Definition(*getLocalData().definition));
+    }
+    return *getLocalData().definition;
 }
 
 Character::~Character(){
@@ -582,42 +625,43 @@ Character::~Character(){
     for (vector<Command2*>::iterator it = getLocalData().commands.begin(); it != getLocalData().commands.end(); it++){
         delete (*it);
     }
+    destroyTickData(tickData);
 }
 
 void Character::initialize(){
     stateControllerId = 0;
 
     getLocalData().max_health = 0;
-    getStateData().health = 0;
+    getTickData().health = 0;
     getLocalData().maxChangeStates = 0;
-    getStateData().currentState = Standing;
-    getStateData().currentPhysics = Physics::Stand;
+    getTickData().currentState = Standing;
+    getTickData().currentPhysics = Physics::Stand;
     setMoveType(Move::Idle);
-    getStateData().wasHitCounter = 0;
-    getStateData().frozen = false;
-    getStateData().reversalActive = false;
-    getStateData().previousState = getStateData().currentState;
+    getTickData().wasHitCounter = 0;
+    getTickData().frozen = false;
+    getTickData().reversalActive = false;
+    getTickData().previousState = getTickData().currentState;
     setStateType(StateType::Stand);
-    getStateData().currentAnimation = Standing;
+    getTickData().currentAnimation = Standing;
     getLocalData().ownPalette = false;
-    getStateData().drawAngle = 0;
+    getTickData().drawAngle = 0;
     /* FIXME: whats the default sprite priority? */
-    getStateData().spritePriority = 0;
+    getTickData().spritePriority = 0;
     // getLocalData().juggleRemaining = 0;
     getLocalData().koecho = false;
     getLocalData().defense = 0;
     getLocalData().fallDefenseUp = 0;
-    getStateData().defenseMultiplier = 1;
-    getStateData().attackMultiplier = 1;
+    getTickData().defenseMultiplier = 1;
+    getTickData().attackMultiplier = 1;
     getLocalData().lieDownTime = 0;
     getLocalData().xscale = 1;
     getLocalData().yscale = 1;
     getLocalData().debug = false;
-    getStateData().has_control = true;
-    getStateData().blocking = false;
+    getTickData().has_control = true;
+    getTickData().blocking = false;
     getLocalData().airjumpnum = 0;
     getLocalData().airjumpheight = 35;
-    getStateData().guarding = false;
+    getTickData().guarding = false;
     getLocalData().behavior = NULL;
 
     getLocalData().intpersistindex = 0;
@@ -625,7 +669,7 @@ void Character::initialize(){
 
     getLocalData().matchWins = 0;
 
-    getStateData().combo = 1;
+    getTickData().combo = 1;
     // nextCombo = 0;
 
     // lastTicket = 0;
@@ -640,16 +684,16 @@ void Character::initialize(){
     getLocalData().runbacky = 0;
     getLocalData().runforwardx = 0;
     getLocalData().runforwardy = 0;
-    getStateData().power = 0;
+    getTickData().power = 0;
 
-    getStateData().velocity_x = 0;
-    getStateData().velocity_y = 0;
+    getTickData().velocity_x = 0;
+    getTickData().velocity_y = 0;
 
     getLocalData().gravity = 0.1;
     getLocalData().standFriction = 0.85;
     getLocalData().crouchFriction = 0.82;
 
-    getStateData().stateTime = 0;
+    getTickData().stateTime = 0;
 
     /* Regeneration */
     getLocalData().regenerateHealth = false;
@@ -672,12 +716,12 @@ void Character::loadSelectData(){
 	
         AstRef parsed(Util::parseDef(ourDefFile));
 	// Set name of character
-	this->getLocalData().name = Mugen::Util::probeDef(parsed, "info", "name");
-	this->getLocalData().displayName = Mugen::Util::probeDef(parsed, "info", "displayname");
-	this->getLocalData().sffFile = Mugen::Util::probeDef(parsed, "files", "sprite");
+	this->editDefinition().name = Mugen::Util::probeDef(parsed, "info", "name");
+	this->editDefinition().displayName = Mugen::Util::probeDef(parsed, "info", "displayname");
+	this->editDefinition().sffFile = Mugen::Util::probeDef(parsed, "files", "sprite");
 	// Get necessary sprites 9000 & 9001 for select screen
         /* FIXME: replace 9000 with some readable constant */
-        Filesystem::AbsolutePath absoluteSff = Storage::instance().lookupInsensitive(baseDir, Filesystem::RelativePath(this->getLocalData().sffFile));
+        Filesystem::AbsolutePath absoluteSff = Storage::instance().lookupInsensitive(baseDir, Filesystem::RelativePath(this->getDefinition().sffFile));
         /* FIXME: use getIconAndPortrait so we only load the sff once */
 	this->getLocalData().sprites[9000][0] = Mugen::Util::probeSff(absoluteSff, 9000, 0, true);
 	this->getLocalData().sprites[9000][1] = Mugen::Util::probeSff(absoluteSff, 9000, 1, true);
@@ -695,7 +739,7 @@ void Character::addCommand(Command2 * command){
 void Character::setAnimation(int animation, int element){
     if (getAnimation(animation) != NULL){
         getLocalData().foreignAnimation = NULL;
-        getStateData().currentAnimation = animation;
+        getTickData().currentAnimation = animation;
         if (getCurrentAnimation() != NULL){
             getCurrentAnimation()->reset();
             getCurrentAnimation()->setPosition(element);
@@ -720,6 +764,7 @@ void Character::loadCmdFile(const Filesystem::RelativePath & path){
         int defaultBufferTime = 1;
 
         AstRef parsed(Util::parseCmd(full));
+        addParsedFile(full);
         PaintownUtil::ReferenceCount<State> currentState;
         for (Ast::AstParse::section_iterator section_it = parsed->getSections()->begin(); section_it != parsed->getSections()->end(); section_it++){
             Ast::Section * section = *section_it;
@@ -850,7 +895,7 @@ void Character::loadCmdFile(const Filesystem::RelativePath & path){
         throw MugenException(out.str(), __FILE__, __LINE__);
     }
                 
-    mergeStates(getLocalData().states, out);
+    mergeStates(editDefinition().states, out);
 }
 
 static bool isStateDefSection(string name){
@@ -954,15 +999,15 @@ bool Character::canBeHit(Character * enemy){
     }
 
     return (getMoveType() != Move::Hit) ||
-           (getMoveType() == Move::Hit && getStateData().juggleRemaining >= enemy->getCurrentJuggle());
+           (getMoveType() == Move::Hit && getTickData().juggleRemaining >= enemy->getCurrentJuggle());
 }
     
 void Character::setConstant(std::string name, const vector<double> & values){
-    getLocalData().constants[name] = Constant(values);
+    editDefinition().constants[name] = Constant(values);
 }
 
 void Character::setConstant(std::string name, double value){
-    getLocalData().constants[name] = Constant(value);
+    editDefinition().constants[name] = Constant(value);
 }
 
 void Character::setFloatVariable(int index, const RuntimeValue & value){
@@ -998,11 +1043,11 @@ RuntimeValue Character::getSystemVariable(int index) const {
 }
         
 void Character::resetStateTime(){
-    getStateData().stateTime = 0;
+    getTickData().stateTime = 0;
 }
         
 void Character::resetJugglePoints(){
-    getStateData().juggleRemaining = getJugglePoints();
+    getTickData().juggleRemaining = getJugglePoints();
 }
     
 /*
@@ -1039,14 +1084,14 @@ void Character::delayChangeState(Mugen::Stage & stage, int stateNumber){
     getHitState().moveContact = 0;
 
     /* reset hit count */
-    getStateData().hitCount = 0;
+    getTickData().hitCount = 0;
 
     ostringstream debug;
     debug << getDisplayName() << "-" << getId().intValue();
     Global::debug(1, debug.str()) << "Tick " << stage.getTicks() << " Change from state " << getCurrentState() << " to state " << stateNumber << endl;
-    getStateData().previousState = getCurrentState();
+    getTickData().previousState = getCurrentState();
     setCurrentState(stateNumber);
-    getStateData().stateTime = -1;
+    getTickData().stateTime = -1;
     /*
     if (getState(currentState) != NULL){
         PaintownUtil::ReferenceCount<State> state = getState(currentState);
@@ -1084,12 +1129,12 @@ void Character::changeState(Mugen::Stage & stage, int stateNumber){
     getHitState().moveContact = 0;
 
     /* reset hit count */
-    getStateData().hitCount = 0;
+    getTickData().hitCount = 0;
 
     ostringstream debug;
     debug << getDisplayName() << "-" << getId().intValue();
     Global::debug(1, debug.str()) << "Tick " << stage.getTicks() << " Change from state " << getCurrentState() << " to state " << stateNumber << endl;
-    getStateData().previousState = getCurrentState();
+    getTickData().previousState = getCurrentState();
     setCurrentState(stateNumber);
     resetStateTime();
     if (getState(getCurrentState(), stage) != NULL){
@@ -1113,6 +1158,7 @@ void Character::loadCnsFile(const Filesystem::RelativePath & path){
     try{
         /* cns can use the Cmd parser */
         AstRef parsed(Util::parseCmd(full));
+        addParsedFile(full);
         for (Ast::AstParse::section_iterator section_it = parsed->getSections()->begin(); section_it != parsed->getSections()->end(); section_it++){
             Ast::Section * section = *section_it;
             std::string head = section->getName();
@@ -1559,8 +1605,108 @@ PaintownUtil::ReferenceCount<State> Character::parseStateDefinition(Ast::Section
     return definition;
 }
         
-static map<string, StateController::Type> types;
-static bool typesSetup = false;
+static map<string, StateController::Type> makeControllerTypes(){
+    map<string, StateController::Type> types;
+    types["afterimage"] = StateController::AfterImage;
+    types["afterimagetime"] = StateController::AfterImageTime;
+    types["allpalfx"] = StateController::AllPalFX;
+    types["angleadd"] = StateController::AngleAdd;
+    types["angledraw"] = StateController::AngleDraw;
+    types["anglemul"] = StateController::AngleMul;
+    types["angleset"] = StateController::AngleSet;
+    types["appendtoclipboard"] = StateController::AppendToClipboard;
+    types["assertspecial"] = StateController::AssertSpecial;
+    types["attackdist"] = StateController::AttackDist;
+    types["attackmulset"] = StateController::AttackMulSet;
+    types["bgpalfx"] = StateController::BGPalFX;
+    types["bindtoparent"] = StateController::BindToParent;
+    types["bindtoroot"] = StateController::BindToRoot;
+    types["bindtotarget"] = StateController::BindToTarget;
+    types["changeanim"] = StateController::ChangeAnim;
+    types["changeanim2"] = StateController::ChangeAnim2;
+    types["changestate"] = StateController::ChangeState;
+    types["clearclipboard"] = StateController::ClearClipboard;
+    types["ctrlset"] = StateController::CtrlSet;
+    types["defencemulset"] = StateController::DefenceMulSet;
+    types["destroyself"] = StateController::DestroySelf;
+    types["displaytoclipboard"] = StateController::DisplayToClipboard;
+    types["envcolor"] = StateController::EnvColor;
+    types["envshake"] = StateController::EnvShake;
+    types["explod"] = StateController::Explod;
+    types["explodbindtime"] = StateController::ExplodBindTime;
+    types["forcefeedback"] = StateController::ForceFeedback;
+    types["fallenvshake"] = StateController::FallEnvShake;
+    types["gamemakeanim"] = StateController::GameMakeAnim;
+    types["gravity"] = StateController::Gravity;
+    types["helper"] = StateController::Helper;
+    types["hitadd"] = StateController::HitAdd;
+    types["hitby"] = StateController::HitBy;
+    types["hitdef"] = StateController::HitDef;
+    types["hitfalldamage"] = StateController::HitFallDamage;
+    types["hitfallset"] = StateController::HitFallSet;
+    types["hitfallvel"] = StateController::HitFallVel;
+    types["hitoverride"] = StateController::HitOverride;
+    types["hitvelset"] = StateController::HitVelSet;
+    types["lifeadd"] = StateController::LifeAdd;
+    types["lifeset"] = StateController::LifeSet;
+    types["makedust"] = StateController::MakeDust;
+    types["modifyexplod"] = StateController::ModifyExplod;
+    types["movehitreset"] = StateController::MoveHitReset;
+    types["nothitby"] = StateController::NotHitBy;
+    types["null"] = StateController::Null;
+    types["offset"] = StateController::Offset;
+    types["palfx"] = StateController::PalFX;
+    types["parentvaradd"] = StateController::ParentVarAdd;
+    types["parentvarset"] = StateController::ParentVarSet;
+    types["pause"] = StateController::Pause;
+    types["playerpush"] = StateController::PlayerPush;
+    types["playsnd"] = StateController::PlaySnd;
+    types["posadd"] = StateController::PosAdd;
+    types["posfreeze"] = StateController::PosFreeze;
+    types["posset"] = StateController::PosSet;
+    types["poweradd"] = StateController::PowerAdd;
+    types["powerset"] = StateController::PowerSet;
+    types["projectile"] = StateController::Projectile;
+    types["removeexplod"] = StateController::RemoveExplod;
+    types["reversaldef"] = StateController::ReversalDef;
+    types["screenbound"] = StateController::ScreenBound;
+    types["selfstate"] = StateController::SelfState;
+    types["sprpriority"] = StateController::SprPriority;
+    types["statetypeset"] = StateController::StateTypeSet;
+    types["sndpan"] = StateController::SndPan;
+    types["stopsnd"] = StateController::StopSnd;
+    types["superpause"] = StateController::SuperPause;
+    types["targetbind"] = StateController::TargetBind;
+    types["targetdrop"] = StateController::TargetDrop;
+    types["targetfacing"] = StateController::TargetFacing;
+    types["targetlifeadd"] = StateController::TargetLifeAdd;
+    types["targetpoweradd"] = StateController::TargetPowerAdd;
+    types["targetstate"] = StateController::TargetState;
+    types["targetveladd"] = StateController::TargetVelAdd;
+    types["targetvelset"] = StateController::TargetVelSet;
+    types["trans"] = StateController::Trans;
+    types["turn"] = StateController::Turn;
+    types["varadd"] = StateController::VarAdd;
+    types["varrandom"] = StateController::VarRandom;
+    types["varrangeset"] = StateController::VarRangeSet;
+    types["varset"] = StateController::VarSet;
+    types["veladd"] = StateController::VelAdd;
+    types["velmul"] = StateController::VelMul;
+    types["velset"] = StateController::VelSet;
+    types["width"] = StateController::Width;
+    types["zoom"] = StateController::Zoom;
+    types["debug"] = StateController::Debug;
+    return types;
+}
+
+/* Characters can load on several threads at once (one per simulated match) so
+ * the table is built exactly once by the local static rather than lazily by
+ * whichever walker gets there first.
+ */
+static const map<string, StateController::Type> & controllerTypes(){
+    static const map<string, StateController::Type> types = makeControllerTypes();
+    return types;
+}
 
 StateController * Character::parseState(Ast::Section * section){
     std::string head = section->getName();
@@ -1573,98 +1719,6 @@ StateController * Character::parseState(Ast::Section * section){
     public:
         StateControllerWalker():
         type(StateController::Unknown){
-            if (!typesSetup){
-                typesSetup = true;
-                types["afterimage"] = StateController::AfterImage;
-                types["afterimagetime"] = StateController::AfterImageTime;
-                types["allpalfx"] = StateController::AllPalFX;
-                types["angleadd"] = StateController::AngleAdd;
-                types["angledraw"] = StateController::AngleDraw;
-                types["anglemul"] = StateController::AngleMul;
-                types["angleset"] = StateController::AngleSet;
-                types["appendtoclipboard"] = StateController::AppendToClipboard;
-                types["assertspecial"] = StateController::AssertSpecial;
-                types["attackdist"] = StateController::AttackDist;
-                types["attackmulset"] = StateController::AttackMulSet;
-                types["bgpalfx"] = StateController::BGPalFX;
-                types["bindtoparent"] = StateController::BindToParent;
-                types["bindtoroot"] = StateController::BindToRoot;
-                types["bindtotarget"] = StateController::BindToTarget;
-                types["changeanim"] = StateController::ChangeAnim;
-                types["changeanim2"] = StateController::ChangeAnim2;
-                types["changestate"] = StateController::ChangeState;
-                types["clearclipboard"] = StateController::ClearClipboard;
-                types["ctrlset"] = StateController::CtrlSet;
-                types["defencemulset"] = StateController::DefenceMulSet;
-                types["destroyself"] = StateController::DestroySelf;
-                types["displaytoclipboard"] = StateController::DisplayToClipboard;
-                types["envcolor"] = StateController::EnvColor;
-                types["envshake"] = StateController::EnvShake;
-                types["explod"] = StateController::Explod;
-                types["explodbindtime"] = StateController::ExplodBindTime;
-                types["forcefeedback"] = StateController::ForceFeedback;
-                types["fallenvshake"] = StateController::FallEnvShake;
-                types["gamemakeanim"] = StateController::GameMakeAnim;
-                types["gravity"] = StateController::Gravity;
-                types["helper"] = StateController::Helper;
-                types["hitadd"] = StateController::HitAdd;
-                types["hitby"] = StateController::HitBy;
-                types["hitdef"] = StateController::HitDef;
-                types["hitfalldamage"] = StateController::HitFallDamage;
-                types["hitfallset"] = StateController::HitFallSet;
-                types["hitfallvel"] = StateController::HitFallVel;
-                types["hitoverride"] = StateController::HitOverride;
-                types["hitvelset"] = StateController::HitVelSet;
-                types["lifeadd"] = StateController::LifeAdd;
-                types["lifeset"] = StateController::LifeSet;
-                types["makedust"] = StateController::MakeDust;
-                types["modifyexplod"] = StateController::ModifyExplod;
-                types["movehitreset"] = StateController::MoveHitReset;
-                types["nothitby"] = StateController::NotHitBy;
-                types["null"] = StateController::Null;
-                types["offset"] = StateController::Offset;
-                types["palfx"] = StateController::PalFX;
-                types["parentvaradd"] = StateController::ParentVarAdd;
-                types["parentvarset"] = StateController::ParentVarSet;
-                types["pause"] = StateController::Pause;
-                types["playerpush"] = StateController::PlayerPush;
-                types["playsnd"] = StateController::PlaySnd;
-                types["posadd"] = StateController::PosAdd;
-                types["posfreeze"] = StateController::PosFreeze;
-                types["posset"] = StateController::PosSet;
-                types["poweradd"] = StateController::PowerAdd;
-                types["powerset"] = StateController::PowerSet;
-                types["projectile"] = StateController::Projectile;
-                types["removeexplod"] = StateController::RemoveExplod;
-                types["reversaldef"] = StateController::ReversalDef;
-                types["screenbound"] = StateController::ScreenBound;
-                types["selfstate"] = StateController::SelfState;
-                types["sprpriority"] = StateController::SprPriority;
-                types["statetypeset"] = StateController::StateTypeSet;
-                types["sndpan"] = StateController::SndPan;
-                types["stopsnd"] = StateController::StopSnd;
-                types["superpause"] = StateController::SuperPause;
-                types["targetbind"] = StateController::TargetBind;
-                types["targetdrop"] = StateController::TargetDrop;
-                types["targetfacing"] = StateController::TargetFacing;
-                types["targetlifeadd"] = StateController::TargetLifeAdd;
-                types["targetpoweradd"] = StateController::TargetPowerAdd;
-                types["targetstate"] = StateController::TargetState;
-                types["targetveladd"] = StateController::TargetVelAdd;
-                types["targetvelset"] = StateController::TargetVelSet;
-                types["trans"] = StateController::Trans;
-                types["turn"] = StateController::Turn;
-                types["varadd"] = StateController::VarAdd;
-                types["varrandom"] = StateController::VarRandom;
-                types["varrangeset"] = StateController::VarRangeSet;
-                types["varset"] = StateController::VarSet;
-                types["veladd"] = StateController::VelAdd;
-                types["velmul"] = StateController::VelMul;
-                types["velset"] = StateController::VelSet;
-                types["width"] = StateController::Width;
-                types["zoom"] = StateController::Zoom;
-                types["debug"] = StateController::Debug;
-            }
         }
 
         StateController::Type type;
@@ -1675,8 +1729,9 @@ StateController * Character::parseState(Ast::Section * section){
                 simple.view() >> type;
                 type = Mugen::Util::fixCase(type);
                 
+                const map<string, StateController::Type> & types = controllerTypes();
                 if (types.find(type) != types.end()){
-                    map<string, StateController::Type>::iterator what = types.find(type);
+                    map<string, StateController::Type>::const_iterator what = types.find(type);
                     this->type = (*what).second;
                 } else {
                     Global::debug(0) << "Unknown state controller type " << type << endl;
@@ -1733,6 +1788,7 @@ void Character::loadStateFile(const Filesystem::AbsolutePath & base, const strin
     // string full = Filesystem::find(base + "/" + PaintownUtil::trim(path));
     /* st can use the Cmd parser */
     AstRef parsed(Util::parseCmd(full));
+    addParsedFile(full);
     map<int, PaintownUtil::ReferenceCount<State> > out;
     PaintownUtil::ReferenceCount<State> currentState;
     for (Ast::AstParse::section_iterator section_it = parsed->getSections()->begin(); section_it != parsed->getSections()->end(); section_it++){
@@ -1757,7 +1813,7 @@ void Character::loadStateFile(const Filesystem::AbsolutePath & base, const strin
         }
     }
 
-    mergeStates(getLocalData().states, out);
+    mergeStates(editDefinition().states, out);
 }
     
 void Character::startRecording(int count){
@@ -1808,7 +1864,7 @@ void Character::stopRecording(){
 }
     
 void Character::checkStateControllers(){
-    for (map<int, PaintownUtil::ReferenceCount<State> >::iterator it = getLocalData().states.begin(); it != getLocalData().states.end(); it++){
+    for (map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = getDefinition().states.begin(); it != getDefinition().states.end(); it++){
         PaintownUtil::ReferenceCount<State> state = it->second;
         if (state->getControllers().size() == 0){
             std::ostringstream out;
@@ -1848,6 +1904,7 @@ void Character::load(int useAct){
     // const std::string ourDefFile = location;
      
     AstRef parsed(Util::parseDef(getLocalData().location));
+    addParsedFile(getLocalData().location);
     try{
         /* Every character should have a [Files] section at least. Possibly [Info] as well
          * but I'm not sure yet.
@@ -1876,34 +1933,34 @@ void Character::load(int useAct){
                         virtual void onAttributeSimple(const Ast::AttributeSimple & simple){
                             if (simple == "name"){
                                 try{
-                                    simple.view() >> self.getLocalData().name;
+                                    simple.view() >> self.editDefinition().name;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "displayname"){
                                 try{
-                                    simple.view() >> self.getLocalData().displayName;
+                                    simple.view() >> self.editDefinition().displayName;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "versiondate"){
                                 try{
-                                    simple.view() >> self.getLocalData().versionDate;
+                                    simple.view() >> self.editDefinition().versionDate;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "mugenversion"){
                                 try{
-                                    simple.view() >> self.getLocalData().mugenVersion;
+                                    simple.view() >> self.editDefinition().mugenVersion;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "author"){
                                 try{
-                                    simple.view() >> self.getLocalData().author;
+                                    simple.view() >> self.editDefinition().author;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "pal.defaults"){
                                 vector<int> numbers;
                                 simple.view() >> numbers;
                                 for (vector<int>::iterator it = numbers.begin(); it != numbers.end(); it++){
-                                    self.getLocalData().palDefaults.push_back((*it) - 1);
+                                    self.editDefinition().palDefaults.push_back((*it) - 1);
                                 }
                                 // Global::debug(1) << "Pal" << self.palDefaults.size() << ": " << num << endl;
                             } else if (simple == "localcoord"){
@@ -1933,7 +1990,7 @@ void Character::load(int useAct){
                             if (simple == "cmd"){
                                 string file;
                                 simple.view() >> file;
-                                self.getLocalData().cmdFile = Filesystem::RelativePath(file);
+                                self.editDefinition().cmdFile = Filesystem::RelativePath(file);
                                 /* loaded later after the state files */
                             } else if (simple == "cns"){
                                 string file;
@@ -1957,13 +2014,13 @@ void Character::load(int useAct){
                                 simple.view() >> path;
                                 stateFiles.push_back(Location(self.getLocalData().baseDir, path));
                             } else if (simple == "sprite"){
-                                simple.view() >> self.getLocalData().sffFile;
+                                simple.view() >> self.editDefinition().sffFile;
                             } else if (simple == "anim"){
-                                simple.view() >> self.getLocalData().airFile;
+                                simple.view() >> self.editDefinition().airFile;
                             } else if (simple == "sound"){
-                                simple.view() >> self.getLocalData().sndFile;
+                                simple.view() >> self.editDefinition().sndFile;
                                 // Mugen::Util::readSounds(Mugen::Util::fixFileName(self.baseDir, self.sndFile), self.sounds);
-                                Util::readSounds(Storage::instance().lookupInsensitive(self.getLocalData().baseDir, Filesystem::RelativePath(self.getLocalData().sndFile)), self.getLocalData().sounds);
+                                Util::readSounds(Storage::instance().lookupInsensitive(self.getLocalData().baseDir, Filesystem::RelativePath(self.editDefinition().sndFile)), self.editDefinition().sounds);
                             } else if (PaintownUtil::matchRegex(PaintownUtil::lowerCaseAll(simple.idString()), PaintownUtil::Regex("pal[0-9]+"))){
                                 int num = atoi(PaintownUtil::captureRegex(PaintownUtil::lowerCaseAll(simple.idString()), PaintownUtil::Regex("pal([0-9]+)"), 0).c_str());
                                 try{
@@ -1972,7 +2029,7 @@ void Character::load(int useAct){
                                      * pal2 =
                                      */
                                     simple.view() >> what;
-                                    self.getLocalData().palFile[num] = what;
+                                    self.editDefinition().palFile[num] = what;
                                 } catch (const Ast::Exception & fail){
                                     Global::debug(1) << "No palette defined for " << num << std::endl;
                                 }
@@ -2009,7 +2066,7 @@ void Character::load(int useAct){
 
                 }
 
-                loadCmdFile(getLocalData().cmdFile);
+                loadCmdFile(getDefinition().cmdFile);
 
                 compileTime.endTime();
                 Global::debug(1) << compileTime.printTime("Compile time") << std::endl;
@@ -2085,12 +2142,12 @@ void Character::load(int useAct){
                         virtual void onAttributeSimple(const Ast::AttributeSimple & simple){
                             if (simple == "intro.storyboard"){
                                 try{
-                                    simple.view() >> self.getLocalData().introFile;
+                                    simple.view() >> self.editDefinition().introFile;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else if (simple == "ending.storyboard"){
                                 try{
-                                    simple.view() >> self.getLocalData().endingFile;
+                                    simple.view() >> self.editDefinition().endingFile;
                                 } catch (const Ast::Exception & fail){
                                 }
                             } else {
@@ -2120,10 +2177,10 @@ void Character::load(int useAct){
     }
 
     // Current palette
-    if (getLocalData().palDefaults.empty()){
+    if (getDefinition().palDefaults.empty()){
 	// Correct the palette defaults
-	for (unsigned int i = 0; i < getLocalData().palFile.size(); ++i){
-	    getLocalData().palDefaults.push_back(i);
+	for (unsigned int i = 0; i < getDefinition().palFile.size(); ++i){
+	    editDefinition().palDefaults.push_back(i);
 	}
     }
     /*
@@ -2151,6 +2208,10 @@ void Character::load(int useAct){
     
     fixAssumptions();
 
+    if (ParseCache::releaseAfterCompile()){
+        releaseParsedFiles();
+    }
+
     /*
     State * state = states[-1];
     for (vector<StateController*>::const_iterator it = state->getControllers().begin(); it != state->getControllers().end(); it++){
@@ -2159,19 +2220,27 @@ void Character::load(int useAct){
     */
 }
 
+static string findPaletteFile(const map<int, string> & files, int palette){
+    map<int, string>::const_iterator found = files.find(palette);
+    if (found != files.end()){
+        return found->second;
+    }
+    return "";
+}
+
 void Character::loadGraphics(int palette){
     std::string paletteFile = "";
-    if (getLocalData().palFile.find(palette) == getLocalData().palFile.end()){
+    if (getDefinition().palFile.find(palette) == getDefinition().palFile.end()){
         /* FIXME: choose a default. its not just palette 1 because that palette
          * might not exist
          */
 	Global::debug(1) << "Couldn't find palette: " << palette << " in palette collection. Defaulting to internal palette if available." << endl;
-        if (getLocalData().palFile.size() > 0){
-            paletteFile = getLocalData().palFile.begin()->second;
+        if (getDefinition().palFile.size() > 0){
+            paletteFile = getDefinition().palFile.begin()->second;
         }
     } else {
-        if (palette < (int) getLocalData().palFile.size()){
-            paletteFile = getLocalData().palFile[palette];
+        if (palette < (int) getDefinition().palFile.size()){
+            paletteFile = findPaletteFile(getDefinition().palFile, palette);
             Global::debug(2) << "Current pal: " << palette << " | Palette File: " << paletteFile << endl;
         }
     }
@@ -2187,10 +2256,63 @@ void Character::loadGraphics(int palette){
 
     getLocalData().sprites = SpriteMap();
 
-    Util::readSprites(Storage::instance().lookupInsensitive(getLocalData().baseDir, Filesystem::RelativePath(getLocalData().sffFile)), finalPalette, getLocalData().sprites, true);
+    Util::readSprites(Storage::instance().lookupInsensitive(getLocalData().baseDir, Filesystem::RelativePath(getDefinition().sffFile)), finalPalette, getLocalData().sprites, true);
 
     Global::debug(2) << "Reading Air (animation) Data..." << endl;
-    getLocalData().animations = Util::loadAnimations(Storage::instance().lookupInsensitive(getLocalData().baseDir, Filesystem::RelativePath(getLocalData().airFile)), getLocalData().sprites, true);
+    Filesystem::AbsolutePath air = Storage::instance().lookupInsensitive(getLocalData().baseDir, Filesystem::RelativePath(getDefinition().airFile));
+    editDefinition().animations = Util::loadAnimations(air, getLocalData().sprites, true);
+    addParsedFile(air);
+}
+
+void Character::addParsedFile(const Filesystem::AbsolutePath & path){
+    std::vector<Filesystem::AbsolutePath> & files = editDefinition().parsedFiles;
+    if (std::find(files.begin(), files.end(), path) == files.end()){
+        files.push_back(path);
+    }
+}
+
+void Character::releaseParsedFiles(){
+    const std::vector<Filesystem::AbsolutePath> & files = getDefinition().parsedFiles;
+    for (std::vector<Filesystem::AbsolutePath>::const_iterator it = files.begin(); it != files.end(); it++){
+        ParseCache::release(*it);
+    }
+}
+
+Character::MemoryUsage Character::getMemoryUsage() const {
+    MemoryUsage usage;
+
+    const std::vector<Filesystem::AbsolutePath> & files = getDefinition().parsedFiles;
+    for (std::vector<Filesystem::AbsolutePath>::const_iterator it = files.begin(); it != files.end(); it++){
+        usage.ast += ParseCache::getSize(*it);
+    }
+
+    const std::map<int, PaintownUtil::ReferenceCount<State> > & states = getDefinition().states;
+    for (std::map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = states.begin(); it != states.end(); it++){
+        if (it->second != NULL){
+            usage.states += 1;
+            usage.controllers += it->second->getControllers().size();
+        }
+    }
+
+    for (SpriteMap::const_iterator group = getLocalData().sprites.begin(); group != getLocalData().sprites.end(); group++){
+        for (GroupMap::const_iterator sprite = group->second.begin(); sprite != group->second.end(); sprite++){
+            if (sprite->second != NULL){
+                /* sprites are converted to 16 bit bitmaps */
+                usage.sprites += sprite->second->getWidth() * sprite->second->getHeight() * 2;
+            }
+        }
+    }
+
+    try{
+        Filesystem::AbsolutePath sounds = Storage::instance().lookupInsensitive(getLocalData().baseDir, Filesystem::RelativePath(getDefinition().sndFile));
+        PaintownUtil::ReferenceCount<Storage::File> file = Storage::instance().open(sounds);
+        if (file != NULL){
+            usage.sounds = file->getSize();
+        }
+    } catch (const Filesystem::Exception & fail){
+    }
+
+    return usage;
 }
 
 bool Character::isBound() const {
@@ -2260,7 +2382,7 @@ void Character::doubleJump(Mugen::Stage & stage, const vector<string> & inputs){
 
 /* TODO: get rid of inputs */
 void Character::stopGuarding(Mugen::Stage & stage, const vector<string> & inputs){
-    getStateData().guarding = false;
+    getTickData().guarding = false;
     if (getStateType() == StateType::Crouch){
         changeState(stage, Crouching);
     } else if (getStateType() == StateType::Air){
@@ -2299,7 +2421,7 @@ void Character::fixAssumptions(){
      * or holdback is pressed
      */
 
-    if (getLocalData().states[-1] != 0){
+    if (editDefinition().states[-1] != 0){
         /* walk */
         {
             ostringstream raw;
@@ -2308,7 +2430,7 @@ void Character::fixAssumptions(){
             raw << "trigger1 = command = \"holdfwd\"\n";
             raw << "trigger2 = command = \"holdback\"\n";
             raw << "value = " << WalkingForwards << "\n";
-            getLocalData().states[-1]->addController(parseController(raw.str(), "paintown internal walk", -1, nextStateControllerId(), StateController::ChangeState));
+            editDefinition().states[-1]->addController(parseController(raw.str(), "paintown internal walk", -1, nextStateControllerId(), StateController::ChangeState));
         }
 
 
@@ -2322,7 +2444,7 @@ void Character::fixAssumptions(){
             raw << "trigger2 = stateno = " << WalkingForwards << "\n";
             raw << "triggerall = command = \"holddown\"\n";
 
-            getLocalData().states[-1]->addControllerFront(parseController(raw.str(), "paintown internal crouch", -1, nextStateControllerId(), StateController::ChangeState));
+            editDefinition().states[-1]->addControllerFront(parseController(raw.str(), "paintown internal crouch", -1, nextStateControllerId(), StateController::ChangeState));
         }
 
         /* jump */
@@ -2350,7 +2472,7 @@ void Character::fixAssumptions(){
             controller->addTrigger(1, Compiler::compileAndDelete(new Ast::ExpressionInfix(-1, -1, Ast::ExpressionInfix::Equals,
                         new Ast::SimpleIdentifier("command"),
                         new Ast::String(-1, -1, new string("holdup")))));
-            getLocalData().states[-1]->addController(controller);
+            editDefinition().states[-1]->addController(controller);
         }
 
         /* double jump */
@@ -2397,12 +2519,12 @@ void Character::fixAssumptions(){
                         // new Ast::String(new string("holdup")
                         new Ast::String(-1, -1, new string(jumpCommand)
                             ))));
-            getLocalData().states[-1]->addController(controller);
+            editDefinition().states[-1]->addController(controller);
         }
     }
 
     {
-        if (getLocalData().states[StopGuardStand] != 0){
+        if (editDefinition().states[StopGuardStand] != 0){
             class StopGuardStandController: public StateController {
             public:
                 StopGuardStandController(unsigned int id):
@@ -2422,55 +2544,55 @@ void Character::fixAssumptions(){
             controller->addTrigger(1, Compiler::compileAndDelete(new Ast::ExpressionInfix(-1, -1, Ast::ExpressionInfix::Equals,
                     new Ast::SimpleIdentifier("animtime"),
                     new Ast::Number(-1, -1, 0))));
-            getLocalData().states[StopGuardStand]->addController(controller);
+            editDefinition().states[StopGuardStand]->addController(controller);
         }
     }
 
     /* need a 20 state controller that changes to state 0 if holdfwd
      * or holdback is not pressed
      */
-    if (getLocalData().states[20] != 0){
+    if (editDefinition().states[20] != 0){
         ostringstream raw;
         raw << "[State 20, paintown-internal-stop-walking]\n";
         raw << "value = " << Standing << "\n";
         raw << "trigger1 = command != \"holdfwd\"\n";
         raw << "trigger1 = command != \"holdback\"\n";
 
-        getLocalData().states[20]->addController(parseController(raw.str(), "paintown internal stop walking", 20, nextStateControllerId(), StateController::ChangeState));
+        editDefinition().states[20]->addController(parseController(raw.str(), "paintown internal stop walking", 20, nextStateControllerId(), StateController::ChangeState));
     }
 
-    if (getLocalData().states[Standing] != 0){
-        getLocalData().states[Standing]->setControl(Compiler::compile(1));
+    if (editDefinition().states[Standing] != 0){
+        editDefinition().states[Standing]->setControl(Compiler::compile(1));
     }
 
-    if (getLocalData().states[StandToCrouch] != NULL){
+    if (editDefinition().states[StandToCrouch] != NULL){
         ostringstream raw;
         raw << "[State " << StandToCrouch << ", paintown-internal-stand-while-crouching]\n";
         raw << "value = " << CrouchToStand << "\n";
         raw << "trigger1 = command != \"holddown\"\n";
 
-        getLocalData().states[StandToCrouch]->addController(parseController(raw.str(), "stand while crouching", StandToCrouch, nextStateControllerId(), StateController::ChangeState));
+        editDefinition().states[StandToCrouch]->addController(parseController(raw.str(), "stand while crouching", StandToCrouch, nextStateControllerId(), StateController::ChangeState));
 
     }
 
     /* stand after crouching */
-    if (getLocalData().states[11] != 0){
+    if (editDefinition().states[11] != 0){
         ostringstream raw;
         raw << "[State 11, paintown-internal-stand-after-crouching]\n";
         raw << "value = " << CrouchToStand << "\n";
         raw << "trigger1 = command != \"holddown\"\n";
 
-        getLocalData().states[11]->addController(parseController(raw.str(), "stand after crouching", 11, nextStateControllerId(), StateController::ChangeState));
+        editDefinition().states[11]->addController(parseController(raw.str(), "stand after crouching", 11, nextStateControllerId(), StateController::ChangeState));
     }
 
     /* get up kids */
-    if (getLocalData().states[Liedown] != 0){
+    if (editDefinition().states[Liedown] != 0){
         ostringstream raw;
         raw << "[State " << Liedown << ", paintown-internal-get-up]\n";
         raw << "value = " << GetUpFromLiedown << "\n";
         raw << "trigger1 = time >= " << getLieDownTime() << "\n";
 
-        getLocalData().states[Liedown]->addController(parseController(raw.str(), "get up", Liedown, nextStateControllerId(), StateController::ChangeState));
+        editDefinition().states[Liedown]->addController(parseController(raw.str(), "get up", Liedown, nextStateControllerId(), StateController::ChangeState));
     }
 
     /* standing turn state */
@@ -2478,7 +2600,7 @@ void Character::fixAssumptions(){
         State * turn = new State(StandTurning);
         turn->setType(State::Unchanged);
         turn->setAnimation(Compiler::compile(StandTurning));
-        getLocalData().states[StandTurning] = turn;
+        editDefinition().states[StandTurning] = turn;
 
         ostringstream raw;
         raw << "[State 5, paintown-internal-turn]\n";
@@ -2493,7 +2615,7 @@ void Character::fixAssumptions(){
         State * turn = new State(CrouchTurning);
         turn->setType(State::Unchanged);
         turn->setAnimation(Compiler::compile(CrouchTurning));
-        getLocalData().states[CrouchTurning] = turn;
+        editDefinition().states[CrouchTurning] = turn;
 
         ostringstream raw;
         raw << "[State 5, paintown-internal-crouch-turn]\n";
@@ -2506,7 +2628,7 @@ void Character::fixAssumptions(){
     /* if y reaches 0 then auto-transition to state 52.
      * probably just add a trigger to state 50
      */
-    if (getLocalData().states[50] != 0){
+    if (editDefinition().states[50] != 0){
         /*
         ostringstream raw;
         raw << "[State 50, paintown-internal-land]\n";
@@ -2573,12 +2695,12 @@ bool Character::canRecover() const {
 }
 
 void Character::nextPalette(){
-    if (getLocalData().currentPalette < getLocalData().palDefaults.size()-1){
+    if (getLocalData().currentPalette < getDefinition().palDefaults.size()-1){
 	getLocalData().currentPalette++;
     } else {
         getLocalData().currentPalette = 0;
     }
-    Global::debug(1) << "Current pal: " << getLocalData().currentPalette << " | Location: " << getLocalData().palDefaults[getLocalData().currentPalette] << " | Palette File: " << getLocalData().palFile[getLocalData().palDefaults[getLocalData().currentPalette]] << endl;
+    Global::debug(1) << "Current pal: " << getLocalData().currentPalette << " | Location: " << getDefinition().palDefaults[getLocalData().currentPalette] << " | Palette File: " << findPaletteFile(getDefinition().palFile, getDefinition().palDefaults[getLocalData().currentPalette]) << endl;
 
     loadGraphics(getLocalData().currentPalette);
 }
@@ -2587,9 +2709,9 @@ void Character::priorPalette(){
     if (getLocalData().currentPalette > 0){
 	getLocalData().currentPalette--;
     } else {
-        getLocalData().currentPalette = getLocalData().palDefaults.size() -1;
+        getLocalData().currentPalette = getDefinition().palDefaults.size() -1;
     }
-    Global::debug(1) << "Current pal: " << getLocalData().currentPalette << " | Palette File: " << getLocalData().palFile[getLocalData().palDefaults[getLocalData().currentPalette]] << endl;
+    Global::debug(1) << "Current pal: " << getLocalData().currentPalette << " | Palette File: " << findPaletteFile(getDefinition().palFile, getDefinition().palDefaults[getLocalData().currentPalette]) << endl;
 
     loadGraphics(getLocalData().currentPalette);
 }
@@ -2635,7 +2757,7 @@ int Character::getAnimation() const {
     if (getLocalData().foreignAnimation != NULL){
         return getLocalData().foreignAnimationNumber;
     }
-    return getStateData().currentAnimation;
+    return getTickData().currentAnimation;
 }
 
 PaintownUtil::ReferenceCount<Animation> Character::getCurrentAnimation() const {
@@ -2644,7 +2766,7 @@ PaintownUtil::ReferenceCount<Animation> Character::getCurrentAnimation() const {
         return getLocalData().foreignAnimation;
     }
 
-    return getAnimation(getStateData().currentAnimation);
+    return getAnimation(getTickData().currentAnimation);
     /*
     typedef std::map< int, Animation * > Animations;
     Animations::const_iterator it = getAnimations().find(currentAnimation);
@@ -2657,7 +2779,7 @@ PaintownUtil::ReferenceCount<Animation> Character::getCurrentAnimation() const {
 }
 
 void Character::resetStatePersistent(){
-    for (map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = getLocalData().states.begin(); it != getLocalData().states.end(); it++){
+    for (map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = getDefinition().states.begin(); it != getDefinition().states.end(); it++){
         const PaintownUtil::ReferenceCount<State> & state = it->second;
         if (state != NULL){
             const std::vector<StateController*> & controllers = state->getControllers();
@@ -2692,7 +2814,7 @@ void Character::setStatePersistent(const std::map<int, std::map<uint32_t, int> >
 std::map<int, std::map<uint32_t, int> > Character::getStatePersistent() const {
     map<int, map<uint32_t, int> > data;
         
-    for (map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = getLocalData().states.begin(); it != getLocalData().states.end(); it++){
+    for (map<int, PaintownUtil::ReferenceCount<State> >::const_iterator it = getDefinition().states.begin(); it != getDefinition().states.end(); it++){
         const PaintownUtil::ReferenceCount<State> & state = it->second;
         if (state != NULL){
             const std::vector<StateController*> & controllers = state->getControllers();
@@ -2733,10 +2855,10 @@ int Character::pauseTime() const {
 }
     
 double Character::getHealth() const {
-    if (getStateData().health < 0){
+    if (getTickData().health < 0){
         return 0;
     }
-    return getStateData().health;
+    return getTickData().health;
 }
 
 /*
@@ -2758,6 +2880,109 @@ static bool holdingBlock(const vector<string> & commands){
     return false;
 }
 
+AfterImage::Frames::Frames():
+start(0),
+count(0),
+limit(-1){
+}
+
+void AfterImage::Frames::reset(int limit){
+    this->limit = limit;
+    start = 0;
+    count = 0;
+    if (limit >= 0){
+        images.resize(limit);
+    }
+}
+
+void AfterImage::Frames::push(const Image & image){
+    if (limit == 0){
+        return;
+    }
+
+    if (count == images.size()){
+        /* only happens without a limit, or for a ring made before reset() */
+        unsigned int size = count * 2;
+        if (size < 4){
+            size = 4;
+        }
+        if (limit > 0 && size > (unsigned int) limit){
+            size = limit;
+        }
+
+        if (size > count){
+            std::vector<Image> larger;
+            larger.reserve(size);
+            larger.push_back(image);
+            for (unsigned int i = 0; i < count; i++){
+                larger.push_back((*this)[i]);
+            }
+            larger.resize(size);
+            images.swap(larger);
+            start = 0;
+            count += 1;
+            return;
+        }
+    }
+
+    /* the slot before the newest frame is either unused or holds the oldest
+     * frame, which drops off the end
+     */
+    start = (start + images.size() - 1) % images.size();
+    images[start] = image;
+    if (count < images.size()){
+        count += 1;
+    }
+}
+
+static unsigned char afterImageChannel(int value, double bright, double contrast, double post, double extraAdd, double extraMultiply){
+    /* x' = (x + bright) * contrast / 256 + post
+     * = x * contrast / 256 + bright * constrast / 256 + post
+     */
+    double out = value * (contrast / 256.0) + (bright * contrast / 256.0 + post);
+
+    /* the mugen docs lied:
+     * "In one application of these palette effects, first the paladd components are added to the afterimage palette, then the components are multiplied by the palmul multipliers. These effects are applied zero times to the most recent afterimage frame, once to the  second-newest afterimage frame, twice in succession to the third-newest afterimage frame, etc."
+     * This would lead you to believe that you should do an add and
+     * multiply operation for some number of times but in fact what
+     * you are supposed to do is do all the add operations first
+     * and then do all the multiply operations second.
+     */
+    out += extraAdd;
+    out *= extraMultiply;
+
+    if (out < 0){
+        out = 0;
+    }
+    if (out > 255){
+        out = 255;
+    }
+
+    return (unsigned char) (int) out;
+}
+
+const AfterImage::Lookup & AfterImage::getLookup(unsigned int step){
+    while (lookups.size() <= step){
+        int extra = lookups.size();
+        double redAdd = add.red * extra;
+        double redMultiply = pow(multiply.red, extra);
+        double greenAdd = add.green * extra;
+        double greenMultiply = pow(multiply.green, extra);
+        double blueAdd = add.blue * extra;
+        double blueMultiply = pow(multiply.blue, extra);
+
+        Lookup lookup;
+        for (int value = 0; value < 256; value++){
+            lookup.red[value] = afterImageChannel(value, bright.red, contrast.red, postBright.red, redAdd, redMultiply);
+            lookup.green[value] = afterImageChannel(value, bright.green, contrast.green, postBright.green, greenAdd, greenMultiply);
+            lookup.blue[value] = afterImageChannel(value, bright.blue, contrast.blue, postBright.blue, blueAdd, blueMultiply);
+        }
+        lookups.push_back(lookup);
+    }
+
+    return lookups[step];
+}
+
 void Character::processAfterImages(){
     if (getLocalData().afterImage.lifetime > 0){
         getLocalData().afterImage.lifetime -= 1;
@@ -2777,14 +3002,9 @@ void Character::processAfterImages(){
         if (animation != NULL){
             // afterImage.currentTime -= afterImage.timegap;
             Frame * currentSprite = animation->getCurrentFrame();
-            getLocalData().afterImage.frames.push_front(AfterImage::Image(*currentSprite, animation->getCurrentEffects(getFacing() == FacingLeft, false, getLocalData().xscale, getLocalData().yscale), x, y, getLocalData().afterImage.lifetime > 0));
+            getLocalData().afterImage.frames.push(AfterImage::Image(*currentSprite, animation->getCurrentEffects(getFacing() == FacingLeft, false, getLocalData().xscale, getLocalData().yscale), x, y, getLocalData().afterImage.lifetime > 0));
         }
     }
-    if (getLocalData().afterImage.length > 0 &&
-        getLocalData().afterImage.frames.size() >= getLocalData().afterImage.length){
-
-        getLocalData().afterImage.frames.resize(getLocalData().afterImage.length - 1);
-    }
 
 #if 0
     for (deque<AfterImage::Image>::iterator it = afterImage.frames.begin(); it != afterImage.frames.end(); /**/ ){
@@ -2846,15 +3066,15 @@ void Character::act(Stage * stage){
     // reversalActive = false;
 
     getStateData().special = SpecialStuff();
-    getStateData().blocking = false;
+    getTickData().blocking = false;
 
-    if (getStateData().frozen){
-        getStateData().frozen = false;
+    if (getTickData().frozen){
+        getTickData().frozen = false;
     }
  
     //! Check pushable
-    if (getStateData().pushPlayer > 0){
-        getStateData().pushPlayer--;
+    if (getTickData().pushPlayer > 0){
+        getTickData().pushPlayer--;
     }
 
     /* reset some stuff */
@@ -2902,7 +3122,7 @@ void Character::act(Stage * stage){
         getHitState().recoverTime -= 1;
     }
 
-    getStateData().blocking = holdingBlock(getStateData().active);
+    getTickData().blocking = holdingBlock(getStateData().active);
 
     // if (hitState.shakeTime > 0 && moveType != Move::Hit){
     if (getHitState().shakeTime > 0){
@@ -2958,10 +3178,10 @@ void Character::act(Stage * stage){
         }
 
         /* if shakeTime is non-zero should we update stateTime? */
-        getStateData().stateTime += 1;
+        getTickData().stateTime += 1;
 
         /* FIXME: there are a bunch more states that are considered blocking */
-        if (getStateData().blocking && !blockingState(getCurrentState()) &&
+        if (getTickData().blocking && !blockingState(getCurrentState()) &&
             getMoveType() == Move::Idle &&
             stage->getEnemy(this)->getMoveType() == Move::Attack &&
             withinGuardDistance(stage->getEnemy(this))){
@@ -3038,16 +3258,16 @@ void Character::act(Stage * stage){
 }
         
 void Character::addPower(double d){
-    getStateData().power += d;
+    getTickData().power += d;
     /* max power is 3000. is that specified somewhere or just hard coded
      * in the engine?
      */
-    if (getStateData().power > 3000){
-        getStateData().power = 3000;
+    if (getTickData().power > 3000){
+        getTickData().power = 3000;
     }
 
-    if (getStateData().power < 0){
-        getStateData().power = 0;
+    if (getTickData().power < 0){
+        getTickData().power = 0;
     }
 }
         
@@ -3072,9 +3292,9 @@ void Character::testStates(Mugen::Stage & stage, const std::vector<std::string>
 }
 
 void Character::addCombo(int combo){
-    getStateData().hitCount += combo;
-    if (getStateData().hitCount < 0){
-        getStateData().hitCount = 0;
+    getTickData().hitCount += combo;
+    if (getTickData().hitCount < 0){
+        getTickData().hitCount = 0;
     }
 }
 
@@ -3236,14 +3456,14 @@ void Character::didHit(Character * enemy, Mugen::Stage & stage){
 
     /* if he is already in a Hit state then increase combo */
     if (enemy->getMoveType() == Move::Hit){
-        getStateData().combo += 1;
+        getTickData().combo += 1;
     } else {
-        getStateData().combo = 1;
+        getTickData().combo = 1;
     }
 
     // nextCombo = 15;
 
-    getStateData().hitCount += 1;
+    getTickData().hitCount += 1;
 
     /* Mainly used for AI so it can tell if a hit succeeded and thus learn which moves to do */
     if (getLocalData().behavior != NULL){
@@ -3271,7 +3491,7 @@ void Character::hurt(double x){
 void Character::takeDamage(Stage & world, Object * obj, double amount, bool kill, bool defense){
     /* TODO: use getDefense() here somehow */
     if (defense){
-        takeDamage(world, obj, amount / getStateData().defenseMultiplier, 0.0, 0.0);
+        takeDamage(world, obj, amount / getTickData().defenseMultiplier, 0.0, 0.0);
     } else {
         takeDamage(world, obj, amount, 0.0, 0.0);
     }
@@ -3312,7 +3532,7 @@ void Character::wasHit(Mugen::Stage & stage, Character * enemy, const HitDefinit
     getStateData().characterData.who = CharacterId(-1);
     getStateData().characterData.enabled = false;
 
-    getStateData().wasHitCounter += 1;
+    getTickData().wasHitCounter += 1;
     update(getHitState(), stage, *this, getY() < 0, hisHit);
     
     addPower(hisHit.givePower.hit);
@@ -3357,7 +3577,7 @@ void Character::wasHit(Mugen::Stage & stage, Character * enemy, const HitDefinit
     /* FIXME: not sure if disabling afterimage's is the right thing */
     getLocalData().afterImage.lifetime = 0;
 
-    getStateData().juggleRemaining -= enemy->getCurrentJuggle() + hisHit.airJuggle;
+    getTickData().juggleRemaining -= enemy->getCurrentJuggle() + hisHit.airJuggle;
 
     for (map<int, HitOverride>::iterator it = getStateData().hitOverrides.begin(); it != getStateData().hitOverrides.end(); it++){
         HitOverride & override = it->second;
@@ -3479,134 +3699,21 @@ bool Character::doStates(Mugen::Stage & stage, const vector<string> & active, in
     return false;
 }
 
-void Character::drawAfterImage(const AfterImage & afterImage, const AfterImage::Image & frame, int index, int x, int y, const Graphics::Bitmap & work){
-    class AfterImageFilter: public Graphics::Bitmap::Filter {
+void Character::drawAfterImage(AfterImage & afterImage, const AfterImage::Image & frame, int index, int x, int y, const Graphics::Bitmap & work){
+    /* The palette effects only depend on the value of each channel, so the
+     * software path reads the precomputed tables for this step. The shader
+     * does the same math on the GPU.
+     */
+    class AfterImageFilter: public Graphics::Bitmap::ChannelFilter {
     public:
-        /* all the components have this formula
-         * x' = (x + bright) * contrast / 256 + post
-         * = x * contrast / 256 + bright * constrast / 256 + post
-         * So we will call 'contrast/256' multiplier and
-         * 'bright * contrast / 256 + post' adder
-         */
-        struct Save{
-            Save(double bright, double contrast, double post):
-                multiplier(contrast / 256.0),
-                adder(bright * contrast / 256.0 + post){
-                }
-            double multiplier;
-            double adder;
-        };
-
-        AfterImageFilter(const AfterImage::RGBx & bright, const AfterImage::RGBx & contrast, const AfterImage::RGBx & post, const AfterImage::RGBx & extraAdd, const AfterImage::RGBx & extraMultiplier, int extra):
-            bright(bright),
-            contrast(contrast),
-            post(post),
-            extraAdd(extraAdd),
-            extraMultiplier(extraMultiplier),
-            extra(extra),
-            redPart(bright.red, contrast.red, post.red),
-            greenPart(bright.green, contrast.green, post.green),
-            bluePart(bright.blue, contrast.blue, post.blue){
-
-                redExtraAdd = extraAdd.red * extra;
-                redExtraMultiply = pow(extraMultiplier.red, extra);
-                greenExtraAdd = extraAdd.green * extra;
-                greenExtraMultiply = pow(extraMultiplier.green, extra);
-                blueExtraAdd = extraAdd.blue * extra;
-                blueExtraMultiply = pow(extraMultiplier.blue, extra);
+        AfterImageFilter(const AfterImage & afterImage, const AfterImage::Lookup & lookup, int extra):
+            ChannelFilter(lookup.red, lookup.green, lookup.blue),
+            afterImage(afterImage),
+            extra(extra){
             }
 
-        const AfterImage::RGBx & bright;
-        const AfterImage::RGBx & contrast;
-        const AfterImage::RGBx & post;
-        const AfterImage::RGBx & extraAdd;
-        const AfterImage::RGBx & extraMultiplier;
+        const AfterImage & afterImage;
         const int extra;
-        mutable map<Graphics::Color, Graphics::Color> cache;
-
-        double redExtraAdd;
-        double redExtraMultiply;
-        double greenExtraAdd;
-        double greenExtraMultiply;
-        double blueExtraAdd;
-        double blueExtraMultiply;
-
-        Save redPart;
-        Save greenPart;
-        Save bluePart;
-
-        Graphics::Color doFilter(int red, int green, int blue) const {
-            double red_out = red;
-            double green_out = green;
-            double blue_out = blue;
-
-            // red_out = (red_out + bright.red) * contrast.red / 256 + post.red;
-            // green_out = (green_out + bright.green) * contrast.green / 256 + post.green;
-            // blue_out = (blue_out + bright.blue) * contrast.blue / 256 + post.blue;
-            red_out = red_out * redPart.multiplier + redPart.adder;
-            green_out = green_out * greenPart.multiplier + greenPart.adder;
-            blue_out = blue_out * bluePart.multiplier + bluePart.adder;
-
-            /* the mugen docs lied:
-             * "In one application of these palette effects, first the paladd components are added to the afterimage palette, then the components are multiplied by the palmul multipliers. These effects are applied zero times to the most recent afterimage frame, once to the  second-newest afterimage frame, twice in succession to the third-newest afterimage frame, etc."
-             * This would lead you to believe that you should do an add and
-             * multiply operation for some number of times but in fact what
-             * you are supposed to do is do all the add operations first
-             * and then do all the multiply operations second.
-             */
-
-            red_out += redExtraAdd;
-            red_out *= redExtraMultiply;
-            green_out += greenExtraAdd;
-            green_out *= greenExtraMultiply;
-            blue_out += blueExtraAdd;
-            blue_out *= blueExtraMultiply;
-
-            /*
-            red_out += extraAdd.red * extra;
-            red_out *= pow(extraMultiplier.red, extra);
-            green_out += extraAdd.green * extra;
-            green_out *= pow(extraMultiplier.green, extra);
-            blue_out += extraAdd.blue * extra;
-            blue_out *= pow(extraMultiplier.blue, extra);
-            */
-
-            /* This is what the code would look like if the mugen docs
-             * were telling the truth.
-             */
-            /*
-               for (int i = 0; i < extra; i++){
-               red_out += extraAdd.red;
-               red_out *= extraMultiplier.red;
-               green_out += extraAdd.green;
-               green_out *= extraMultiplier.green;
-               blue_out += extraAdd.blue;
-               blue_out *= extraMultiplier.blue;
-               }
-               */
-
-            if (red_out < 0){
-                red_out = 0;
-            }
-            if (red_out > 255){
-                red_out = 255;
-            }
-            if (green_out < 0){
-                green_out = 0;
-            }
-            if (green_out > 255){
-                green_out = 255;
-            }
-            if (blue_out < 0){
-                blue_out = 0;
-            }
-            if (blue_out > 255){
-                blue_out = 255;
-            }
-
-            Graphics::Color out = Graphics::makeColor((int) red_out, (int) green_out, (int) blue_out);
-            return out;
-        }
 
         PaintownUtil::ReferenceCount<Graphics::Shader> shader;
 
@@ -3637,30 +3744,17 @@ void Character::drawAfterImage(const AfterImage & afterImage, const AfterImage::
         void setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & what){
 #ifdef USE_ALLEGRO5
             Graphics::setShaderFloat(shader->getShader(), "extra", extra);
-            Graphics::setShaderVec4(shader->getShader(), "bright", bright.red / 255.0, bright.green / 255.0, bright.blue / 255.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "contrast", contrast.red / 255.0, contrast.green / 255.0,  contrast.blue / 255.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "post", post.red / 255.0, post.green / 255.0, post.blue / 255.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "extraAdd", extraAdd.red / 255.0, extraAdd.green / 255.0, extraAdd.blue / 255.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "extraMultiplier", extraMultiplier.red, extraMultiplier.green, extraMultiplier.blue, 0);
+            Graphics::setShaderVec4(shader->getShader(), "bright", afterImage.bright.red / 255.0, afterImage.bright.green / 255.0, afterImage.bright.blue / 255.0, 0);
+            Graphics::setShaderVec4(shader->getShader(), "contrast", afterImage.contrast.red / 255.0, afterImage.contrast.green / 255.0,  afterImage.contrast.blue / 255.0, 0);
+            Graphics::setShaderVec4(shader->getShader(), "post", afterImage.postBright.red / 255.0, afterImage.postBright.green / 255.0, afterImage.postBright.blue / 255.0, 0);
+            Graphics::setShaderVec4(shader->getShader(), "extraAdd", afterImage.add.red / 255.0, afterImage.add.green / 255.0, afterImage.add.blue / 255.0, 0);
+            Graphics::setShaderVec4(shader->getShader(), "extraMultiplier", afterImage.multiply.red, afterImage.multiply.green, afterImage.multiply.blue, 0);
 #endif
         }
-
-        Graphics::Color filter(Graphics::Color pixel) const {
-            if (cache.find(pixel) != cache.end()){
-                return cache[pixel];
-            }
-
-            int red = Graphics::getRed(pixel);
-            int green = Graphics::getGreen(pixel);
-            int blue = Graphics::getBlue(pixel);
-            Graphics::Color out = doFilter(red, green, blue);
-            cache[pixel] = out;
-            return out;
-        }
     };
 
     /* TODO: handle afterImage.color and afterImage.invert */
-    AfterImageFilter filter(afterImage.bright, afterImage.contrast, afterImage.postBright, afterImage.add, afterImage.multiply, index);
+    AfterImageFilter filter(afterImage, afterImage.getLookup(index), index);
 
     Effects total = frame.effects + afterImage.translucent;
     total.filter = &filter;
@@ -3682,150 +3776,6 @@ void Character::drawAfterImage(const AfterImage & afterImage, const AfterImage::
     // frame.cache = Bitmap(fixed, true);
 }
 
-class PaletteFilter: public Graphics::Bitmap::Filter {
-    public:
-        PaletteFilter(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color):
-        time(time),
-        addRed(addRed),
-        addGreen(addGreen),
-        addBlue(addBlue),
-        multiplyRed(multiplyRed),
-        multiplyGreen(multiplyGreen),
-        multiplyBlue(multiplyBlue),
-        sinRed(sinRed),
-        sinGreen(sinGreen),
-        sinBlue(sinBlue),
-        period(period),
-        invert(invert),
-        color(color){
-        }
-
-        int time;
-        int addRed;
-        int addGreen;
-        int addBlue;
-        int multiplyRed;
-        int multiplyGreen;
-        int multiplyBlue;
-        int sinRed;
-        int sinGreen;
-        int sinBlue;
-        int period;
-        int invert;
-        int color;
-        
-        mutable map<Graphics::Color, Graphics::Color> cache;
-
-        Graphics::Color doFilter(int red, int green, int blue) const {
-            int newRed = red;
-            int newGreen = green;
-            int newBlue = blue;
-
-            if (color < 255){
-                double greyRed = (1 - 0.299) * color / 255 + 0.299;
-                double greyGreen = (1 - 0.587) * color / 255 + 0.587;
-                double greyBlue = (1 - 0.114) * color / 255 + 0.114;
-                red = (int)(red * greyRed + 0.5 + 16);
-                green = (int)(green * greyGreen + 0.5 + 16);
-                blue = (int)(blue * greyBlue + 0.5 + 16);
-            }
-
-            if (invert){
-                red = 255 - red;
-                green = 255 - green;
-                blue = 255 - blue;
-            }
-
-            if (period > 0){
-                newRed = (red + addRed + sinRed * sin(2 * PaintownUtil::pi * time / period)) * multiplyRed / 256;
-                newGreen = (green + addGreen + sinGreen * sin(2 * PaintownUtil::pi * time / period)) * multiplyGreen / 256;
-                newBlue = (blue + addBlue + sinBlue * sin(2 * PaintownUtil::pi * time / period)) * multiplyBlue / 256;
-            } else {
-                newRed = (red + addRed) * multiplyRed / 256;
-                newGreen = (green + addGreen) * multiplyGreen / 256;
-                newBlue = (blue + addBlue) * multiplyBlue / 256;
-            }
-
-            if (newRed > 255){
-                newRed = 255;
-            }
-
-            if (newRed < 0){
-                newRed = 0;
-            }
-
-            if (newGreen > 255){
-                newGreen = 255;
-            }
-
-            if (newGreen < 0){
-                newGreen = 0;
-            }
-
-            if (newBlue > 255){
-                newBlue = 255;
-            }
-
-            if (newBlue < 0){
-                newBlue = 0;
-            }
-
-            return Graphics::makeColor(newRed, newGreen, newBlue);
-        }
-
-        PaintownUtil::ReferenceCount<Graphics::Shader> shader;
-
-        static PaintownUtil::ReferenceCount<Graphics::Shader> create(){
-            PaintownUtil::ReferenceCount<Graphics::Shader> out;
-
-#ifdef USE_ALLEGRO5
-            std::ostringstream vertex;
-            vertex << "#version 110\n";
-            vertex << Graphics::defaultVertexShader();
-            ALLEGRO_SHADER * a5shader = Graphics::create_shader(vertex.str(),
-                                                                Storage::readFile(Storage::instance().find(Filesystem::RelativePath("shaders/mugen-palette-effect.fragment.glsl"))));
-            out = PaintownUtil::ReferenceCount<Graphics::Shader>(new Graphics::Shader(a5shader));
-#endif
-
-            return out;
-        }
-
-        PaintownUtil::ReferenceCount<Graphics::Shader> getShader(){
-            if (shader == NULL){
-                PaintownUtil::ReferenceCount<Graphics::ShaderManager> manager = Graphics::shaderManager.current();
-                shader = manager->getShader("mugen-palfx", create);
-            }
-
-            return shader;
-        }
-
-        void setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & what){
-#ifdef USE_ALLEGRO5
-            Graphics::setShaderBool(shader->getShader(), "invert", invert > 0);
-            Graphics::setShaderInt(shader->getShader(), "time", time);
-            Graphics::setShaderInt(shader->getShader(), "period", period);
-            Graphics::setShaderFloat(shader->getShader(), "color", (float) color / 255.0);
-            Graphics::setShaderVec4(shader->getShader(), "add", (float) addRed / 255.0, (float) addGreen / 255.0, (float) addBlue / 255.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "multiply", (float) multiplyRed / 256.0, (float) multiplyGreen / 256.0, (float) multiplyBlue / 256.0, 0);
-            Graphics::setShaderVec4(shader->getShader(), "sin_", (float) sinRed / 255.0, (float) sinGreen / 255.0, (float) sinBlue / 255.0, 0);
-#endif
-        }
-
-        Graphics::Color filter(Graphics::Color pixel) const {
-            
-            if (cache.find(pixel) != cache.end()){
-                return cache[pixel];
-            }
-
-            int red = Graphics::getRed(pixel);
-            int green = Graphics::getGreen(pixel);
-            int blue = Graphics::getBlue(pixel);
-            Graphics::Color out = doFilter(red, green, blue);
-            cache[pixel] = out;
-            return out;
-        }
-    };
-
 Graphics::Bitmap::Filter * Character::getPaletteEffects(unsigned int time){
     return new PaletteFilter(time, getLocalData().paletteEffects.addRed,
                     getLocalData().paletteEffects.addGreen, getLocalData().paletteEffects.addBlue,
@@ -3882,7 +3832,7 @@ void Character::drawMugenShade(Graphics::Bitmap * work, int rel_x, int intensity
 }
         
 int Character::getStateTime() const {
-    return getStateData().stateTime;
+    return getTickData().stateTime;
 }
 
 void Character::draw(Graphics::Bitmap * work, int cameraX, int cameraY){
@@ -3909,7 +3859,7 @@ void Character::draw(Graphics::Bitmap * work, int cameraX, int cameraY){
         }
 
         for (unsigned int index = 0; index < getLocalData().afterImage.frames.size(); index += getLocalData().afterImage.framegap){
-            AfterImage::Image & frame = getLocalData().afterImage.frames[index];
+            const AfterImage::Image & frame = getLocalData().afterImage.frames[index];
             if (frame.show){
                 int x = frame.x - cameraX + getLocalData().drawOffset.x + frame.sprite.xoffset;
                 int y = frame.y - cameraY + getLocalData().drawOffset.y + frame.sprite.yoffset;
@@ -3960,7 +3910,7 @@ void Character::draw(Graphics::Bitmap * work, int cameraX, int cameraY){
         Graphics::Color color = Graphics::makeColor(255, 255, 255);
         Graphics::Color backgroundColor = Graphics::MaskColor();
         FontRender * render = FontRender::getInstance();
-        render->addMessage(font, x, y, color, backgroundColor, "State %d Animation %d", getCurrentState(), getStateData().currentAnimation);
+        render->addMessage(font, x, y, color, backgroundColor, "State %d Animation %d", getCurrentState(), getTickData().currentAnimation);
         y += font.getHeight();
         render->addMessage(font, x, y, color, backgroundColor, "Vx %f Vy %f", getXVelocity(), getYVelocity());
         y += font.getHeight();
@@ -4116,7 +4066,7 @@ int Character::getFrontX() const {
 }
 
 int Character::getCurrentCombo() const {
-    return getStateData().combo;
+    return getTickData().combo;
 }
 
 /* TODO: implement these */
@@ -4136,22 +4086,22 @@ void Character::addMatchWin(){
 
 void Character::resetPlayer(){
     clearWins();
-    getStateData().power = 0;
+    getTickData().power = 0;
     setHealth(getMaxHealth());
 }
         
 bool Character::isBlocking(const HitDefinition & hit){
     /* FIXME: can only block if in the proper state relative to the hit def */
-    return hasControl() && getStateData().blocking;
+    return hasControl() && getTickData().blocking;
 }
         
 void Character::resetHitFlag(){
     /* FIXME: not sure if this is right */
-    getStateData().guarding = false;
+    getTickData().guarding = false;
 }
 
 bool Character::isGuarding() const {
-    return getStateData().guarding;
+    return getTickData().guarding;
 }
         
 void Character::guarded(Mugen::Stage & stage, Object * enemy, const HitDefinition & hit){
@@ -4183,7 +4133,6 @@ void Character::setAfterImage(int time, int length, int timegap, int framegap, T
     getLocalData().afterImage.lifetime = time;
     getLocalData().afterImage.length = length;
     getLocalData().afterImage.translucent = translucent;
-    getLocalData().afterImage.frames.clear();
     getLocalData().afterImage.paletteColor = paletteColor;
     getLocalData().afterImage.invertColor = invertColor;
     getLocalData().afterImage.bright = bright;
@@ -4191,6 +4140,8 @@ void Character::setAfterImage(int time, int length, int timegap, int framegap, T
     getLocalData().afterImage.postBright = postBright;
     getLocalData().afterImage.add = add;
     getLocalData().afterImage.multiply = multiply;
+    getLocalData().afterImage.frames.reset(length > 0 ? length - 1 : -1);
+    getLocalData().afterImage.lookups.clear();
 }
         
 void Character::setAfterImageTime(int time){
@@ -4198,18 +4149,18 @@ void Character::setAfterImageTime(int time){
 }
         
 void Character::updateAngleEffect(double angle){
-    getStateData().drawAngle = angle;
+    getTickData().drawAngle = angle;
 }
 
 double Character::getAngleEffect() const {
-    return getStateData().drawAngle;
+    return getTickData().drawAngle;
 }
         
 void Character::drawAngleEffect(double angle, bool setAngle, double scaleX, double scaleY){
     if (setAngle){
-        getStateData().drawAngle = angle;
+        getTickData().drawAngle = angle;
     }
-    getStateData().drawAngleData.angle = getStateData().drawAngle;
+    getStateData().drawAngleData.angle = getTickData().drawAngle;
     getStateData().drawAngleData.enabled = true;
     getStateData().drawAngleData.scaleX = scaleX;
     getStateData().drawAngleData.scaleY = scaleY;
@@ -4262,30 +4213,30 @@ void Character::setHitByOverride(int slot, int time, bool standing, bool crouchi
 }
         
 void Character::setDefenseMultiplier(double defense){
-    getStateData().defenseMultiplier = defense;
+    getTickData().defenseMultiplier = defense;
 }
 
 void Character::setAttackMultiplier(double attack){
-    getStateData().attackMultiplier = attack;
+    getTickData().attackMultiplier = attack;
 }
         
 void Character::doFreeze(){
-    getStateData().frozen = true;
+    getTickData().frozen = true;
 }
         
 void Character::moveX(double x, bool force){
-    if (force || !getStateData().frozen){
+    if (force || !getTickData().frozen){
 	if (getFacing() == FacingLeft){
-            getStateData().virtualx -= x;
+            getTickData().virtualx -= x;
 	} else {
-            getStateData().virtualx += x;
+            getTickData().virtualx += x;
 	}
     }
 }
 
 void Character::moveY(double y, bool force){
-    if (force || !getStateData().frozen){
-        getStateData().virtualy += y;
+    if (force || !getTickData().frozen){
+        getTickData().virtualy += y;
     }
 }
         
@@ -4303,23 +4254,23 @@ Point Character::getDrawOffset() const {
 
 void Character::setMaxHealth(double health){
     getLocalData().max_health = health;
-    if (this->getStateData().health > getLocalData().max_health){
-        this->getStateData().health = getLocalData().max_health;
+    if (this->getTickData().health > getLocalData().max_health){
+        this->getTickData().health = getLocalData().max_health;
     }
 }
 
 void Character::setHealth(double health){
-    this->getStateData().health = health;
-    if (this->getStateData().health < 0){
-        this->getStateData().health = 0;
+    this->getTickData().health = health;
+    if (this->getTickData().health < 0){
+        this->getTickData().health = 0;
     }
-    if (this->getStateData().health > getMaxHealth()){
-        this->getStateData().health = getMaxHealth();
+    if (this->getTickData().health > getMaxHealth()){
+        this->getTickData().health = getMaxHealth();
     }
 }
 
 void Character::setSpritePriority(int priority){
-    getStateData().spritePriority = priority;
+    getTickData().spritePriority = priority;
 }
         
 int Character::getSpritePriority() const {
@@ -4327,7 +4278,7 @@ int Character::getSpritePriority() const {
     if (getHitState().shakeTime > 0){
         return getHitState().spritePriority;
     } else {
-        return getStateData().spritePriority;
+        return getTickData().spritePriority;
     }
 }
 
@@ -4366,15 +4317,15 @@ double Character::getGroundFriction() const {
 }
         
 void Character::setReversalActive(){
-    getStateData().reversalActive = true;
+    getTickData().reversalActive = true;
 }
 
 void Character::setReversalInactive(){
-    getStateData().reversalActive = false;
+    getTickData().reversalActive = false;
 }
         
 bool Character::isReversalActive(){
-    return getStateData().reversalActive;
+    return getTickData().reversalActive;
 }
 
 bool Character::canReverse(Character * enemy){
@@ -4427,11 +4378,11 @@ double Character::forwardPoint(double x) const {
 }
         
 void Character::disablePushCheck(){
-    getStateData().pushPlayer = 1;
+    getTickData().pushPlayer = 1;
 }
 
 bool Character::isPushable(){
-    return getStateData().pushPlayer == 0;
+    return getTickData().pushPlayer == 0;
 }
         
 void Character::setHitOverride(int slot, const HitAttributes & attribute, int state, int time, bool air){
@@ -4446,8 +4397,8 @@ void Character::setDrawOffset(double x, double y){
 }
 
 PaintownUtil::ReferenceCount<State> Character::getSelfState(int id) const {
-    if (getLocalData().states.find(id) != getLocalData().states.end()){
-        return getLocalData().states.find(id)->second;
+    if (getDefinition().states.find(id) != getDefinition().states.end()){
+        return getDefinition().states.find(id)->second;
     }
     return PaintownUtil::ReferenceCount<State>(NULL);
 }
@@ -4465,7 +4416,7 @@ PaintownUtil::ReferenceCount<State> Character::getState(int id, Stage & stage) c
 }
 
 void Character::setState(int id, PaintownUtil::ReferenceCount<State> what){
-    getLocalData().states[id] = what;
+    editDefinition().states[id] = what;
 }
         
 void Character::setPaletteEffects(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color){
@@ -4486,7 +4437,7 @@ void Character::setPaletteEffects(int time, int addRed, int addGreen, int addBlu
 }
         
 unsigned int Character::getWasHitCount() const {
-    return getStateData().wasHitCounter;
+    return getTickData().wasHitCounter;
 }
         
 void Character::roundEnd(Stage & stage){
@@ -4658,6 +4609,10 @@ int Character::getAirFront() const {
     return getLocalData().airfront;
 }
 
+void Character::setTickData(const TickData & data){
+    *tickData = data;
+}
+
 void Character::setStateData(const StateData & data){
     this->stateData = data;
     const std::map<std::string, std::string > & serializedCommands = data.commandState;;
@@ -4681,7 +4636,8 @@ void Character::setStateData(const StateData & data){
     }
 }
 
-Character::LocalData::LocalData(){
+Character::LocalData::LocalData():
+definition(new Definition()){
 #define Z(x) x = 0
     /* TODO: add all the variables here */
     Z(projdoscale);
@@ -4728,22 +4684,9 @@ Character::LocalData::LocalData(const Character::LocalData & copy){
     // C(spritePriority);
     C(location);
     C(baseDir);
-    C(name);
-    C(displayName);
-    C(versionDate);
-    C(mugenVersion);
-    C(author);
-    C(palDefaults);
+    C(definition);
     C(currentPalette);
-    C(cmdFile);
     C(ownPalette);
-    C(constantsFile);
-    C(sffFile);
-    C(airFile);
-    C(sndFile);
-    C(palFile);
-    C(introFile);
-    C(endingFile);
     C(attack);
     C(defense);
     C(fallDefenseUp);
@@ -4792,7 +4735,6 @@ Character::LocalData::LocalData(const Character::LocalData & copy){
     C(yaccel);
     C(crouchFriction);
     C(crouchFrictionThreshold);
-    C(constants);
     /*
     C(currentState);
     C(previousState);
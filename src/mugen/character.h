@@ -150,7 +150,51 @@ struct AfterImage{
     RGBx add;
     RGBx multiply;
 
-    std::deque<Image> frames;
+    /* The recorded frames, newest first. The images are kept in a ring so
+     * recording a frame only copies it into a slot once the ring has grown
+     * to the afterimage length.
+     */
+    class Frames{
+    public:
+        Frames();
+
+        /* forget all frames and keep at most 'limit' of them from now on,
+         * a negative limit keeps everything
+         */
+        void reset(int limit);
+        void push(const Image & image);
+
+        inline unsigned int size() const {
+            return count;
+        }
+
+        inline const Image & operator[](unsigned int index) const {
+            return images[(start + index) % images.size()];
+        }
+
+    protected:
+        std::vector<Image> images;
+        unsigned int start;
+        unsigned int count;
+        int limit;
+    };
+
+    Frames frames;
+
+    /* The palette effects reduced to a table per color channel, one for each
+     * afterimage step since the add/multiply part depends on how old the
+     * frame is. Built when a step is first needed and thrown away when the
+     * parameters change.
+     */
+    struct Lookup{
+        unsigned char red[256];
+        unsigned char green[256];
+        unsigned char blue[256];
+    };
+
+    std::vector<Lookup> lookups;
+
+    const Lookup & getLookup(unsigned int step);
 };
 
 struct PaletteEffects{
@@ -349,7 +393,7 @@ public:
         virtual void loadGraphics(int palette);
 	
 	virtual inline const std::string getName() const {
-            return getLocalData().name;
+            return getDefinition().name;
         }
 
         virtual const Filesystem::AbsolutePath & getLocation() const {
@@ -357,11 +401,11 @@ public:
         }
 
         virtual inline const std::string & getAuthor() const {
-            return getLocalData().author;
+            return getDefinition().author;
         }
 	
 	virtual inline const std::string getDisplayName() const {
-            return getLocalData().displayName;
+            return getDefinition().displayName;
         }
 	
 	virtual inline unsigned int getCurrentPalette() const {
@@ -369,11 +413,11 @@ public:
         }
 
         virtual inline const std::map<int, PaintownUtil::ReferenceCount<Animation> > & getAnimations() const {
-            return getLocalData().animations;
+            return getDefinition().animations;
         }
 
         virtual const std::map<int, PaintownUtil::ReferenceCount<State> > & getStates() const {
-            return getLocalData().states;
+            return getDefinition().states;
         }
 
         virtual PaintownUtil::ReferenceCount<Animation> getAnimation(int id) const;
@@ -386,13 +430,35 @@ public:
         */
 	
 	virtual inline const Mugen::SoundMap & getSounds() const {
-            return getLocalData().sounds;
+            return getDefinition().sounds;
         }
 
 	virtual inline const Mugen::SoundMap * getCommonSounds() const {
             return getLocalData().commonSounds;
         }
 
+        /* Approximate memory held by the character, shown by the console */
+        struct MemoryUsage{
+            MemoryUsage():
+                ast(0),
+                states(0),
+                controllers(0),
+                sprites(0),
+                sounds(0){
+                }
+
+            /* parse trees of the character's files still in the parse cache */
+            unsigned long ast;
+            unsigned int states;
+            unsigned int controllers;
+            /* pixel data of the loaded sprites */
+            unsigned long sprites;
+            /* size of the snd file */
+            unsigned long sounds;
+        };
+
+        virtual MemoryUsage getMemoryUsage() const;
+
         virtual inline PaintownUtil::ReferenceCount<Mugen::Sprite> getSprite(int group, int image){
             return getLocalData().sprites[group][image];
         }
@@ -464,7 +530,7 @@ public:
     virtual int getAnimation() const;
     
     virtual inline int getCurrentState() const {
-        return getStateData().currentState;
+        return getTickData().currentState;
     }
 
     virtual std::map<int, std::map<uint32_t, int> > getStatePersistent() const;
@@ -488,19 +554,19 @@ public:
         }
 
         virtual inline void setXVelocity(double x){
-            getStateData().velocity_x = x;
+            getTickData().velocity_x = x;
         }
 
         virtual inline double getXVelocity() const {
-            return getStateData().velocity_x;
+            return getTickData().velocity_x;
         }
         
         virtual inline void setYVelocity(double y){
-            getStateData().velocity_y = y;
+            getTickData().velocity_y = y;
         }
         
         virtual inline double getYVelocity() const {
-            return getStateData().velocity_y;
+            return getTickData().velocity_y;
         }
 
         virtual inline double getWalkBackX() const {
@@ -572,21 +638,21 @@ public:
         }
         
         virtual inline double getPower() const {
-            return getStateData().power;
+            return getTickData().power;
         }
 
         virtual inline void setPower(double p){
-            getStateData().power = p;
+            getTickData().power = p;
         }
 
         virtual void addPower(double d);
 
         virtual inline bool hasControl() const {
-            return getStateData().has_control;
+            return getTickData().has_control;
         }
 
         virtual inline void setControl(bool b){
-            getStateData().has_control = b;
+            getTickData().has_control = b;
         }
 
         virtual inline void setJumpBack(double x){
@@ -656,7 +722,7 @@ public:
         virtual int getStateTime() const;
 
         virtual inline int getPreviousState() const {
-            return getStateData().previousState;
+            return getTickData().previousState;
         }
 
         virtual inline const std::string & getMoveType() const {
@@ -707,11 +773,11 @@ public:
         virtual RuntimeValue getSystemVariable(int index) const;
 
         virtual inline Physics::Type getCurrentPhysics() const {
-            return getStateData().currentPhysics;
+            return getTickData().currentPhysics;
         }
 
         virtual void setCurrentPhysics(Physics::Type p){
-            getStateData().currentPhysics = p;
+            getTickData().currentPhysics = p;
         }
 
         virtual void setGravity(double n){
@@ -931,11 +997,11 @@ public:
         virtual void resetJugglePoints();
 
         virtual inline void setCurrentJuggle(int j){
-            getStateData().currentJuggle = j;
+            getTickData().currentJuggle = j;
         }
 
         virtual inline int getCurrentJuggle() const {
-            return getStateData().currentJuggle;
+            return getTickData().currentJuggle;
         }
 
         virtual inline void setCommonSounds(const Mugen::SoundMap * sounds){
@@ -964,7 +1030,7 @@ public:
         virtual int getCurrentCombo() const;
 
         virtual inline int getHitCount() const {
-            return getStateData().hitCount;
+            return getTickData().hitCount;
         }
 
         virtual inline const std::vector<WinGame> & getWins() const {
@@ -1169,7 +1235,7 @@ protected:
     void initialize();
 
     virtual inline void setCurrentState(int state){
-        this->getStateData().currentState = state;
+        this->getTickData().currentState = state;
     }
 
     void checkStateControllers();
@@ -1179,6 +1245,10 @@ protected:
     virtual void loadCmdFile(const Filesystem::RelativePath & path);
     virtual void loadCnsFile(const Filesystem::RelativePath & path);
     virtual void loadStateFile(const Filesystem::AbsolutePath & base, const std::string & path);
+    /* remember a file parsed during load() */
+    void addParsedFile(const Filesystem::AbsolutePath & path);
+    /* drop the parse trees once everything is compiled, see ParseCache */
+    void releaseParsedFiles();
 
     virtual void addCommand(Command2 * command);
 
@@ -1211,7 +1281,7 @@ protected:
 public:
     virtual void setAfterImage(int time, int length, int timegap, int framegap, TransType effects, int paletteColor, bool invertColor, const AfterImage::RGBx & bright, const AfterImage::RGBx & contrast, const AfterImage::RGBx & postBright, const AfterImage::RGBx & add, const AfterImage::RGBx & multiply);
 
-    void drawAfterImage(const AfterImage & afterImage, const AfterImage::Image & frame, int index, int x, int y, const Graphics::Bitmap & work);
+    void drawAfterImage(AfterImage & afterImage, const AfterImage::Image & frame, int index, int x, int y, const Graphics::Bitmap & work);
     void processAfterImages();
 
     virtual void setPaletteEffects(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color);
@@ -1228,25 +1298,13 @@ protected:
     unsigned int stateControllerId;
     unsigned int nextStateControllerId();
 
-    /* Data that doesn't have to be sent to remote instances */
-    struct LocalData{
-        LocalData();
-        LocalData(const LocalData & copy);
-
-        CharacterId id;
-
-        /* Location is the directory passed in ctor
-           This is where the def is loaded and all the relevant files
-           are loaded from
-           */
-        Filesystem::AbsolutePath location;
-
-        Filesystem::AbsolutePath baseDir;
-        
-        std::map<int, PaintownUtil::ReferenceCount<State> > states;
-        AfterImage afterImage;
-        PaletteEffects paletteEffects;
-
+    /* Everything loaded from the character's files that stays the same for
+     * the whole match. Helpers share their owner's definition instead of
+     * copying the maps, so spawning a helper only copies the per instance
+     * data. Use editDefinition() to change it, which makes a private copy
+     * first if the definition is shared.
+     */
+    struct Definition{
         /* These items are taken from character.def file */
 
         /* Base definitions */
@@ -1263,7 +1321,6 @@ protected:
         std::string author;
         // Palette defaults
         std::vector< unsigned int> palDefaults;
-        unsigned int currentPalette;
 
         /* Relevant files */
 
@@ -1292,6 +1349,44 @@ protected:
         std::string introFile;
         std::string endingFile;
 
+        std::map<int, PaintownUtil::ReferenceCount<State> > states;
+
+        /* Animation Lists stored by action number, ie [Begin Action 500] */
+        std::map< int, PaintownUtil::ReferenceCount<Animation> > animations;
+
+        /* Sounds */
+        Mugen::SoundMap sounds;
+
+        /* Commands, Triggers or whatever else we come up with */
+        std::map<std::string, Constant> constants;
+
+        /* every file parsed by load(), used to find the parse trees later */
+        std::vector<Filesystem::AbsolutePath> parsedFiles;
+    };
+
+    /* Data that doesn't have to be sent to remote instances */
+    struct LocalData{
+        LocalData();
+        LocalData(const LocalData & copy);
+
+        CharacterId id;
+
+        /* Location is the directory passed in ctor
+           This is where the def is loaded and all the relevant files
+           are loaded from
+           */
+        Filesystem::AbsolutePath location;
+
+        Filesystem::AbsolutePath baseDir;
+        
+        /* shared with every helper spawned from this character */
+        PaintownUtil::ReferenceCount<Definition> definition;
+
+        unsigned int currentPalette;
+
+        AfterImage afterImage;
+        PaletteEffects paletteEffects;
+
         /* Now on to the nitty gritty */
 
         /* Player Data and constants comes from cns file */
@@ -1417,17 +1512,9 @@ protected:
         // Bitmaps of those sprites
         // std::map< unsigned int, std::map< unsigned int, Graphics::Bitmap * > > bitmaps;
 
-        /* Animation Lists stored by action number, ie [Begin Action 500] */
-        std::map< int, PaintownUtil::ReferenceCount<Animation> > animations;
-
-        /* Sounds */
-        Mugen::SoundMap sounds;
         /* sounds from the stage */
         const Mugen::SoundMap * commonSounds;
 
-        /* Commands, Triggers or whatever else we come up with */
-        std::map<std::string, Constant> constants;
-
         std::vector<Command2 *> commands;
 
         // Debug state
@@ -1506,6 +1593,8 @@ protected:
 
     LocalData localData;
     StateData stateData;
+    /* a slot from the pool in character.cpp */
+    TickData * tickData;
 
 public:
     const StateData & getStateData() const {
@@ -1516,6 +1605,14 @@ public:
         return stateData;
     }
 
+    const TickData & getTickData() const {
+        return *tickData;
+    }
+
+    TickData & getTickData(){
+        return *tickData;
+    }
+
     const LocalData & getLocalData() const {
         return localData;
     }
@@ -1524,7 +1621,18 @@ public:
         return localData;
     }
 
+    const Definition & getDefinition() const {
+        return *localData.definition;
+    }
+
+    Definition & editDefinition();
+
     void setStateData(const StateData & data);
+    void setTickData(const TickData & data);
+
+private:
+    /* the tick data is not shared, copy a character with the constructor */
+    Character & operator=(const Character & copy);
 };
 
 }
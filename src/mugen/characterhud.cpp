@@ -227,6 +227,23 @@ void FightElement::render(const Element::Layer & layer, int x, int y, const Grap
     }
 }
 
+bool FightElement::drawsOn(const Element::Layer & layer) const {
+    switch (type){
+	case IS_ACTION:
+	case IS_SPRITE:
+	case IS_FONT:
+            return layer == getLayer();
+        case IS_SOUND:
+	case IS_NOTSET:
+	default:
+	    return false;
+    }
+}
+
+bool FightElement::isStatic() const {
+    return type != IS_ACTION;
+}
+
 void FightElement::play(){
     switch (type){
 	case IS_ACTION:
@@ -401,13 +418,18 @@ maxHealth(1000),
 currentHealth(1000),
 damage(1000),
 wait(DAMAGE_WAIT_TIME),
-powerLevel(Level0){
+powerLevel(Level0),
+changed(true){
 }
 
 Bar::~Bar(){
 }
 
 void Bar::act(Mugen::Character & character){
+    const int oldMaxHealth = maxHealth;
+    const int oldHealth = currentHealth;
+    const int oldDamage = damage;
+    const PowerState oldPowerLevel = powerLevel;
     switch (type){
         case Health: {
             maxHealth = character.getMaxHealth();
@@ -470,6 +492,18 @@ void Bar::act(Mugen::Character & character){
         case None : break;
         default: break;
     }
+    changed = oldMaxHealth != maxHealth ||
+              oldHealth != currentHealth ||
+              oldDamage != damage ||
+              oldPowerLevel != powerLevel;
+}
+
+bool Bar::drawsOn(const Element::Layer & layer) const {
+    return type != None && (back0.drawsOn(layer) || back1.drawsOn(layer) || middle.drawsOn(layer) || front.drawsOn(layer) || counter.drawsOn(layer));
+}
+
+bool Bar::isStatic() const {
+    return type == None || (back0.isStatic() && back1.isStatic() && middle.isStatic() && front.isStatic() && counter.isStatic());
 }
 
 void Bar::render(Element::Layer layer, const Graphics::Bitmap & bmp){
@@ -512,14 +546,17 @@ void Bar::render(Element::Layer layer, const Graphics::Bitmap & bmp){
     }
 }
 
-Face::Face(){
+Face::Face():
+changed(true){
 }
 
 Face::~Face(){
 }
 
 void Face::act(Character & character){
+    PaintownUtil::ReferenceCount<Mugen::Sprite> old = face.getSprite();
     face.setSprite(character.getSprite(face.getSpriteData().x,face.getSpriteData().y));
+    changed = old != face.getSprite();
 }
 
 void Face::render(const Element::Layer & layer, const Graphics::Bitmap & bmp){
@@ -527,14 +564,25 @@ void Face::render(const Element::Layer & layer, const Graphics::Bitmap & bmp){
     face.render(layer, position.x, position.y, bmp);
 }
 
-Name::Name(){
+bool Face::drawsOn(const Element::Layer & layer) const {
+    return background.drawsOn(layer) || face.drawsOn(layer);
+}
+
+bool Face::isStatic() const {
+    return background.isStatic() && face.isStatic();
+}
+
+Name::Name():
+changed(true){
 }
 
 Name::~Name(){
 }
 
 void Name::act(Mugen::Character & character){
-    font.setText(character.getDisplayName());
+    const std::string name = character.getDisplayName();
+    changed = name != font.getText();
+    font.setText(name);
 }
 
 void Name::render(const Element::Layer & layer, const Graphics::Bitmap & bmp){
@@ -542,6 +590,14 @@ void Name::render(const Element::Layer & layer, const Graphics::Bitmap & bmp){
     font.render(layer, position.x, position.y, bmp);
 }
 
+bool Name::drawsOn(const Element::Layer & layer) const {
+    return background.drawsOn(layer) || font.drawsOn(layer);
+}
+
+bool Name::isStatic() const {
+    return background.isStatic() && font.isStatic();
+}
+
 static void getElementProperties(const Ast::AttributeSimple & simple, const std::string & component, const std::string & elementName, FightElement & element, Mugen::SpriteMap & sprites, std::map<int, PaintownUtil::ReferenceCount<Animation> > & animations, std::vector<Mugen::Font *> & fonts){
     std::string compCopy = component;
     if (!compCopy.empty()){
@@ -621,7 +677,8 @@ frameCount(0),
 time(Mugen::Data::getInstance().getTime()),
 ticker(0),
 started(false),
-disabled(false){
+disabled(false),
+changed(true){
 }
 
 GameTime::~GameTime(){
@@ -652,6 +709,7 @@ void GameTime::act(){
     } else {
 	str << time;
     }
+    changed = str.str() != timer.getText();
     timer.setText(str.str());
 }
 
@@ -660,6 +718,14 @@ void GameTime::render(const Element::Layer & layer, const Graphics::Bitmap & bmp
     timer.render(layer, position.x, position.y, bmp);
 }
 
+bool GameTime::drawsOn(const Element::Layer & layer) const {
+    return background.drawsOn(layer) || timer.drawsOn(layer);
+}
+
+bool GameTime::isStatic() const {
+    return background.isStatic() && timer.isStatic();
+}
+
 void GameTime::reset(){
     // Resets the time
     time = Mugen::Data::getInstance().getTime();
@@ -2141,6 +2207,7 @@ GameInfo::GameInfo(const Filesystem::AbsolutePath & fightFile){
         
 void GameInfo::setGameTime(int time){
     timer.setTime(time);
+    invalidate();
 }
 
 GameInfo::~GameInfo(){
@@ -2201,9 +2268,17 @@ void GameInfo::act(Mugen::Stage & stage, Mugen::Character & player1, Mugen::Char
         roundControl.setState(Round::RoundOver, stage, player1, player2);
         timer.stop();
     }
+
+    if (player1LifeBar.hasChanged() || player2LifeBar.hasChanged() ||
+        player1PowerBar.hasChanged() || player2PowerBar.hasChanged() ||
+        player1Face.hasChanged() || player2Face.hasChanged() ||
+        player1Name.hasChanged() || player2Name.hasChanged() ||
+        timer.hasChanged()){
+        invalidate();
+    }
 }
 
-void GameInfo::render(const Element::Layer & layer, const Graphics::Bitmap &bmp){
+void GameInfo::renderRetained(const Element::Layer & layer, const Graphics::Bitmap & bmp){
     player1LifeBar.render(layer,bmp);
 
     // Program received signal SIGFPE, Arithmetic exception.
@@ -2219,6 +2294,56 @@ void GameInfo::render(const Element::Layer & layer, const Graphics::Bitmap &bmp)
     player2Name.render(layer, bmp);
 
     timer.render(layer, bmp);
+}
+
+bool GameInfo::retainedDrawsOn(const Element::Layer & layer) const {
+    return player1LifeBar.drawsOn(layer) || player2LifeBar.drawsOn(layer) ||
+           player1PowerBar.drawsOn(layer) || player2PowerBar.drawsOn(layer) ||
+           player1Face.drawsOn(layer) || player2Face.drawsOn(layer) ||
+           player1Name.drawsOn(layer) || player2Name.drawsOn(layer) ||
+           timer.drawsOn(layer);
+}
+
+bool GameInfo::retainedIsStatic() const {
+    return player1LifeBar.isStatic() && player2LifeBar.isStatic() &&
+           player1PowerBar.isStatic() && player2PowerBar.isStatic() &&
+           player1Face.isStatic() && player2Face.isStatic() &&
+           player1Name.isStatic() && player2Name.isStatic() &&
+           timer.isStatic();
+}
+
+void GameInfo::invalidate(){
+    for (unsigned int i = 0; i < sizeof(retained) / sizeof(RetainedLayer); i++){
+        retained[i].dirty = true;
+    }
+}
+
+void GameInfo::render(const Element::Layer & layer, const Graphics::Bitmap &bmp){
+    /* Animations would have to be redrawn every tick and might be
+     * translucent, which can't be drawn ahead of time onto an empty bitmap.
+     */
+    if (!retainedIsStatic()){
+        renderRetained(layer, bmp);
+    } else if (retainedDrawsOn(layer)){
+        RetainedLayer & cache = retained[layer];
+        if (cache.bitmap == NULL ||
+            cache.bitmap->getWidth() != bmp.getWidth() ||
+            cache.bitmap->getHeight() != bmp.getHeight()){
+            cache.bitmap = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(bmp.getWidth(), bmp.getHeight()));
+            cache.dirty = true;
+        }
+
+        if (cache.dirty){
+            cache.bitmap->clearToMask();
+            renderRetained(layer, *cache.bitmap);
+            /* most of the layer is empty, so let the draw skip it */
+            cache.bitmap->encodeMask();
+            cache.dirty = false;
+        }
+
+        cache.bitmap->draw(0, 0, bmp);
+    }
+
     combo.render(layer, bmp);
     roundControl.render(layer, bmp);
     winIconDisplay.render(layer, bmp);
@@ -2227,6 +2352,7 @@ void GameInfo::render(const Element::Layer & layer, const Graphics::Bitmap &bmp)
 void GameInfo::reset(Mugen::Stage & stage, Mugen::Character & player1, Mugen::Character & player2){
     timer.reset();
     roundControl.reset(stage, player1, player2);
+    invalidate();
 }
 
 void GameInfo::parseAnimations(const AstRef & parsed){
@@ -2266,4 +2392,5 @@ void GameInfo::deserialize(const Token * token){
     const Token * roundToken = NULL;
     view >> roundToken;
     roundControl.deserialize(roundToken);
+    invalidate();
 }
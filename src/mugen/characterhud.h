@@ -124,6 +124,20 @@ class FightElement: public Element {
             text = t; 
         }
 
+        virtual inline const std::string & getText() const {
+            return text;
+        }
+
+        virtual inline PaintownUtil::ReferenceCount<Mugen::Sprite> getSprite() const {
+            return sprite;
+        }
+
+        //! True if rendering this element on the layer draws something
+        virtual bool drawsOn(const Element::Layer & layer) const;
+
+        //! True if the element looks the same every tick unless its inputs change
+        virtual bool isStatic() const;
+
         virtual Token * serialize();
         virtual void deserialize(const Token * token);
 	
@@ -156,6 +170,13 @@ class Bar{
 	
 	virtual void act(Character &);
 	virtual void render(Element::Layer layer, const Graphics::Bitmap &);
+        virtual bool drawsOn(const Element::Layer & layer) const;
+        virtual bool isStatic() const;
+
+        //! True if the last act() changed what the bar looks like
+        virtual inline bool hasChanged() const {
+            return changed;
+        }
 
         enum Type{
             None,
@@ -263,6 +284,8 @@ class Bar{
 	
 	//! Power Level
 	PowerState powerLevel;
+
+        bool changed;
 };
 
 class Face{
@@ -272,6 +295,11 @@ class Face{
 	
 	virtual void act(Character &);
 	virtual void render(const Element::Layer & layer, const Graphics::Bitmap & bmp);
+        virtual bool drawsOn(const Element::Layer & layer) const;
+        virtual bool isStatic() const;
+        virtual inline bool hasChanged() const {
+            return changed;
+        }
 	virtual inline void setPosition(int x, int y){
             position.x = x;
             position.y = y;
@@ -292,6 +320,7 @@ class Face{
 	Mugen::Point spacing;
 	FightElement background;
 	FightElement face;
+        bool changed;
 };
 
 class Name{
@@ -301,6 +330,11 @@ class Name{
 	
 	virtual void act(Mugen::Character & character);
 	virtual void render(const Element::Layer &, const Graphics::Bitmap &);
+        virtual bool drawsOn(const Element::Layer & layer) const;
+        virtual bool isStatic() const;
+        virtual inline bool hasChanged() const {
+            return changed;
+        }
 	virtual void setPosition(int x, int y){
             this->position.x = x;
             this->position.y = y;
@@ -316,6 +350,7 @@ class Name{
 	Mugen::Point position;
 	FightElement background;
 	FightElement font;
+        bool changed;
 };
 
 class GameTime{
@@ -324,6 +359,11 @@ class GameTime{
 	virtual ~GameTime();
 	virtual void act();
 	virtual void render(const Element::Layer &, const Graphics::Bitmap &);
+        virtual bool drawsOn(const Element::Layer & layer) const;
+        virtual bool isStatic() const;
+        virtual inline bool hasChanged() const {
+            return changed;
+        }
 	virtual void start();
 	virtual void stop();
 	virtual void reset();
@@ -370,6 +410,7 @@ class GameTime{
 	int ticker;
 	bool started;
         bool disabled;
+        bool changed;
 };
 
 class Combo{
@@ -840,6 +881,30 @@ class GameInfo{
     private:
         
         void parseAnimations(const PaintownUtil::ReferenceCount<Ast::AstParse> & parsed);
+
+        //! Draw the bars, faces, names and timer
+        void renderRetained(const Element::Layer & layer, const Graphics::Bitmap & work);
+        bool retainedDrawsOn(const Element::Layer & layer) const;
+        bool retainedIsStatic() const;
+        void invalidate();
+
+        /* The bars, faces, names and timer only change when the life, power,
+         * names or time do. They are drawn into a bitmap per layer that is
+         * copied to the screen every frame and only redrawn after one of them
+         * changed. The combo counter and the round announcements move every
+         * tick so they are always drawn directly, and so are the win icons
+         * because they go on top of those.
+         */
+        struct RetainedLayer{
+            RetainedLayer():
+                dirty(true){
+                }
+
+            PaintownUtil::ReferenceCount<Graphics::Bitmap> bitmap;
+            bool dirty;
+        };
+
+        RetainedLayer retained[3];
 	
 	//! Player Data
 	Bar player1LifeBar;
@@ -1285,7 +1285,7 @@ public:
             public:
                 RuntimeValue evaluate(const Environment & environment) const {
                     /* Returns a random number between 0 and 999, inclusive. */
-                    return RuntimeValue((int) Mugen::random(1000));
+                    return RuntimeValue((int) Mugen::random(environment.getStage().getRandom(), 1000));
                 }
 
                 Value * copy() const {
@@ -1726,7 +1726,7 @@ public:
             class NumExplod: public Value {
             public:
                 RuntimeValue evaluate(const Environment & environment) const {
-                    return RuntimeValue((int) environment.getStage().findExplode(0, (&environment.getCharacter())).size());
+                    return RuntimeValue((int) environment.getStage().countExplods(0, &environment.getCharacter()));
                 }
 
                 Value * copy() const {
@@ -4393,7 +4393,7 @@ public:
                 }
 
                 RuntimeValue evaluate(const Environment & environment) const {
-                    return RuntimeValue((int) environment.getStage().findExplode((int) id->evaluate(environment).toNumber(), &environment.getCharacter()).size());
+                    return RuntimeValue((int) environment.getStage().countExplods((int) id->evaluate(environment).toNumber(), &environment.getCharacter()));
                 }
             };
 
@@ -7,6 +7,8 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
+#include <algorithm>
 #include <sstream>
 #include <exception>
 
@@ -890,11 +892,33 @@ const std::set<ConstraintCompare> & Constraint::getDepends(){
 
 Command2::Command2(const std::string & name, Ast::KeyList * keys, int maxTime, int bufferTime):
 constraints(makeConstraints(keys)),
+words(0),
 name(name),
 maxTime(maxTime),
 bufferTime(bufferTime),
 useBufferTime(0),
 emitted(false){
+    compileDependencies();
+}
+
+void Command2::compileDependencies(){
+    words = (constraints.size() + 31) / 32;
+    dependencyBits.assign(constraints.size() * words, 0);
+    satisfiedBits.assign(words, 0);
+
+    std::map<uint32_t, unsigned int> position;
+    for (unsigned int index = 0; index < constraints.size(); index++){
+        position[constraints[index]->getId()] = index;
+    }
+
+    for (unsigned int index = 0; index < constraints.size(); index++){
+        uint32_t * bits = &dependencyBits[index * words];
+        const set<ConstraintCompare> & depends = constraints[index]->getDepends();
+        for (set<ConstraintCompare>::const_iterator it = depends.begin(); it != depends.end(); it++){
+            unsigned int depend = position[it->constraint->getId()];
+            bits[depend / 32] |= 1u << (depend % 32);
+        }
+    }
 }
     
 const std::string & Command2::getName() const {
@@ -959,14 +983,17 @@ bool Command2::handle(const Mugen::Input & input, int ticks){
     }
 
     bool emit = false;
-    std::set<ConstraintRef> satisfied;
-    for (vector<ConstraintRef>::iterator it = constraints.begin(); it != constraints.end(); it++){
+    unsigned int satisfied = 0;
+    std::fill(satisfiedBits.begin(), satisfiedBits.end(), 0);
+    /* Constraints are in topological order so every dependency has been
+     * looked at by the time a constraint is.
+     */
+    for (unsigned int index = 0; index < constraints.size(); index++){
         bool all = true;
-        ConstraintRef constraint = *it;
-        const std::set<ConstraintCompare> & depends = constraint->getDepends();
-        for (std::set<ConstraintCompare>::const_iterator it2 = depends.begin(); it2 != depends.end(); it2++){
+        const uint32_t * depends = &dependencyBits[index * words];
+        for (unsigned int word = 0; word < words; word++){
             /* If its not in the satisified set then not all dependencies can be satisifed */
-            if (satisfied.find(it2->constraint) == satisfied.end()){
+            if ((satisfiedBits[word] & depends[word]) != depends[word]){
                 all = false;
                 break;
             }
@@ -974,8 +1001,10 @@ bool Command2::handle(const Mugen::Input & input, int ticks){
 
         /* If `all' is still true then all dependencies have been satisfied and we can continue */
         if (all){
+            Constraint * constraint = constraints[index].raw();
             if (constraint->satisfy(input, ticks)){
-                satisfied.insert(constraint);
+                satisfiedBits[index / 32] |= 1u << (index % 32);
+                satisfied += 1;
                 if (constraint->isEmit()){
                     emit = true;
                 }
@@ -994,7 +1023,7 @@ bool Command2::handle(const Mugen::Input & input, int ticks){
     }
 
     /* Reset the constraints if they were all satisfied. */
-    if (satisfied.size() == constraints.size()){
+    if (satisfied == constraints.size()){
         resetConstraints();
     }
 
@@ -1003,7 +1032,7 @@ bool Command2::handle(const Mugen::Input & input, int ticks){
     Global::debug(0) << "Tick: " << ticks << " Input " << debugInput(input) << std::endl;
     for (vector<ConstraintRef>::iterator it = constraints.begin(); it != constraints.end(); it++){
         ConstraintRef constraint = *it;
-        Global::debug(0) << " Constraint " << constraint->getTime() << " " << constraint->toString() << " satisfied " << (satisfied.find(constraint) != satisfied.end()) << std::endl;
+        Global::debug(0) << " Constraint " << constraint->getTime() << " " << constraint->toString() << std::endl;
     }
     Global::debug(0) << std::endl;
     */
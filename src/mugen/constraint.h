@@ -136,8 +136,19 @@ public:
 protected:
     void resetConstraints();
     int activeTicks(int ticks);
+    void compileDependencies();
 
     std::vector<PaintownUtil::ReferenceCount<Constraint> > constraints;
+
+    /* The dependency sets turned into bitmasks over the positions in
+     * `constraints', `words' 32 bit words per constraint, so handle() can
+     * check them without touching a std::set. `satisfiedBits' is scratch
+     * space for handle(), sized once here.
+     */
+    unsigned int words;
+    std::vector<uint32_t> dependencyBits;
+    std::vector<uint32_t> satisfiedBits;
+
     std::string name;
     int maxTime;
     int bufferTime;
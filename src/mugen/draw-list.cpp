@@ -0,0 +1,90 @@
+#include "draw-list.h"
+
+namespace Mugen{
+
+DrawList::DrawList(){
+}
+
+void DrawList::clear(){
+    items.clear();
+}
+
+void DrawList::add(int priority, Character * character){
+    Item item;
+    item.priority = priority;
+    item.type = DrawCharacter;
+    item.character = character;
+    items.push_back(item);
+}
+
+void DrawList::add(int priority, Effect * effect){
+    Item item;
+    item.priority = priority;
+    item.type = DrawEffect;
+    item.effect = effect;
+    items.push_back(item);
+}
+
+void DrawList::add(int priority, Projectile * projectile){
+    Item item;
+    item.priority = priority;
+    item.type = DrawProjectile;
+    item.projectile = projectile;
+    items.push_back(item);
+}
+
+/* Distance from the lowest priority in the list. Keeps the order of the
+ * priorities and, unlike flipping the sign bit, gives small keys to small
+ * priorities on both sides of 0.
+ */
+static inline unsigned int sortKey(int priority, int lowest){
+    return (unsigned int) priority - (unsigned int) lowest;
+}
+
+void DrawList::sort(){
+    if (items.size() < 2){
+        return;
+    }
+
+    int lowest = items[0].priority;
+    int highest = items[0].priority;
+    for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); it++){
+        if (it->priority < lowest){
+            lowest = it->priority;
+        }
+        if (it->priority > highest){
+            highest = it->priority;
+        }
+    }
+    unsigned int range = sortKey(highest, lowest);
+
+    sorted.resize(items.size());
+
+    /* Least significant byte first. Each pass is a counting sort so it is
+     * stable, which keeps items of equal priority in the order they were
+     * added. Only the bytes the largest key uses are sorted on, so when the
+     * priorities span less than 256 (normal sprite priorities are -5 to 5 or
+     * so) there is one pass.
+     */
+    for (unsigned int shift = 0; shift < 32 && (range >> shift) != 0; shift += 8){
+        unsigned int counts[256] = {0};
+        for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); it++){
+            counts[(sortKey(it->priority, lowest) >> shift) & 0xff] += 1;
+        }
+
+        unsigned int position = 0;
+        for (unsigned int i = 0; i < 256; i++){
+            unsigned int count = counts[i];
+            counts[i] = position;
+            position += count;
+        }
+
+        for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); it++){
+            sorted[counts[(sortKey(it->priority, lowest) >> shift) & 0xff]++] = *it;
+        }
+
+        items.swap(sorted);
+    }
+}
+
+}
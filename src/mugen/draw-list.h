@@ -0,0 +1,62 @@
+#ifndef _paintown_mugen_draw_list_h
+#define _paintown_mugen_draw_list_h
+
+#include <vector>
+
+namespace Mugen{
+
+class Character;
+class Effect;
+class Projectile;
+
+/* Everything the stage draws between the background and the foreground,
+ * ordered by sprite priority. Things with the same priority are drawn in the
+ * order they were added. The stage keeps one of these and refills it every
+ * frame so the vectors are only allocated once.
+ */
+class DrawList{
+public:
+    enum Type{
+        DrawCharacter,
+        DrawEffect,
+        DrawProjectile
+    };
+
+    struct Item{
+        int priority;
+        Type type;
+        union{
+            Character * character;
+            Effect * effect;
+            Projectile * projectile;
+        };
+    };
+
+    DrawList();
+
+    void clear();
+
+    void add(int priority, Character * character);
+    void add(int priority, Effect * effect);
+    void add(int priority, Projectile * projectile);
+
+    /* Stable radix sort on the priority, so linear in the number of items */
+    void sort();
+
+    inline unsigned int size() const {
+        return items.size();
+    }
+
+    inline const Item & operator[](unsigned int index) const {
+        return items[index];
+    }
+
+protected:
+    std::vector<Item> items;
+    /* scratch space for the sort */
+    std::vector<Item> sorted;
+};
+
+}
+
+#endif
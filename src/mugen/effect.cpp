@@ -45,6 +45,22 @@ bool Effect::isDead(){
 Effect::~Effect(){
 }
 
+void * Effect::operator new(size_t size){
+    return ObjectPool::allocateHeap(size);
+}
+
+void * Effect::operator new(size_t size, ObjectPool & pool){
+    return pool.allocate(size);
+}
+
+void Effect::operator delete(void * memory){
+    ObjectPool::release(memory);
+}
+
+void Effect::operator delete(void * memory, ObjectPool & pool){
+    ObjectPool::release(memory);
+}
+
 /* FIXME: can sparks be scaled? */
 Spark::Spark(int x, int y, int spritePriority, PaintownUtil::ReferenceCount<Animation> animation):
 Effect(NULL, animation, -1, x, y, 1, 1, spritePriority){
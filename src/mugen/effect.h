@@ -3,6 +3,7 @@
 
 #include "util/pointer.h"
 #include "common.h"
+#include "pool.h"
 
 namespace Graphics{
     class Bitmap;
@@ -16,6 +17,14 @@ class Character;
 class Effect{
 public:
     Effect(const Character * owner, ::Util::ReferenceCount<Animation> animation, int id, int x, int y, double scaleX, double scaleY, int spritePriority);
+
+    /* `new (stage.getObjectPool()) Effect(...)' takes the memory from the
+     * stage's pool, a plain `new' uses the heap. `delete' works for both.
+     */
+    static void * operator new(size_t size);
+    static void * operator new(size_t size, ObjectPool & pool);
+    static void operator delete(void * memory);
+    static void operator delete(void * memory, ObjectPool & pool);
     
     virtual void draw(const Graphics::Bitmap & work, int cameraX, int cameraY);
     virtual void logic();
@@ -49,8 +58,18 @@ public:
         return id;
     }
 
+    /* set by the stage when the effect is added */
+    inline void setHandle(const Handle & handle){
+        this->handle = handle;
+    }
+
+    inline const Handle & getHandle() const {
+        return handle;
+    }
+
     virtual ~Effect();
 protected:
+    Handle handle;
     const Character * owner;
     ::Util::ReferenceCount<Animation> animation;
     int id;
@@ -61,7 +61,8 @@ colors(0),
 offsetx(0),
 offsety(0),
 pcx(NULL),
-pcxsize(0){
+pcxsize(0),
+runUses(0){
     if (Mugen::Util::fixCase(file.getExtension()) != "fnt"){
         throw LoadException(__FILE__, __LINE__, "Font files must end with an .fnt extension");
     }
@@ -111,6 +112,7 @@ Font::Font( const Font &copy ){
     this->offsety = copy.offsety;
     this->pcx = copy.pcx;
     this->banks = copy.banks;
+    this->runUses = 0;
 }
 
 Font::~Font(){
@@ -148,12 +150,11 @@ int Font::getSizeY() const{
 }
 
 int Font::textLength( const char * text ) const{
-    std::string str(text);
     int size =0;
-    for (unsigned int i = 0; i < str.size(); ++i){
-        std::map<char, FontLocation>::const_iterator loc = positions.find(str[i]);
-        if (loc != positions.end()){
-            size += loc->second.width + spacingx;
+    for (const char * i = text; *i != 0; ++i){
+        const FontLocation & loc = positions[(unsigned char) *i];
+        if (loc.exists){
+            size += loc.width + spacingx;
         } else {
             // Couldn't find a position for this character assume regular width and skip to the next character
             size += width + spacingx;
@@ -186,30 +187,73 @@ void Font::printf(int x, int y, int bank, const Graphics::Bitmap & work, const s
     vsnprintf(buf, sizeof(buf), str.c_str(), ap);
     va_end(ap);
 
-    const std::string newstr(buf);
-            
     const PaintownUtil::ReferenceCount<Graphics::Bitmap> & font = changeBank(bank);
     if (font == NULL){
         return;
     }
 
+    const GlyphRun & run = findRun(bank, *font, buf);
+    if (run.bitmap != NULL){
+        run.bitmap->draw(x + offsetx, y + offsety, work);
+    }
+}
+
+/* how many printed strings to keep around per font */
+static const unsigned int MAX_RUNS = 32;
+
+const GlyphRun & Font::findRun(int bank, const Graphics::Bitmap & font, const char * text){
+    runUses += 1;
+    for (std::vector<GlyphRun>::iterator it = runs.begin(); it != runs.end(); it++){
+        GlyphRun & run = *it;
+        if (run.bank == bank && run.text == text){
+            run.lastUse = runUses;
+            return run;
+        }
+    }
+
+    /* take a new slot until there are enough, then reuse the one that was
+     * printed the longest time ago
+     */
+    GlyphRun * run = NULL;
+    if (runs.size() < MAX_RUNS){
+        runs.push_back(GlyphRun());
+        run = &runs.back();
+    } else {
+        run = &runs[0];
+        for (std::vector<GlyphRun>::iterator it = runs.begin(); it != runs.end(); it++){
+            if (it->lastUse < run->lastUse){
+                run = &*it;
+            }
+        }
+    }
+
+    run->bank = bank;
+    run->text = text;
+    run->lastUse = runUses;
+    run->bitmap = PaintownUtil::ReferenceCount<Graphics::Bitmap>(NULL);
+
+    const int length = textLength(text);
+    if (length <= 0 || height <= 0){
+        return *run;
+    }
+
+    run->bitmap = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(length, height));
+    run->bitmap->clearToMask();
+
     int workoffsetx = 0;
-    for (unsigned int i = 0; i < newstr.size(); ++i){
-        std::map<char, FontLocation>::const_iterator loc = positions.find(newstr[i]);
-        if (loc != positions.end()){
-            /*
-            Bitmap character = Bitmap::temporaryBitmap(loc->second.width + spacingx, height + spacingy);
-            character.clearToMask();
-            bmp->Blit(loc->second.startx, 0, loc->second.width + spacingx, height + spacingy,0,0, character);
-            */
-            Graphics::Bitmap character(*font, loc->second.startx, 0, loc->second.width, height);
-            character.draw(x + workoffsetx + offsetx, y + offsety, work);
-            workoffsetx += loc->second.width + spacingx;
+    for (const char * i = text; *i != 0; ++i){
+        const FontLocation & loc = positions[(unsigned char) *i];
+        if (loc.exists){
+            Graphics::Bitmap character(font, loc.startx, 0, loc.width, height);
+            character.draw(workoffsetx, 0, *run->bitmap);
+            workoffsetx += loc.width + spacingx;
         } else{
             // Couldn't find a position for this character draw nothing, assume width, and skip to the next character
             workoffsetx += width + spacingx;
         }
     }
+
+    return *run;
 }
 
 void Font::render(int x, int y, int position, int bank, const Graphics::Bitmap & work, const string & str){
@@ -272,8 +316,12 @@ PaintownUtil::ReferenceCount<Graphics::Bitmap> Font::changeBank(int bank){
         return PaintownUtil::ReferenceCount<Graphics::Bitmap>(NULL);
     }
 
+    if (banks.size() <= (unsigned int) bank){
+        banks.resize(bank + 1);
+    }
+
     if (banks[bank] == NULL){
-        banks[bank] = makeBank(bank);
+        banks[bank] = PaintownUtil::ReferenceCount<Graphics::Bitmap>(makeBank(bank));
     }
 
     return banks[bank];
@@ -420,9 +468,10 @@ void Font::load(const Filesystem::AbsolutePath & path){
                     FontLocation loc;
                     loc.startx = startx;
                     loc.width = chrwidth;
+                    loc.exists = true;
                     char code = character[0];
                     Global::debug(3) << "Storing Character: " << code << " | startx: " << loc.startx << " | width: " << loc.width << endl;
-                    positions[code] = loc;
+                    positions[(unsigned char) code] = loc;
                 }
                 delete opt;
                 ++locationx;
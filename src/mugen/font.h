@@ -3,7 +3,7 @@
 
 #include <fstream>
 #include <string>
-#include <map>
+#include <vector>
 #include <stdint.h>
 
 // Extend the font interface already made for paintown
@@ -25,8 +25,31 @@ enum FontType{
 };
 
 struct FontLocation{
+    FontLocation():
+        startx(0),
+        width(0),
+        exists(false){
+        }
+
     int startx;
     int width;
+    /* false if the font has no glyph for this character */
+    bool exists;
+};
+
+/* A string drawn once with one bank of the font. The HUD prints mostly the
+ * same strings every frame so these are kept and blitted in one go.
+ */
+struct GlyphRun{
+    GlyphRun():
+        bank(0),
+        lastUse(0){
+        }
+
+    int bank;
+    std::string text;
+    PaintownUtil::ReferenceCount<Graphics::Bitmap> bitmap;
+    unsigned int lastUse;
 };
 
 class Font{
@@ -62,6 +85,7 @@ public:
 protected:
     unsigned char * findBankPalette(int bank) const;
     Graphics::Bitmap * makeBank(int bank) const;
+    const GlyphRun & findRun(int bank, const Graphics::Bitmap & font, const char * text);
     
 protected:
     // File
@@ -77,12 +101,17 @@ protected:
     int colors;
     int offsetx;
     int offsety;
-    std::map<int, PaintownUtil::ReferenceCount<Graphics::Bitmap> > banks;
+    /* indexed by bank, each one is made the first time it is used */
+    std::vector<PaintownUtil::ReferenceCount<Graphics::Bitmap> > banks;
     unsigned char *pcx;
     unsigned char palette[768];
     uint32_t pcxsize;
-    // mapping positions of font in bitmap
-    std::map< char, FontLocation> positions;
+    // mapping positions of font in bitmap, indexed by the unsigned character
+    FontLocation positions[256];
+
+    /* recently printed strings */
+    std::vector<GlyphRun> runs;
+    unsigned int runUses;
     
     // int currentBank;
     
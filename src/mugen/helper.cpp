@@ -13,11 +13,8 @@ owner(owner->getId()),
 root(root->getId()),
 id(id),
 name(owner->getName() + " " + name + " (helper)"){
+    /* the states, animations and sounds come with the owner's definition */
     getLocalData().behavior = &dummy;
-    getLocalData().states = owner->getStates();
-    getLocalData().animations = owner->getAnimations();
-    getLocalData().sounds = owner->getSounds();
-    getLocalData().commonSounds = owner->getCommonSounds();
 }
 
 Helper::~Helper(){
@@ -0,0 +1,105 @@
+#include "palette-filter.h"
+#include <math.h>
+#include <sstream>
+#include "util/funcs.h"
+#include "util/file-system.h"
+
+namespace Mugen{
+
+/* one channel of the palfx formula, `grey' is how much of the channel is kept
+ * by the color parameter and `wave' is the sin term for the current tick
+ */
+static unsigned char paletteChannel(int value, bool useGrey, double grey, bool invert, int add, int multiply, double wave){
+    if (useGrey){
+        value = (int)(value * grey + 0.5 + 16);
+    }
+
+    if (invert){
+        value = 255 - value;
+    }
+
+    int out = (int)((value + add + wave) * multiply / 256);
+
+    if (out > 255){
+        out = 255;
+    }
+
+    if (out < 0){
+        out = 0;
+    }
+
+    return out;
+}
+
+PaletteFilter::PaletteFilter(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color):
+ChannelFilter(redTable, greenTable, blueTable),
+time(time),
+addRed(addRed),
+addGreen(addGreen),
+addBlue(addBlue),
+multiplyRed(multiplyRed),
+multiplyGreen(multiplyGreen),
+multiplyBlue(multiplyBlue),
+sinRed(sinRed),
+sinGreen(sinGreen),
+sinBlue(sinBlue),
+period(period),
+invert(invert),
+color(color){
+    bool useGrey = color < 255;
+    double greyRed = (1 - 0.299) * color / 255 + 0.299;
+    double greyGreen = (1 - 0.587) * color / 255 + 0.587;
+    double greyBlue = (1 - 0.114) * color / 255 + 0.114;
+
+    double wave = 0;
+    if (period > 0){
+        wave = sin(2 * PaintownUtil::pi * time / period);
+    }
+
+    for (int value = 0; value < 256; value++){
+        redTable[value] = paletteChannel(value, useGrey, greyRed, invert, addRed, multiplyRed, sinRed * wave);
+        greenTable[value] = paletteChannel(value, useGrey, greyGreen, invert, addGreen, multiplyGreen, sinGreen * wave);
+        blueTable[value] = paletteChannel(value, useGrey, greyBlue, invert, addBlue, multiplyBlue, sinBlue * wave);
+    }
+}
+
+PaintownUtil::ReferenceCount<Graphics::Shader> PaletteFilter::create(){
+    PaintownUtil::ReferenceCount<Graphics::Shader> out;
+
+#ifdef USE_ALLEGRO5
+    std::ostringstream vertex;
+    vertex << "#version 110\n";
+    vertex << Graphics::defaultVertexShader();
+    ALLEGRO_SHADER * a5shader = Graphics::create_shader(vertex.str(),
+                                                        Storage::readFile(Storage::instance().find(Filesystem::RelativePath("shaders/mugen-palette-effect.fragment.glsl"))));
+    out = PaintownUtil::ReferenceCount<Graphics::Shader>(new Graphics::Shader(a5shader));
+#endif
+
+    return out;
+}
+
+PaintownUtil::ReferenceCount<Graphics::Shader> PaletteFilter::getShader(){
+    if (shader == NULL){
+        PaintownUtil::ReferenceCount<Graphics::ShaderManager> manager = Graphics::shaderManager.current();
+        shader = manager->getShader("mugen-palfx", create);
+    }
+
+    return shader;
+}
+
+void PaletteFilter::setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & what){
+#ifdef USE_ALLEGRO5
+    Graphics::setShaderBool(shader->getShader(), "invert", invert > 0);
+    Graphics::setShaderInt(shader->getShader(), "time", time);
+    Graphics::setShaderInt(shader->getShader(), "period", period);
+    Graphics::setShaderFloat(shader->getShader(), "color", (float) color / 255.0);
+    Graphics::setShaderVec4(shader->getShader(), "add", (float) addRed / 255.0, (float) addGreen / 255.0, (float) addBlue / 255.0, 0);
+    Graphics::setShaderVec4(shader->getShader(), "multiply", (float) multiplyRed / 256.0, (float) multiplyGreen / 256.0, (float) multiplyBlue / 256.0, 0);
+    Graphics::setShaderVec4(shader->getShader(), "sin_", (float) sinRed / 255.0, (float) sinGreen / 255.0, (float) sinBlue / 255.0, 0);
+#endif
+}
+
+PaletteFilter::~PaletteFilter(){
+}
+
+}
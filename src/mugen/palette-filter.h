@@ -0,0 +1,57 @@
+#ifndef _paintown_mugen_palette_filter_h
+#define _paintown_mugen_palette_filter_h
+
+#include "util/graphics/bitmap.h"
+#include "util/pointer.h"
+
+namespace PaintownUtil = ::Util;
+
+namespace Mugen{
+
+/* The PalFX effect used by characters and the stage. Every channel is changed
+ * on its own so the effect for the current tick is computed once into a table
+ * per channel, and the blitters look pixels up in those tables.
+ */
+class PaletteFilter: public Graphics::Bitmap::ChannelFilter {
+public:
+    PaletteFilter(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color);
+
+    virtual PaintownUtil::ReferenceCount<Graphics::Shader> getShader();
+    virtual void setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & shader);
+
+    virtual ~PaletteFilter();
+
+protected:
+    static PaintownUtil::ReferenceCount<Graphics::Shader> create();
+
+    int time;
+    int addRed;
+    int addGreen;
+    int addBlue;
+    int multiplyRed;
+    int multiplyGreen;
+    int multiplyBlue;
+    int sinRed;
+    int sinGreen;
+    int sinBlue;
+    int period;
+    int invert;
+    int color;
+
+    PaintownUtil::ReferenceCount<Graphics::Shader> shader;
+
+    unsigned char redTable[256];
+    unsigned char greenTable[256];
+    unsigned char blueTable[256];
+
+private:
+    /* the channels point at this object's own tables, so a copy would read
+     * the original's
+     */
+    PaletteFilter(const PaletteFilter & copy);
+    PaletteFilter & operator=(const PaletteFilter & copy);
+};
+
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "util/file-system.h"
 #include "util/system.h"
 #include "util/debug.h"
+#include "util/configuration.h"
 
 using namespace std;
 
@@ -109,6 +110,57 @@ void Parser::destroy(){
     cache.clear();
 }
 
+/* shared by the parsers of a thread's cache so their uses can be compared */
+static PAINTOWN_THREAD_LOCAL unsigned long parseUses = 0;
+
+void Parser::release(const Filesystem::AbsolutePath & path){
+    PaintownUtil::Thread::ScopedLock scoped(lock);
+    cache.erase(path);
+}
+
+unsigned long Parser::size(){
+    PaintownUtil::Thread::ScopedLock scoped(lock);
+    unsigned long total = 0;
+    for (map<const Filesystem::AbsolutePath, Entry>::iterator it = cache.begin(); it != cache.end(); it++){
+        total += it->second.bytes;
+    }
+    return total;
+}
+
+unsigned long Parser::size(const Filesystem::AbsolutePath & path){
+    PaintownUtil::Thread::ScopedLock scoped(lock);
+    map<const Filesystem::AbsolutePath, Entry>::iterator found = cache.find(path);
+    if (found != cache.end()){
+        return found->second.bytes;
+    }
+    return 0;
+}
+
+unsigned long Parser::oldestUse(){
+    PaintownUtil::Thread::ScopedLock scoped(lock);
+    unsigned long oldest = (unsigned long) -1;
+    for (map<const Filesystem::AbsolutePath, Entry>::iterator it = cache.begin(); it != cache.end(); it++){
+        if (it->second.lastUse < oldest){
+            oldest = it->second.lastUse;
+        }
+    }
+    return oldest;
+}
+
+void Parser::releaseOldest(){
+    PaintownUtil::Thread::ScopedLock scoped(lock);
+    map<const Filesystem::AbsolutePath, Entry>::iterator oldest = cache.end();
+    for (map<const Filesystem::AbsolutePath, Entry>::iterator it = cache.begin(); it != cache.end(); it++){
+        if (oldest == cache.end() || it->second.lastUse < oldest->second.lastUse){
+            oldest = it;
+        }
+    }
+    if (oldest != cache.end()){
+        Global::debug(1, "mugen-parse-cache") << "Releasing " << oldest->first.path() << endl;
+        cache.erase(oldest);
+    }
+}
+
 Parser::Parser(){
 }
 
@@ -134,11 +186,15 @@ static list<Ast::Section*> * copy(list<Ast::Section*> * input){
  */
 Util::ReferenceCount<Ast::AstParse> Parser::parse(const Filesystem::AbsolutePath & path){
     PaintownUtil::Thread::ScopedLock scoped(lock);
-    if (cache[path] == NULL){
-        cache[path] = loadFile(path);
+    Entry & entry = cache[path];
+    if (entry.parse == NULL){
+        entry.parse = loadFile(path);
+        entry.bytes = ParseCache::estimateSize(entry.parse);
     }
 
-    return cache[path];
+    parseUses += 1;
+    entry.lastUse = parseUses;
+    return entry.parse;
 }
 
 CmdCache::CmdCache(){
@@ -181,6 +237,8 @@ static list<Ast::Section*> * reallyParseX(const Filesystem::AbsolutePath & path,
         delete[] data;
         throw;
     }
+    /* the tree has its own copies of everything it needs from the text */
+    delete[] data;
     return out;
 }
 
@@ -208,7 +266,8 @@ Util::ReferenceCount<Ast::AstParse> DefCache::doParse(const Filesystem::Absolute
     return Util::ReferenceCount<Ast::AstParse>(new Ast::AstParse(reallyParseDef(path)));
 }
 
-ParseCache * ParseCache::cache = NULL;
+/* one cache per thread, see parse-cache.h */
+static PAINTOWN_THREAD_LOCAL ParseCache * cache = NULL;
 
 Util::ReferenceCount<Ast::AstParse> ParseCache::parseCmd(const Filesystem::AbsolutePath & path){
     if (cache == NULL){
@@ -237,7 +296,88 @@ void ParseCache::destroy(){
     }
 }
 
-ParseCache::ParseCache(){
+void ParseCache::release(const Filesystem::AbsolutePath & path){
+    if (cache){
+        cache->cmdCache.release(path);
+        cache->airCache.release(path);
+        cache->defCache.release(path);
+    }
+}
+
+unsigned long ParseCache::getSize(){
+    if (cache){
+        return cache->cmdCache.size() + cache->airCache.size() + cache->defCache.size();
+    }
+    return 0;
+}
+
+unsigned long ParseCache::getSize(const Filesystem::AbsolutePath & path){
+    if (cache){
+        return cache->cmdCache.size(path) + cache->airCache.size(path) + cache->defCache.size(path);
+    }
+    return 0;
+}
+
+bool ParseCache::releaseAfterCompile(){
+    if (cache){
+        return cache->releaseParse;
+    }
+    return false;
+}
+
+/* Rough size of one node including the strings it owns. The nodes are small
+ * objects with a vtable, a line and column and usually a string or a couple
+ * of child pointers.
+ */
+static const unsigned long AST_NODE_BYTES = 48;
+
+unsigned long ParseCache::estimateSize(const PaintownUtil::ReferenceCount<Ast::AstParse> & parse){
+    if (parse == NULL || parse->getSections() == NULL){
+        return 0;
+    }
+
+    /* the garbage collector's marking visits every node once */
+    map<const void *, bool> marks;
+    for (Ast::AstParse::section_iterator it = parse->getSections()->begin(); it != parse->getSections()->end(); it++){
+        (*it)->mark(marks);
+    }
+    return marks.size() * AST_NODE_BYTES;
+}
+
+void ParseCache::trim(){
+    if (budget == 0){
+        return;
+    }
+
+    Parser * parsers[] = {&cmdCache, &airCache, &defCache};
+    while (cmdCache.size() + airCache.size() + defCache.size() > budget){
+        Parser * oldest = NULL;
+        unsigned long oldestUse = (unsigned long) -1;
+        for (unsigned int i = 0; i < sizeof(parsers) / sizeof(Parser*); i++){
+            unsigned long use = parsers[i]->oldestUse();
+            if (use < oldestUse){
+                oldestUse = use;
+                oldest = parsers[i];
+            }
+        }
+
+        if (oldest == NULL){
+            break;
+        }
+
+        oldest->releaseOldest();
+    }
+}
+
+ParseCache::ParseCache():
+budget(0),
+releaseParse(false){
+    int kilobytes = ::Configuration::getProperty("mugen/parse-cache-budget", 0);
+    if (kilobytes > 0){
+        budget = (unsigned long) kilobytes * 1024;
+    }
+    releaseParse = ::Configuration::getProperty("mugen/release-parse", false);
+
     /* If there is already an existing cache then this object will not be the target of
      * static calls. If there is not an existing cache then this becomes the 'global' one.
      */
@@ -261,15 +401,21 @@ ParseCache::~ParseCache(){
 }
 
 Util::ReferenceCount<Ast::AstParse> ParseCache::doParseCmd(const Filesystem::AbsolutePath & path){
-    return cmdCache.parse(path);
+    Util::ReferenceCount<Ast::AstParse> out = cmdCache.parse(path);
+    trim();
+    return out;
 }
     
 Util::ReferenceCount<Ast::AstParse> ParseCache::doParseAir(const Filesystem::AbsolutePath & path){
-    return airCache.parse(path);
+    Util::ReferenceCount<Ast::AstParse> out = airCache.parse(path);
+    trim();
+    return out;
 }
 
 Util::ReferenceCount<Ast::AstParse> ParseCache::doParseDef(const Filesystem::AbsolutePath & path){
-    return defCache.parse(path);
+    Util::ReferenceCount<Ast::AstParse> out = defCache.parse(path);
+    trim();
+    return out;
 }
 
 }
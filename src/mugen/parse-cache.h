@@ -26,11 +26,35 @@ public:
 
     void destroy();
 
+    /* forget the tree for one file */
+    void release(const Filesystem::AbsolutePath & path);
+
+    /* approximate bytes held by all cached trees or by the tree of one file */
+    unsigned long size();
+    unsigned long size(const Filesystem::AbsolutePath & path);
+
+    /* when the least recently used tree was last used, or the largest
+     * possible value if there are no trees
+     */
+    unsigned long oldestUse();
+    void releaseOldest();
+
 protected:
     virtual PaintownUtil::ReferenceCount<Ast::AstParse> doParse(const Filesystem::AbsolutePath & path) = 0;
     PaintownUtil::ReferenceCount<Ast::AstParse> loadFile(const Filesystem::AbsolutePath & path);
 
-    std::map<const Filesystem::AbsolutePath, PaintownUtil::ReferenceCount<Ast::AstParse> > cache;
+    struct Entry{
+        Entry():
+            bytes(0),
+            lastUse(0){
+            }
+
+        PaintownUtil::ReferenceCount<Ast::AstParse> parse;
+        unsigned long bytes;
+        unsigned long lastUse;
+    };
+
+    std::map<const Filesystem::AbsolutePath, Entry> cache;
     PaintownUtil::Thread::LockObject lock;
 };
 
@@ -59,6 +83,18 @@ protected:
     virtual PaintownUtil::ReferenceCount<Ast::AstParse> doParse(const Filesystem::AbsolutePath & path);
 };
 
+/* Caches parsed ASTs. The first ParseCache created on a thread becomes the
+ * target of the static parse methods for that thread only, so simulations
+ * loading on separate threads never share cached trees (the reference counts
+ * on the ASTs are not atomic).
+ *
+ * Two options in the mugen section of the configuration limit how much memory
+ * the trees keep once they have been compiled:
+ *   parse-cache-budget - kilobytes of trees to keep, least recently used
+ *                        trees are dropped first. 0 (the default) is no limit.
+ *   release-parse      - if true characters drop the trees of their files as
+ *                        soon as load() is done with them.
+ */
 class ParseCache{
 public:
     ParseCache();
@@ -71,18 +107,35 @@ public:
 
     /* clear the cache */
     static void destroy();
+
+    /* drop the cached trees of one file */
+    static void release(const Filesystem::AbsolutePath & path);
+
+    /* approximate bytes held by the cache, or by the trees of one file */
+    static unsigned long getSize();
+    static unsigned long getSize(const Filesystem::AbsolutePath & path);
+
+    /* true if trees should be released once they are compiled */
+    static bool releaseAfterCompile();
+
+    /* approximate bytes used by a parsed tree */
+    static unsigned long estimateSize(const PaintownUtil::ReferenceCount<Ast::AstParse> & parse);
+
 protected:
 
     PaintownUtil::ReferenceCount<Ast::AstParse> doParseCmd(const Filesystem::AbsolutePath & path);
     PaintownUtil::ReferenceCount<Ast::AstParse> doParseAir(const Filesystem::AbsolutePath & path);
     PaintownUtil::ReferenceCount<Ast::AstParse> doParseDef(const Filesystem::AbsolutePath & path);
     void destroyCache();
-
-    static ParseCache * cache;
+    void trim();
 
     CmdCache cmdCache;
     AirCache airCache;
     DefCache defCache;
+
+    /* in bytes, 0 is no limit */
+    unsigned long budget;
+    bool releaseParse;
 };
 
 }
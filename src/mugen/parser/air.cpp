@@ -15,6 +15,7 @@ typedef std::list<Ast::Section*> SectionList;
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 
 
 namespace Mugen{
@@ -199,6 +200,51 @@ private:
     
 };
 
+/* Hands out the memory for the memo table in large blocks so a parse does a
+ * few allocations instead of one for every column and chunk. Nothing is given
+ * back until the arena goes away, so objects built in it have to be destroyed
+ * by hand.
+ */
+class Arena{
+public:
+    Arena():
+    current(0),
+    used(0),
+    size(0){
+    }
+
+    void * allocate(unsigned int bytes){
+        /* keep every object aligned for pointers and doubles */
+        bytes = (bytes + 7) & ~7u;
+        if (current == 0 || used + bytes > size){
+            size = bytes > BlockSize ? bytes : BlockSize;
+            current = new char[size];
+            blocks.push_back(current);
+            used = 0;
+        }
+        void * out = current + used;
+        used += bytes;
+        return out;
+    }
+
+    ~Arena(){
+        for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); it++){
+            delete[] *it;
+        }
+    }
+
+private:
+    Arena(const Arena &);
+    Arena & operator=(const Arena &);
+
+    static const unsigned int BlockSize = 64 * 1024;
+    char * current;
+    unsigned int used;
+    unsigned int size;
+    std::vector<char*> blocks;
+};
+
+
 
 struct Chunk0{
 Result chunk_start;
@@ -250,10 +296,18 @@ struct Column{
     }
 
     ~Column(){
-        delete chunk0;
-        delete chunk1;
-        delete chunk2;
-        delete chunk3;
+        if (chunk0 != 0){
+            chunk0->~Chunk0();
+        }
+        if (chunk1 != 0){
+            chunk1->~Chunk1();
+        }
+        if (chunk2 != 0){
+            chunk2->~Chunk2();
+        }
+        if (chunk3 != 0){
+            chunk3->~Chunk3();
+        }
     }
 };
 
@@ -554,11 +608,16 @@ public:
         }
         /* create columns lazily because not every position will have a column. */
         if (memo[position] == NULL){
-            memo[position] = new Column();
+            memo[position] = new (arena.allocate(sizeof(Column))) Column();
         }
         return *(memo[position]);
     }
 
+    /* memory for chunks, freed along with the stream */
+    inline void * allocate(unsigned int bytes){
+        return arena.allocate(bytes);
+    }
+
     void update(const int position){
         if (position > farthest){
             farthest = position;
@@ -579,7 +638,9 @@ public:
     ~Stream(){
         delete[] temp;
         for (int i = 0; i < memo_size; i++){
-            delete memo[i];
+            if (memo[i] != NULL){
+                memo[i]->~Column();
+            }
         }
         delete[] memo;
     }
@@ -590,6 +651,8 @@ private:
     /* an array is faster and uses less memory than std::map */
     Column ** memo;
     int memo_size;
+    /* owns the columns and chunks */
+    Arena arena;
     int max;
     int farthest;
     std::vector<std::string> rule_backtrace;
@@ -987,7 +1050,7 @@ Result rule_start(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_start = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -997,7 +1060,7 @@ Result rule_start(Stream & stream, const int position){
         out_peg_6:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_start = errorResult;
         stream.update(errorResult.getPosition());
@@ -1338,7 +1401,7 @@ Result rule_action(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_action = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -1348,7 +1411,7 @@ Result rule_action(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_action = errorResult;
         stream.update(errorResult.getPosition());
@@ -2221,7 +2284,7 @@ Result rule_line_end(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2251,7 +2314,7 @@ Result rule_line_end(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = result_peg_12;
         stream.update(result_peg_12.getPosition());
@@ -2261,7 +2324,7 @@ Result rule_line_end(Stream & stream, const int position){
         out_peg_15:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = errorResult;
         stream.update(errorResult.getPosition());
@@ -2302,7 +2365,7 @@ Result rule_whitespace(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_whitespace = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2311,7 +2374,7 @@ Result rule_whitespace(Stream & stream, const int position){
         return result_peg_3;
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_whitespace = errorResult;
         stream.update(errorResult.getPosition());
@@ -2352,7 +2415,7 @@ Result rule_sn(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_sn = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2361,7 +2424,7 @@ Result rule_sn(Stream & stream, const int position){
         return result_peg_3;
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_sn = errorResult;
         stream.update(errorResult.getPosition());
@@ -2440,7 +2503,7 @@ Result rule_space_newline(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_space_newline = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2489,7 +2552,7 @@ Result rule_space_newline(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_space_newline = result_peg_12;
         stream.update(result_peg_12.getPosition());
@@ -2499,7 +2562,7 @@ Result rule_space_newline(Stream & stream, const int position){
         out_peg_18:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_space_newline = errorResult;
         stream.update(errorResult.getPosition());
@@ -2578,7 +2641,7 @@ Result rule_sw(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_sw = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2596,7 +2659,7 @@ Result rule_sw(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_sw = result_peg_12;
         stream.update(result_peg_12.getPosition());
@@ -2606,7 +2669,7 @@ Result rule_sw(Stream & stream, const int position){
         out_peg_13:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_sw = errorResult;
         stream.update(errorResult.getPosition());
@@ -2713,7 +2776,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2804,7 +2867,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_17;
         stream.update(result_peg_17.getPosition());
@@ -2906,7 +2969,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_31;
         stream.update(result_peg_31.getPosition());
@@ -2916,7 +2979,7 @@ Result rule_comment(Stream & stream, const int position){
         out_peg_33:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = errorResult;
         stream.update(errorResult.getPosition());
@@ -3054,7 +3117,7 @@ Result rule_collision_default(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision_default = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -3176,7 +3239,7 @@ Result rule_collision_default(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision_default = result_peg_20;
         stream.update(result_peg_20.getPosition());
@@ -3298,7 +3361,7 @@ Result rule_collision_default(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision_default = result_peg_37;
         stream.update(result_peg_37.getPosition());
@@ -3420,7 +3483,7 @@ Result rule_collision_default(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision_default = result_peg_54;
         stream.update(result_peg_54.getPosition());
@@ -3430,7 +3493,7 @@ Result rule_collision_default(Stream & stream, const int position){
         out_peg_56:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision_default = errorResult;
         stream.update(errorResult.getPosition());
@@ -4341,7 +4404,7 @@ Result rule_collision(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -5231,7 +5294,7 @@ Result rule_collision(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision = result_peg_149;
         stream.update(result_peg_149.getPosition());
@@ -6121,7 +6184,7 @@ Result rule_collision(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision = result_peg_295;
         stream.update(result_peg_295.getPosition());
@@ -6131,7 +6194,7 @@ Result rule_collision(Stream & stream, const int position){
         out_peg_297:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_collision = errorResult;
         stream.update(errorResult.getPosition());
@@ -6536,7 +6599,7 @@ Result rule_action_start(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_action_start = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6546,7 +6609,7 @@ Result rule_action_start(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_action_start = errorResult;
         stream.update(errorResult.getPosition());
@@ -6659,7 +6722,7 @@ Result rule_integer(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_integer = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6669,7 +6732,7 @@ Result rule_integer(Stream & stream, const int position){
         out_peg_18:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_integer = errorResult;
         stream.update(errorResult.getPosition());
@@ -6887,7 +6950,7 @@ Result rule_valuelist(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_valuelist = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6897,7 +6960,7 @@ Result rule_valuelist(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_valuelist = errorResult;
         stream.update(errorResult.getPosition());
@@ -6932,7 +6995,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6994,7 +7057,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -7037,7 +7100,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_11;
         stream.update(result_peg_11.getPosition());
@@ -7072,7 +7135,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_15;
         stream.update(result_peg_15.getPosition());
@@ -7115,7 +7178,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_18;
         stream.update(result_peg_18.getPosition());
@@ -7150,7 +7213,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_22;
         stream.update(result_peg_22.getPosition());
@@ -7185,7 +7248,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_25;
         stream.update(result_peg_25.getPosition());
@@ -7220,7 +7283,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_28;
         stream.update(result_peg_28.getPosition());
@@ -7255,7 +7318,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_31;
         stream.update(result_peg_31.getPosition());
@@ -7290,7 +7353,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = result_peg_34;
         stream.update(result_peg_34.getPosition());
@@ -7300,7 +7363,7 @@ Result rule_value(Stream & stream, const int position){
         out_peg_36:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_value = errorResult;
         stream.update(errorResult.getPosition());
@@ -16,6 +16,7 @@ typedef std::list<Ast::Section*> SectionList;
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 
 
 namespace Mugen{
@@ -200,6 +201,51 @@ private:
     
 };
 
+/* Hands out the memory for the memo table in large blocks so a parse does a
+ * few allocations instead of one for every column and chunk. Nothing is given
+ * back until the arena goes away, so objects built in it have to be destroyed
+ * by hand.
+ */
+class Arena{
+public:
+    Arena():
+    current(0),
+    used(0),
+    size(0){
+    }
+
+    void * allocate(unsigned int bytes){
+        /* keep every object aligned for pointers and doubles */
+        bytes = (bytes + 7) & ~7u;
+        if (current == 0 || used + bytes > size){
+            size = bytes > BlockSize ? bytes : BlockSize;
+            current = new char[size];
+            blocks.push_back(current);
+            used = 0;
+        }
+        void * out = current + used;
+        used += bytes;
+        return out;
+    }
+
+    ~Arena(){
+        for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); it++){
+            delete[] *it;
+        }
+    }
+
+private:
+    Arena(const Arena &);
+    Arena & operator=(const Arena &);
+
+    static const unsigned int BlockSize = 64 * 1024;
+    char * current;
+    unsigned int used;
+    unsigned int size;
+    std::vector<char*> blocks;
+};
+
+
 
 struct Chunk0{
 Result chunk_start;
@@ -352,20 +398,48 @@ struct Column{
     }
 
     ~Column(){
-        delete chunk0;
-        delete chunk1;
-        delete chunk2;
-        delete chunk3;
-        delete chunk4;
-        delete chunk5;
-        delete chunk6;
-        delete chunk7;
-        delete chunk8;
-        delete chunk9;
-        delete chunk10;
-        delete chunk11;
-        delete chunk12;
-        delete chunk13;
+        if (chunk0 != 0){
+            chunk0->~Chunk0();
+        }
+        if (chunk1 != 0){
+            chunk1->~Chunk1();
+        }
+        if (chunk2 != 0){
+            chunk2->~Chunk2();
+        }
+        if (chunk3 != 0){
+            chunk3->~Chunk3();
+        }
+        if (chunk4 != 0){
+            chunk4->~Chunk4();
+        }
+        if (chunk5 != 0){
+            chunk5->~Chunk5();
+        }
+        if (chunk6 != 0){
+            chunk6->~Chunk6();
+        }
+        if (chunk7 != 0){
+            chunk7->~Chunk7();
+        }
+        if (chunk8 != 0){
+            chunk8->~Chunk8();
+        }
+        if (chunk9 != 0){
+            chunk9->~Chunk9();
+        }
+        if (chunk10 != 0){
+            chunk10->~Chunk10();
+        }
+        if (chunk11 != 0){
+            chunk11->~Chunk11();
+        }
+        if (chunk12 != 0){
+            chunk12->~Chunk12();
+        }
+        if (chunk13 != 0){
+            chunk13->~Chunk13();
+        }
     }
 };
 
@@ -666,11 +740,16 @@ public:
         }
         /* create columns lazily because not every position will have a column. */
         if (memo[position] == NULL){
-            memo[position] = new Column();
+            memo[position] = new (arena.allocate(sizeof(Column))) Column();
         }
         return *(memo[position]);
     }
 
+    /* memory for chunks, freed along with the stream */
+    inline void * allocate(unsigned int bytes){
+        return arena.allocate(bytes);
+    }
+
     void update(const int position){
         if (position > farthest){
             farthest = position;
@@ -691,7 +770,9 @@ public:
     ~Stream(){
         delete[] temp;
         for (int i = 0; i < memo_size; i++){
-            delete memo[i];
+            if (memo[i] != NULL){
+                memo[i]->~Column();
+            }
         }
         delete[] memo;
     }
@@ -702,6 +783,8 @@ private:
     /* an array is faster and uses less memory than std::map */
     Column ** memo;
     int memo_size;
+    /* owns the columns and chunks */
+    Arena arena;
     int max;
     int farthest;
     std::vector<std::string> rule_backtrace;
@@ -1852,7 +1935,7 @@ Result rule_start(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_start = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -1862,7 +1945,7 @@ Result rule_start(Stream & stream, const int position){
         out_peg_6:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_start = errorResult;
         stream.update(errorResult.getPosition());
@@ -2147,7 +2230,7 @@ Result rule_line_end(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2177,7 +2260,7 @@ Result rule_line_end(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = result_peg_12;
         stream.update(result_peg_12.getPosition());
@@ -2187,7 +2270,7 @@ Result rule_line_end(Stream & stream, const int position){
         out_peg_15:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_line_end = errorResult;
         stream.update(errorResult.getPosition());
@@ -2228,7 +2311,7 @@ Result rule_whitespace(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_whitespace = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2237,7 +2320,7 @@ Result rule_whitespace(Stream & stream, const int position){
         return result_peg_3;
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_whitespace = errorResult;
         stream.update(errorResult.getPosition());
@@ -2302,7 +2385,7 @@ Result rule_sw(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_sw = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2320,7 +2403,7 @@ Result rule_sw(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_sw = result_peg_10;
         stream.update(result_peg_10.getPosition());
@@ -2330,7 +2413,7 @@ Result rule_sw(Stream & stream, const int position){
         out_peg_11:
     
         if (column_peg_2.chunk0 == 0){
-            column_peg_2.chunk0 = new Chunk0();
+            column_peg_2.chunk0 = new (stream.allocate(sizeof(Chunk0))) Chunk0();
         }
         column_peg_2.chunk0->chunk_sw = errorResult;
         stream.update(errorResult.getPosition());
@@ -2437,7 +2520,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2528,7 +2611,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_17;
         stream.update(result_peg_17.getPosition());
@@ -2630,7 +2713,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_31;
         stream.update(result_peg_31.getPosition());
@@ -2732,7 +2815,7 @@ Result rule_comment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = result_peg_46;
         stream.update(result_peg_46.getPosition());
@@ -2742,7 +2825,7 @@ Result rule_comment(Stream & stream, const int position){
         out_peg_48:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_comment = errorResult;
         stream.update(errorResult.getPosition());
@@ -2940,7 +3023,7 @@ Result rule_section(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_section = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -2950,7 +3033,7 @@ Result rule_section(Stream & stream, const int position){
         out_peg_7:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_section = errorResult;
         stream.update(errorResult.getPosition());
@@ -3539,7 +3622,7 @@ Result rule_section_title(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_section_title = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -3549,7 +3632,7 @@ Result rule_section_title(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_section_title = errorResult;
         stream.update(errorResult.getPosition());
@@ -3731,7 +3814,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -3895,7 +3978,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_28;
         stream.update(result_peg_28.getPosition());
@@ -4054,7 +4137,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_55;
         stream.update(result_peg_55.getPosition());
@@ -4166,7 +4249,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_80;
         stream.update(result_peg_80.getPosition());
@@ -4517,7 +4600,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_97;
         stream.update(result_peg_97.getPosition());
@@ -4552,7 +4635,7 @@ Result rule_assignment(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = result_peg_155;
         stream.update(result_peg_155.getPosition());
@@ -4562,7 +4645,7 @@ Result rule_assignment(Stream & stream, const int position){
         out_peg_157:
     
         if (column_peg_2.chunk1 == 0){
-            column_peg_2.chunk1 = new Chunk1();
+            column_peg_2.chunk1 = new (stream.allocate(sizeof(Chunk1))) Chunk1();
         }
         column_peg_2.chunk1->chunk_assignment = errorResult;
         stream.update(errorResult.getPosition());
@@ -4648,7 +4731,7 @@ Result rule_identifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_identifier = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -4658,7 +4741,7 @@ Result rule_identifier(Stream & stream, const int position){
         out_peg_7:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_identifier = errorResult;
         stream.update(errorResult.getPosition());
@@ -4780,7 +4863,7 @@ Result rule_integer(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_integer = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -4790,7 +4873,7 @@ Result rule_integer(Stream & stream, const int position){
         out_peg_20:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_integer = errorResult;
         stream.update(errorResult.getPosition());
@@ -4945,7 +5028,7 @@ Result rule_float(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_float = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -5054,7 +5137,7 @@ Result rule_float(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_float = result_peg_27;
         stream.update(result_peg_27.getPosition());
@@ -5064,7 +5147,7 @@ Result rule_float(Stream & stream, const int position){
         out_peg_42:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_float = errorResult;
         stream.update(errorResult.getPosition());
@@ -5370,7 +5453,7 @@ Result rule_range(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_range = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -5659,7 +5742,7 @@ Result rule_range(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_range = result_peg_50;
         stream.update(result_peg_50.getPosition());
@@ -5948,7 +6031,7 @@ Result rule_range(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_range = result_peg_97;
         stream.update(result_peg_97.getPosition());
@@ -6237,7 +6320,7 @@ Result rule_range(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_range = result_peg_144;
         stream.update(result_peg_144.getPosition());
@@ -6247,7 +6330,7 @@ Result rule_range(Stream & stream, const int position){
         out_peg_146:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_range = errorResult;
         stream.update(errorResult.getPosition());
@@ -6373,7 +6456,7 @@ Result rule_name(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_name = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6383,7 +6466,7 @@ Result rule_name(Stream & stream, const int position){
         out_peg_9:
     
         if (column_peg_2.chunk2 == 0){
-            column_peg_2.chunk2 = new Chunk2();
+            column_peg_2.chunk2 = new (stream.allocate(sizeof(Chunk2))) Chunk2();
         }
         column_peg_2.chunk2->chunk_name = errorResult;
         stream.update(errorResult.getPosition());
@@ -6573,7 +6656,7 @@ Result rule_valuelist(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_valuelist = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -6863,7 +6946,7 @@ Result rule_valuelist(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_valuelist = result_peg_30;
         stream.update(result_peg_30.getPosition());
@@ -6873,7 +6956,7 @@ Result rule_valuelist(Stream & stream, const int position){
         out_peg_41:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_valuelist = errorResult;
         stream.update(errorResult.getPosition());
@@ -6994,7 +7077,7 @@ Result rule_expr(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7024,7 +7107,7 @@ Result rule_expr(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr = result_peg_19;
         stream.update(result_peg_19.getPosition());
@@ -7034,7 +7117,7 @@ Result rule_expr(Stream & stream, const int position){
         out_peg_21:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr = errorResult;
         stream.update(errorResult.getPosition());
@@ -7081,7 +7164,7 @@ Result rule_expr_c(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr_c = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7091,7 +7174,7 @@ Result rule_expr_c(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr_c = errorResult;
         stream.update(errorResult.getPosition());
@@ -7138,7 +7221,7 @@ Result rule_expr2(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr2 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7148,7 +7231,7 @@ Result rule_expr2(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr2 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7195,7 +7278,7 @@ Result rule_expr3(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr3 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7205,7 +7288,7 @@ Result rule_expr3(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk3 == 0){
-            column_peg_2.chunk3 = new Chunk3();
+            column_peg_2.chunk3 = new (stream.allocate(sizeof(Chunk3))) Chunk3();
         }
         column_peg_2.chunk3->chunk_expr3 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7252,7 +7335,7 @@ Result rule_expr4(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr4 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7262,7 +7345,7 @@ Result rule_expr4(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr4 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7309,7 +7392,7 @@ Result rule_expr5(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr5 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7319,7 +7402,7 @@ Result rule_expr5(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr5 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7366,7 +7449,7 @@ Result rule_expr6(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr6 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7376,7 +7459,7 @@ Result rule_expr6(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr6 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7423,7 +7506,7 @@ Result rule_expr7(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr7 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7433,7 +7516,7 @@ Result rule_expr7(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr7 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7480,7 +7563,7 @@ Result rule_expr8(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr8 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7490,7 +7573,7 @@ Result rule_expr8(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk4 == 0){
-            column_peg_2.chunk4 = new Chunk4();
+            column_peg_2.chunk4 = new (stream.allocate(sizeof(Chunk4))) Chunk4();
         }
         column_peg_2.chunk4->chunk_expr8 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7537,7 +7620,7 @@ Result rule_expr9(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr9 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7547,7 +7630,7 @@ Result rule_expr9(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr9 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7594,7 +7677,7 @@ Result rule_expr10(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr10 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7604,7 +7687,7 @@ Result rule_expr10(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr10 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7651,7 +7734,7 @@ Result rule_expr11(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr11 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7661,7 +7744,7 @@ Result rule_expr11(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr11 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7708,7 +7791,7 @@ Result rule_expr12(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr12 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7718,7 +7801,7 @@ Result rule_expr12(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr12 = errorResult;
         stream.update(errorResult.getPosition());
@@ -7940,7 +8023,7 @@ Result rule_expr13(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr13 = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -7950,7 +8033,7 @@ Result rule_expr13(Stream & stream, const int position){
         out_peg_34:
     
         if (column_peg_2.chunk5 == 0){
-            column_peg_2.chunk5 = new Chunk5();
+            column_peg_2.chunk5 = new (stream.allocate(sizeof(Chunk5))) Chunk5();
         }
         column_peg_2.chunk5->chunk_expr13 = errorResult;
         stream.update(errorResult.getPosition());
@@ -9992,7 +10075,7 @@ Result rule_all_compare(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk7 == 0){
-            column_peg_2.chunk7 = new Chunk7();
+            column_peg_2.chunk7 = new (stream.allocate(sizeof(Chunk7))) Chunk7();
         }
         column_peg_2.chunk7->chunk_all_compare = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -10063,7 +10146,7 @@ Result rule_all_compare(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk7 == 0){
-            column_peg_2.chunk7 = new Chunk7();
+            column_peg_2.chunk7 = new (stream.allocate(sizeof(Chunk7))) Chunk7();
         }
         column_peg_2.chunk7->chunk_all_compare = result_peg_18;
         stream.update(result_peg_18.getPosition());
@@ -10073,7 +10156,7 @@ Result rule_all_compare(Stream & stream, const int position){
         out_peg_26:
     
         if (column_peg_2.chunk7 == 0){
-            column_peg_2.chunk7 = new Chunk7();
+            column_peg_2.chunk7 = new (stream.allocate(sizeof(Chunk7))) Chunk7();
         }
         column_peg_2.chunk7->chunk_all_compare = errorResult;
         stream.update(errorResult.getPosition());
@@ -11094,7 +11177,7 @@ Result rule_expr13_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_expr13_real = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -11112,7 +11195,7 @@ Result rule_expr13_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_expr13_real = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -11130,7 +11213,7 @@ Result rule_expr13_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_expr13_real = result_peg_7;
         stream.update(result_peg_7.getPosition());
@@ -11292,7 +11375,7 @@ Result rule_expr13_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_expr13_real = result_peg_9;
         stream.update(result_peg_9.getPosition());
@@ -11302,7 +11385,7 @@ Result rule_expr13_real(Stream & stream, const int position){
         out_peg_11:
     
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_expr13_real = errorResult;
         stream.update(errorResult.getPosition());
@@ -11493,7 +11576,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -11656,7 +11739,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_28;
         stream.update(result_peg_28.getPosition());
@@ -12016,7 +12099,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_53;
         stream.update(result_peg_53.getPosition());
@@ -12179,7 +12262,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_114;
         stream.update(result_peg_114.getPosition());
@@ -12536,7 +12619,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_141;
         stream.update(result_peg_141.getPosition());
@@ -12973,7 +13056,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_202;
         stream.update(result_peg_202.getPosition());
@@ -13315,7 +13398,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_272;
         stream.update(result_peg_272.getPosition());
@@ -13357,7 +13440,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_326;
         stream.update(result_peg_326.getPosition());
@@ -14156,7 +14239,7 @@ Result rule_function(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = result_peg_331;
         stream.update(result_peg_331.getPosition());
@@ -14166,7 +14249,7 @@ Result rule_function(Stream & stream, const int position){
         out_peg_406:
     
         if (column_peg_2.chunk8 == 0){
-            column_peg_2.chunk8 = new Chunk8();
+            column_peg_2.chunk8 = new (stream.allocate(sizeof(Chunk8))) Chunk8();
         }
         column_peg_2.chunk8->chunk_function = errorResult;
         stream.update(errorResult.getPosition());
@@ -14344,7 +14427,7 @@ Result rule_paren_integer(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_paren_integer = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -14362,7 +14445,7 @@ Result rule_paren_integer(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_paren_integer = result_peg_28;
         stream.update(result_peg_28.getPosition());
@@ -14372,7 +14455,7 @@ Result rule_paren_integer(Stream & stream, const int position){
         out_peg_29:
     
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_paren_integer = errorResult;
         stream.update(errorResult.getPosition());
@@ -14566,7 +14649,7 @@ Result rule_hitdef__attack__attribute(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_hitdef__attack__attribute = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -14576,7 +14659,7 @@ Result rule_hitdef__attack__attribute(Stream & stream, const int position){
         out_peg_6:
     
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_hitdef__attack__attribute = errorResult;
         stream.update(errorResult.getPosition());
@@ -14838,7 +14921,7 @@ Result rule_hitdef__attribute(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_hitdef__attribute = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -14848,7 +14931,7 @@ Result rule_hitdef__attribute(Stream & stream, const int position){
         out_peg_14:
     
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_hitdef__attribute = errorResult;
         stream.update(errorResult.getPosition());
@@ -15036,7 +15119,7 @@ Result rule_args(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_args = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -15046,7 +15129,7 @@ Result rule_args(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk9 == 0){
-            column_peg_2.chunk9 = new Chunk9();
+            column_peg_2.chunk9 = new (stream.allocate(sizeof(Chunk9))) Chunk9();
         }
         column_peg_2.chunk9->chunk_args = errorResult;
         stream.update(errorResult.getPosition());
@@ -15270,7 +15353,7 @@ Result rule_function_rest(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_function_rest = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -15285,7 +15368,7 @@ Result rule_function_rest(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_function_rest = result_peg_38;
         stream.update(result_peg_38.getPosition());
@@ -15294,7 +15377,7 @@ Result rule_function_rest(Stream & stream, const int position){
         return result_peg_38;
     
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_function_rest = errorResult;
         stream.update(errorResult.getPosition());
@@ -15328,7 +15411,7 @@ Result rule_keys(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_keys = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -15338,7 +15421,7 @@ Result rule_keys(Stream & stream, const int position){
         out_peg_4:
     
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_keys = errorResult;
         stream.update(errorResult.getPosition());
@@ -15603,7 +15686,7 @@ Result rule_key_value_list(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_key_value_list = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -15631,7 +15714,7 @@ Result rule_key_value_list(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_key_value_list = result_peg_42;
         stream.update(result_peg_42.getPosition());
@@ -15640,7 +15723,7 @@ Result rule_key_value_list(Stream & stream, const int position){
         return result_peg_42;
     
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_key_value_list = errorResult;
         stream.update(errorResult.getPosition());
@@ -15706,7 +15789,7 @@ Result rule_key(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_key = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -15716,7 +15799,7 @@ Result rule_key(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk10 == 0){
-            column_peg_2.chunk10 = new Chunk10();
+            column_peg_2.chunk10 = new (stream.allocate(sizeof(Chunk10))) Chunk10();
         }
         column_peg_2.chunk10->chunk_key = errorResult;
         stream.update(errorResult.getPosition());
@@ -16202,7 +16285,7 @@ Result rule_key_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_real = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -16212,7 +16295,7 @@ Result rule_key_real(Stream & stream, const int position){
         out_peg_39:
     
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_real = errorResult;
         stream.update(errorResult.getPosition());
@@ -16292,7 +16375,7 @@ Result rule_key_modifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_modifier = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -16327,7 +16410,7 @@ Result rule_key_modifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_modifier = result_peg_13;
         stream.update(result_peg_13.getPosition());
@@ -16362,7 +16445,7 @@ Result rule_key_modifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_modifier = result_peg_16;
         stream.update(result_peg_16.getPosition());
@@ -16397,7 +16480,7 @@ Result rule_key_modifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_modifier = result_peg_19;
         stream.update(result_peg_19.getPosition());
@@ -16407,7 +16490,7 @@ Result rule_key_modifier(Stream & stream, const int position){
         out_peg_21:
     
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_key_modifier = errorResult;
         stream.update(errorResult.getPosition());
@@ -16441,7 +16524,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -16459,7 +16542,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -16477,7 +16560,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_7;
         stream.update(result_peg_7.getPosition());
@@ -16495,7 +16578,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_9;
         stream.update(result_peg_9.getPosition());
@@ -16529,7 +16612,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_11;
         stream.update(result_peg_11.getPosition());
@@ -16547,7 +16630,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_16;
         stream.update(result_peg_16.getPosition());
@@ -16656,7 +16739,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_18;
         stream.update(result_peg_18.getPosition());
@@ -16674,7 +16757,7 @@ Result rule_value(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = result_peg_35;
         stream.update(result_peg_35.getPosition());
@@ -16684,7 +16767,7 @@ Result rule_value(Stream & stream, const int position){
         out_peg_36:
     
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_value = errorResult;
         stream.update(errorResult.getPosition());
@@ -16858,7 +16941,7 @@ Result rule_resource(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -16912,7 +16995,7 @@ Result rule_resource(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource = result_peg_24;
         stream.update(result_peg_24.getPosition());
@@ -16922,7 +17005,7 @@ Result rule_resource(Stream & stream, const int position){
         out_peg_28:
     
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource = errorResult;
         stream.update(errorResult.getPosition());
@@ -16960,7 +17043,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -16982,7 +17065,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -17004,7 +17087,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_7;
         stream.update(result_peg_7.getPosition());
@@ -17026,7 +17109,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_9;
         stream.update(result_peg_9.getPosition());
@@ -17048,7 +17131,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_11;
         stream.update(result_peg_11.getPosition());
@@ -17070,7 +17153,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_13;
         stream.update(result_peg_13.getPosition());
@@ -17092,7 +17175,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_15;
         stream.update(result_peg_15.getPosition());
@@ -17114,7 +17197,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_17;
         stream.update(result_peg_17.getPosition());
@@ -17136,7 +17219,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_19;
         stream.update(result_peg_19.getPosition());
@@ -17158,7 +17241,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_21;
         stream.update(result_peg_21.getPosition());
@@ -17180,7 +17263,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_23;
         stream.update(result_peg_23.getPosition());
@@ -17773,7 +17856,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_25;
         stream.update(result_peg_25.getPosition());
@@ -17791,7 +17874,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_100;
         stream.update(result_peg_100.getPosition());
@@ -17813,7 +17896,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_102;
         stream.update(result_peg_102.getPosition());
@@ -17835,7 +17918,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_104;
         stream.update(result_peg_104.getPosition());
@@ -17857,7 +17940,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_106;
         stream.update(result_peg_106.getPosition());
@@ -17879,7 +17962,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_108;
         stream.update(result_peg_108.getPosition());
@@ -17901,7 +17984,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_110;
         stream.update(result_peg_110.getPosition());
@@ -17923,7 +18006,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_112;
         stream.update(result_peg_112.getPosition());
@@ -17945,7 +18028,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_114;
         stream.update(result_peg_114.getPosition());
@@ -17967,7 +18050,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_116;
         stream.update(result_peg_116.getPosition());
@@ -17989,7 +18072,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_118;
         stream.update(result_peg_118.getPosition());
@@ -18011,7 +18094,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_120;
         stream.update(result_peg_120.getPosition());
@@ -18033,7 +18116,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_122;
         stream.update(result_peg_122.getPosition());
@@ -18055,7 +18138,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_124;
         stream.update(result_peg_124.getPosition());
@@ -18077,7 +18160,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_126;
         stream.update(result_peg_126.getPosition());
@@ -18099,7 +18182,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_128;
         stream.update(result_peg_128.getPosition());
@@ -18121,7 +18204,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_130;
         stream.update(result_peg_130.getPosition());
@@ -18143,7 +18226,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_132;
         stream.update(result_peg_132.getPosition());
@@ -18165,7 +18248,7 @@ Result rule_resource__s(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = result_peg_134;
         stream.update(result_peg_134.getPosition());
@@ -18175,7 +18258,7 @@ Result rule_resource__s(Stream & stream, const int position){
         out_peg_135:
     
         if (column_peg_2.chunk11 == 0){
-            column_peg_2.chunk11 = new Chunk11();
+            column_peg_2.chunk11 = new (stream.allocate(sizeof(Chunk11))) Chunk11();
         }
         column_peg_2.chunk11->chunk_resource__s = errorResult;
         stream.update(errorResult.getPosition());
@@ -18213,7 +18296,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -18235,7 +18318,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -18257,7 +18340,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_7;
         stream.update(result_peg_7.getPosition());
@@ -18279,7 +18362,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_9;
         stream.update(result_peg_9.getPosition());
@@ -18301,7 +18384,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_11;
         stream.update(result_peg_11.getPosition());
@@ -18323,7 +18406,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_13;
         stream.update(result_peg_13.getPosition());
@@ -18345,7 +18428,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_15;
         stream.update(result_peg_15.getPosition());
@@ -18367,7 +18450,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_17;
         stream.update(result_peg_17.getPosition());
@@ -18389,7 +18472,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_19;
         stream.update(result_peg_19.getPosition());
@@ -18411,7 +18494,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_21;
         stream.update(result_peg_21.getPosition());
@@ -18433,7 +18516,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_23;
         stream.update(result_peg_23.getPosition());
@@ -18455,7 +18538,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_25;
         stream.update(result_peg_25.getPosition());
@@ -18477,7 +18560,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_27;
         stream.update(result_peg_27.getPosition());
@@ -18499,7 +18582,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_29;
         stream.update(result_peg_29.getPosition());
@@ -19092,7 +19175,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_31;
         stream.update(result_peg_31.getPosition());
@@ -19110,7 +19193,7 @@ Result rule_resource__f(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = result_peg_106;
         stream.update(result_peg_106.getPosition());
@@ -19120,7 +19203,7 @@ Result rule_resource__f(Stream & stream, const int position){
         out_peg_107:
     
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_resource__f = errorResult;
         stream.update(errorResult.getPosition());
@@ -19491,7 +19574,7 @@ Result rule_helper(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -19501,7 +19584,7 @@ Result rule_helper(Stream & stream, const int position){
         out_peg_22:
     
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper = errorResult;
         stream.update(errorResult.getPosition());
@@ -19679,7 +19762,7 @@ Result rule_helper__expression(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__expression = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -19689,7 +19772,7 @@ Result rule_helper__expression(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__expression = errorResult;
         stream.update(errorResult.getPosition());
@@ -19723,7 +19806,7 @@ Result rule_helper__identifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__identifier = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -19741,7 +19824,7 @@ Result rule_helper__identifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__identifier = result_peg_5;
         stream.update(result_peg_5.getPosition());
@@ -19775,7 +19858,7 @@ Result rule_helper__identifier(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__identifier = result_peg_7;
         stream.update(result_peg_7.getPosition());
@@ -19785,7 +19868,7 @@ Result rule_helper__identifier(Stream & stream, const int position){
         out_peg_11:
     
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_helper__identifier = errorResult;
         stream.update(errorResult.getPosition());
@@ -19899,7 +19982,7 @@ Result rule_hitflag(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_hitflag = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -19909,7 +19992,7 @@ Result rule_hitflag(Stream & stream, const int position){
         out_peg_11:
     
         if (column_peg_2.chunk12 == 0){
-            column_peg_2.chunk12 = new Chunk12();
+            column_peg_2.chunk12 = new (stream.allocate(sizeof(Chunk12))) Chunk12();
         }
         column_peg_2.chunk12->chunk_hitflag = errorResult;
         stream.update(errorResult.getPosition());
@@ -20018,7 +20101,7 @@ Result rule_keyword(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -20028,7 +20111,7 @@ Result rule_keyword(Stream & stream, const int position){
         out_peg_5:
     
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword = errorResult;
         stream.update(errorResult.getPosition());
@@ -20148,7 +20231,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_3;
         stream.update(result_peg_3.getPosition());
@@ -20252,7 +20335,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_18;
         stream.update(result_peg_18.getPosition());
@@ -20356,7 +20439,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_33;
         stream.update(result_peg_33.getPosition());
@@ -20460,7 +20543,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_48;
         stream.update(result_peg_48.getPosition());
@@ -20564,7 +20647,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_63;
         stream.update(result_peg_63.getPosition());
@@ -20668,7 +20751,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_78;
         stream.update(result_peg_78.getPosition());
@@ -20772,7 +20855,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_93;
         stream.update(result_peg_93.getPosition());
@@ -20876,7 +20959,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_108;
         stream.update(result_peg_108.getPosition());
@@ -20980,7 +21063,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_123;
         stream.update(result_peg_123.getPosition());
@@ -21084,7 +21167,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_138;
         stream.update(result_peg_138.getPosition());
@@ -21188,7 +21271,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_153;
         stream.update(result_peg_153.getPosition());
@@ -21292,7 +21375,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_168;
         stream.update(result_peg_168.getPosition());
@@ -21396,7 +21479,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_183;
         stream.update(result_peg_183.getPosition());
@@ -21500,7 +21583,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_198;
         stream.update(result_peg_198.getPosition());
@@ -21604,7 +21687,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_213;
         stream.update(result_peg_213.getPosition());
@@ -21708,7 +21791,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_228;
         stream.update(result_peg_228.getPosition());
@@ -21812,7 +21895,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_243;
         stream.update(result_peg_243.getPosition());
@@ -21916,7 +21999,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_258;
         stream.update(result_peg_258.getPosition());
@@ -22020,7 +22103,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_273;
         stream.update(result_peg_273.getPosition());
@@ -22038,7 +22121,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         
         
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = result_peg_288;
         stream.update(result_peg_288.getPosition());
@@ -22048,7 +22131,7 @@ Result rule_keyword_real(Stream & stream, const int position){
         out_peg_289:
     
         if (column_peg_2.chunk13 == 0){
-            column_peg_2.chunk13 = new Chunk13();
+            column_peg_2.chunk13 = new (stream.allocate(sizeof(Chunk13))) Chunk13();
         }
         column_peg_2.chunk13->chunk_keyword_real = errorResult;
         stream.update(errorResult.getPosition());
@@ -178,6 +178,51 @@ struct Value{
 
 %(state-class)s
 %(result-class)s
+
+/* Hands out the memory for the memo table in large blocks so a parse does a
+ * few allocations instead of one for every column and chunk. Nothing is given
+ * back until the arena goes away, so objects built in it have to be destroyed
+ * by hand.
+ */
+class Arena{
+public:
+    Arena():
+    current(0),
+    used(0),
+    size(0){
+    }
+
+    void * allocate(unsigned int bytes){
+        /* keep every object aligned for pointers and doubles */
+        bytes = (bytes + 7) & ~7u;
+        if (current == 0 || used + bytes > size){
+            size = bytes > BlockSize ? bytes : BlockSize;
+            current = new char[size];
+            blocks.push_back(current);
+            used = 0;
+        }
+        void * out = current + used;
+        used += bytes;
+        return out;
+    }
+
+    ~Arena(){
+        for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); it++){
+            delete[] *it;
+        }
+    }
+
+private:
+    Arena(const Arena &);
+    Arena & operator=(const Arena &);
+
+    static const unsigned int BlockSize = 64 * 1024;
+    char * current;
+    unsigned int used;
+    unsigned int size;
+    std::vector<char*> blocks;
+};
+
 %(chunks)s
 
 class ParseException: std::exception {
@@ -476,11 +521,16 @@ public:
         }
         /* create columns lazily because not every position will have a column. */
         if (memo[position] == NULL){
-            memo[position] = new Column();
+            memo[position] = new (arena.allocate(sizeof(Column))) Column();
         }
         return *(memo[position]);
     }
 
+    /* memory for chunks, freed along with the stream */
+    inline void * allocate(unsigned int bytes){
+        return arena.allocate(bytes);
+    }
+
     void update(const int position){
         if (position > farthest){
             farthest = position;
@@ -501,7 +551,9 @@ public:
     ~Stream(){
         delete[] temp;
         for (int i = 0; i < memo_size; i++){
-            delete memo[i];
+            if (memo[i] != NULL){
+                memo[i]->~Column();
+            }
         }
         delete[] memo;
     }
@@ -512,6 +564,8 @@ private:
     /* an array is faster and uses less memory than std::map */
     Column ** memo;
     int memo_size;
+    /* owns the columns and chunks */
+    Arena arena;
     int max;
     int farthest;
     std::vector<std::string> rule_backtrace;
@@ -1112,7 +1166,7 @@ struct Column{
        'members': indent("\n".join(["%s * %s;" % (x, x.lower()) for x in all])),
        'hit-count': hit_count,
        'rules': len(rules),
-       'deletes': indent(indent("\n".join(["delete %s;" % x.lower() for x in all])))}
+       'deletes': indent(indent("\n".join(["if (%s != 0){\n    %s->~%s();\n}" % (x.lower(), x.lower(), x) for x in all])))}
 
         return data
 
@@ -1229,6 +1283,7 @@ unsigned int newId(){
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 
 %(namespace-start)s
 %(start-code)s
@@ -1313,6 +1368,7 @@ const void * parse(const char * in, int length, bool stats = false){
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 
 %s
 %s
@@ -1338,6 +1394,7 @@ extern Result errorResult;
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 #include "%s.h"
 
 %s
@@ -15,6 +15,7 @@ typedef std::list<Ast::Section*> SectionList;
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <new>
 
 
 namespace Mugen{
@@ -199,6 +200,51 @@ private:
     
 };
 
+/* Hands out the memory for the memo table in large blocks so a parse does a
+ * few allocations instead of one for every column and chunk. Nothing is given
+ * back until the arena goes away, so objects built in it have to be destroyed
+ * by hand.
+ */
+class Arena{
+public:
+    Arena():
+    current(0),
+    used(0),
+    size(0){
+    }
+
+    void * allocate(unsigned int bytes){
+        /* keep every object aligned for pointers and doubles */
+        bytes = (bytes + 7) & ~7u;
+        if (current == 0 || used + bytes > size){
+            size = bytes > BlockSize ? bytes : BlockSize;
+            current = new char[size];
+            blocks.push_back(current);
+            used = 0;
+        }
+        void * out = current + used;
+        used += bytes;
+        return out;
+    }
+
+    ~Arena(){
+        for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); it++){
+            delete[] *it;
+        }
+    }
+
+private:
+    Arena(const Arena &);
+    Arena & operator=(const Arena &);
+
+    static const unsigned int BlockSize = 64 * 1024;
+    char * current;
+    unsigned int used;
+    unsigned int size;
+    std::vector<char*> blocks;
+};
+
+
 
 struct Chunk0{
 Result chunk_start;
@@ -252,10 +298,18 @@ struct Column{
     }
 
     ~Column(){
-        delete chunk0;
-        delete chunk1;
-        delete chunk2;
-        delete chunk3;
+        if (chunk0 != 0){
+            chunk0->~Chunk0();
+        }
+        if (chunk1 != 0){
+            chunk1->~Chunk1();
+        }
+        if (chunk2 != 0){
+            chunk2->~Chunk2();
+        }
+        if (chunk3 != 0){
+            chunk3->~Chunk3();
+        }
     }
 };
 
@@ -556,11 +610,16 @@ public:
         }
         /* create columns lazily because not every position will have a column. */
         if (memo[position] == NULL){
-            memo[position] = new Column();
+            memo[position] = new (arena.allocate(sizeof(Column))) Column();
         }
         return *(memo[position]);
     }
 
+    /* memory for chunks, freed along with the stream */
+    inline void * allocate(unsigned int bytes){
+        return arena.allocate(bytes);
+    }
+
     void update(const int position){
         if (position > farthest){
             farthest = position;
@@ -581,7 +640,9 @@ public:
     ~Stream(){
         delete[] temp;
         for (int i = 0; i < memo_size; i++){
-            delete memo[i];
+            if (memo[i] != NULL){
+                memo[i]->~Column();
+            }
         }
         delete[] memo;
     }
@@ -592,6 +653,8 @@ private:
     /* an array is faster and uses less memory than std::map */
     Column ** memo;
     int memo_size;
+    /* owns the columns and chunks */
+    Arena arena;
     int max;
     int farthest;
     std::vector<std::string> rule_backtrace;
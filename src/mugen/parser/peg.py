@@ -1164,11 +1164,11 @@ Result rule_%s(Stream & stream, int position, Value ** arguments){
             chunk = chunk_accessor.getChunk(columnVar)
             data = """
 if (%s == 0){
-    %s = new %s();
+    %s = new (%s.allocate(sizeof(%s))) %s();
 }
 %s = %s;
 %s.update(%s.getPosition());
-""" % (chunk, chunk, chunk_accessor.getType(), chunk_accessor.getValue(chunk), new, stream, new)
+""" % (chunk, chunk, stream, chunk_accessor.getType(), chunk_accessor.getType(), chunk_accessor.getValue(chunk), new, stream, new)
             return data
             
         columnVar = gensym("column")
@@ -0,0 +1,115 @@
+#include "pool.h"
+#include <new>
+
+namespace Mugen{
+
+BlockPool::BlockPool(unsigned int blockSize, unsigned int blocksPerChunk):
+blockSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize),
+blocksPerChunk(blocksPerChunk),
+freeList(NULL),
+used(0){
+}
+
+BlockPool::~BlockPool(){
+    for (std::vector<char*>::iterator it = chunks.begin(); it != chunks.end(); it++){
+        delete[] *it;
+    }
+}
+
+void * BlockPool::allocate(){
+    if (freeList == NULL){
+        char * chunk = new char[blockSize * blocksPerChunk];
+        chunks.push_back(chunk);
+        /* thread the new blocks onto the free list, first block on top */
+        for (int i = blocksPerChunk - 1; i >= 0; i--){
+            FreeBlock * block = (FreeBlock*) (chunk + i * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+
+    FreeBlock * block = freeList;
+    freeList = block->next;
+    used += 1;
+    return block;
+}
+
+void BlockPool::release(void * memory){
+    FreeBlock * block = (FreeBlock*) memory;
+    block->next = freeList;
+    freeList = block;
+    used -= 1;
+}
+
+/* Stored in front of every object so release() knows where it came from.
+ * The union keeps the object after it aligned for anything.
+ */
+union PoolHeader{
+    BlockPool * pool;
+    double alignDouble;
+    long long alignLong;
+    void * alignPointer;
+};
+
+static const unsigned int smallestBlock = 64;
+static const unsigned int poolCount = 5;
+static const unsigned int blocksPerChunk = 32;
+
+ObjectPool::ObjectPool():
+oversized(0){
+    unsigned int size = smallestBlock;
+    for (unsigned int i = 0; i < poolCount; i++){
+        pools.push_back(new BlockPool(size, blocksPerChunk));
+        size *= 2;
+    }
+}
+
+ObjectPool::~ObjectPool(){
+    for (std::vector<BlockPool*>::iterator it = pools.begin(); it != pools.end(); it++){
+        delete *it;
+    }
+}
+
+void * ObjectPool::allocate(size_t size){
+    size_t total = size + sizeof(PoolHeader);
+    for (std::vector<BlockPool*>::iterator it = pools.begin(); it != pools.end(); it++){
+        BlockPool * pool = *it;
+        if (total <= pool->getBlockSize()){
+            PoolHeader * header = (PoolHeader*) pool->allocate();
+            header->pool = pool;
+            return header + 1;
+        }
+    }
+
+    oversized += 1;
+    return allocateHeap(size);
+}
+
+void * ObjectPool::allocateHeap(size_t size){
+    PoolHeader * header = (PoolHeader*) ::operator new(size + sizeof(PoolHeader));
+    header->pool = NULL;
+    return header + 1;
+}
+
+void ObjectPool::release(void * memory){
+    if (memory == NULL){
+        return;
+    }
+
+    PoolHeader * header = ((PoolHeader*) memory) - 1;
+    if (header->pool != NULL){
+        header->pool->release(header);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+unsigned int ObjectPool::getUsed() const {
+    unsigned int total = 0;
+    for (std::vector<BlockPool*>::const_iterator it = pools.begin(); it != pools.end(); it++){
+        total += (*it)->getUsed();
+    }
+    return total;
+}
+
+}
@@ -0,0 +1,166 @@
+#ifndef _paintown_mugen_pool_h
+#define _paintown_mugen_pool_h
+
+#include <vector>
+#include <stddef.h>
+
+namespace Mugen{
+
+/* Hands out blocks of one size carved from larger chunks. Released blocks go
+ * on a free list and are reused before a new chunk is made. Chunks are only
+ * given back to the system when the pool is destroyed.
+ */
+class BlockPool{
+public:
+    BlockPool(unsigned int blockSize, unsigned int blocksPerChunk);
+    ~BlockPool();
+
+    void * allocate();
+    void release(void * block);
+
+    inline unsigned int getBlockSize() const {
+        return blockSize;
+    }
+
+    /* blocks currently handed out */
+    inline unsigned int getUsed() const {
+        return used;
+    }
+
+    /* blocks in all chunks, used or not */
+    inline unsigned int getCapacity() const {
+        return chunks.size() * blocksPerChunk;
+    }
+
+private:
+    BlockPool(const BlockPool & copy);
+    BlockPool & operator=(const BlockPool & copy);
+
+    struct FreeBlock{
+        FreeBlock * next;
+    };
+
+    const unsigned int blockSize;
+    const unsigned int blocksPerChunk;
+    std::vector<char*> chunks;
+    FreeBlock * freeList;
+    unsigned int used;
+};
+
+/* A handful of BlockPools of increasing size for objects that are created and
+ * destroyed constantly, like explods and projectiles. Every allocation
+ * remembers the pool it came from so a plain `delete' (through the class
+ * operator delete) puts the memory back in the right place. Allocations that
+ * are too big for any pool, or made without a pool, go to the heap.
+ *
+ * The pool must outlive everything allocated from it.
+ */
+class ObjectPool{
+public:
+    ObjectPool();
+    ~ObjectPool();
+
+    void * allocate(size_t size);
+
+    /* Allocate from the heap but with the same header, so release() works */
+    static void * allocateHeap(size_t size);
+
+    /* Give back memory from allocate() or allocateHeap() */
+    static void release(void * memory);
+
+    /* objects currently allocated from the pools */
+    unsigned int getUsed() const;
+    /* objects that didn't fit any pool */
+    inline unsigned int getOversized() const {
+        return oversized;
+    }
+
+private:
+    ObjectPool(const ObjectPool & copy);
+    ObjectPool & operator=(const ObjectPool & copy);
+
+    std::vector<BlockPool*> pools;
+    unsigned int oversized;
+};
+
+/* Refers to an object in a HandleTable. The generation changes every time a
+ * slot is reused so a handle to an object that is gone never finds the object
+ * that replaced it.
+ */
+struct Handle{
+    Handle():
+        slot(0),
+        generation(0){
+        }
+
+    unsigned int slot;
+    unsigned int generation;
+};
+
+template <class T>
+class HandleTable{
+public:
+    HandleTable(){
+    }
+
+    Handle add(T * object){
+        Handle handle;
+        if (freeSlots.size() > 0){
+            handle.slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            handle.slot = slots.size();
+            slots.push_back(Slot());
+        }
+        Slot & slot = slots[handle.slot];
+        slot.object = object;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    /* NULL if the object was removed */
+    T * get(const Handle & handle) const {
+        if (handle.slot < slots.size() && slots[handle.slot].generation == handle.generation){
+            return slots[handle.slot].object;
+        }
+        return NULL;
+    }
+
+    void remove(const Handle & handle){
+        if (get(handle) != NULL){
+            Slot & slot = slots[handle.slot];
+            slot.object = NULL;
+            slot.generation += 1;
+            freeSlots.push_back(handle.slot);
+        }
+    }
+
+    void clear(){
+        for (unsigned int i = 0; i < slots.size(); i++){
+            if (slots[i].object != NULL){
+                slots[i].object = NULL;
+                slots[i].generation += 1;
+                freeSlots.push_back(i);
+            }
+        }
+    }
+
+private:
+    struct Slot{
+        Slot():
+            object(NULL),
+            /* start at 1 so a default Handle is never valid */
+            generation(1){
+            }
+
+        T * object;
+        unsigned int generation;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<unsigned int> freeSlots;
+};
+
+}
+
+#endif
@@ -53,6 +53,22 @@ lastCanceled(0){
     }
 }
 
+void * Projectile::operator new(size_t size){
+    return ObjectPool::allocateHeap(size);
+}
+
+void * Projectile::operator new(size_t size, ObjectPool & pool){
+    return pool.allocate(size);
+}
+
+void Projectile::operator delete(void * memory){
+    ObjectPool::release(memory);
+}
+
+void Projectile::operator delete(void * memory, ObjectPool & pool){
+    ObjectPool::release(memory);
+}
+
 Projectile::~Projectile(){
 }
 
@@ -5,6 +5,7 @@
 #include "object.h"
 #include "animation.h"
 #include "common.h"
+#include "pool.h"
 #include <vector>
 
 namespace Graphics{
@@ -27,6 +28,12 @@ public:
                int shadowGreen, int shadowBlue, int superMoveTime, int pauseMoveTime,
                int afterImageTime, int afterImageLength, Facing facing, const HitDefinition & hit);
 
+    /* see Effect */
+    static void * operator new(size_t size);
+    static void * operator new(size_t size, ObjectPool & pool);
+    static void operator delete(void * memory);
+    static void operator delete(void * memory, ObjectPool & pool);
+
     virtual ~Projectile();
 
     virtual int getSpritePriority() const;
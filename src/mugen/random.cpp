@@ -75,36 +75,19 @@ Random Random::deserialize(const Token * token){
     return out;
 }
 
-PaintownUtil::ReferenceCount<Random> Random::current;
-PaintownUtil::ReferenceCount<Random> Random::getState(){
-    if (current == NULL){
-        current = PaintownUtil::ReferenceCount<Random>(new Random());
-    }
-
-    return current;
-}
-    
-void Random::setState(const Random & what){
-    current = PaintownUtil::ReferenceCount<Random>(new Random(what));
-}
-
-uint32_t Random::random(){
-    return Random::getState()->next();
-}
-
-uint32_t random(){
-    return Random::random();
+uint32_t random(Random & state){
+    return state.next();
 }
 
-uint32_t random(int q){
+uint32_t random(Random & state, int q){
     if (q <= 0){
         return 0;
     }
-    return Mugen::random() % q;
+    return Mugen::random(state) % q;
 }
 
-uint32_t random(int low, int high){
-    return Mugen::random(high - low) + low;
+uint32_t random(Random & state, int low, int high){
+    return Mugen::random(state, high - low) + low;
 }
 
 }
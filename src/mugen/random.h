@@ -2,15 +2,16 @@
 #define _paintown_mugen_random_h
 
 #include <stdint.h>
-#include "util/pointer.h"
 
-namespace PaintownUtil = ::Util;
 class Token;
 
 namespace Mugen{
 
 /* Uses the WELL 512 random algorithm.
  * http://www.iro.umontreal.ca/~panneton/WELLRNG.html
+ *
+ * There is no global generator. Each Stage owns one so that matches
+ * running on different threads don't share state.
  */
 class Random{
 public:
@@ -22,11 +23,6 @@ public:
 
     uint64_t next();
 
-    static uint32_t random();
-
-    static PaintownUtil::ReferenceCount<Random> getState();
-    static void setState(const Random & what);
-
     Token * serialize() const;
     static Random deserialize(const Token * token);
 
@@ -35,13 +31,11 @@ protected:
 
     uint64_t state[16];
     uint32_t index;
-
-    static PaintownUtil::ReferenceCount<Random> current;
 };
 
-uint32_t random();
-uint32_t random(int high);
-uint32_t random(int low, int high);
+uint32_t random(Random & state);
+uint32_t random(Random & state, int high);
+uint32_t random(Random & state, int low, int high);
 
 }
 
@@ -15,8 +15,10 @@
 #include "util/sound/music.h"
 #include "util/exceptions/shutdown_exception.h"
 #include "util/system.h"
+#include "util/timedifference.h"
 #include "character.h"
 #include "world.h"
+#include "parse-cache.h"
 
 #include "util/lz4/lz4.h"
 
@@ -341,6 +343,8 @@ class LogicDraw: public PaintownUtil::Logic, public PaintownUtil::Draw {
         totalTicks(0),
         options(options),
         show(true),
+        renderTime(0),
+        hudTime(0),
         showGameSpeed(0),
         escapeMenu(options){
             gameInput.set(Keyboard::Key_F1, SlowDown);
@@ -410,6 +414,9 @@ class LogicDraw: public PaintownUtil::Logic, public PaintownUtil::Draw {
         unsigned int totalTicks;
         RunMatchOptions & options;
         bool show;
+        /* stage and HUD render time in microseconds since the fps was last shown */
+        unsigned long long renderTime;
+        unsigned long long hudTime;
         int showGameSpeed;
         
         EscapeMenu escapeMenu;
@@ -658,6 +665,11 @@ class LogicDraw: public PaintownUtil::Logic, public PaintownUtil::Draw {
                 if (Global::second_counter % 2 == 0){
                     if (show){
                         Global::debug(0) << "FPS: " << getFps() << std::endl;
+                        if (renderTime > 0){
+                            Global::debug(0) << "HUD: " << (hudTime * 100 / renderTime) << "% of stage render time" << std::endl;
+                        }
+                        renderTime = 0;
+                        hudTime = 0;
                         show = false;
                     }
                 } else {
@@ -665,21 +677,31 @@ class LogicDraw: public PaintownUtil::Logic, public PaintownUtil::Draw {
                 }
             }
 
+            TimeDifference render;
             if (stage->isZoomed()){
                 Graphics::Bitmap work(DEFAULT_WIDTH, DEFAULT_HEIGHT);
+                render.startTime();
                 stage->render(&work);
+                render.endTime();
                 // Global::debug(0) << "X1 " << stage->zoomX1() << " Y1 " << stage->zoomY1() << " X2 " << stage->zoomX2() << " Y2 " << stage->zoomY2() << std::endl;
                 work.Stretch(screen, stage->zoomX1(), stage->zoomY1(), stage->zoomX2() - stage->zoomX1(), stage->zoomY2() - stage->zoomY1(), 0, 0, screen.getWidth(), screen.getHeight());
             } else {
                 Graphics::StretchedBitmap work(DEFAULT_WIDTH, DEFAULT_HEIGHT, screen, Graphics::StretchedBitmap::NoClear, Graphics::qualityFilterName(::Configuration::getQualityFilter()));
                 work.start();
+                render.startTime();
                 stage->render(&work);
+                render.endTime();
                 options.draw(work);
                 work.finish();
             }
 
-            FontRender * render = FontRender::getInstance();
-            render->render(&screen);
+            if (show_fps){
+                renderTime += render.getMicroseconds();
+                hudTime += stage->getHudRenderTime();
+            }
+
+            FontRender * fonts = FontRender::getInstance();
+            fonts->render(&screen);
             console.draw(screen);
             if (showGameSpeed > 0){
                 const ::Font & font = ::Font::getDefaultFont(15, 15);
@@ -747,16 +769,29 @@ void Game::runMatch(Mugen::Stage * stage, const std::string & musicOverride, Run
 
         class CommandMemory: public Console::Command {
         public:
-            CommandMemory(){
+            CommandMemory(Mugen::Stage * stage):
+            stage(stage){
             }
 
+            Mugen::Stage * stage;
+
             string getDescription() const {
-                return "memory - current memory usage";
+                return "memory - current memory usage and what each player holds";
             }
 
             string act(const string & line){
                 ostringstream out;
                 out << "Memory usage: " << PaintownUtil::niceSize(System::memoryUsage()) << "\n";
+                out << "Parse cache: " << PaintownUtil::niceSize(ParseCache::getSize()) << "\n";
+                std::vector<Character*> players = stage->getPlayers();
+                for (std::vector<Character*>::iterator it = players.begin(); it != players.end(); it++){
+                    Character * player = *it;
+                    Character::MemoryUsage usage = player->getMemoryUsage();
+                    out << player->getDisplayName() << ": ast " << PaintownUtil::niceSize(usage.ast)
+                        << " states " << usage.states << " (" << usage.controllers << " controllers)"
+                        << " sprites " << PaintownUtil::niceSize(usage.sprites)
+                        << " sounds " << PaintownUtil::niceSize(usage.sounds) << "\n";
+                }
                 return out.str();
             }
         };
@@ -901,7 +936,7 @@ void Game::runMatch(Mugen::Stage * stage, const std::string & musicOverride, Run
         console.addCommand("quit", PaintownUtil::ReferenceCount<Console::Command>(new CommandQuit()));
         console.addAlias("exit", "quit");
         console.addCommand("help", PaintownUtil::ReferenceCount<Console::Command>(new CommandHelp(console)));
-        console.addCommand("memory", PaintownUtil::ReferenceCount<Console::Command>(new CommandMemory()));
+        console.addCommand("memory", PaintownUtil::ReferenceCount<Console::Command>(new CommandMemory(stage)));
         console.addCommand("kill", PaintownUtil::ReferenceCount<Console::Command>(new CommandKill(stage)));
         console.addCommand("record", PaintownUtil::ReferenceCount<Console::Command>(new CommandRecord(stage)));
         console.addCommand("debug", PaintownUtil::ReferenceCount<Console::Command>(new CommandDebug(stage)));
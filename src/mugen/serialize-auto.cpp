@@ -1144,6 +1144,161 @@ ReversalData deserializeReversalData(const Token * data){
 }
 
 
+Token * serialize(const TickData & data){
+    Token * out = new Token();
+    *out << "TickData";
+   *out->newToken() << "virtualx" << data.virtualx;
+   *out->newToken() << "virtualy" << data.virtualy;
+   *out->newToken() << "virtualz" << data.virtualz;
+   *out->newToken() << "velocity_x" << data.velocity_x;
+   *out->newToken() << "velocity_y" << data.velocity_y;
+   *out->newToken() << "health" << data.health;
+   *out->newToken() << "power" << data.power;
+   *out->newToken() << "defenseMultiplier" << data.defenseMultiplier;
+   *out->newToken() << "attackMultiplier" << data.attackMultiplier;
+   *out->newToken() << "drawAngle" << data.drawAngle;
+   *out->newToken() << "currentState" << data.currentState;
+   *out->newToken() << "previousState" << data.previousState;
+   *out->newToken() << "currentAnimation" << data.currentAnimation;
+   *out->newToken() << "stateTime" << data.stateTime;
+    *out->newToken() << "currentPhysics" << serialize(data.currentPhysics);
+    *out->newToken() << "facing" << serialize(data.facing);
+   *out->newToken() << "juggleRemaining" << data.juggleRemaining;
+   *out->newToken() << "currentJuggle" << data.currentJuggle;
+   *out->newToken() << "combo" << data.combo;
+   *out->newToken() << "hitCount" << data.hitCount;
+   *out->newToken() << "wasHitCounter" << data.wasHitCounter;
+   *out->newToken() << "pushPlayer" << data.pushPlayer;
+   *out->newToken() << "spritePriority" << data.spritePriority;
+   *out->newToken() << "has_control" << data.has_control;
+   *out->newToken() << "blocking" << data.blocking;
+   *out->newToken() << "guarding" << data.guarding;
+   *out->newToken() << "frozen" << data.frozen;
+   *out->newToken() << "reversalActive" << data.reversalActive;
+
+    return out;
+}
+
+TickData deserializeTickData(const Token * data){
+    TickData out;
+    const Token * use = NULL;
+    use = data->findToken("_/virtualx");
+    if (use != NULL){
+        use->view() >> out.virtualx;
+    }
+    use = data->findToken("_/virtualy");
+    if (use != NULL){
+        use->view() >> out.virtualy;
+    }
+    use = data->findToken("_/virtualz");
+    if (use != NULL){
+        use->view() >> out.virtualz;
+    }
+    use = data->findToken("_/velocity_x");
+    if (use != NULL){
+        use->view() >> out.velocity_x;
+    }
+    use = data->findToken("_/velocity_y");
+    if (use != NULL){
+        use->view() >> out.velocity_y;
+    }
+    use = data->findToken("_/health");
+    if (use != NULL){
+        use->view() >> out.health;
+    }
+    use = data->findToken("_/power");
+    if (use != NULL){
+        use->view() >> out.power;
+    }
+    use = data->findToken("_/defenseMultiplier");
+    if (use != NULL){
+        use->view() >> out.defenseMultiplier;
+    }
+    use = data->findToken("_/attackMultiplier");
+    if (use != NULL){
+        use->view() >> out.attackMultiplier;
+    }
+    use = data->findToken("_/drawAngle");
+    if (use != NULL){
+        use->view() >> out.drawAngle;
+    }
+    use = data->findToken("_/currentState");
+    if (use != NULL){
+        use->view() >> out.currentState;
+    }
+    use = data->findToken("_/previousState");
+    if (use != NULL){
+        use->view() >> out.previousState;
+    }
+    use = data->findToken("_/currentAnimation");
+    if (use != NULL){
+        use->view() >> out.currentAnimation;
+    }
+    use = data->findToken("_/stateTime");
+    if (use != NULL){
+        use->view() >> out.stateTime;
+    }
+    use = data->findToken("_/currentPhysics/PhysicsType");
+    if (use != NULL){
+        out.currentPhysics = deserializePhysicsType(use);
+    }
+    use = data->findToken("_/facing/Facing");
+    if (use != NULL){
+        out.facing = deserializeFacing(use);
+    }
+    use = data->findToken("_/juggleRemaining");
+    if (use != NULL){
+        use->view() >> out.juggleRemaining;
+    }
+    use = data->findToken("_/currentJuggle");
+    if (use != NULL){
+        use->view() >> out.currentJuggle;
+    }
+    use = data->findToken("_/combo");
+    if (use != NULL){
+        use->view() >> out.combo;
+    }
+    use = data->findToken("_/hitCount");
+    if (use != NULL){
+        use->view() >> out.hitCount;
+    }
+    use = data->findToken("_/wasHitCounter");
+    if (use != NULL){
+        use->view() >> out.wasHitCounter;
+    }
+    use = data->findToken("_/pushPlayer");
+    if (use != NULL){
+        use->view() >> out.pushPlayer;
+    }
+    use = data->findToken("_/spritePriority");
+    if (use != NULL){
+        use->view() >> out.spritePriority;
+    }
+    use = data->findToken("_/has_control");
+    if (use != NULL){
+        use->view() >> out.has_control;
+    }
+    use = data->findToken("_/blocking");
+    if (use != NULL){
+        use->view() >> out.blocking;
+    }
+    use = data->findToken("_/guarding");
+    if (use != NULL){
+        use->view() >> out.guarding;
+    }
+    use = data->findToken("_/frozen");
+    if (use != NULL){
+        use->view() >> out.frozen;
+    }
+    use = data->findToken("_/reversalActive");
+    if (use != NULL){
+        use->view() >> out.reversalActive;
+    }
+
+    return out;
+}
+
+
 
 Token * serialize(const WidthOverride & data){
     Token * out = new Token();
@@ -1395,15 +1550,6 @@ DrawAngleEffect deserializeDrawAngleEffect(const Token * data){
 Token * serialize(const StateData & data){
     Token * out = new Token();
     *out << "StateData";
-   *out->newToken() << "juggleRemaining" << data.juggleRemaining;
-   *out->newToken() << "currentJuggle" << data.currentJuggle;
-   *out->newToken() << "currentState" << data.currentState;
-   *out->newToken() << "previousState" << data.previousState;
-   *out->newToken() << "currentAnimation" << data.currentAnimation;
-   *out->newToken() << "velocity_x" << data.velocity_x;
-   *out->newToken() << "velocity_y" << data.velocity_y;
-   *out->newToken() << "has_control" << data.has_control;
-   *out->newToken() << "stateTime" << data.stateTime;
 
     Token * t1 = out->newToken();
     *t1 << "variables";
@@ -1422,27 +1568,16 @@ Token * serialize(const StateData & data){
     for (std::map<int, RuntimeValue >::const_iterator it = data.systemVariables.begin(); it != data.systemVariables.end(); it++){
         *t3->newToken() << "e" << serialize(it->first) << serialize(it->second);
     }
-        *out->newToken() << "currentPhysics" << serialize(data.currentPhysics);
-   *out->newToken() << "stateType" << data.stateType;   *out->newToken() << "moveType" << data.moveType;    *out->newToken() << "hit" << serialize(data.hit);
+       *out->newToken() << "stateType" << data.stateType;   *out->newToken() << "moveType" << data.moveType;    *out->newToken() << "hit" << serialize(data.hit);
     *out->newToken() << "hitState" << serialize(data.hitState);
-   *out->newToken() << "combo" << data.combo;
-   *out->newToken() << "hitCount" << data.hitCount;
-   *out->newToken() << "blocking" << data.blocking;
-   *out->newToken() << "guarding" << data.guarding;
     *out->newToken() << "widthOverride" << serialize(data.widthOverride);
     Token * token_hitByOverride = out->newToken();
     *token_hitByOverride << "hitByOverride";
     *token_hitByOverride->newToken() << 0 << serialize(data.hitByOverride[0]);
     *token_hitByOverride->newToken() << 1 << serialize(data.hitByOverride[1]);
-   *out->newToken() << "defenseMultiplier" << data.defenseMultiplier;
-   *out->newToken() << "attackMultiplier" << data.attackMultiplier;
-   *out->newToken() << "frozen" << data.frozen;
     *out->newToken() << "reversal" << serialize(data.reversal);
-   *out->newToken() << "reversalActive" << data.reversalActive;
     *out->newToken() << "transOverride" << serialize(data.transOverride);
-   *out->newToken() << "pushPlayer" << data.pushPlayer;
     *out->newToken() << "special" << serialize(data.special);
-   *out->newToken() << "health" << data.health;
     *out->newToken() << "bind" << serialize(data.bind);
 
     Token * t4 = out->newToken();
@@ -1450,10 +1585,7 @@ Token * serialize(const StateData & data){
     for (std::map<int, std::vector<CharacterId > >::const_iterator it = data.targets.begin(); it != data.targets.end(); it++){
         *t4->newToken() << "e" << serialize(it->first) << serialize(it->second);
     }
-       *out->newToken() << "spritePriority" << data.spritePriority;
-   *out->newToken() << "wasHitCounter" << data.wasHitCounter;
-    *out->newToken() << "characterData" << serialize(data.characterData);
-   *out->newToken() << "drawAngle" << data.drawAngle;
+        *out->newToken() << "characterData" << serialize(data.characterData);
     *out->newToken() << "drawAngleData" << serialize(data.drawAngleData);
 
     Token * t5 = out->newToken();
@@ -1467,12 +1599,7 @@ Token * serialize(const StateData & data){
     for (std::map<int, HitOverride >::const_iterator it = data.hitOverrides.begin(); it != data.hitOverrides.end(); it++){
         *t6->newToken() << "e" << serialize(it->first) << serialize(it->second);
     }
-       *out->newToken() << "virtualx" << data.virtualx;
-   *out->newToken() << "virtualy" << data.virtualy;
-   *out->newToken() << "virtualz" << data.virtualz;
-    *out->newToken() << "facing" << serialize(data.facing);
-   *out->newToken() << "power" << data.power;
-
+    
     Token * t7 = out->newToken();
     *t7 << "commandState";
     for (std::map<std::string, std::string >::const_iterator it = data.commandState.begin(); it != data.commandState.end(); it++){
@@ -1485,42 +1612,6 @@ Token * serialize(const StateData & data){
 StateData deserializeStateData(const Token * data){
     StateData out;
     const Token * use = NULL;
-    use = data->findToken("_/juggleRemaining");
-    if (use != NULL){
-        use->view() >> out.juggleRemaining;
-    }
-    use = data->findToken("_/currentJuggle");
-    if (use != NULL){
-        use->view() >> out.currentJuggle;
-    }
-    use = data->findToken("_/currentState");
-    if (use != NULL){
-        use->view() >> out.currentState;
-    }
-    use = data->findToken("_/previousState");
-    if (use != NULL){
-        use->view() >> out.previousState;
-    }
-    use = data->findToken("_/currentAnimation");
-    if (use != NULL){
-        use->view() >> out.currentAnimation;
-    }
-    use = data->findToken("_/velocity_x");
-    if (use != NULL){
-        use->view() >> out.velocity_x;
-    }
-    use = data->findToken("_/velocity_y");
-    if (use != NULL){
-        use->view() >> out.velocity_y;
-    }
-    use = data->findToken("_/has_control");
-    if (use != NULL){
-        use->view() >> out.has_control;
-    }
-    use = data->findToken("_/stateTime");
-    if (use != NULL){
-        use->view() >> out.stateTime;
-    }
     use = data->findToken("_/variables");
     if (use != NULL){
         for (TokenView view = use->view(); view.hasMore(); /**/){
@@ -1557,10 +1648,6 @@ StateData deserializeStateData(const Token * data){
         }
 
     }
-    use = data->findToken("_/currentPhysics/PhysicsType");
-    if (use != NULL){
-        out.currentPhysics = deserializePhysicsType(use);
-    }
     use = data->findToken("_/stateType");
     if (use != NULL){
         use->view() >> out.stateType;
@@ -1577,22 +1664,6 @@ StateData deserializeStateData(const Token * data){
     if (use != NULL){
         out.hitState = deserializeHitState(use);
     }
-    use = data->findToken("_/combo");
-    if (use != NULL){
-        use->view() >> out.combo;
-    }
-    use = data->findToken("_/hitCount");
-    if (use != NULL){
-        use->view() >> out.hitCount;
-    }
-    use = data->findToken("_/blocking");
-    if (use != NULL){
-        use->view() >> out.blocking;
-    }
-    use = data->findToken("_/guarding");
-    if (use != NULL){
-        use->view() >> out.guarding;
-    }
     use = data->findToken("_/widthOverride");
     if (use != NULL){
         const Token * child;
@@ -1602,47 +1673,23 @@ StateData deserializeStateData(const Token * data){
     use = data->findToken("_/hitByOverride");
     if (use != NULL){
         
-    }
-    use = data->findToken("_/defenseMultiplier");
-    if (use != NULL){
-        use->view() >> out.defenseMultiplier;
-    }
-    use = data->findToken("_/attackMultiplier");
-    if (use != NULL){
-        use->view() >> out.attackMultiplier;
-    }
-    use = data->findToken("_/frozen");
-    if (use != NULL){
-        use->view() >> out.frozen;
     }
     use = data->findToken("_/reversal/ReversalData");
     if (use != NULL){
         out.reversal = deserializeReversalData(use);
     }
-    use = data->findToken("_/reversalActive");
-    if (use != NULL){
-        use->view() >> out.reversalActive;
-    }
     use = data->findToken("_/transOverride");
     if (use != NULL){
         const Token * child;
         use->view() >> child;
         out.transOverride = deserializeTransOverride(child);
     }
-    use = data->findToken("_/pushPlayer");
-    if (use != NULL){
-        use->view() >> out.pushPlayer;
-    }
     use = data->findToken("_/special");
     if (use != NULL){
         const Token * child;
         use->view() >> child;
         out.special = deserializeSpecialStuff(child);
     }
-    use = data->findToken("_/health");
-    if (use != NULL){
-        use->view() >> out.health;
-    }
     use = data->findToken("_/bind");
     if (use != NULL){
         const Token * child;
@@ -1661,24 +1708,12 @@ StateData deserializeStateData(const Token * data){
         }
 
     }
-    use = data->findToken("_/spritePriority");
-    if (use != NULL){
-        use->view() >> out.spritePriority;
-    }
-    use = data->findToken("_/wasHitCounter");
-    if (use != NULL){
-        use->view() >> out.wasHitCounter;
-    }
     use = data->findToken("_/characterData");
     if (use != NULL){
         const Token * child;
         use->view() >> child;
         out.characterData = deserializeCharacterData(child);
     }
-    use = data->findToken("_/drawAngle");
-    if (use != NULL){
-        use->view() >> out.drawAngle;
-    }
     use = data->findToken("_/drawAngleData");
     if (use != NULL){
         const Token * child;
@@ -1707,26 +1742,6 @@ StateData deserializeStateData(const Token * data){
         }
 
     }
-    use = data->findToken("_/virtualx");
-    if (use != NULL){
-        use->view() >> out.virtualx;
-    }
-    use = data->findToken("_/virtualy");
-    if (use != NULL){
-        use->view() >> out.virtualy;
-    }
-    use = data->findToken("_/virtualz");
-    if (use != NULL){
-        use->view() >> out.virtualz;
-    }
-    use = data->findToken("_/facing/Facing");
-    if (use != NULL){
-        out.facing = deserializeFacing(use);
-    }
-    use = data->findToken("_/power");
-    if (use != NULL){
-        use->view() >> out.power;
-    }
     use = data->findToken("_/commandState");
     if (use != NULL){
         for (TokenView view = use->view(); view.hasMore(); /**/){
@@ -5,6 +5,7 @@
 #include "util/funcs.h"
 #include "util/pointer.h"
 #include "util/debug.h"
+#include "util/thread.h"
 #include <math.h>
 
 namespace PaintownUtil = ::Util;
@@ -35,10 +36,12 @@ pcx(NULL),
 width(0),
 height(0),
 loaded(false),
-defaultMask(mask){
+defaultMask(mask),
+scaledUses(0){
 }
 
-SpriteV1::SpriteV1(const SpriteV1 &copy){
+SpriteV1::SpriteV1(const SpriteV1 &copy):
+scaledUses(0){
     this->next = copy.next;
     this->location = copy.location;
     this->length = copy.length;
@@ -151,6 +154,10 @@ void SpriteV1::cleanup(){
 
     unmaskedBitmap = NULL;
     maskedBitmap = NULL;
+
+    for (int i = 0; i < ScaledCacheSize; i++){
+        scaledCache[i] = ScaledBitmap();
+    }
 }
 
 SpriteV1::~SpriteV1(){
@@ -227,20 +234,57 @@ static bool isScaled(const Mugen::Effects & effects){
            fabs(effects.scaley - 1) > epsilon;
 }
 
+static PAINTOWN_THREAD_LOCAL unsigned int scaledAllocations = 0;
+
+unsigned int SpriteV1::getScaledAllocations(){
+    return scaledAllocations;
+}
+
+/* Returns `source' stretched to width x height, reusing a previous stretch
+ * if there is one. The size is what the stretch depends on so any two
+ * scales that round to the same size share a slot.
+ */
+PaintownUtil::ReferenceCount<Graphics::Bitmap> SpriteV1::getScaledBitmap(const PaintownUtil::ReferenceCount<Graphics::Bitmap> & source, int width, int height){
+    scaledUses += 1;
+
+    ScaledBitmap * oldest = &scaledCache[0];
+    for (int i = 0; i < ScaledCacheSize; i++){
+        ScaledBitmap & slot = scaledCache[i];
+        if (slot.source == source && slot.width == width && slot.height == height && slot.scaled != NULL){
+            slot.lastUse = scaledUses;
+            return slot.scaled;
+        }
+
+        if (slot.lastUse < oldest->lastUse){
+            oldest = &slot;
+        }
+    }
+
+    // modImage = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(Graphics::Bitmap::temporaryBitmap((int) (use->getWidth() * effects.scalex), (int) (use->getHeight() * effects.scaley))));
+    PaintownUtil::ReferenceCount<Graphics::Bitmap> scaled(new Graphics::Bitmap(width, height));
+    source->Stretch(*(scaled.raw()));
+    scaledAllocations += 1;
+
+    oldest->source = source;
+    oldest->scaled = scaled;
+    oldest->width = width;
+    oldest->height = height;
+    oldest->lastUse = scaledUses;
+
+    return scaled;
+}
+
 PaintownUtil::ReferenceCount<Graphics::Bitmap> SpriteV1::getFinalBitmap(const Mugen::Effects & effects){
     PaintownUtil::ReferenceCount<Graphics::Bitmap> use = getBitmap(effects.mask);
     if (use == NULL){
         return use;
     }
 
-    PaintownUtil::ReferenceCount<Graphics::Bitmap> modImage = use;
     if (isScaled(effects)){
-        // modImage = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(Graphics::Bitmap::temporaryBitmap((int) (use->getWidth() * effects.scalex), (int) (use->getHeight() * effects.scaley))));
-        modImage = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap((int) (use->getWidth() * effects.scalex), (int) (use->getHeight() * effects.scaley)));
-        use->Stretch(*(modImage.raw()));
+        return getScaledBitmap(use, (int) (use->getWidth() * effects.scalex), (int) (use->getHeight() * effects.scaley));
     }
 
-    return modImage;
+    return use;
 }
 
 void SpriteV1::render(const int xaxis, const int yaxis, const Graphics::Bitmap &where, const Mugen::Effects &effects){
@@ -252,6 +296,7 @@ PaintownUtil::ReferenceCount<Graphics::Bitmap> SpriteV1::load(bool mask){
         PaintownUtil::ReferenceCount<Graphics::Bitmap> bitmap = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(Graphics::memoryPCX((unsigned char*) pcx, newlength), mask));
         if (mask){
             bitmap->replaceColor(bitmap->get8BitMaskColor(), Graphics::MaskColor());
+            bitmap->encodeMask();
         }
 
         return bitmap;
@@ -279,6 +324,7 @@ PaintownUtil::ReferenceCount<Graphics::Bitmap> SpriteV1::getBitmap(bool mask){
         if (unmaskedBitmap != NULL){
             maskedBitmap = PaintownUtil::ReferenceCount<Graphics::Bitmap>(new Graphics::Bitmap(*unmaskedBitmap, true));
             maskedBitmap->replaceColor(maskedBitmap->get8BitMaskColor(), Graphics::MaskColor());
+            maskedBitmap->encodeMask();
             return maskedBitmap;
         }
 
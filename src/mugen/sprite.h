@@ -108,6 +108,12 @@ class SpriteV1: public Sprite {
 	
         // static void draw(const Graphics::Bitmap &bmp, const int xaxis, const int yaxis, const int x, const int y, const Graphics::Bitmap &where, const Mugen::Effects &effects);
 
+        /* Number of scaled bitmaps created by any SpriteV1 on this thread.
+         * Take the difference between two frames to see how many bitmaps a
+         * frame allocated.
+         */
+        static unsigned int getScaledAllocations();
+
     protected:
         /* destroy allocated things */
         void cleanup();
@@ -143,6 +149,31 @@ class SpriteV1: public Sprite {
         /* Loaded with a palette that may not be our own */
         PaintownUtil::ReferenceCount<Graphics::Bitmap> unmaskedBitmap;
         PaintownUtil::ReferenceCount<Graphics::Bitmap> maskedBitmap;
+
+        /* Scaled copies of the bitmap, keyed by the size they were scaled
+         * to. A sprite is usually drawn at one or two scales so a few slots
+         * are enough, the least recently used slot is replaced.
+         */
+        struct ScaledBitmap{
+            ScaledBitmap():
+                width(0),
+                height(0),
+                lastUse(0){
+                }
+
+            /* the unscaled bitmap this came from */
+            PaintownUtil::ReferenceCount<Graphics::Bitmap> source;
+            PaintownUtil::ReferenceCount<Graphics::Bitmap> scaled;
+            int width;
+            int height;
+            unsigned int lastUse;
+        };
+
+        static const int ScaledCacheSize = 3;
+        ScaledBitmap scaledCache[ScaledCacheSize];
+        unsigned int scaledUses;
+
+        PaintownUtil::ReferenceCount<Graphics::Bitmap> getScaledBitmap(const PaintownUtil::ReferenceCount<Graphics::Bitmap> & source, int width, int height);
         
         void draw(const PaintownUtil::ReferenceCount<Graphics::Bitmap> &, const int xaxis, const int yaxis, const Graphics::Bitmap &, const Mugen::Effects &);
 };
@@ -36,6 +36,7 @@
 #include "util/timedifference.h"
 #include "character.h"
 #include "helper.h"
+#include "palette-filter.h"
 
 #include "parse-cache.h"
 #include "parser/all.h"
@@ -174,7 +175,9 @@ loaded(false),
 gameHUD(NULL),
 gameOver(false),
 objectId(0),
-replay(false){
+replay(false),
+projectileBroadphaseDirty(true),
+hudRenderTime(0){
     getStateData().gameRate = 1;
 }
 
@@ -683,12 +686,19 @@ void Mugen::Stage::moveCamera(const double x, const double y){
     }
 }
 
-static bool anyCollisions(const vector<Mugen::Area> & boxes1, int x1, int y1, const vector<Mugen::Area> & boxes2, int x2, int y2){
+static bool anyCollisions(const vector<Mugen::Area> & boxes1, int x1, int y1, const vector<Mugen::Area> & boxes2, int x2, int y2, Mugen::CollisionStatistics & statistics){
+    /* don't bother with the individual boxes if the boxes covering all of them miss */
+    if (!Mugen::Bounds(boxes1, x1, y1).overlaps(Mugen::Bounds(boxes2, x2, y2))){
+        statistics.pairsSkipped += 1;
+        return false;
+    }
 
+    statistics.pairsTested += 1;
     for (vector<Mugen::Area>::const_iterator attack_i = boxes1.begin(); attack_i != boxes1.end(); attack_i++){
         for (vector<Mugen::Area>::const_iterator defense_i = boxes2.begin(); defense_i != boxes2.end(); defense_i++){
             const Mugen::Area & attack = *attack_i;
             const Mugen::Area & defense = *defense_i;
+            statistics.boxTests += 1;
             if (attack.collision(x1, y1, defense, x2, y2)){
                 return true;
             }
@@ -699,13 +709,23 @@ static bool anyCollisions(const vector<Mugen::Area> & boxes1, int x1, int y1, co
 
 }
 
-static bool anyBlocking(const vector<Mugen::Area> & boxes1, int x1, int y1, int attackDist, const vector<Mugen::Area> & boxes2, int x2, int y2){
+static bool anyBlocking(const vector<Mugen::Area> & boxes1, int x1, int y1, int attackDist, const vector<Mugen::Area> & boxes2, int x2, int y2, Mugen::CollisionStatistics & statistics){
+    Mugen::Bounds defenseBounds(boxes2, x2, y2);
+    defenseBounds.x1 -= attackDist;
+    defenseBounds.x2 += attackDist;
+    if (!Mugen::Bounds(boxes1, x1, y1).overlaps(defenseBounds)){
+        statistics.pairsSkipped += 1;
+        return false;
+    }
+
+    statistics.pairsTested += 1;
     for (vector<Mugen::Area>::const_iterator attack_i = boxes1.begin(); attack_i != boxes1.end(); attack_i++){
         for (vector<Mugen::Area>::const_iterator defense_i = boxes2.begin(); defense_i != boxes2.end(); defense_i++){
             const Mugen::Area & attack = *attack_i;
             Mugen::Area defense = *defense_i;
 	    defense.x1 -= attackDist;
 	    defense.x2 += attackDist;
+            statistics.boxTests += 1;
             if (attack.collision(x1, y1, defense, x2, y2)){
                 return true;
             }
@@ -717,15 +737,15 @@ static bool anyBlocking(const vector<Mugen::Area> & boxes1, int x1, int y1, int
 
 bool Mugen::Stage::doBlockingDetection(Mugen::Character * obj1, Mugen::Character * obj2){
     // return anyBlocking(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), obj1->getAttackDistance(), obj2->getDefenseBoxes(), (int) obj2->getX(), (int) obj2->getY());
-    return anyBlocking(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), 0, obj2->getDefenseBoxes(), (int) obj2->getX(), (int) obj2->getY());
+    return anyBlocking(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), 0, obj2->getDefenseBoxes(), (int) obj2->getX(), (int) obj2->getY(), collisionStatistics);
 }
 
 bool Mugen::Stage::doCollisionDetection(Mugen::Character * obj1, Mugen::Character * obj2){
-    return anyCollisions(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), obj2->getDefenseBoxes(), (int) obj2->getX(), (int) obj2->getY());
+    return anyCollisions(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), obj2->getDefenseBoxes(), (int) obj2->getX(), (int) obj2->getY(), collisionStatistics);
 }
 
 bool Mugen::Stage::doReversalDetection(Mugen::Character * obj1, Mugen::Character * obj2){
-    return anyCollisions(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), obj2->getAttackBoxes(), (int) obj2->getX(), (int) obj2->getY());
+    return anyCollisions(obj1->getAttackBoxes(), (int) obj1->getX(), (int) obj1->getY(), obj2->getAttackBoxes(), (int) obj2->getX(), (int) obj2->getY(), collisionStatistics);
 }
     
 bool Mugen::Stage::replayEnabled() const {
@@ -763,8 +783,8 @@ void Mugen::Stage::addSpark(int x, int y, int sparkNumber, bool own, Character *
         return;
     }
     /* FIXME: sprite priority */
-    Mugen::Spark * spark = new Mugen::Spark(x, y, 0, PaintownUtil::ReferenceCount<Mugen::Animation>(sprite->copy()));
-    showSparks.push_back(spark);
+    Mugen::Spark * spark = new (objectPool) Mugen::Spark(x, y, 0, PaintownUtil::ReferenceCount<Mugen::Animation>(sprite->copy()));
+    addEffect(spark);
 }
 
 void Mugen::Stage::addSpark(int x, int y, const ResourceEffect & resource, const ResourceEffect & default_, Character * owner){
@@ -803,7 +823,8 @@ void Mugen::Stage::playSound(Character * owner, int group, int item, bool own){
 
 void Mugen::Stage::doProjectileCollision(Projectile * projectile, Character * mugen){
     if (anyCollisions(mugen->getDefenseBoxes(), (int) mugen->getX(), (int) mugen->getRY(),
-                      projectile->getAttackBoxes(), (int) projectile->getX(), (int) projectile->getY())){
+                      projectile->getAttackBoxes(), (int) projectile->getX(), (int) projectile->getY(),
+                      collisionStatistics)){
         projectile->doCollision(mugen, *this);
 
         Character * owner = getCharacter(projectile->getOwner());
@@ -838,7 +859,8 @@ void Mugen::Stage::doProjectileCollision(Projectile * projectile, Character * mu
 
 void Mugen::Stage::doProjectileToProjectileCollision(Projectile * mine, Projectile * his){
     if (anyCollisions(mine->getDefenseBoxes(), (int) mine->getX(), (int) mine->getY(),
-                      his->getAttackBoxes(), (int) his->getX(), (int) his->getY())){
+                      his->getAttackBoxes(), (int) his->getX(), (int) his->getY(),
+                      collisionStatistics)){
         if (mine->getPriority() > his->getPriority()){
             his->canceled(*this, mine);
         } else if (his->getPriority() > mine->getPriority()){
@@ -851,6 +873,40 @@ void Mugen::Stage::doProjectileToProjectileCollision(Projectile * mine, Projecti
     }
 }
 
+void Mugen::Stage::updateProjectileBroadphase(){
+    if (!projectileBroadphaseDirty){
+        return;
+    }
+
+    projectileAttacks.clear();
+    projectileBounds.clear();
+    for (unsigned int index = 0; index < projectiles.size(); index++){
+        Projectile * projectile = projectiles[index];
+        Bounds attack(projectile->getAttackBoxes(), (int) projectile->getX(), (int) projectile->getY());
+        Bounds both(projectile->getDefenseBoxes(), (int) projectile->getX(), (int) projectile->getY());
+        both.add(attack);
+        projectileAttacks.add(index, attack);
+        projectileBounds.add(index, both);
+    }
+
+    /* Each pair has to be checked both ways, the defense boxes of one against
+     * the attack boxes of the other, so both get the other as a neighbor.
+     */
+    vector<pair<int, int> > touching;
+    projectileBounds.pairs(touching);
+    projectileNeighbors.clear();
+    projectileNeighbors.resize(projectiles.size());
+    for (vector<pair<int, int> >::iterator it = touching.begin(); it != touching.end(); it++){
+        projectileNeighbors[it->first].push_back(it->second);
+        projectileNeighbors[it->second].push_back(it->first);
+    }
+    for (vector<vector<int> >::iterator it = projectileNeighbors.begin(); it != projectileNeighbors.end(); it++){
+        std::sort(it->begin(), it->end());
+    }
+
+    projectileBroadphaseDirty = false;
+}
+
 /* for helpers and players */
 void Mugen::Stage::physics(Character * mugen){
     // Z/Y offset
@@ -968,26 +1024,45 @@ void Mugen::Stage::physics(Character * mugen){
         }
     }
 
-    for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); it++){
-        Projectile * projectile = *it;
-        if (projectile->getOwner() != mugen->getId() && projectile->canCollide()){
-            doProjectileCollision(projectile, mugen);
-        }
+    if (projectiles.size() > 0){
+        updateProjectileBroadphase();
+        vector<int> touching;
+        projectileAttacks.query(Bounds(mugen->getDefenseBoxes(), (int) mugen->getX(), (int) mugen->getRY()), touching);
+        collisionStatistics.pairsSkipped += projectiles.size() - touching.size();
+        std::sort(touching.begin(), touching.end());
 
-        for (vector<Projectile*>::iterator it2 = projectiles.begin(); it2 != projectiles.end(); it2++){
-            Projectile * other = *it2;
-            /* I'm assuming that projectiles fired from the same character cant cancel each other */
-            /* FIXME: should we test to see if both projectiles can collide or will they
-             * cancel each other even if one has its miss time active?
-             */
-            if (other != projectile && other->getOwner() != projectile->getOwner()){
-                doProjectileToProjectileCollision(projectile, other);
+        /* Each projectile gets to hit the character and then cancel against
+         * the others before the next one is looked at, so a projectile can
+         * hit and be canceled in the same tick. Only the pairs whose bounds
+         * touch are checked. Projectiles don't move during physics and a hit
+         * or a cancel only takes a projectile's boxes away, so the bounds
+         * from the start of the tick still cover everything that can collide.
+         */
+        vector<int>::iterator hit = touching.begin();
+        for (unsigned int index = 0; index < projectileNeighbors.size(); index++){
+            Projectile * projectile = projectiles[index];
+            if (hit != touching.end() && *hit == (int) index){
+                hit++;
+                if (projectile->getOwner() != mugen->getId() && projectile->canCollide()){
+                    doProjectileCollision(projectile, mugen);
+                }
+            }
+
+            const vector<int> & neighbors = projectileNeighbors[index];
+            collisionStatistics.pairsSkipped += projectiles.size() - 1 - neighbors.size();
+            for (vector<int>::const_iterator it = neighbors.begin(); it != neighbors.end(); it++){
+                Projectile * other = projectiles[*it];
+                /* I'm assuming that projectiles fired from the same character cant cancel each other */
+                /* FIXME: should we test to see if both projectiles can collide or will they
+                 * cancel each other even if one has its miss time active?
+                 */
+                if (other->getOwner() != projectile->getOwner()){
+                    doProjectileToProjectileCollision(projectile, other);
+                }
             }
         }
     }
 
-    /* TODO: projectile collisions with other projectiles */
-
     // Check collisions
     for (vector<Mugen::Character*>::iterator enem = objects.begin(); enem != objects.end(); ++enem){
         Mugen::Character *enemy = *enem;
@@ -1002,7 +1077,8 @@ void Mugen::Stage::physics(Character * mugen){
                 // NOTE: if Push Check is disabled do not do this
                 if (mplayer->isPushable() && menemy->isPushable()){
                     while (anyCollisions(mplayer->getDefenseBoxes(), (int) mplayer->getX(), (int) mplayer->getY(),
-                                         menemy->getDefenseBoxes(), (int) menemy->getX(), (int) menemy->getY()) &&
+                                         menemy->getDefenseBoxes(), (int) menemy->getX(), (int) menemy->getY(),
+                                         collisionStatistics) &&
                            centerCollision(mplayer, menemy) &&
                            (fabs(enemy->getX() - mugen->getX()) < enemy->getWidth() + mugen->getWidth()) &&
                            mplayer->getY() < enemy->getHeight()){
@@ -1182,6 +1258,8 @@ bool Mugen::Stage::exists(CharacterId id){
 void Mugen::Stage::runCycle(){
     updateZoom();
 
+    collisionStatistics.reset();
+
     getStateData().screenBound.clear();
 
     if (paletteEffects.time > 0){
@@ -1194,31 +1272,41 @@ void Mugen::Stage::runCycle(){
         getStateData().quake_time--;
     }
 
-    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); /**/){ 
+    /* Live effects are moved down over the dead ones in a single pass so the
+     * draw order doesn't change and nothing is erased from the middle.
+     */
+    vector<Mugen::Effect*>::iterator aliveSpark = showSparks.begin();
+    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){ 
         Mugen::Effect * spark = *it;
         spark->logic();
 
         /* if the spark looped then kill it */
         if (spark->isDead()){
-            delete spark;
-            it = showSparks.erase(it);
+            destroyEffect(spark);
         } else {
-            it++;
+            *aliveSpark = spark;
+            aliveSpark++;
         }
     }
+    showSparks.erase(aliveSpark, showSparks.end());
 
     /* FIXME: Projectiles should not act during a pause or superpause */
-    for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); /**/){
+    vector<Projectile*>::iterator aliveProjectile = projectiles.begin();
+    for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); it++){
         Projectile * projectile = *it;
         projectile->logic(*this);
 
         if (projectile->isDead()){
             delete projectile;
-            it = projectiles.erase(it);
         } else {
-            it++;
+            *aliveProjectile = projectile;
+            aliveProjectile++;
         }
     }
+    projectiles.erase(aliveProjectile, projectiles.end());
+
+    /* projectiles moved so their bounds have to be recomputed */
+    projectileBroadphaseDirty = true;
 
     // implement some stuff before we actually begin the round then start the round
     if (!stageStart){
@@ -1369,155 +1457,8 @@ void Mugen::Stage::logic(){
 #endif
 }
 
-class PaletteShader: public Graphics::Bitmap::Filter {
-public:
-    PaletteShader(int time, int addRed, int addGreen, int addBlue, int multiplyRed, int multiplyGreen, int multiplyBlue, int sinRed, int sinGreen, int sinBlue, int period, int invert, int color):
-        time(time),
-        addRed(addRed),
-        addGreen(addGreen),
-        addBlue(addBlue),
-        multiplyRed(multiplyRed),
-        multiplyGreen(multiplyGreen),
-        multiplyBlue(multiplyBlue),
-        sinRed(sinRed),
-        sinGreen(sinGreen),
-        sinBlue(sinBlue),
-        period(period),
-        invert(invert),
-        color(color){
-        }
-
-    int time;
-    int addRed;
-    int addGreen;
-    int addBlue;
-    int multiplyRed;
-    int multiplyGreen;
-    int multiplyBlue;
-    int sinRed;
-    int sinGreen;
-    int sinBlue;
-    int period;
-    int invert;
-    int color;
-
-    mutable map<Graphics::Color, Graphics::Color> cache;
-
-    Graphics::Color doFilter(int red, int green, int blue) const {
-        int newRed = red;
-        int newGreen = green;
-        int newBlue = blue;
-
-        if (color < 255){
-            double greyRed = (1 - 0.299) * color / 255 + 0.299;
-            double greyGreen = (1 - 0.587) * color / 255 + 0.587;
-            double greyBlue = (1 - 0.114) * color / 255 + 0.114;
-            red = (int)(red * greyRed + 0.5 + 16);
-            green = (int)(green * greyGreen + 0.5 + 16);
-            blue = (int)(blue * greyBlue + 0.5 + 16);
-        }
-
-        if (invert){
-            red = 255 - red;
-            green = 255 - green;
-            blue = 255 - blue;
-        }
-
-        if (period > 0){
-            newRed = (red + addRed + sinRed * sin(2 * PaintownUtil::pi * time / period)) * multiplyRed / 256;
-            newGreen = (green + addGreen + sinGreen * sin(2 * PaintownUtil::pi * time / period)) * multiplyGreen / 256;
-            newBlue = (blue + addBlue + sinBlue * sin(2 * PaintownUtil::pi * time / period)) * multiplyBlue / 256;
-        } else {
-            newRed = (red + addRed) * multiplyRed / 256;
-            newGreen = (green + addGreen) * multiplyGreen / 256;
-            newBlue = (blue + addBlue) * multiplyBlue / 256;
-        }
-
-        if (newRed > 255){
-            newRed = 255;
-        }
-
-        if (newRed < 0){
-            newRed = 0;
-        }
-
-        if (newGreen > 255){
-            newGreen = 255;
-        }
-
-        if (newGreen < 0){
-            newGreen = 0;
-        }
-
-        if (newBlue > 255){
-            newBlue = 255;
-        }
-
-        if (newBlue < 0){
-            newBlue = 0;
-        }
-
-        return Graphics::makeColor(newRed, newGreen, newBlue);
-    }
-
-    /* FIXME: this was copied verbatim from character.cpp */
-    static PaintownUtil::ReferenceCount<Graphics::Shader> create(){
-        PaintownUtil::ReferenceCount<Graphics::Shader> out;
-
-#ifdef USE_ALLEGRO5
-        std::ostringstream vertex;
-        vertex << "#version 110\n";
-        vertex << Graphics::defaultVertexShader();
-        ALLEGRO_SHADER * a5shader = Graphics::create_shader(vertex.str(),
-                                                            Storage::readFile(Storage::instance().find(Filesystem::RelativePath("shaders/mugen-palette-effect.fragment.glsl"))));
-        out = PaintownUtil::ReferenceCount<Graphics::Shader>(new Graphics::Shader(a5shader));
-#endif
-
-        return out;
-    }
-
-    PaintownUtil::ReferenceCount<Graphics::Shader> shader;
-
-    PaintownUtil::ReferenceCount<Graphics::Shader> getShader(){
-        if (shader == NULL){
-            PaintownUtil::ReferenceCount<Graphics::ShaderManager> manager = Graphics::shaderManager.current();
-            /* This is the same shader name as the character palfx shader */
-            shader = manager->getShader("mugen-palfx", create);
-        }
-
-        return shader;
-    }
-
-    void setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & what){
-#ifdef USE_ALLEGRO5
-        Graphics::setShaderBool(shader->getShader(), "invert", invert > 0);
-        Graphics::setShaderInt(shader->getShader(), "time", time);
-        Graphics::setShaderInt(shader->getShader(), "period", period);
-        Graphics::setShaderFloat(shader->getShader(), "color", (float) color / 255.0);
-        Graphics::setShaderVec4(shader->getShader(), "add", (float) addRed / 255.0, (float) addGreen / 255.0, (float) addBlue / 255.0, 0);
-        Graphics::setShaderVec4(shader->getShader(), "multiply", (float) multiplyRed / 256.0, (float) multiplyGreen / 256.0, (float) multiplyBlue / 256.0, 0);
-        Graphics::setShaderVec4(shader->getShader(), "sin_", (float) sinRed / 255.0, (float) sinGreen / 255.0, (float) sinBlue / 255.0, 0);
-#endif
-
-    }
-
-    Graphics::Color filter(Graphics::Color pixel) const {
-
-        if (cache.find(pixel) != cache.end()){
-            return cache[pixel];
-        }
-
-        int red = Graphics::getRed(pixel);
-        int green = Graphics::getGreen(pixel);
-        int blue = Graphics::getBlue(pixel);
-        Graphics::Color out = doFilter(red, green, blue);
-        cache[pixel] = out;
-        return out;
-    }
-};
-
 void Mugen::Stage::drawBackgroundWithEffectsSide(int x, int y, const Graphics::Bitmap & board, void (Mugen::Background::*render) (int, int, const Graphics::Bitmap &, Graphics::Bitmap::Filter *)){
-    PaletteShader effects(paletteEffects.counter, paletteEffects.addRed,
+    PaletteFilter effects(paletteEffects.counter, paletteEffects.addRed,
                     paletteEffects.addGreen, paletteEffects.addBlue,
                     paletteEffects.multiplyRed, paletteEffects.multiplyGreen,
                     paletteEffects.multiplyBlue, paletteEffects.sinRed,
@@ -1553,15 +1494,39 @@ PaintownUtil::ReferenceCount<Mugen::World> Mugen::Stage::snapshotState(){
     }
 
     world->setStageData(getStateData());
-    world->setRandom(*Random::getState());
+    world->setRandom(random);
     world->setGameInfo(gameHUD->serialize());
 
     return world;
 }
     
+const Mugen::CollisionStatistics & Mugen::Stage::getCollisionStatistics() const {
+    return collisionStatistics;
+}
+
+unsigned long long Mugen::Stage::getHudRenderTime() const {
+    return hudRenderTime;
+}
+
+void Mugen::Stage::renderHud(const Mugen::Element::Layer & layer, Graphics::Bitmap * work){
+    TimeDifference diff;
+    diff.startTime();
+    gameHUD->render(layer, *work);
+    diff.endTime();
+    hudRenderTime += diff.getMicroseconds();
+}
+
+Mugen::Random & Mugen::Stage::getRandom() const {
+    return random;
+}
+
+void Mugen::Stage::setRandom(const Random & random){
+    this->random = random;
+}
+
 void Mugen::Stage::updateState(const Mugen::World & world){
     setStateData(world.getStageData());
-    Random::setState(world.getRandom());
+    random = world.getRandom();
     gameHUD->deserialize(world.getGameInfo());
 
     const map<CharacterId, AllCharacterData> & data = world.getCharacterData();
@@ -1569,6 +1534,7 @@ void Mugen::Stage::updateState(const Mugen::World & world){
         Mugen::Character * who = getCharacter(it->first);
         if (who != NULL){
             who->setStateData(it->second.character);
+            who->setTickData(it->second.tick);
             who->setCurrentAnimationState(it->second.animation);
             who->setStatePersistent(it->second.statePersistent);
         }
@@ -1587,55 +1553,33 @@ void Mugen::Stage::updateState(const Mugen::World & world){
     gameHUD->getRound().updatePlayerBehavior(*players[0], *players[1]);
 }
 
-/* Returns a sorted listed of sprite priorties */
-vector<int> Mugen::Stage::allSpritePriorities(){
-    vector<int> priorities;
+/* Collect everything that has a sprite priority and sort it. Within one
+ * priority characters come first, then effects, then projectiles, each in
+ * the order they are stored.
+ */
+void Mugen::Stage::buildDrawList(){
+    drawList.clear();
 
     for (vector<Mugen::Character*>::iterator it = objects.begin(); it != objects.end(); it++){
         Mugen::Character * object = *it;
-        priorities.push_back(object->getSpritePriority());
+        drawList.add(object->getSpritePriority(), object);
     }
 
-    for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); it++){
-        Projectile * projectile = *it;
-        priorities.push_back(projectile->getSpritePriority());
-    }
-        
     for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){
         Mugen::Effect * spark = *it;
-        priorities.push_back(spark->getSpritePriority());
+        drawList.add(spark->getSpritePriority(), spark);
     }
 
-    std::sort(priorities.begin(), priorities.end());
-    vector<int>::iterator newEnd = std::unique(priorities.begin(), priorities.end());
-    priorities.resize(newEnd - priorities.begin());
-
-    return priorities;
-}
-
-int Mugen::Stage::findMinimumSpritePriority(){
-    vector<int> priorities = allSpritePriorities();
-    std::sort(priorities.begin(), priorities.end());
-
-    if (priorities.size() > 0){
-        return priorities[0];
-    }
-
-    return 0;
-}
-
-int Mugen::Stage::findMaximumSpritePriority(){
-    vector<int> priorities = allSpritePriorities();
-    std::sort(priorities.begin(), priorities.end());
-
-    if (priorities.size() > 0){
-        return priorities[priorities.size() - 1];
+    for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); it++){
+        Projectile * projectile = *it;
+        drawList.add(projectile->getSpritePriority(), projectile);
     }
 
-    return 0;
+    drawList.sort();
 }
 
 void Mugen::Stage::render(Graphics::Bitmap *work){
+    hudRenderTime = 0;
 
     if (getStateData().environmentColor.time == 0){
         if (paletteEffects.time > 0){
@@ -1658,23 +1602,16 @@ void Mugen::Stage::render(Graphics::Bitmap *work){
     }
 
     //! Render layer 0 HUD
-    gameHUD->render(Mugen::Element::Background, *work);
+    renderHud(Mugen::Element::Background, work);
 
-    /* FIXME: this is a hack to deal with sprite priorities. Really we should get all
-     * the drawable objects and sort them.
-     */
-    /*
-    int minumumSpritePriority = findMinimumSpritePriority();
-    int maximumSpritePriority = findMaximumSpritePriority();
-    */
+    buildDrawList();
+    for (unsigned int index = 0; index < drawList.size(); index++){
+        const DrawList::Item & item = drawList[index];
+        switch (item.type){
+            case DrawList::DrawCharacter: {
+                /* Players go in here */
+                Mugen::Character * obj = item.character;
 
-    vector<int> priorities = allSpritePriorities();
-    for (vector<int>::iterator spritePriority = priorities.begin(); spritePriority != priorities.end(); spritePriority++){
-        // Players go in here
-        for (vector<Mugen::Character*>::iterator it = objects.begin(); it != objects.end(); it++){
-            Mugen::Character *obj = *it;
-
-            if (obj->getSpritePriority() == *spritePriority){
                 /* Reflection */
                 /* FIXME: reflection and shade need camerax/y */
                 if (reflectionIntensity > 0){
@@ -1686,23 +1623,17 @@ void Mugen::Stage::render(Graphics::Bitmap *work){
 
                 /* draw the player */
                 obj->draw(work, (int)(getStateData().camerax - DEFAULT_WIDTH / 2), (int) getStateData().cameray);
+                break;
             }
-        }
-
-        for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){
-            Mugen::Effect * spark = *it;
-            if (spark->getSpritePriority() == *spritePriority){
-                spark->draw(*work, (int) (getStateData().camerax - DEFAULT_WIDTH / 2), (int) getStateData().cameray);
+            case DrawList::DrawEffect: {
+                item.effect->draw(*work, (int) (getStateData().camerax - DEFAULT_WIDTH / 2), (int) getStateData().cameray);
+                break;
             }
-        }
-
-        for (vector<Projectile*>::iterator it = projectiles.begin(); it != projectiles.end(); it++){
-            Projectile * projectile = *it;
-            if (projectile->getSpritePriority() == *spritePriority){
-                projectile->draw(*work, getStateData().camerax - DEFAULT_WIDTH / 2, getStateData().cameray);
+            case DrawList::DrawProjectile: {
+                item.projectile->draw(*work, getStateData().camerax - DEFAULT_WIDTH / 2, getStateData().cameray);
+                break;
             }
         }
-
     }
 
     if (getStateData().environmentColor.time > 0 && !getStateData().environmentColor.under){
@@ -1710,7 +1641,7 @@ void Mugen::Stage::render(Graphics::Bitmap *work){
     }
 
     //! Render layer 1 HUD
-    gameHUD->render(Mugen::Element::Foreground, *work);
+    renderHud(Mugen::Element::Foreground, work);
 
     if (getStateData().environmentColor.time == 0){
         if (paletteEffects.time > 0){
@@ -1721,7 +1652,7 @@ void Mugen::Stage::render(Graphics::Bitmap *work){
     }
     
     //! Render layer 2 HUD
-    gameHUD->render(Mugen::Element::Top, *work);
+    renderHud(Mugen::Element::Top, work);
 
     // Player debug
     for (vector<Mugen::Character*>::iterator it = objects.begin(); it != objects.end(); it++){
@@ -2048,6 +1979,8 @@ void Mugen::Stage::cleanup(){
             delete *it;
         }
         showSparks.clear();
+        effectHandles.clear();
+        effectsByOwner.clear();
 /*
         for (map<unsigned int, map<unsigned int, Mugen::Sound*> >::iterator it1 = sounds.begin(); it1 != sounds.end(); it1++){
             map<unsigned int, Mugen::Sound*> & group = (*it1).second;
@@ -2062,6 +1995,7 @@ void Mugen::Stage::cleanup(){
             delete *it;
         }
         projectiles.clear();
+        projectileBroadphaseDirty = true;
 
         for (vector<Mugen::Character*>::iterator it = objects.begin(); it != objects.end(); /**/){
             Mugen::Character * object = *it;
@@ -2129,6 +2063,7 @@ int Mugen::Stage::maximumDown() const {
     
 void Mugen::Stage::addProjectile(Projectile * projectile){
     projectiles.push_back(projectile);
+    projectileBroadphaseDirty = true;
 }
 
 void Mugen::Stage::updatePlayer(Mugen::Character * player){
@@ -2534,8 +2469,47 @@ void Mugen::Stage::createDust(int x, int y){
     addSpark(x, y, 120, false, NULL);
 }
         
+Mugen::ObjectPool & Mugen::Stage::getObjectPool(){
+    return objectPool;
+}
+
 void Mugen::Stage::addEffect(Mugen::Effect * effect){
+    effect->setHandle(effectHandles.add(effect));
     showSparks.push_back(effect);
+    if (effect->getOwner() != NULL){
+        effectsByOwner[effect->getOwner()].push_back(effect->getHandle());
+    }
+}
+
+void Mugen::Stage::destroyEffect(Mugen::Effect * effect){
+    effectHandles.remove(effect->getHandle());
+    delete effect;
+}
+
+const vector<Mugen::Handle> & Mugen::Stage::ownerEffects(const Mugen::Character * owner) const {
+    static const vector<Handle> none;
+    map<const Character*, vector<Handle> >::iterator found = effectsByOwner.find(owner);
+    if (found == effectsByOwner.end()){
+        return none;
+    }
+
+    /* drop handles of effects that have died since the last lookup */
+    vector<Handle> & handles = found->second;
+    vector<Handle>::iterator alive = handles.begin();
+    for (vector<Handle>::iterator it = handles.begin(); it != handles.end(); it++){
+        if (effectHandles.get(*it) != NULL){
+            *alive = *it;
+            alive++;
+        }
+    }
+    handles.erase(alive, handles.end());
+
+    if (handles.size() == 0){
+        effectsByOwner.erase(found);
+        return none;
+    }
+
+    return handles;
 }
 
 int Mugen::Stage::countMyHelpers(const Mugen::Character * owner) const {
@@ -2602,15 +2576,39 @@ void Mugen::Stage::removeHelper(Mugen::Character * who){
 }
 
 void Mugen::Stage::removeEffects(const Mugen::Character * owner, int id){
-    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); /**/ ){ 
+    vector<Effect*> removed;
+    const vector<Handle> & handles = ownerEffects(owner);
+    for (vector<Handle>::const_iterator it = handles.begin(); it != handles.end(); it++){
+        Effect * effect = effectHandles.get(*it);
+        if (id == -1 || id == effect->getId()){
+            effectHandles.remove(*it);
+            removed.push_back(effect);
+        }
+    }
+
+    if (removed.size() == 0){
+        return;
+    }
+
+    /* the handles of the removed effects are no longer valid, so this just
+     * drops them from the owner's list
+     */
+    ownerEffects(owner);
+
+    std::sort(removed.begin(), removed.end());
+    vector<Mugen::Effect*>::iterator alive = showSparks.begin();
+    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){ 
         Mugen::Effect * effect = *it;
-        if (effect->getOwner() == owner && (id == -1 || id == effect->getId())){
-            delete effect;
-            it = showSparks.erase(it);
-        } else {
-            it++;
+        if (!std::binary_search(removed.begin(), removed.end(), effect)){
+            *alive = effect;
+            alive++;
         }
     }
+    showSparks.erase(alive, showSparks.end());
+
+    for (vector<Effect*>::iterator it = removed.begin(); it != removed.end(); it++){
+        delete *it;
+    }
 }
 
 Mugen::Character * Mugen::Stage::getCharacter(const CharacterId & id) const {
@@ -2626,9 +2624,10 @@ Mugen::Character * Mugen::Stage::getCharacter(const CharacterId & id) const {
 std::vector<Mugen::Effect*> Mugen::Stage::findExplode(int id, const Character * owner) const {
     vector<Effect*> found;
 
-    for (vector<Effect*>::const_iterator it = showSparks.begin(); it != showSparks.end(); it++){
-        Effect * effect = *it;
-        if ((id == 0 || effect->getId() == id) && effect->getOwner() == owner){
+    const vector<Handle> & handles = ownerEffects(owner);
+    for (vector<Handle>::const_iterator it = handles.begin(); it != handles.end(); it++){
+        Effect * effect = effectHandles.get(*it);
+        if (id == 0 || effect->getId() == id){
             found.push_back(effect);
         }
     }
@@ -2636,6 +2635,22 @@ std::vector<Mugen::Effect*> Mugen::Stage::findExplode(int id, const Character *
     return found;
 }
 
+int Mugen::Stage::countExplods(int id, const Character * owner) const {
+    const vector<Handle> & handles = ownerEffects(owner);
+    if (id == 0){
+        return handles.size();
+    }
+
+    int count = 0;
+    for (vector<Handle>::const_iterator it = handles.begin(); it != handles.end(); it++){
+        if (effectHandles.get(*it)->getId() == id){
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
 vector<Mugen::Projectile*> Mugen::Stage::findProjectile(int id, const Character * owner) const {
     vector<Projectile*> found;
 
@@ -2701,9 +2716,10 @@ vector<Mugen::Helper*> Mugen::Stage::findHelpers(const Mugen::Character * owner)
 }
     
 Mugen::Effect * Mugen::Stage::findEffect(const Mugen::Character * owner, int id){
-    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){ 
-        Mugen::Effect * effect = *it;
-        if (effect->getOwner() == owner && id == effect->getId()){
+    const vector<Handle> & handles = ownerEffects(owner);
+    for (vector<Handle>::const_iterator it = handles.begin(); it != handles.end(); it++){
+        Mugen::Effect * effect = effectHandles.get(*it);
+        if (id == effect->getId()){
             return effect;
         }
     }
@@ -2713,9 +2729,10 @@ Mugen::Effect * Mugen::Stage::findEffect(const Mugen::Character * owner, int id)
 
 vector<Mugen::Effect *> Mugen::Stage::findEffects(const Mugen::Character * owner, int id){
     vector<Mugen::Effect*> effects;
-    for (vector<Mugen::Effect*>::iterator it = showSparks.begin(); it != showSparks.end(); it++){ 
-        Mugen::Effect * effect = *it;
-        if (effect->getOwner() == owner && (id == effect->getId() || id == -1)){
+    const vector<Handle> & handles = ownerEffects(owner);
+    for (vector<Handle>::const_iterator it = handles.begin(); it != handles.end(); it++){
+        Mugen::Effect * effect = effectHandles.get(*it);
+        if (id == effect->getId() || id == -1){
             effects.push_back(effect);
         }
     }
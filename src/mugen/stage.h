@@ -11,6 +11,10 @@
 #include "util/graphics/bitmap.h"
 #include "common.h"
 #include "stage-state.h"
+#include "random.h"
+#include "broadphase.h"
+#include "pool.h"
+#include "draw-list.h"
 
 namespace Graphics{
 class Bitmap;
@@ -183,6 +187,18 @@ public:
     virtual PaintownUtil::ReferenceCount<World> snapshotState();
     virtual void updateState(const World & world);
 
+    /* The random stream used by triggers, controllers and the AI. It belongs
+     * to the stage so that separate matches can run on separate threads.
+     */
+    virtual Random & getRandom() const;
+    virtual void setRandom(const Random & random);
+
+    /* Collision counters for the last tick */
+    virtual const CollisionStatistics & getCollisionStatistics() const;
+
+    /* Microseconds spent drawing the fight HUD in the last render */
+    virtual unsigned long long getHudRenderTime() const;
+
     // Inherited world actions
     virtual void draw(Graphics::Bitmap * work);
     virtual void addObject(Character * o);
@@ -226,6 +242,11 @@ public:
     /* get an animation from fightfx.sff */
     virtual PaintownUtil::ReferenceCount<Animation> getFightAnimation(int id);
 
+    /* Explods, sparks and projectiles should be allocated from here, as in
+     * `new (stage.getObjectPool()) Projectile(...)'. The stage deletes them.
+     */
+    virtual ObjectPool & getObjectPool();
+
     virtual void addProjectile(Projectile * projectile);
     virtual void addEffect(Effect * effect);
     virtual void removeEffects(const Character * owner, int id);
@@ -233,6 +254,8 @@ public:
     virtual int countMyHelpers(const Character * owner) const;
     virtual std::vector<Projectile*> findProjectile(int id, const Character * owner) const;
     virtual std::vector<Effect*> findExplode(int id, const Character * owner) const;
+    /* same as findExplode(id, owner).size() */
+    virtual int countExplods(int id, const Character * owner) const;
     virtual std::vector<Helper*> findHelpers(const Character * owner) const;
     virtual std::vector<Helper*> findHelpers(const Character * owner, int id) const;
     virtual Effect * findEffect(const Character * owner, int id);
@@ -369,10 +392,9 @@ protected:
     void playSound(Character * owner, int group, int item, bool own);
     void doProjectileCollision(Projectile * projectile, Character * mugen);
     void doProjectileToProjectileCollision(Projectile * mine, Projectile * his);
+    void updateProjectileBroadphase();
 
-    int findMaximumSpritePriority();
-    int findMinimumSpritePriority();
-    std::vector<int> allSpritePriorities();
+    void buildDrawList();
 
     std::vector<Character*> getOpponents(Object * who);
 
@@ -620,6 +642,9 @@ private:
 
     void cleanup();
 
+    /* declared before anything allocated from it */
+    ObjectPool objectPool;
+
     std::vector<Projectile*> projectiles;
 
     std::vector<Character*> objects;
@@ -649,8 +674,21 @@ private:
 
     SpriteMap effects;
     std::map<int, PaintownUtil::ReferenceCount<Animation> > sparks;
+    /* in the order they were added, which is also the draw order */
     std::vector<Effect*> showSparks;
 
+    /* Effects by owner for removeEffects and the numexplod trigger. Entries
+     * for effects that went away on their own are dropped the next time the
+     * owner is looked up.
+     */
+    HandleTable<Effect> effectHandles;
+    mutable std::map<const Character*, std::vector<Handle> > effectsByOwner;
+    const std::vector<Handle> & ownerEffects(const Character * owner) const;
+    void destroyEffect(Effect * effect);
+
+    /* refilled every frame by buildDrawList */
+    DrawList drawList;
+
     // Character huds
     GameInfo *gameHUD;
 
@@ -666,6 +704,23 @@ private:
     PaintownUtil::ReferenceCount<StageObserver> observer;
     /* true if doing in-game replay */
     bool replay;
+
+    /* mutable because triggers only get a const Stage but still draw numbers */
+    mutable Random random;
+
+    /* Projectile bounds, indexed the same as `projectiles'. Rebuilt once per
+     * tick or when a projectile is added.
+     */
+    SweepAndPrune projectileAttacks;
+    SweepAndPrune projectileBounds;
+    /* for each projectile, the others whose bounds touch its bounds */
+    std::vector<std::vector<int> > projectileNeighbors;
+    bool projectileBroadphaseDirty;
+
+    CollisionStatistics collisionStatistics;
+
+    void renderHud(const Mugen::Element::Layer & layer, Graphics::Bitmap * work);
+    unsigned long long hudRenderTime;
 };
 
 }
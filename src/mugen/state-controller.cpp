@@ -1147,7 +1147,7 @@ public:
                     vector<CharacterId> & objects = it->second;
                     if (objects.size() > 0){
                         /* Save a random object */
-                        CharacterId save = objects[Mugen::random(objects.size())];
+                        CharacterId save = objects[Mugen::random(stage.getRandom(), objects.size())];
                         objects.clear();
                         objects.push_back(save);
                     }
@@ -4566,8 +4566,8 @@ private:
 #define evaluateNumber(value, default_) (value != NULL ? value->evaluate(env).toNumber() : default_)
         int animation_value = (int) evaluateNumber(this->animation, -1);
         int id_value = (int) evaluateNumber(id, -1);
-        double posX_value = evaluateNumber(posX, 0) + Mugen::random(randomX) - randomX / 2;
-        double posY_value = evaluateNumber(posY, 0) + Mugen::random(randomY) - randomY / 2;
+        double posX_value = evaluateNumber(posX, 0) + Mugen::random(stage.getRandom(), randomX) - randomX / 2;
+        double posY_value = evaluateNumber(posY, 0) + Mugen::random(stage.getRandom(), randomY) - randomY / 2;
         double velocityX_value = evaluateNumber(velocityX, 0);
         double velocityY_value = evaluateNumber(velocityY, 0);
         double accelerationX_value = evaluateNumber(accelerationX, 0);
@@ -4621,7 +4621,7 @@ private:
 
         /* FIXME: handle rest of the explod parameters
          */
-        ExplodeEffect * effect = new ExplodeEffect(&guy, stage, animation, id_value, x, y, velocityX_value, velocityY_value, accelerationX_value, accelerationY_value, removeTime_value, bindTime_value, positionType, posX_value, posY_value, scaleX, scaleY, spritePriority_value, superMove, superMoveTime, horizontalFlip, verticalFlip, ownPalette, removeOnHit);
+        ExplodeEffect * effect = new (stage.getObjectPool()) ExplodeEffect(&guy, stage, animation, id_value, x, y, velocityX_value, velocityY_value, accelerationX_value, accelerationY_value, removeTime_value, bindTime_value, positionType, posX_value, posY_value, scaleX, scaleY, spritePriority_value, superMove, superMoveTime, horizontalFlip, verticalFlip, ownPalette, removeOnHit);
         stage.addEffect(effect);
     }
 
@@ -4688,8 +4688,8 @@ public:
         int y = (int)(evaluateNumber(posY, environment, 0) + guy.getRY());
 
         int random = evaluateNumber(this->random, environment, 0);
-        x += Mugen::random(random) - random / 2;
-        y += Mugen::random(random) - random / 2;
+        x += Mugen::random(stage.getRandom(), random) - random / 2;
+        y += Mugen::random(stage.getRandom(), random) - random / 2;
 
         PaintownUtil::ReferenceCount<Animation> animation;
         animation = stage.getFightAnimation(animation_value);
@@ -4707,7 +4707,7 @@ public:
             }
         };
 
-        stage.addEffect(new GameAnimation(animation, x, y));
+        stage.addEffect(new (stage.getObjectPool()) GameAnimation(animation, x, y));
     }
 
     StateController * deepCopy() const {
@@ -5233,7 +5233,7 @@ public:
         int index = (int) evaluateNumber(this->index, environment, 0);
         int minimum = (int) evaluateNumber(this->minimum, environment, 0);
         int maximum = (int) evaluateNumber(this->maximum, environment, 0);
-        guy.setVariable(index, RuntimeValue((int) Mugen::random(minimum, maximum)));
+        guy.setVariable(index, RuntimeValue((int) Mugen::random(stage.getRandom(), minimum, maximum)));
     }
 
     StateController * deepCopy() const {
@@ -7599,7 +7599,7 @@ public:
         }
 
         /* FIXME: we have to cast the root to a non-const Character* */
-        stage.addProjectile(new Mugen::Projectile(x, y, id, (Character*) stage.getCharacter(guy.getRoot()), animation, hitAnimation, dieAnimation,
+        stage.addProjectile(new (stage.getObjectPool()) Mugen::Projectile(x, y, id, (Character*) stage.getCharacter(guy.getRoot()), animation, hitAnimation, dieAnimation,
                                            cancelAnimation, scaleX, scaleY, autoRemove, removeTime, 
                                            velocityX, velocityY, removeVelocityX, removeVelocityY,
                                            accelerateX, accelerateY, velocityXMultipler, 
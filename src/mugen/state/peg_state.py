@@ -0,0 +1,1917 @@
+
+import peg
+
+
+
+
+
+def special_escape(s):
+    return s.replace("\\n", "\\\\n").replace("\\t", "\\\\t").replace("\"", '\\\"').replace("\\r", "\\\\r")
+
+class PegError(Exception):
+    def __init__(self):
+        Exception.__init__(self)
+
+class NotError(Exception):
+    def __init__(self):
+        Exception.__init__(self)
+
+class Result:
+    def __init__(self, position):
+        self.position = position
+        self.values = []
+
+    def getPosition(self):
+        return self.position
+
+    def nextPosition(self, amount = 1):
+        self.position += amount
+
+    def setValue(self, value):
+        self.values = value
+
+    def getLastValue(self):
+        if type(self.values) is list:
+            if len(self.values) > 0:
+                return self.values[-1]
+            else:
+                return None
+        return self.values
+    
+    def matches(self):
+        return len(self.values)
+
+    def getValues(self):
+        return self.values
+
+    def addResult(self, him):
+        self.values.append(him.values)
+        self.position = him.position
+    
+    #def extendResult(self, him):
+    #    self.values.extend(him.values)
+    #    self.position = him.position
+
+class Stream:
+    def __init__(self, filename = None, input = None):
+        def read():
+            file = open(filename, 'r')
+            out = file.read()
+            file.close()
+            return out
+        self.position = 0
+        self.limit = 100
+        self.furthest = 0
+        self.memo = {}
+        if filename != None:
+            self.all = read()
+        elif input != None:
+            self.all = input
+        else:
+            raise PegError("Pass a filename or input")
+        # print "Read " + str(len(self.all))
+
+    def get(self, position, number = 1):
+        if position + number > self.limit:
+            # print (position + number)
+            self.limit += 5000
+        if position + number > len(self.all):
+            return chr(0)
+        # print "stream: %s" % self.all[position:position+number]
+        return self.all[position:position+number]
+
+    def get2(self, position):
+        if position != self.position:
+            self.file.seek(position)
+        self.position = position + 1
+        if position > self.limit:
+            print position
+            self.limit += 5000
+        return self.file.read(1)
+
+    def reportError(self):
+        line = 1
+        column = 1
+        for i in xrange(0, self.furthest):
+            if self.all[i] == '\n':
+                line += 1
+                column = 1
+            else:
+                column += 1
+        context = 10
+        left = self.furthest - context
+        right = self.furthest + context
+        if left < 0:
+            left = 0
+        if right > len(self.all):
+            right = len(self.all)
+        out = "Read up till line %d, column %d" % (line, column)
+        out += "\n"
+        out += "'%s'" % special_escape(self.all[left:right])
+        out += "\n"
+        out += "%s^" % (' ' * (self.furthest - left))
+        return out
+
+    def update(self, rule, position, result):
+        if result != None and result.getPosition() > self.furthest:
+            self.furthest = result.getPosition()
+
+        for_rule = None
+        try:
+            for_rule = self.memo[rule]
+        except KeyError:
+            self.memo[rule] = {}
+            for_rule = self.memo[rule]
+        
+        for_position = None
+        try:
+            for_position = for_rule[position]
+        except KeyError:
+            for_rule[position] = None
+
+        for_rule[position] = result
+
+    def hasResult(self, rule, position):
+        try:
+            x = self.memo[rule][position]
+            return True
+        except KeyError:
+            return False
+
+    def result(self, rule, position):
+        return self.memo[rule][position]
+
+
+
+RULE_start = 0
+RULE_structs = 1
+RULE_include = 2
+RULE_include__string = 3
+RULE_string = 4
+RULE_namespace = 5
+RULE_struct = 6
+RULE_identifier = 7
+RULE_letter = 8
+RULE_digit = 9
+RULE_number = 10
+RULE_letter_digit = 11
+RULE_array = 12
+RULE_field = 13
+RULE_type__modifier = 14
+RULE_type__identifier = 15
+RULE_template = 16
+RULE_newline = 17
+RULE_s = 18
+RULE_comment = 19
+RULE_inner__comment = 20
+
+
+import state    
+
+
+
+def rule_start(stream, position):
+    if stream.hasResult(RULE_start, position):
+        return stream.result(RULE_start, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_3 = Result(result_peg_2.getPosition());
+                # print "Trying rule " + 'include'
+                result_peg_3 = rule_include(stream, result_peg_3.getPosition())
+                if result_peg_3 == None:
+                    raise PegError
+                result_peg_2.addResult(result_peg_3);
+        except PegError:
+            pass
+        includes = result_peg_2.getValues()
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_4 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'namespace'
+        result_peg_4 = rule_namespace(stream, result_peg_4.getPosition())
+        if result_peg_4 == None:
+            raise PegError
+        name = result_peg_4.getValues()
+        
+        result_peg_1.addResult(result_peg_4);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_6 = Result(result_peg_5.getPosition());
+                result_peg_7 = Result(result_peg_6.getPosition())
+                
+                result_peg_8 = Result(result_peg_7.getPosition());
+                try:
+                    if '\n' == stream.get(result_peg_8.getPosition(), 1):
+                        result_peg_8.nextPosition(1)
+                        result_peg_8.setValue('\n')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_7.setValue(None)
+                        
+                result_peg_6.addResult(result_peg_7);
+                
+                result_peg_9 = Result(result_peg_6.getPosition())
+                
+                temp_peg_10 = stream.get(result_peg_9.getPosition())
+                if temp_peg_10 != chr(0):
+                    result_peg_9.setValue(temp_peg_10)
+                    result_peg_9.nextPosition()
+                else:
+                    raise PegError
+                
+                result_peg_6.addResult(result_peg_9);
+                
+                result_peg_6.setValue(result_peg_6.getLastValue())
+                result_peg_5.addResult(result_peg_6);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_11 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'newline'
+        result_peg_11 = rule_newline(stream, result_peg_11.getPosition())
+        if result_peg_11 == None:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_11);
+        
+        result_peg_12 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_13 = Result(result_peg_12.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_13 = rule_s(stream, result_peg_13.getPosition())
+                if result_peg_13 == None:
+                    raise PegError
+                result_peg_12.addResult(result_peg_13);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_12);
+        
+        result_peg_14 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'structs'
+        result_peg_14 = rule_structs(stream, result_peg_14.getPosition())
+        if result_peg_14 == None:
+            raise PegError
+        objs = result_peg_14.getValues()
+        
+        result_peg_1.addResult(result_peg_14);
+        
+        result_peg_15 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_16 = Result(result_peg_15.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_16 = rule_s(stream, result_peg_16.getPosition())
+                if result_peg_16 == None:
+                    raise PegError
+                result_peg_15.addResult(result_peg_16);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_15);
+        
+        result_peg_17 = Result(result_peg_1.getPosition())
+        
+        if chr(0) == stream.get(result_peg_17.getPosition()):
+            result_peg_17.nextPosition()
+            result_peg_17.setValue(chr(0))
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_17);
+        
+        result_peg_18 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = state.Program(includes, name, objs)
+        result_peg_18.setValue(value)
+        
+        result_peg_1.addResult(result_peg_18);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_start, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_start, position, None)
+    return None
+
+
+def rule_structs(stream, position):
+    if stream.hasResult(RULE_structs, position):
+        return stream.result(RULE_structs, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_3 = Result(result_peg_2.getPosition());
+                result_peg_4 = Result(result_peg_3.getPosition())
+                
+                try:
+                    while True:
+                        result_peg_5 = Result(result_peg_4.getPosition());
+                        # print "Trying rule " + 's'
+                        result_peg_5 = rule_s(stream, result_peg_5.getPosition())
+                        if result_peg_5 == None:
+                            raise PegError
+                        result_peg_4.addResult(result_peg_5);
+                except PegError:
+                    pass
+                        
+                result_peg_3.addResult(result_peg_4);
+                
+                result_peg_6 = Result(result_peg_3.getPosition())
+                
+                # print "Trying rule " + 'struct'
+                result_peg_6 = rule_struct(stream, result_peg_6.getPosition())
+                if result_peg_6 == None:
+                    raise PegError
+                obj = result_peg_6.getValues()
+                
+                result_peg_3.addResult(result_peg_6);
+                
+                result_peg_3.setValue(result_peg_3.getLastValue())
+                result_peg_2.addResult(result_peg_3);
+        except PegError:
+            if result_peg_2.matches() == 0:
+                raise PegError
+                
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_structs, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_structs, position, None)
+    return None
+
+
+def rule_include(stream, position):
+    if stream.hasResult(RULE_include, position):
+        return stream.result(RULE_include, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if 'include' == stream.get(result_peg_2.getPosition(), 7):
+            result_peg_2.nextPosition(7)
+            result_peg_2.setValue('include')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            if result_peg_3.matches() == 0:
+                raise PegError
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'include__string'
+        result_peg_5 = rule_include__string(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        what = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_7 = Result(result_peg_6.getPosition());
+                result_peg_8 = Result(result_peg_7.getPosition())
+                
+                result_peg_9 = Result(result_peg_8.getPosition());
+                try:
+                    if '\n' == stream.get(result_peg_9.getPosition(), 1):
+                        result_peg_9.nextPosition(1)
+                        result_peg_9.setValue('\n')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_8.setValue(None)
+                        
+                result_peg_7.addResult(result_peg_8);
+                
+                result_peg_10 = Result(result_peg_7.getPosition())
+                
+                temp_peg_11 = stream.get(result_peg_10.getPosition())
+                if temp_peg_11 != chr(0):
+                    result_peg_10.setValue(temp_peg_11)
+                    result_peg_10.nextPosition()
+                else:
+                    raise PegError
+                
+                result_peg_7.addResult(result_peg_10);
+                
+                result_peg_7.setValue(result_peg_7.getLastValue())
+                result_peg_6.addResult(result_peg_7);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_12 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_13 = Result(result_peg_12.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_13 = rule_s(stream, result_peg_13.getPosition())
+                if result_peg_13 == None:
+                    raise PegError
+                result_peg_12.addResult(result_peg_13);
+        except PegError:
+            if result_peg_12.matches() == 0:
+                raise PegError
+                
+        result_peg_1.addResult(result_peg_12);
+        
+        result_peg_14 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_15 = Result(result_peg_14.getPosition());
+                if '\n' == stream.get(result_peg_15.getPosition(), 1):
+                    result_peg_15.nextPosition(1)
+                    result_peg_15.setValue('\n')
+                else:
+                    raise PegError
+                result_peg_14.addResult(result_peg_15);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_14);
+        
+        result_peg_16 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = what
+        result_peg_16.setValue(value)
+        
+        result_peg_1.addResult(result_peg_16);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_include, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_include, position, None)
+    return None
+
+
+def rule_include__string(stream, position):
+    if stream.hasResult(RULE_include__string, position):
+        return stream.result(RULE_include__string, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'string'
+        result_peg_2 = rule_string(stream, result_peg_2.getPosition())
+        if result_peg_2 == None:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_include__string, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_3 = Result(position)
+        result_peg_4 = Result(result_peg_3.getPosition())
+        
+        if '<' == stream.get(result_peg_4.getPosition(), 1):
+            result_peg_4.nextPosition(1)
+            result_peg_4.setValue('<')
+        else:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_4);
+        
+        result_peg_5 = Result(result_peg_3.getPosition())
+        
+        try:
+            while True:
+                result_peg_6 = Result(result_peg_5.getPosition());
+                result_peg_7 = Result(result_peg_6.getPosition())
+                
+                result_peg_8 = Result(result_peg_7.getPosition());
+                try:
+                    if '>' == stream.get(result_peg_8.getPosition(), 1):
+                        result_peg_8.nextPosition(1)
+                        result_peg_8.setValue('>')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_7.setValue(None)
+                        
+                result_peg_6.addResult(result_peg_7);
+                
+                result_peg_9 = Result(result_peg_6.getPosition())
+                
+                temp_peg_10 = stream.get(result_peg_9.getPosition())
+                if temp_peg_10 != chr(0):
+                    result_peg_9.setValue(temp_peg_10)
+                    result_peg_9.nextPosition()
+                else:
+                    raise PegError
+                
+                result_peg_6.addResult(result_peg_9);
+                
+                result_peg_6.setValue(result_peg_6.getLastValue())
+                result_peg_5.addResult(result_peg_6);
+        except PegError:
+            pass
+        contents = result_peg_5.getValues()
+        
+        result_peg_3.addResult(result_peg_5);
+        
+        result_peg_11 = Result(result_peg_3.getPosition())
+        
+        if '>' == stream.get(result_peg_11.getPosition(), 1):
+            result_peg_11.nextPosition(1)
+            result_peg_11.setValue('>')
+        else:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_11);
+        
+        result_peg_12 = Result(result_peg_3.getPosition())
+        
+        value = None
+        values = result_peg_3.getValues()
+        value = "<%s>" % ''.join(contents)
+        result_peg_12.setValue(value)
+        
+        result_peg_3.addResult(result_peg_12);
+        
+        result_peg_3.setValue(result_peg_3.getLastValue())
+        stream.update(RULE_include__string, position, result_peg_3)
+        return result_peg_3
+    except PegError:
+        pass
+    stream.update(RULE_include__string, position, None)
+    return None
+
+
+def rule_string(stream, position):
+    if stream.hasResult(RULE_string, position):
+        return stream.result(RULE_string, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if '"' == stream.get(result_peg_2.getPosition(), 1):
+            result_peg_2.nextPosition(1)
+            result_peg_2.setValue('"')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                result_peg_5 = Result(result_peg_4.getPosition())
+                
+                result_peg_6 = Result(result_peg_5.getPosition());
+                try:
+                    if '"' == stream.get(result_peg_6.getPosition(), 1):
+                        result_peg_6.nextPosition(1)
+                        result_peg_6.setValue('"')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_5.setValue(None)
+                        
+                result_peg_4.addResult(result_peg_5);
+                
+                result_peg_7 = Result(result_peg_4.getPosition())
+                
+                result_peg_8 = Result(result_peg_7.getPosition());
+                try:
+                    if '\n' == stream.get(result_peg_8.getPosition(), 1):
+                        result_peg_8.nextPosition(1)
+                        result_peg_8.setValue('\n')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_7.setValue(None)
+                        
+                result_peg_4.addResult(result_peg_7);
+                
+                result_peg_9 = Result(result_peg_4.getPosition())
+                
+                temp_peg_10 = stream.get(result_peg_9.getPosition())
+                if temp_peg_10 != chr(0):
+                    result_peg_9.setValue(temp_peg_10)
+                    result_peg_9.nextPosition()
+                else:
+                    raise PegError
+                
+                result_peg_4.addResult(result_peg_9);
+                
+                result_peg_4.setValue(result_peg_4.getLastValue())
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+        contents = result_peg_3.getValues()
+        
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_11 = Result(result_peg_1.getPosition())
+        
+        if '"' == stream.get(result_peg_11.getPosition(), 1):
+            result_peg_11.nextPosition(1)
+            result_peg_11.setValue('"')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_11);
+        
+        result_peg_12 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = '"' + ''.join(contents) + '"'
+        result_peg_12.setValue(value)
+        
+        result_peg_1.addResult(result_peg_12);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_string, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_string, position, None)
+    return None
+
+
+def rule_namespace(stream, position):
+    if stream.hasResult(RULE_namespace, position):
+        return stream.result(RULE_namespace, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if 'namespace' == stream.get(result_peg_2.getPosition(), 9):
+            result_peg_2.nextPosition(9)
+            result_peg_2.setValue('namespace')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            if result_peg_3.matches() == 0:
+                raise PegError
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'identifier'
+        result_peg_5 = rule_identifier(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        id = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_namespace, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_namespace, position, None)
+    return None
+
+
+def rule_struct(stream, position):
+    if stream.hasResult(RULE_struct, position):
+        return stream.result(RULE_struct, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if 'struct' == stream.get(result_peg_2.getPosition(), 6):
+            result_peg_2.nextPosition(6)
+            result_peg_2.setValue('struct')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'identifier'
+        result_peg_5 = rule_identifier(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        name = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_7 = Result(result_peg_6.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_7 = rule_s(stream, result_peg_7.getPosition())
+                if result_peg_7 == None:
+                    raise PegError
+                result_peg_6.addResult(result_peg_7);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_8 = Result(result_peg_1.getPosition())
+        
+        if '{' == stream.get(result_peg_8.getPosition(), 1):
+            result_peg_8.nextPosition(1)
+            result_peg_8.setValue('{')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_8);
+        
+        result_peg_9 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_10 = Result(result_peg_9.getPosition());
+                result_peg_11 = Result(result_peg_10.getPosition())
+                
+                try:
+                    while True:
+                        result_peg_12 = Result(result_peg_11.getPosition());
+                        # print "Trying rule " + 's'
+                        result_peg_12 = rule_s(stream, result_peg_12.getPosition())
+                        if result_peg_12 == None:
+                            raise PegError
+                        result_peg_11.addResult(result_peg_12);
+                except PegError:
+                    pass
+                        
+                result_peg_10.addResult(result_peg_11);
+                
+                result_peg_13 = Result(result_peg_10.getPosition())
+                
+                # print "Trying rule " + 'field'
+                result_peg_13 = rule_field(stream, result_peg_13.getPosition())
+                if result_peg_13 == None:
+                    raise PegError
+                
+                result_peg_10.addResult(result_peg_13);
+                
+                result_peg_10.setValue(result_peg_10.getLastValue())
+                result_peg_9.addResult(result_peg_10);
+        except PegError:
+            pass
+        fields = result_peg_9.getValues()
+        
+        result_peg_1.addResult(result_peg_9);
+        
+        result_peg_14 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_15 = Result(result_peg_14.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_15 = rule_s(stream, result_peg_15.getPosition())
+                if result_peg_15 == None:
+                    raise PegError
+                result_peg_14.addResult(result_peg_15);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_14);
+        
+        result_peg_16 = Result(result_peg_1.getPosition())
+        
+        if '}' == stream.get(result_peg_16.getPosition(), 1):
+            result_peg_16.nextPosition(1)
+            result_peg_16.setValue('}')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_16);
+        
+        result_peg_17 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = state.State(name)
+        for field in fields:
+            value.addField(field)
+        result_peg_17.setValue(value)
+        
+        result_peg_1.addResult(result_peg_17);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_struct, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_struct, position, None)
+    return None
+
+
+def rule_identifier(stream, position):
+    if stream.hasResult(RULE_identifier, position):
+        return stream.result(RULE_identifier, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'letter'
+        result_peg_2 = rule_letter(stream, result_peg_2.getPosition())
+        if result_peg_2 == None:
+            raise PegError
+        a = result_peg_2.getValues()
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 'letter_digit'
+                result_peg_4 = rule_letter_digit(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+        rest = result_peg_3.getValues()
+        
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = a + ''.join(rest)
+        result_peg_5.setValue(value)
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_identifier, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_identifier, position, None)
+    return None
+
+
+def rule_letter(stream, position):
+    if stream.hasResult(RULE_letter, position):
+        return stream.result(RULE_letter, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        letter_peg_3 = stream.get(result_peg_2.getPosition())
+        if letter_peg_3 in 'abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_':
+            result_peg_2.nextPosition()
+            result_peg_2.setValue(letter_peg_3)
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_letter, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_letter, position, None)
+    return None
+
+
+def rule_digit(stream, position):
+    if stream.hasResult(RULE_digit, position):
+        return stream.result(RULE_digit, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        letter_peg_3 = stream.get(result_peg_2.getPosition())
+        if letter_peg_3 in '0123456789':
+            result_peg_2.nextPosition()
+            result_peg_2.setValue(letter_peg_3)
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_digit, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_digit, position, None)
+    return None
+
+
+def rule_number(stream, position):
+    if stream.hasResult(RULE_number, position):
+        return stream.result(RULE_number, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_3 = Result(result_peg_2.getPosition());
+                # print "Trying rule " + 'digit'
+                result_peg_3 = rule_digit(stream, result_peg_3.getPosition())
+                if result_peg_3 == None:
+                    raise PegError
+                result_peg_2.addResult(result_peg_3);
+        except PegError:
+            if result_peg_2.matches() == 0:
+                raise PegError
+        all = result_peg_2.getValues()
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_4 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = ''.join(all)
+        result_peg_4.setValue(value)
+        
+        result_peg_1.addResult(result_peg_4);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_number, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_number, position, None)
+    return None
+
+
+def rule_letter_digit(stream, position):
+    if stream.hasResult(RULE_letter_digit, position):
+        return stream.result(RULE_letter_digit, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'letter'
+        result_peg_2 = rule_letter(stream, result_peg_2.getPosition())
+        if result_peg_2 == None:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_letter_digit, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_3 = Result(position)
+        result_peg_4 = Result(result_peg_3.getPosition())
+        
+        # print "Trying rule " + 'digit'
+        result_peg_4 = rule_digit(stream, result_peg_4.getPosition())
+        if result_peg_4 == None:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_4);
+        
+        result_peg_3.setValue(result_peg_3.getLastValue())
+        stream.update(RULE_letter_digit, position, result_peg_3)
+        return result_peg_3
+    except PegError:
+        pass
+    stream.update(RULE_letter_digit, position, None)
+    return None
+
+
+def rule_array(stream, position):
+    if stream.hasResult(RULE_array, position):
+        return stream.result(RULE_array, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if '[' == stream.get(result_peg_2.getPosition(), 1):
+            result_peg_2.nextPosition(1)
+            result_peg_2.setValue('[')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'number'
+        result_peg_5 = rule_number(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        out = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_7 = Result(result_peg_6.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_7 = rule_s(stream, result_peg_7.getPosition())
+                if result_peg_7 == None:
+                    raise PegError
+                result_peg_6.addResult(result_peg_7);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_8 = Result(result_peg_1.getPosition())
+        
+        if ']' == stream.get(result_peg_8.getPosition(), 1):
+            result_peg_8.nextPosition(1)
+            result_peg_8.setValue(']')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_8);
+        
+        result_peg_9 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = out
+        result_peg_9.setValue(value)
+        
+        result_peg_1.addResult(result_peg_9);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_array, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_array, position, None)
+    return None
+
+
+def rule_field(stream, position):
+    if stream.hasResult(RULE_field, position):
+        return stream.result(RULE_field, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'struct'
+        result_peg_2 = rule_struct(stream, result_peg_2.getPosition())
+        if result_peg_2 == None:
+            raise PegError
+        obj = result_peg_2.getValues()
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'identifier'
+        result_peg_5 = rule_identifier(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        name = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        try:
+            save_peg_7 = result_peg_6.getPosition()
+            
+            # print "Trying rule " + 'array'
+            result_peg_6 = rule_array(stream, result_peg_6.getPosition())
+            if result_peg_6 == None:
+                raise PegError
+            
+        except PegError:
+            result_peg_6 = Result(save_peg_7)
+            result_peg_6.setValue(None)
+        array = result_peg_6.getValues()
+        
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_8 = Result(result_peg_1.getPosition())
+        
+        try:
+            save_peg_9 = result_peg_8.getPosition()
+            
+            if ';' == stream.get(result_peg_8.getPosition(), 1):
+                result_peg_8.nextPosition(1)
+                result_peg_8.setValue(';')
+            else:
+                raise PegError
+            
+        except PegError:
+            result_peg_8 = Result(save_peg_9)
+            result_peg_8.setValue(None)
+        
+        result_peg_1.addResult(result_peg_8);
+        
+        result_peg_10 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        if array != None:
+            value = state.Field(obj, name, array)
+        else:
+            value = state.Field(obj, name)
+        result_peg_10.setValue(value)
+        
+        result_peg_1.addResult(result_peg_10);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_field, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_11 = Result(position)
+        result_peg_12 = Result(result_peg_11.getPosition())
+        
+        # print "Trying rule " + 'type__identifier'
+        result_peg_12 = rule_type__identifier(stream, result_peg_12.getPosition())
+        if result_peg_12 == None:
+            raise PegError
+        type = result_peg_12.getValues()
+        
+        result_peg_11.addResult(result_peg_12);
+        
+        result_peg_13 = Result(result_peg_11.getPosition())
+        
+        try:
+            while True:
+                result_peg_14 = Result(result_peg_13.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_14 = rule_s(stream, result_peg_14.getPosition())
+                if result_peg_14 == None:
+                    raise PegError
+                result_peg_13.addResult(result_peg_14);
+        except PegError:
+            if result_peg_13.matches() == 0:
+                raise PegError
+                
+        result_peg_11.addResult(result_peg_13);
+        
+        result_peg_15 = Result(result_peg_11.getPosition())
+        
+        # print "Trying rule " + 'identifier'
+        result_peg_15 = rule_identifier(stream, result_peg_15.getPosition())
+        if result_peg_15 == None:
+            raise PegError
+        name = result_peg_15.getValues()
+        
+        result_peg_11.addResult(result_peg_15);
+        
+        result_peg_16 = Result(result_peg_11.getPosition())
+        
+        try:
+            save_peg_17 = result_peg_16.getPosition()
+            
+            if ';' == stream.get(result_peg_16.getPosition(), 1):
+                result_peg_16.nextPosition(1)
+                result_peg_16.setValue(';')
+            else:
+                raise PegError
+            
+        except PegError:
+            result_peg_16 = Result(save_peg_17)
+            result_peg_16.setValue(None)
+        
+        result_peg_11.addResult(result_peg_16);
+        
+        result_peg_18 = Result(result_peg_11.getPosition())
+        
+        value = None
+        values = result_peg_11.getValues()
+        value = state.Field(type, name)
+        result_peg_18.setValue(value)
+        
+        result_peg_11.addResult(result_peg_18);
+        
+        result_peg_11.setValue(result_peg_11.getLastValue())
+        stream.update(RULE_field, position, result_peg_11)
+        return result_peg_11
+    except PegError:
+        pass
+    stream.update(RULE_field, position, None)
+    return None
+
+
+def rule_type__modifier(stream, position):
+    if stream.hasResult(RULE_type__modifier, position):
+        return stream.result(RULE_type__modifier, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if 'unsigned' == stream.get(result_peg_2.getPosition(), 8):
+            result_peg_2.nextPosition(8)
+            result_peg_2.setValue('unsigned')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_type__modifier, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_3 = Result(position)
+        result_peg_4 = Result(result_peg_3.getPosition())
+        
+        if 'signed' == stream.get(result_peg_4.getPosition(), 6):
+            result_peg_4.nextPosition(6)
+            result_peg_4.setValue('signed')
+        else:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_4);
+        
+        result_peg_3.setValue(result_peg_3.getLastValue())
+        stream.update(RULE_type__modifier, position, result_peg_3)
+        return result_peg_3
+    except PegError:
+        pass
+    stream.update(RULE_type__modifier, position, None)
+    return None
+
+
+def rule_type__identifier(stream, position):
+    if stream.hasResult(RULE_type__identifier, position):
+        return stream.result(RULE_type__identifier, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        try:
+            save_peg_3 = result_peg_2.getPosition()
+            
+            # print "Trying rule " + 'type__modifier'
+            result_peg_2 = rule_type__modifier(stream, result_peg_2.getPosition())
+            if result_peg_2 == None:
+                raise PegError
+            
+        except PegError:
+            result_peg_2 = Result(save_peg_3)
+            result_peg_2.setValue(None)
+        modifier = result_peg_2.getValues()
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_4 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_5 = Result(result_peg_4.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_5 = rule_s(stream, result_peg_5.getPosition())
+                if result_peg_5 == None:
+                    raise PegError
+                result_peg_4.addResult(result_peg_5);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_4);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'identifier'
+        result_peg_6 = rule_identifier(stream, result_peg_6.getPosition())
+        if result_peg_6 == None:
+            raise PegError
+        name = result_peg_6.getValues()
+        
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_7 = Result(result_peg_1.getPosition())
+        
+        try:
+            save_peg_8 = result_peg_7.getPosition()
+            
+            # print "Trying rule " + 'template'
+            result_peg_7 = rule_template(stream, result_peg_7.getPosition())
+            if result_peg_7 == None:
+                raise PegError
+            
+        except PegError:
+            result_peg_7 = Result(save_peg_8)
+            result_peg_7.setValue(None)
+        template = result_peg_7.getValues()
+        
+        result_peg_1.addResult(result_peg_7);
+        
+        result_peg_9 = Result(result_peg_1.getPosition())
+        
+        try:
+            save_peg_10 = result_peg_9.getPosition()
+            
+            result_peg_11 = Result(result_peg_9.getPosition())
+            
+            if '::' == stream.get(result_peg_11.getPosition(), 2):
+                result_peg_11.nextPosition(2)
+                result_peg_11.setValue('::')
+            else:
+                raise PegError
+            
+            result_peg_9.addResult(result_peg_11);
+            
+            result_peg_12 = Result(result_peg_9.getPosition())
+            
+            # print "Trying rule " + 'type__identifier'
+            result_peg_12 = rule_type__identifier(stream, result_peg_12.getPosition())
+            if result_peg_12 == None:
+                raise PegError
+            
+            result_peg_9.addResult(result_peg_12);
+            
+            result_peg_9.setValue(result_peg_9.getLastValue())
+            
+        except PegError:
+            result_peg_9 = Result(save_peg_10)
+            result_peg_9.setValue(None)
+        namespace = result_peg_9.getValues()
+        
+        result_peg_1.addResult(result_peg_9);
+        
+        result_peg_13 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = state.makeType(modifier, name, template, namespace)
+        result_peg_13.setValue(value)
+        
+        result_peg_1.addResult(result_peg_13);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_type__identifier, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_type__identifier, position, None)
+    return None
+
+
+def rule_template(stream, position):
+    if stream.hasResult(RULE_template, position):
+        return stream.result(RULE_template, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if '<' == stream.get(result_peg_2.getPosition(), 1):
+            result_peg_2.nextPosition(1)
+            result_peg_2.setValue('<')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_4 = rule_s(stream, result_peg_4.getPosition())
+                if result_peg_4 == None:
+                    raise PegError
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_5 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'type__identifier'
+        result_peg_5 = rule_type__identifier(stream, result_peg_5.getPosition())
+        if result_peg_5 == None:
+            raise PegError
+        arg1 = result_peg_5.getValues()
+        
+        result_peg_1.addResult(result_peg_5);
+        
+        result_peg_6 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_7 = Result(result_peg_6.getPosition());
+                result_peg_8 = Result(result_peg_7.getPosition())
+                
+                try:
+                    while True:
+                        result_peg_9 = Result(result_peg_8.getPosition());
+                        # print "Trying rule " + 's'
+                        result_peg_9 = rule_s(stream, result_peg_9.getPosition())
+                        if result_peg_9 == None:
+                            raise PegError
+                        result_peg_8.addResult(result_peg_9);
+                except PegError:
+                    pass
+                        
+                result_peg_7.addResult(result_peg_8);
+                
+                result_peg_10 = Result(result_peg_7.getPosition())
+                
+                if ',' == stream.get(result_peg_10.getPosition(), 1):
+                    result_peg_10.nextPosition(1)
+                    result_peg_10.setValue(',')
+                else:
+                    raise PegError
+                
+                result_peg_7.addResult(result_peg_10);
+                
+                result_peg_11 = Result(result_peg_7.getPosition())
+                
+                try:
+                    while True:
+                        result_peg_12 = Result(result_peg_11.getPosition());
+                        # print "Trying rule " + 's'
+                        result_peg_12 = rule_s(stream, result_peg_12.getPosition())
+                        if result_peg_12 == None:
+                            raise PegError
+                        result_peg_11.addResult(result_peg_12);
+                except PegError:
+                    pass
+                        
+                result_peg_7.addResult(result_peg_11);
+                
+                result_peg_13 = Result(result_peg_7.getPosition())
+                
+                # print "Trying rule " + 'type__identifier'
+                result_peg_13 = rule_type__identifier(stream, result_peg_13.getPosition())
+                if result_peg_13 == None:
+                    raise PegError
+                
+                result_peg_7.addResult(result_peg_13);
+                
+                result_peg_7.setValue(result_peg_7.getLastValue())
+                result_peg_6.addResult(result_peg_7);
+        except PegError:
+            pass
+        args = result_peg_6.getValues()
+        
+        result_peg_1.addResult(result_peg_6);
+        
+        result_peg_14 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_15 = Result(result_peg_14.getPosition());
+                # print "Trying rule " + 's'
+                result_peg_15 = rule_s(stream, result_peg_15.getPosition())
+                if result_peg_15 == None:
+                    raise PegError
+                result_peg_14.addResult(result_peg_15);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_14);
+        
+        result_peg_16 = Result(result_peg_1.getPosition())
+        
+        if '>' == stream.get(result_peg_16.getPosition(), 1):
+            result_peg_16.nextPosition(1)
+            result_peg_16.setValue('>')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_16);
+        
+        result_peg_17 = Result(result_peg_1.getPosition())
+        
+        value = None
+        values = result_peg_1.getValues()
+        value = [arg1] + args
+        result_peg_17.setValue(value)
+        
+        result_peg_1.addResult(result_peg_17);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_template, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_template, position, None)
+    return None
+
+
+def rule_newline(stream, position):
+    if stream.hasResult(RULE_newline, position):
+        return stream.result(RULE_newline, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if '\n' == stream.get(result_peg_2.getPosition(), 1):
+            result_peg_2.nextPosition(1)
+            result_peg_2.setValue('\n')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_newline, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    stream.update(RULE_newline, position, None)
+    return None
+
+
+def rule_s(stream, position):
+    if stream.hasResult(RULE_s, position):
+        return stream.result(RULE_s, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if ' ' == stream.get(result_peg_2.getPosition(), 1):
+            result_peg_2.nextPosition(1)
+            result_peg_2.setValue(' ')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_s, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_3 = Result(position)
+        result_peg_4 = Result(result_peg_3.getPosition())
+        
+        if '\t' == stream.get(result_peg_4.getPosition(), 1):
+            result_peg_4.nextPosition(1)
+            result_peg_4.setValue('\t')
+        else:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_4);
+        
+        result_peg_3.setValue(result_peg_3.getLastValue())
+        stream.update(RULE_s, position, result_peg_3)
+        return result_peg_3
+    except PegError:
+        pass
+    try:
+        result_peg_5 = Result(position)
+        result_peg_6 = Result(result_peg_5.getPosition())
+        
+        if '\n' == stream.get(result_peg_6.getPosition(), 1):
+            result_peg_6.nextPosition(1)
+            result_peg_6.setValue('\n')
+        else:
+            raise PegError
+        
+        result_peg_5.addResult(result_peg_6);
+        
+        result_peg_5.setValue(result_peg_5.getLastValue())
+        stream.update(RULE_s, position, result_peg_5)
+        return result_peg_5
+    except PegError:
+        pass
+    try:
+        result_peg_7 = Result(position)
+        result_peg_8 = Result(result_peg_7.getPosition())
+        
+        if '\r' == stream.get(result_peg_8.getPosition(), 1):
+            result_peg_8.nextPosition(1)
+            result_peg_8.setValue('\r')
+        else:
+            raise PegError
+        
+        result_peg_7.addResult(result_peg_8);
+        
+        result_peg_7.setValue(result_peg_7.getLastValue())
+        stream.update(RULE_s, position, result_peg_7)
+        return result_peg_7
+    except PegError:
+        pass
+    try:
+        result_peg_9 = Result(position)
+        result_peg_10 = Result(result_peg_9.getPosition())
+        
+        # print "Trying rule " + 'comment'
+        result_peg_10 = rule_comment(stream, result_peg_10.getPosition())
+        if result_peg_10 == None:
+            raise PegError
+        
+        result_peg_9.addResult(result_peg_10);
+        
+        result_peg_9.setValue(result_peg_9.getLastValue())
+        stream.update(RULE_s, position, result_peg_9)
+        return result_peg_9
+    except PegError:
+        pass
+    stream.update(RULE_s, position, None)
+    return None
+
+
+def rule_comment(stream, position):
+    if stream.hasResult(RULE_comment, position):
+        return stream.result(RULE_comment, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        if '//' == stream.get(result_peg_2.getPosition(), 2):
+            result_peg_2.nextPosition(2)
+            result_peg_2.setValue('//')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_3 = Result(result_peg_1.getPosition())
+        
+        try:
+            while True:
+                result_peg_4 = Result(result_peg_3.getPosition());
+                result_peg_5 = Result(result_peg_4.getPosition())
+                
+                result_peg_6 = Result(result_peg_5.getPosition());
+                try:
+                    if '\n' == stream.get(result_peg_6.getPosition(), 1):
+                        result_peg_6.nextPosition(1)
+                        result_peg_6.setValue('\n')
+                    else:
+                        raise NotError
+                    raise PegError
+                except NotError:
+                    result_peg_5.setValue(None)
+                        
+                result_peg_4.addResult(result_peg_5);
+                
+                result_peg_7 = Result(result_peg_4.getPosition())
+                
+                temp_peg_8 = stream.get(result_peg_7.getPosition())
+                if temp_peg_8 != chr(0):
+                    result_peg_7.setValue(temp_peg_8)
+                    result_peg_7.nextPosition()
+                else:
+                    raise PegError
+                
+                result_peg_4.addResult(result_peg_7);
+                
+                result_peg_4.setValue(result_peg_4.getLastValue())
+                result_peg_3.addResult(result_peg_4);
+        except PegError:
+            pass
+                
+        result_peg_1.addResult(result_peg_3);
+        
+        result_peg_9 = Result(result_peg_1.getPosition())
+        
+        if '\n' == stream.get(result_peg_9.getPosition(), 1):
+            result_peg_9.nextPosition(1)
+            result_peg_9.setValue('\n')
+        else:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_9);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_comment, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_10 = Result(position)
+        result_peg_11 = Result(result_peg_10.getPosition())
+        
+        if '/*' == stream.get(result_peg_11.getPosition(), 2):
+            result_peg_11.nextPosition(2)
+            result_peg_11.setValue('/*')
+        else:
+            raise PegError
+        
+        result_peg_10.addResult(result_peg_11);
+        
+        result_peg_12 = Result(result_peg_10.getPosition())
+        
+        try:
+            while True:
+                result_peg_13 = Result(result_peg_12.getPosition());
+                # print "Trying rule " + 'inner__comment'
+                result_peg_13 = rule_inner__comment(stream, result_peg_13.getPosition())
+                if result_peg_13 == None:
+                    raise PegError
+                result_peg_12.addResult(result_peg_13);
+        except PegError:
+            pass
+                
+        result_peg_10.addResult(result_peg_12);
+        
+        result_peg_14 = Result(result_peg_10.getPosition())
+        
+        if '*/' == stream.get(result_peg_14.getPosition(), 2):
+            result_peg_14.nextPosition(2)
+            result_peg_14.setValue('*/')
+        else:
+            raise PegError
+        
+        result_peg_10.addResult(result_peg_14);
+        
+        result_peg_10.setValue(result_peg_10.getLastValue())
+        stream.update(RULE_comment, position, result_peg_10)
+        return result_peg_10
+    except PegError:
+        pass
+    stream.update(RULE_comment, position, None)
+    return None
+
+
+def rule_inner__comment(stream, position):
+    if stream.hasResult(RULE_inner__comment, position):
+        return stream.result(RULE_inner__comment, position)
+    try:
+        result_peg_1 = Result(position)
+        result_peg_2 = Result(result_peg_1.getPosition())
+        
+        # print "Trying rule " + 'comment'
+        result_peg_2 = rule_comment(stream, result_peg_2.getPosition())
+        if result_peg_2 == None:
+            raise PegError
+        
+        result_peg_1.addResult(result_peg_2);
+        
+        result_peg_1.setValue(result_peg_1.getLastValue())
+        stream.update(RULE_inner__comment, position, result_peg_1)
+        return result_peg_1
+    except PegError:
+        pass
+    try:
+        result_peg_3 = Result(position)
+        result_peg_4 = Result(result_peg_3.getPosition())
+        
+        result_peg_5 = Result(result_peg_4.getPosition());
+        try:
+            if '*/' == stream.get(result_peg_5.getPosition(), 2):
+                result_peg_5.nextPosition(2)
+                result_peg_5.setValue('*/')
+            else:
+                raise NotError
+            raise PegError
+        except NotError:
+            result_peg_4.setValue(None)
+                
+        result_peg_3.addResult(result_peg_4);
+        
+        result_peg_6 = Result(result_peg_3.getPosition())
+        
+        temp_peg_7 = stream.get(result_peg_6.getPosition())
+        if temp_peg_7 != chr(0):
+            result_peg_6.setValue(temp_peg_7)
+            result_peg_6.nextPosition()
+        else:
+            raise PegError
+        
+        result_peg_3.addResult(result_peg_6);
+        
+        result_peg_3.setValue(result_peg_3.getLastValue())
+        stream.update(RULE_inner__comment, position, result_peg_3)
+        return result_peg_3
+    except PegError:
+        pass
+    stream.update(RULE_inner__comment, position, None)
+    return None
+
+
+def doParse(stream):
+    done = rule_start(stream, 0)
+    if done == None:
+        # print "Error parsing " + file
+        raise Exception(stream.reportError())
+    else:
+        return done.getValues()
+
+def parseFile(file):
+    # print "Parsing " + file
+    return doParse(Stream(filename = file))
+
+def parseString(value):
+    return doParse(Stream(input = value))
+
@@ -31,8 +31,9 @@ World::~World(){
     delete gameInfo;
 }
 
-AllCharacterData::AllCharacterData(const StateData & character, const AnimationState & animation, const std::map<int, std::map<uint32_t, int> > & statePersistent):
+AllCharacterData::AllCharacterData(const StateData & character, const TickData & tick, const AnimationState & animation, const std::map<int, std::map<uint32_t, int> > & statePersistent):
 character(character),
+tick(tick),
 animation(animation),
 statePersistent(statePersistent){
 }
@@ -41,7 +42,7 @@ AllCharacterData::AllCharacterData(){
 }
 
 void World::addCharacter(const Character & who){
-    characterData[who.getId()] = AllCharacterData(who.getStateData(), who.getCurrentAnimationState(), who.getStatePersistent());
+    characterData[who.getId()] = AllCharacterData(who.getStateData(), who.getTickData(), who.getCurrentAnimationState(), who.getStatePersistent());
     AllCharacterData & data = characterData[who.getId()];
     const std::vector<Command2 *> & commands = who.getCommands();
     std::map<std::string, std::string > & commandState = data.character.commandState;
@@ -141,6 +142,7 @@ static Token * serialize(const AllCharacterData & data){
     Token * token = new Token();
     *token << "data";
     *token << serialize(data.character);
+    *token << serialize(data.tick);
     *token << serialize(data.animation);
     *token << serialize(data.statePersistent);
     return token;
@@ -153,6 +155,11 @@ static AllCharacterData deserializeAllCharacterData(const Token * token){
         out.character = deserializeStateData(character);
     }
 
+    const Token * tick = token->findToken("data/TickData");
+    if (tick != NULL){
+        out.tick = deserializeTickData(tick);
+    }
+
     const Token * animation = token->findToken("data/AnimationState");
     if (animation != NULL){
         out.animation = deserializeAnimationState(animation);
@@ -14,10 +14,11 @@ namespace Mugen{
 class Character;
 
 struct AllCharacterData{
-    AllCharacterData(const StateData & character, const AnimationState & animation, const std::map<int, std::map<uint32_t, int> > & statePersistent);
+    AllCharacterData(const StateData & character, const TickData & tick, const AnimationState & animation, const std::map<int, std::map<uint32_t, int> > & statePersistent);
     AllCharacterData();
 
     StateData character;
+    TickData tick;
     AnimationState animation;
     std::map<int, std::map<uint32_t, int> > statePersistent;
 };
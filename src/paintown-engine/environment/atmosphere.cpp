@@ -57,6 +57,8 @@ Atmosphere(){
     fog = new Graphics::Bitmap( 50, 50 );
     fog->fill(Graphics::MaskColor());
     fog->circleFill( 25, 25, 20, Graphics::makeColor( 0xbb, 0xbb, 0xcc ) );
+    /* only the circle gets blended when the fog is drawn */
+    fog->encodeMask();
 
     for ( int i = -20; i < screenX(); i += 20 ){
         fogs.push_back( new Fog( i + Util::rnd( 9 ) - 4, screenY() - 30, Util::rnd( 360 ) ) );
@@ -27,22 +27,27 @@ using namespace std;
 
 namespace Paintown{
 
-Frame::Frame( Graphics::Bitmap * p, ECollide * e ){
-	pic = p;
-	collide = e;
-	mine = true;
+Frame::Frame( Graphics::Bitmap * p, ECollide * e ):
+pic(p),
+collide(e),
+mine(true){
+}
+
+Frame::Frame(Graphics::Bitmap * p, const Util::ReferenceCount<ECollide> & collide):
+pic(p),
+collide(collide),
+mine(true){
 }
 	
-Frame::Frame( const Frame & f ){
-    pic = f.pic;
-    collide = f.collide;
-    mine = false;
+Frame::Frame( const Frame & f ):
+pic(f.pic),
+collide(f.collide),
+mine(false){
 }
 
 Frame::~Frame(){
     if ( mine ){
         delete pic;
-        delete collide;
     }
 }
 
@@ -432,6 +437,7 @@ changedAttacks(false){
                         *pic = pic->scaleBy(owner->getSpriteScale(), owner->getSpriteScale());
                     }
 
+                    pic->encodeMask();
                     ECollide * collide = new ECollide(pic);
                     Frame * f = new Frame(pic, collide);
                     frames[full.path()] = f;
@@ -476,7 +482,7 @@ changedAttacks(false){
     if ( first != frames.end() ){
         Frame * x = (*first).second;
         current_frame = x->pic;
-        current_collide = x->collide;
+        current_collide = x->collide.raw();
     }
 
     own_bitmaps = true;
@@ -716,29 +722,28 @@ void Animation::reMap(map<Graphics::Color, Graphics::Color> & colors ){
             Frame* & xframe = (*it).second;
 
             Graphics::Bitmap * xpic = new Graphics::Bitmap( *(xframe->pic), true );
-            ECollide * xcollide = new ECollide( xframe->collide );
 
             /* oh evil! I am altering a map while iterating over it.
              * It should be ok, though, since Im altering an element
              * that already exists.
+             * The collision object is shared, only the colors change.
              */
-            frames[ (*it).first ] = new Frame( xpic, xcollide );
+            frames[ (*it).first ] = new Frame(xpic, xframe->collide);
         }
     }
 
+    const Graphics::Bitmap::ColorMapFilter lookup(colors);
     for ( map<string,Frame*>::iterator it = frames.begin(); it != frames.end(); it++ ){
         Frame * xframe = (*it).second;
 
         Graphics::Bitmap * use = xframe->pic;
-        reMap(use, colors);
+        reMap(use, lookup);
     }
 
     own_bitmaps = true;
 }
 
-void Animation::reMap( Graphics::Bitmap * work, map<Graphics::Color, Graphics::Color> & colors ){
-    const map<Graphics::Color, Graphics::Color>::iterator it_end = colors.end();
-
+void Animation::reMap(Graphics::Bitmap * work, const Graphics::Bitmap::ColorMapFilter & colors){
     /* maybe this is a little faster than just reading every pixel
      * and writing it back. i dunno
      */
@@ -748,9 +753,9 @@ void Animation::reMap( Graphics::Bitmap * work, map<Graphics::Color, Graphics::C
         for ( unsigned int x1 = 0; x1 < xcols.size(); x1++ ){
             Graphics::Color pixel = xcols[x1];
 
-            map<Graphics::Color, Graphics::Color>::iterator find_it = colors.find(pixel);
-            if (find_it != it_end){
-                work->putPixel(x1, y1, (*find_it).second);
+            Graphics::Color replace = colors.lookup(pixel);
+            if (replace != pixel){
+                work->putPixel(x1, y1, replace);
             }
             /*
                if ( colors.find( pixel ) != it_end ){
@@ -760,6 +765,9 @@ void Animation::reMap( Graphics::Bitmap * work, map<Graphics::Color, Graphics::C
         }
     }
 
+    /* the colors changed so the opaque runs may have too */
+    work->encodeMask();
+
     /*
        for ( int x1 = 0; x1 < work->getWidth(); x1++ ){
        for ( int y1 = 0; y1 < work->getHeight(); y1++ ){
@@ -1053,7 +1061,7 @@ void Animation::setFrame( const string & path ){
     if ( frames.find(path) != frames.end() ){
         Frame * x = frames[ path ];
         current_frame = x->pic;
-        current_collide = x->collide;
+        current_collide = x->collide.raw();
     } else {
         Global::debug( 0 ) <<"No frame "<<path<<endl;
     }
@@ -1070,7 +1078,7 @@ void Animation::setFrame( const int fr ){
 
 	Frame * x = (*it).second;
 	current_frame = x->pic;
-	current_collide = x->collide;
+	current_collide = x->collide.raw();
 }
 	
 /*
@@ -38,15 +38,20 @@ struct KeyPress{
 	*/
 };
 
-/* stores a bitmap and a collision object to go with it */
+/* stores a bitmap and a collision object to go with it. Copies of a frame,
+ * such as recolored ones, share the collision object since changing the
+ * colors doesn't change the shape.
+ */
 struct Frame{
     Graphics::Bitmap * pic;
-    ECollide * collide;
+    Util::ReferenceCount<ECollide> collide;
 
     Frame( Graphics::Bitmap * pic, ECollide * e);
+    Frame(Graphics::Bitmap * pic, const Util::ReferenceCount<ECollide> & collide);
     Frame( const Frame & f );
     ~Frame();
 
+    /* true if pic is deleted along with the frame */
     bool mine;
 };
 
@@ -291,7 +296,7 @@ public:
 
 protected:
 
-	void reMap(Graphics::Bitmap * work, std::map<Graphics::Color, Graphics::Color> & colors );
+	void reMap(Graphics::Bitmap * work, const Graphics::Bitmap::ColorMapFilter & colors);
 
 	// int convertKeyPress( const string & key_name ) throw( LoadException );
     Input::PaintownInput convertKeyPress( const std::string & key_name );
@@ -43,9 +43,11 @@ Remap::Remap(const Filesystem::RelativePath & from, const Filesystem::RelativePa
 remapFrom(from),
 remapTo(to){
     colors = computeRemapColors(from, to);
+    setColors(colors);
 }
 
 Remap::Remap(const Remap & copy):
+ColorMapFilter(copy),
 remapFrom(copy.remapFrom),
 remapTo(copy.remapTo),
 colors(copy.colors){
@@ -128,14 +130,6 @@ Util::ReferenceCount<Graphics::Shader> Remap::getShader(){
     return shader;
 }
     
-Graphics::Color Remap::filter(Graphics::Color pixel) const {
-    map<Graphics::Color, Graphics::Color>::const_iterator replace = colors.find(pixel);
-    if (replace != colors.end()){
-        return replace->second;
-    }
-    return pixel;
-}
-
 map<Graphics::Color, Graphics::Color> Remap::computeRemapColors(const Filesystem::RelativePath & from, const Filesystem::RelativePath & to){
     Graphics::RestoreState state;
     Graphics::Bitmap b_from(Paintown::Mod::getCurrentMod()->makeBitmap(from));
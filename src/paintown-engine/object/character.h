@@ -53,14 +53,12 @@ const int Status_Falling = 9; /* falling due to lack of ground beneath them */
 class Character;
 
 /* Handles palette swaps */
-class Remap: public Graphics::Bitmap::Filter {
+class Remap: public Graphics::Bitmap::ColorMapFilter {
 public:
     Remap(const Filesystem::RelativePath & from, const Filesystem::RelativePath & to);
     Remap(const Remap & copy);
 
     virtual ~Remap();
-            
-    virtual Graphics::Color filter(Graphics::Color color) const;
 
     virtual Util::ReferenceCount<Graphics::Shader> getShader();
 
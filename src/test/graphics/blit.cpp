@@ -0,0 +1,305 @@
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/sdl/span.h"
+#include <stdlib.h>
+#include <vector>
+#include <sstream>
+
+/* Runs the 16-bit sprite row kernels for every instruction set the cpu has
+ * and reports Mpixels/s for each blend mode, drawing both normally and
+ * horizontally flipped, and the fill and shade kernels used for tints and
+ * lights. Every kernel is also checked against the scalar one, with full rows
+ * and with some widths that leave a partial vector at the end. Then a
+ * character shaped sprite is drawn with and without its opaque runs encoded.
+ * Usage: blit [frames]
+ */
+
+using namespace Graphics;
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+static const Span::Pixel MASK = 0xf81f;
+static const unsigned int ALPHA = 128;
+
+static void makeSprite(std::vector<Span::Pixel> & sprite){
+    sprite.resize(WIDTH * HEIGHT);
+    for (unsigned int i = 0; i < sprite.size(); i++){
+        /* roughly a quarter of a sprite is transparent */
+        if (rand() % 4 == 0){
+            sprite[i] = MASK;
+        } else {
+            sprite[i] = rand() & 0xffff;
+        }
+    }
+}
+
+/* Something shaped like a fighting game character: an opaque blob in the
+ * middle of a frame that is mostly mask color, with some gaps in it.
+ */
+static void makeCharacter(std::vector<Span::Pixel> & sprite){
+    sprite.resize(WIDTH * HEIGHT);
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            double dx = (x - WIDTH / 2) / (WIDTH * 0.2);
+            double dy = (y - HEIGHT / 2) / (HEIGHT * 0.45);
+            bool inside = dx * dx + dy * dy < 1 && (x / 8 + y / 16) % 5 != 0;
+            sprite[y * WIDTH + x] = inside ? (rand() & 0xffff) | 1 : MASK;
+        }
+    }
+}
+
+/* draws the first `width' pixels of every row */
+static void drawRows(Span::Kernel kernel, bool reverse, std::vector<Span::Pixel> & screen, const std::vector<Span::Pixel> & sprite, int width = WIDTH){
+    for (int y = 0; y < HEIGHT; y++){
+        Span::Pixel * destination = &screen[y * WIDTH];
+        if (reverse){
+            destination += width - 1;
+        }
+        kernel(destination, &sprite[y * WIDTH], width, MASK, ALPHA);
+    }
+}
+
+/* Row widths to compare against the scalar kernels. The vector kernels leave
+ * whatever doesn't fill a whole vector at the end of a row to the scalar
+ * code, and WIDTH divides evenly, so some widths that don't are checked too.
+ */
+static const int CHECK_WIDTHS[] = {WIDTH, 1, 7, 17, WIDTH - 1};
+static const int CHECK_WIDTH_COUNT = sizeof(CHECK_WIDTHS) / sizeof(int);
+
+/* returns the number of pixels that differ from the scalar kernel */
+static int check(Span::Isa isa, Span::Mode mode, bool reverse, const std::vector<Span::Pixel> & background, const std::vector<Span::Pixel> & sprite){
+    int wrong = 0;
+    for (int i = 0; i < CHECK_WIDTH_COUNT; i++){
+        std::vector<Span::Pixel> expected(background);
+        std::vector<Span::Pixel> actual(background);
+        drawRows(Span::kernel(Span::Scalar, mode, reverse), reverse, expected, sprite, CHECK_WIDTHS[i]);
+        drawRows(Span::kernel(isa, mode, reverse), reverse, actual, sprite, CHECK_WIDTHS[i]);
+        for (unsigned int pixel = 0; pixel < expected.size(); pixel++){
+            if (expected[pixel] != actual[pixel]){
+                wrong += 1;
+            }
+        }
+    }
+    return wrong;
+}
+
+/* returns the number of pixels the fill kernel gets different from the
+ * scalar one
+ */
+static int checkFill(Span::Isa isa, const std::vector<Span::Pixel> & background){
+    int wrong = 0;
+    for (int i = 0; i < CHECK_WIDTH_COUNT; i++){
+        std::vector<Span::Pixel> expected(background);
+        std::vector<Span::Pixel> actual(background);
+        for (int y = 0; y < HEIGHT; y++){
+            Span::fillKernel(Span::Scalar)(&expected[y * WIDTH], CHECK_WIDTHS[i], 0x1234, MASK, ALPHA);
+            Span::fillKernel(isa)(&actual[y * WIDTH], CHECK_WIDTHS[i], 0x1234, MASK, ALPHA);
+        }
+        for (unsigned int pixel = 0; pixel < expected.size(); pixel++){
+            if (expected[pixel] != actual[pixel]){
+                wrong += 1;
+            }
+        }
+    }
+    return wrong;
+}
+
+/* the same for the shade kernel */
+static int checkShade(Span::Isa isa, const std::vector<Span::Pixel> & background, const std::vector<Span::Pixel> & colors, const std::vector<unsigned char> & alphas){
+    int wrong = 0;
+    for (int i = 0; i < CHECK_WIDTH_COUNT; i++){
+        std::vector<Span::Pixel> expected(background);
+        std::vector<Span::Pixel> actual(background);
+        for (int y = 0; y < HEIGHT; y++){
+            Span::shadeKernel(Span::Scalar)(&expected[y * WIDTH], &colors[y * WIDTH], &alphas[0], CHECK_WIDTHS[i]);
+            Span::shadeKernel(isa)(&actual[y * WIDTH], &colors[y * WIDTH], &alphas[0], CHECK_WIDTHS[i]);
+        }
+        for (unsigned int pixel = 0; pixel < expected.size(); pixel++){
+            if (expected[pixel] != actual[pixel]){
+                wrong += 1;
+            }
+        }
+    }
+    return wrong;
+}
+
+/* runs the fill and shade kernels for one instruction set over a whole
+ * screen, returns the number of kernels that differ from the scalar ones
+ */
+static int runTints(Span::Isa isa, int frames, const std::vector<Span::Pixel> & background, const std::vector<Span::Pixel> & colors){
+    std::vector<unsigned char> alphas(WIDTH);
+    for (int x = 0; x < WIDTH; x++){
+        alphas[x] = x * 255 / (WIDTH - 1);
+    }
+
+    int failed = 0;
+
+    std::vector<Span::Pixel> screen(background);
+    Span::FillKernel fill = Span::fillKernel(isa);
+    TimeDifference fillTimer;
+    fillTimer.startTime();
+    for (int frame = 0; frame < frames; frame++){
+        for (int y = 0; y < HEIGHT; y++){
+            fill(&screen[y * WIDTH], WIDTH, 0x1234, MASK, ALPHA);
+        }
+    }
+    fillTimer.endTime();
+    bool fillWrong = checkFill(isa, background) != 0;
+    failed += fillWrong ? 1 : 0;
+
+    screen = background;
+    Span::ShadeKernel shade = Span::shadeKernel(isa);
+    TimeDifference shadeTimer;
+    shadeTimer.startTime();
+    for (int frame = 0; frame < frames; frame++){
+        for (int y = 0; y < HEIGHT; y++){
+            shade(&screen[y * WIDTH], &colors[y * WIDTH], &alphas[0], WIDTH);
+        }
+    }
+    shadeTimer.endTime();
+    bool shadeWrong = checkShade(isa, background, colors, alphas) != 0;
+    failed += shadeWrong ? 1 : 0;
+
+    double pixels = (double) WIDTH * HEIGHT * frames;
+    double fillSeconds = fillTimer.getMicroseconds() / 1000000.0;
+    double shadeSeconds = shadeTimer.getMicroseconds() / 1000000.0;
+    std::ostringstream out;
+    out << Span::name(isa) << " fill: " << (fillSeconds > 0 ? pixels / fillSeconds / 1000000 : 0) << " Mpixels/s"
+        << (fillWrong ? " (differs from scalar)" : "")
+        << ", shade: " << (shadeSeconds > 0 ? pixels / shadeSeconds / 1000000 : 0) << " Mpixels/s"
+        << (shadeWrong ? " (differs from scalar)" : "");
+    Global::debug(0) << out.str() << std::endl;
+
+    return failed;
+}
+
+static void drawRuns(const Span::Runs & runs, Span::Mode mode, bool reverse, std::vector<Span::Pixel> & screen, const std::vector<Span::Pixel> & sprite){
+    for (int y = 0; y < HEIGHT; y++){
+        Span::Pixel * destination = &screen[y * WIDTH];
+        if (reverse){
+            destination += WIDTH - 1;
+        }
+        runs.draw(y, 0, WIDTH, &sprite[y * WIDTH], destination, mode, reverse, ALPHA);
+    }
+}
+
+static double rate(TimeDifference & timer, int frames){
+    double seconds = timer.getMicroseconds() / 1000000.0;
+    if (seconds <= 0){
+        return 0;
+    }
+    return (double) WIDTH * HEIGHT * frames / seconds / 1000000;
+}
+
+/* compares drawing every pixel of a character sprite with drawing only its
+ * opaque runs, returns the number of modes where the two differ
+ */
+static int runRuns(int frames, const std::vector<Span::Pixel> & background){
+    std::vector<Span::Pixel> sprite;
+    makeCharacter(sprite);
+    Span::Runs runs(&sprite[0], WIDTH, HEIGHT, WIDTH, MASK);
+
+    int opaque = 0;
+    for (unsigned int i = 0; i < sprite.size(); i++){
+        if (sprite[i] != MASK){
+            opaque += 1;
+        }
+    }
+    Global::debug(0) << "Character sprite is " << (opaque * 100 / (WIDTH * HEIGHT)) << "% opaque in " << runs.size() << " runs" << std::endl;
+
+    int failed = 0;
+    Span::Mode modes[] = {Span::Copy, Span::Trans};
+    for (unsigned int i = 0; i < sizeof(modes) / sizeof(Span::Mode); i++){
+        Span::Mode mode = modes[i];
+        for (int flip = 0; flip < 2; flip++){
+            bool reverse = flip == 1;
+            std::vector<Span::Pixel> pixels(background);
+            std::vector<Span::Pixel> encoded(background);
+            Span::Kernel kernel = Span::kernel(mode, reverse);
+
+            TimeDifference pixelTimer;
+            pixelTimer.startTime();
+            for (int frame = 0; frame < frames; frame++){
+                drawRows(kernel, reverse, pixels, sprite);
+            }
+            pixelTimer.endTime();
+
+            TimeDifference runTimer;
+            runTimer.startTime();
+            for (int frame = 0; frame < frames; frame++){
+                drawRuns(runs, mode, reverse, encoded, sprite);
+            }
+            runTimer.endTime();
+
+            std::ostringstream out;
+            out << "character " << Span::name(mode) << (reverse ? " hflip" : "")
+                << ": rows " << rate(pixelTimer, frames) << " Mpixels/s, runs " << rate(runTimer, frames) << " Mpixels/s";
+            if (pixels != encoded){
+                out << " (runs drew something different)";
+                failed += 1;
+            }
+            Global::debug(0) << out.str() << std::endl;
+        }
+    }
+
+    return failed;
+}
+
+static int run(int frames){
+    std::vector<Span::Pixel> sprite;
+    std::vector<Span::Pixel> background;
+    makeSprite(sprite);
+    makeSprite(background);
+
+    Global::debug(0) << "Fastest kernels: " << Span::name(Span::best()) << std::endl;
+
+    int failed = 0;
+    for (int isa = 0; isa < Span::IsaCount; isa++){
+        if (!Span::supported((Span::Isa) isa)){
+            Global::debug(0) << Span::name((Span::Isa) isa) << " is not supported" << std::endl;
+            continue;
+        }
+        for (int mode = 0; mode < Span::ModeCount; mode++){
+            for (int flip = 0; flip < 2; flip++){
+                bool reverse = flip == 1;
+                int wrong = check((Span::Isa) isa, (Span::Mode) mode, reverse, background, sprite);
+                if (wrong != 0){
+                    failed += 1;
+                }
+
+                std::vector<Span::Pixel> screen(background);
+                Span::Kernel kernel = Span::kernel((Span::Isa) isa, (Span::Mode) mode, reverse);
+                TimeDifference timer;
+                timer.startTime();
+                for (int frame = 0; frame < frames; frame++){
+                    drawRows(kernel, reverse, screen, sprite);
+                }
+                timer.endTime();
+
+                double seconds = timer.getMicroseconds() / 1000000.0;
+                double pixels = (double) WIDTH * HEIGHT * frames;
+                std::ostringstream out;
+                out << Span::name((Span::Isa) isa) << " " << Span::name((Span::Mode) mode) << (reverse ? " hflip" : "")
+                    << ": " << (seconds > 0 ? pixels / seconds / 1000000 : 0) << " Mpixels/s";
+                if (wrong != 0){
+                    out << " (" << wrong << " pixels differ from scalar)";
+                }
+                Global::debug(0) << out.str() << std::endl;
+            }
+        }
+        failed += runTints((Span::Isa) isa, frames, background, sprite);
+    }
+
+    failed += runRuns(frames, background);
+
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char ** argv){
+    Global::setDebug(0);
+    int frames = 500;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    return run(frames);
+}
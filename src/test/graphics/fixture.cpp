@@ -0,0 +1,36 @@
+#include "fixture.h"
+#include <stdlib.h>
+
+using namespace Graphics;
+
+namespace Fixture{
+
+Color randomColor(){
+    return makeColor(rand() % 256, rand() % 256, rand() % 256);
+}
+
+Bitmap makeSprite(int width, int height){
+    Bitmap sprite(width, height);
+    sprite.fill(MaskColor());
+    for (int y = 0; y < height; y++){
+        for (int x = 0; x < width; x++){
+            double dx = (x - width / 2) / (width * 0.4);
+            double dy = (y - height / 2) / (height * 0.45);
+            if (dx * dx + dy * dy < 1 && (x / 4 + y / 8) % 5 != 0){
+                sprite.putPixel(x, y, randomColor());
+            }
+        }
+    }
+    sprite.encodeMask();
+    return sprite;
+}
+
+Bitmap makeBackground(int width, int height){
+    Bitmap background(width, height);
+    for (int y = 0; y < height; y++){
+        background.hLine(0, y, width - 1, makeColor(y % 256, 255 - y % 256, (y * 3) % 256));
+    }
+    return background;
+}
+
+}
@@ -0,0 +1,22 @@
+#ifndef _paintown_test_graphics_fixture_h
+#define _paintown_test_graphics_fixture_h
+
+#include "util/graphics/bitmap.h"
+
+/* Bitmaps the graphics tests draw their scenes with. The sprites use rand()
+ * so call srand first to get the same ones every run.
+ */
+
+namespace Fixture{
+
+Graphics::Color randomColor();
+
+/* an opaque blob with some holes in it on a mask colored frame */
+Graphics::Bitmap makeSprite(int width, int height);
+
+/* one color per row, repeating every 256 rows */
+Graphics::Bitmap makeBackground(int width, int height);
+
+}
+
+#endif
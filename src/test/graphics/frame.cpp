@@ -0,0 +1,154 @@
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "fixture.h"
+#include <stdlib.h>
+#include <vector>
+#include <sstream>
+
+/* Renders the same fighting game like scene in 16-bit and in 32-bit color and
+ * reports the average time per frame for each. The scene is a background,
+ * masked characters drawn plain and flipped, translucent, additive and lit
+ * effects, and a translucent box. The last frames of the two depths are
+ * compared afterwards, they should only differ by the 5-6-5 rounding.
+ * Usage: frame [frames]
+ */
+
+using namespace Graphics;
+using namespace Fixture;
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+static const int CHARACTERS = 6;
+static const int EFFECTS = 12;
+
+struct Rgb{
+    int red, green, blue;
+};
+
+static void drawScene(const Bitmap & work, const Bitmap & background, const std::vector<Bitmap> & characters, const std::vector<Bitmap> & effects, int frame){
+    background.Blit(work);
+
+    for (unsigned int i = 0; i < characters.size(); i++){
+        int x = (int) (i * 53 + frame) % WIDTH - 40;
+        int y = HEIGHT - characters[i].getHeight() - 10;
+        if (i % 2 == 0){
+            characters[i].draw(x, y, work);
+        } else {
+            characters[i].drawHFlip(x, y, work);
+        }
+    }
+
+    for (unsigned int i = 0; i < effects.size(); i++){
+        int x = (int) (i * 29 + frame * 2) % WIDTH - 20;
+        int y = (int) (i * 17) % (HEIGHT - 40);
+        switch (i % 3){
+            case 0: {
+                effects[i].translucent(0, 0, 0, 128).draw(x, y, work);
+                break;
+            }
+            case 1: {
+                Bitmap::addBlender(0, 0, 0, 255);
+                effects[i].translucent().draw(x, y, work);
+                break;
+            }
+            case 2: {
+                Bitmap::transBlender(255, 255, 255, 96);
+                effects[i].lit().draw(x, y, work);
+                break;
+            }
+        }
+    }
+
+    Bitmap::transBlender(0, 0, 0, 100);
+    work.translucent().rectangleFill(10, 10, WIDTH - 10, 40, makeColor(0, 0, 64));
+}
+
+/* returns the average microseconds per frame, the last frame is put in out */
+static double runDepth(int depth, int frames, std::vector<Rgb> & out){
+    setRenderDepth(depth);
+    Bitmap::setFakeGraphicsMode(WIDTH, HEIGHT);
+
+    /* same seed so both depths draw the same scene */
+    srand(1);
+    Bitmap background = makeBackground(WIDTH, HEIGHT);
+    std::vector<Bitmap> characters;
+    for (int i = 0; i < CHARACTERS; i++){
+        characters.push_back(makeSprite(80, 110));
+    }
+    std::vector<Bitmap> effects;
+    for (int i = 0; i < EFFECTS; i++){
+        effects.push_back(makeSprite(48, 48));
+    }
+
+    Bitmap work(WIDTH, HEIGHT);
+    TimeDifference timer;
+    timer.startTime();
+    for (int frame = 0; frame < frames; frame++){
+        drawScene(work, background, characters, effects, frame);
+    }
+    timer.endTime();
+
+    out.clear();
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            Color pixel = work.getPixel(x, y);
+            Rgb rgb = {getRed(pixel), getGreen(pixel), getBlue(pixel)};
+            out.push_back(rgb);
+        }
+    }
+
+    Bitmap::shutdown();
+
+    return frames > 0 ? (double) timer.getMicroseconds() / frames : 0;
+}
+
+static int difference(int a, int b){
+    return a < b ? b - a : a - b;
+}
+
+static int run(int frames){
+    std::vector<Rgb> frame16;
+    std::vector<Rgb> frame32;
+    double time16 = runDepth(16, frames, frame16);
+    double time32 = runDepth(32, frames, frame32);
+
+    Global::debug(0) << "16-bit: " << time16 << "us per frame" << std::endl;
+    Global::debug(0) << "32-bit: " << time32 << "us per frame" << std::endl;
+
+    unsigned long long total = 0;
+    int most = 0;
+    for (unsigned int i = 0; i < frame16.size() && i < frame32.size(); i++){
+        int red = difference(frame16[i].red, frame32[i].red);
+        int green = difference(frame16[i].green, frame32[i].green);
+        int blue = difference(frame16[i].blue, frame32[i].blue);
+        total += red + green + blue;
+        if (red > most){
+            most = red;
+        }
+        if (green > most){
+            most = green;
+        }
+        if (blue > most){
+            most = blue;
+        }
+    }
+    double average = frame16.size() > 0 ? (double) total / (frame16.size() * 3) : 0;
+    std::ostringstream out;
+    out << "Channel difference between the depths: average " << average << " largest " << most;
+    Global::debug(0) << out.str() << std::endl;
+
+    /* 5-6-5 loses up to 7 per channel each time a pixel is stored, a few
+     * blends on top of each other shouldn't average more than that
+     */
+    return average < 8 ? 0 : 1;
+}
+
+int main(int argc, char ** argv){
+    Global::setDebug(0);
+    int frames = 300;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    return run(frames);
+}
@@ -0,0 +1,257 @@
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "fixture.h"
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <sstream>
+
+/* Draws a night level the way NightAtmosphere and FogAtmosphere do: a
+ * background, a row of lamps shining light cones onto it, the darkened sky
+ * put over everything with applyTrans and a band of translucent fog at the
+ * bottom. Reports the time per frame in 16-bit and in 32-bit color. In both
+ * depths a few lights and a tint, some of them hanging off the edges of the
+ * clip rectangle, are also checked pixel by pixel against the trans blender
+ * math.
+ * Usage: light [frames]
+ */
+
+using namespace Graphics;
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+
+struct Lamp{
+    int x, y;
+    int width, height;
+    int top;
+    int focusAlpha, edgeAlpha;
+    Color color;
+};
+
+/* the background from the other tests with some boxes on the bottom half */
+static Bitmap makeBackground(){
+    Bitmap background = Fixture::makeBackground(WIDTH, HEIGHT);
+    for (int x = 0; x < WIDTH; x += 40){
+        background.rectangleFill(x, HEIGHT / 2, x + 20, HEIGHT - 1, makeColor(x % 256, 90, 40));
+    }
+    return background;
+}
+
+static Bitmap makeFog(){
+    Bitmap fog(50, 50);
+    fog.fill(MaskColor());
+    fog.circleFill(25, 25, 20, makeColor(0xbb, 0xbb, 0xcc));
+    fog.encodeMask();
+    return fog;
+}
+
+static std::vector<Lamp> makeLamps(){
+    std::vector<Lamp> lamps;
+    for (int i = 0; i < 6; i++){
+        Lamp lamp;
+        lamp.x = 20 + i * 56;
+        lamp.y = 30 + (i % 2) * 10;
+        lamp.width = 40 + (i % 3) * 10;
+        lamp.height = HEIGHT - lamp.y;
+        lamp.top = 10;
+        lamp.focusAlpha = 0;
+        lamp.edgeAlpha = 128;
+        lamp.color = i % 2 == 0 ? makeColor(32, 32, 0) : makeColor(0, 32, 192);
+        lamps.push_back(lamp);
+    }
+    return lamps;
+}
+
+static void drawScene(const Bitmap & work, const Bitmap & background, const Bitmap & fog, const std::vector<Lamp> & lamps, int frame){
+    background.Blit(work);
+
+    Bitmap::transBlender(0, 0, 0, 128);
+    for (unsigned int i = 0; i < lamps.size(); i++){
+        const Lamp & lamp = lamps[i];
+        work.light(lamp.x, lamp.y, lamp.width, lamp.height, lamp.top, lamp.focusAlpha, lamp.edgeAlpha, lamp.color, makeColor(0, 0, 0));
+    }
+
+    Bitmap::transBlender(0, 0, 0, 127);
+    work.applyTrans(makeColor(0, 0, 0));
+
+    Bitmap::transBlender(0, 0, 0, 64);
+    for (int x = -20; x < WIDTH; x += 20){
+        for (int layer = 0; layer < 5; layer++){
+            int y = HEIGHT - 30 - layer * 8 + (int)(sin((frame + x + layer * 40) * 3.14159 / 180.0) * 2);
+            fog.translucent().draw(x + layer, y, work);
+        }
+    }
+}
+
+/* what the trans blender should do to one 8-bit channel in 32-bit */
+static int blend(int source, int destination, int alpha){
+    int n = alpha == 0 ? 0 : alpha + 1;
+    if (n > 256){
+        n = 256;
+    }
+    return (source * n + destination * (256 - n)) >> 8;
+}
+
+/* and to a 5-6-5 pixel in 16-bit, all three channels at once */
+static int blend16(int source, int destination, int alpha){
+    int n = alpha == 0 ? 0 : (alpha + 1) / 8;
+    unsigned int x = ((source & 0xFFFF) | (source << 16)) & 0x7E0F81F;
+    unsigned int y = ((destination & 0xFFFF) | (destination << 16)) & 0x7E0F81F;
+    unsigned int result = ((x - y) * n / 32 + y) & 0x7E0F81F;
+    return (result & 0xFFFF) | (result >> 16);
+}
+
+static int pack16(Color color){
+    return ((getRed(color) >> 3) << 11) | ((getGreen(color) >> 2) << 5) | (getBlue(color) >> 3);
+}
+
+static Color blend(Color source, Color destination, int alpha){
+    if (getRenderDepth() == 16){
+        int pixel = blend16(pack16(source), pack16(destination), alpha);
+        return makeColor(((pixel >> 11) & 0x1f) << 3, ((pixel >> 5) & 0x3f) << 2, (pixel & 0x1f) << 3);
+    }
+    return makeColor(blend(getRed(source), getRed(destination), alpha),
+                     blend(getGreen(source), getGreen(destination), alpha),
+                     blend(getBlue(source), getBlue(destination), alpha));
+}
+
+static void referenceLight(std::vector<Color> & pixels, int clipX1, int clipY1, int clipX2, int clipY2, const Lamp & lamp){
+    std::vector<Color> colors(lamp.width);
+    blend_palette(&colors[0], lamp.width, lamp.color, makeColor(0, 0, 0));
+    double xtan = (double) lamp.height / (double) lamp.width;
+    for (int sy = lamp.top; sy < lamp.height; sy++){
+        int y = lamp.y + sy;
+        if (y < clipY1 || y >= clipY2){
+            continue;
+        }
+        int top = (int)((double) sy / xtan);
+        for (int sx = -top; sx <= top && top > 0; sx++){
+            int x = lamp.x + sx;
+            if (x < clipX1 || x >= clipX2){
+                continue;
+            }
+            int column = sx < 0 ? -sx : sx;
+            int alpha = (unsigned char)((double)(lamp.edgeAlpha - lamp.focusAlpha) * (double) column / (double) lamp.width + lamp.focusAlpha);
+            pixels[y * WIDTH + x] = blend(colors[column], pixels[y * WIDTH + x], alpha);
+        }
+    }
+}
+
+static int compare(const Bitmap & work, const std::vector<Color> & expected){
+    int wrong = 0;
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            if (work.getPixel(x, y) != expected[y * WIDTH + x]){
+                wrong += 1;
+            }
+        }
+    }
+    return wrong;
+}
+
+/* returns the number of pixels that differ from the reference */
+static int check(const Bitmap & background){
+    Bitmap work(WIDTH, HEIGHT);
+    background.Blit(work);
+    std::vector<Color> expected;
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            expected.push_back(work.getPixel(x, y));
+        }
+    }
+
+    std::vector<Lamp> lamps = makeLamps();
+    /* off the left and the right edge, and one that starts at its tip */
+    lamps[0].x = 5;
+    lamps[lamps.size() - 1].x = WIDTH - 10;
+    lamps[1].top = 0;
+
+    int clipX1 = 10, clipY1 = 40, clipX2 = WIDTH - 30, clipY2 = HEIGHT - 20;
+    work.setClipRect(clipX1, clipY1, clipX2, clipY2);
+    Bitmap::transBlender(0, 0, 0, 128);
+    for (unsigned int i = 0; i < lamps.size(); i++){
+        const Lamp & lamp = lamps[i];
+        work.light(lamp.x, lamp.y, lamp.width, lamp.height, lamp.top, lamp.focusAlpha, lamp.edgeAlpha, lamp.color, makeColor(0, 0, 0));
+        referenceLight(expected, clipX1, clipY1, clipX2, clipY2, lamp);
+    }
+    /* the same lights again come out of the cache */
+    for (unsigned int i = 0; i < lamps.size(); i += 2){
+        const Lamp & lamp = lamps[i];
+        work.light(lamp.x, lamp.y, lamp.width, lamp.height, lamp.top, lamp.focusAlpha, lamp.edgeAlpha, lamp.color, makeColor(0, 0, 0));
+        referenceLight(expected, clipX1, clipY1, clipX2, clipY2, lamp);
+    }
+
+    Bitmap::transBlender(0, 0, 0, 100);
+    work.applyTrans(makeColor(0, 0, 40));
+    for (int y = clipY1; y < clipY2; y++){
+        for (int x = clipX1; x < clipX2; x++){
+            Color & pixel = expected[y * WIDTH + x];
+            if (pixel != MaskColor()){
+                pixel = blend(makeColor(0, 0, 40), pixel, 100);
+            }
+        }
+    }
+
+    return compare(work, expected);
+}
+
+/* returns the average microseconds per frame and sets wrong to the number of
+ * pixels the checked lights got wrong
+ */
+static double runDepth(int depth, int frames, int & wrong){
+    setRenderDepth(depth);
+    Bitmap::setFakeGraphicsMode(WIDTH, HEIGHT);
+
+    TimeDifference timer;
+    {
+        /* the bitmaps have to be gone before shutdown */
+        Bitmap background = makeBackground();
+        Bitmap fog = makeFog();
+        std::vector<Lamp> lamps = makeLamps();
+
+        wrong = check(background);
+
+        Bitmap work(WIDTH, HEIGHT);
+        timer.startTime();
+        for (int frame = 0; frame < frames; frame++){
+            drawScene(work, background, fog, lamps, frame);
+        }
+        timer.endTime();
+    }
+
+    Bitmap::shutdown();
+
+    return frames > 0 ? (double) timer.getMicroseconds() / frames : 0;
+}
+
+static void report(int depth, double time, int wrong){
+    std::ostringstream out;
+    out << depth << "-bit: " << time << "us per frame";
+    if (wrong != 0){
+        out << " (" << wrong << " pixels differ from the reference)";
+    }
+    Global::debug(0) << out.str() << std::endl;
+}
+
+static int run(int frames){
+    int wrong16 = 0;
+    int wrong32 = 0;
+    double time16 = runDepth(16, frames, wrong16);
+    double time32 = runDepth(32, frames, wrong32);
+
+    report(16, time16, wrong16);
+    report(32, time32, wrong32);
+
+    return wrong16 == 0 && wrong32 == 0 ? 0 : 1;
+}
+
+int main(int argc, char ** argv){
+    Global::setDebug(0);
+    int frames = 300;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    return run(frames);
+}
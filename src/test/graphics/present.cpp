@@ -0,0 +1,160 @@
+#include "util/debug.h"
+#include "util/init.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include <stdlib.h>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+/* Runs a game loop like util/events.cpp does: a logic tick, a 320x240 scene
+ * scaled up to the screen buffer and then BlitToScreen. The loop is run with
+ * frames presented on the calling thread and then on the present thread, and
+ * a histogram of the frame times is printed for each along with the slowest
+ * frames and what the surface pool did in the last frame, which shouldn't
+ * allocate anything, sub-bitmaps included.
+ * Set SDL_VIDEODRIVER=dummy to run it without a window.
+ * Usage: present [frames] [logic microseconds]
+ */
+
+using namespace Graphics;
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+/* histogram buckets are half a millisecond wide */
+static const int BUCKET = 500;
+static const int BUCKETS = 40;
+/* how many of the slowest frames to list */
+static const unsigned int WORST = 5;
+
+/* stands in for a logic tick */
+static volatile unsigned int logicSink;
+static void runLogic(int microseconds){
+    TimeDifference timer;
+    timer.startTime();
+    unsigned int value = logicSink;
+    do{
+        for (int i = 0; i < 1000; i++){
+            value = value * 1664525 + 1013904223;
+        }
+        timer.endTime();
+    } while ((int) timer.getMicroseconds() < microseconds);
+    logicSink = value;
+}
+
+static void drawScene(const Bitmap & work, int frame){
+    for (int y = 0; y < HEIGHT; y += 8){
+        work.rectangleFill(0, y, WIDTH - 1, y + 7, makeColor((y + frame) % 256, 255 - y, (y * 3) % 256));
+    }
+    for (int i = 0; i < 20; i++){
+        int x = (i * 37 + frame * 3) % WIDTH;
+        int y = (i * 23) % HEIGHT;
+        work.circleFill(x, y, 12, makeColor(255, (i * 40) % 256, 0));
+    }
+}
+
+/* frame times in microseconds */
+static void runLoop(bool thread, int frames, int logic, std::vector<unsigned long long> & times){
+    setPresentThread(thread);
+    const Bitmap & screen = *getScreenBuffer();
+    times.clear();
+    for (int frame = 0; frame < frames; frame++){
+        TimeDifference timer;
+        timer.startTime();
+        runLogic(logic);
+        screen.clear();
+        StretchedBitmap work(WIDTH, HEIGHT, screen);
+        work.start();
+        drawScene(work, frame);
+        work.finish();
+        screen.BlitToScreen();
+        timer.endTime();
+        times.push_back(timer.getMicroseconds());
+    }
+    setPresentThread(false);
+}
+
+static void reportPool(){
+    SurfacePoolStatistics pool = getSurfacePoolStatistics();
+    std::ostringstream out;
+    out << "Surfaces in the last frame: " << pool.created << " allocated, " << pool.reused << " taken from the pool, "
+        << pool.returned << " returned, " << pool.freed << " freed, "
+        << pool.subBitmaps << " sub-bitmaps made. Pool holds " << pool.surfaces << " surfaces, " << (pool.bytes / 1024) << "kb";
+    Global::debug(0) << out.str() << std::endl;
+}
+
+static void report(const std::string & name, const std::vector<unsigned long long> & times){
+    std::vector<int> buckets(BUCKETS + 1);
+    unsigned long long total = 0;
+    unsigned long long worst = 0;
+    for (unsigned int i = 0; i < times.size(); i++){
+        total += times[i];
+        if (times[i] > worst){
+            worst = times[i];
+        }
+        unsigned int bucket = times[i] / BUCKET;
+        if (bucket > BUCKETS){
+            bucket = BUCKETS;
+        }
+        buckets[bucket] += 1;
+    }
+
+    std::ostringstream out;
+    out << name << ": average " << (times.size() > 0 ? total / times.size() : 0) << "us, worst " << worst << "us";
+    Global::debug(0) << out.str() << std::endl;
+    for (int i = 0; i <= BUCKETS; i++){
+        if (buckets[i] == 0){
+            continue;
+        }
+        std::ostringstream line;
+        if (i == BUCKETS){
+            line << "  >=" << (i * BUCKET / 1000.0) << "ms";
+        } else {
+            line << "  " << (i * BUCKET / 1000.0) << "-" << ((i + 1) * BUCKET / 1000.0) << "ms";
+        }
+        line << " " << buckets[i] << " ";
+        int stars = buckets[i] * 60 / times.size();
+        for (int star = 0; star < stars; star++){
+            line << "*";
+        }
+        Global::debug(0) << line.str() << std::endl;
+    }
+
+    /* time and frame number, slowest first */
+    std::vector<std::pair<unsigned long long, int> > slowest;
+    for (unsigned int i = 0; i < times.size(); i++){
+        slowest.push_back(std::make_pair(times[i], (int) i));
+    }
+    unsigned int count = std::min(WORST, (unsigned int) slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), std::greater<std::pair<unsigned long long, int> >());
+    std::ostringstream worstFrames;
+    worstFrames << "  slowest frames:";
+    for (unsigned int i = 0; i < count; i++){
+        worstFrames << " " << slowest[i].second << " (" << slowest[i].first << "us)";
+    }
+    Global::debug(0) << worstFrames.str() << std::endl;
+}
+
+int main(int argc, char ** argv){
+    Global::InitConditions conditions;
+    Global::init(conditions);
+    Global::setDebug(0);
+    int frames = 600;
+    int logic = 2000;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    if (argc > 2){
+        logic = atoi(argv[2]);
+    }
+
+    std::vector<unsigned long long> times;
+    runLoop(false, frames, logic, times);
+    report("Present on the calling thread", times);
+    reportPool();
+    runLoop(true, frames, logic, times);
+    report("Present thread", times);
+    reportPool();
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "util/debug.h"
+#include "util/thread.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "fixture.h"
+#include <stdlib.h>
+#include <vector>
+#include <sstream>
+
+/* Draws a fighting game like scene straight onto a bitmap and then again
+ * through a RenderList drawn with 1, 2, 3, 4, ... bands. Every banded frame
+ * has to match the immediate one pixel for pixel. The scene changes the
+ * blender between sprites and moves the clip rectangle around so the state
+ * kept with each command is checked too. It also draws onto a sub-bitmap of
+ * the target and redraws a scratch bitmap after drawing it, which both have
+ * to draw what was recorded first. Reports the time per frame for each.
+ * Usage: record [frames]
+ */
+
+using namespace Graphics;
+using namespace Fixture;
+
+static const int WIDTH = 640;
+static const int HEIGHT = 480;
+static const int CHARACTERS = 8;
+static const int EFFECTS = 24;
+
+static void drawScene(const Bitmap & work, const Bitmap & scratch, const Bitmap & background, const std::vector<Bitmap> & characters, const std::vector<Bitmap> & effects, int frame){
+    work.fill(makeColor(0, 0, 0));
+    background.Blit(0, 0, WIDTH, HEIGHT - 20, 0, 10, work);
+
+    for (unsigned int i = 0; i < characters.size(); i++){
+        int x = (int) (i * 83 + frame) % WIDTH - 40;
+        int y = HEIGHT - characters[i].getHeight() - (int) (i * 7) % 30;
+        switch (i % 3){
+            case 0: characters[i].draw(x, y, work); break;
+            case 1: characters[i].drawHFlip(x, y, work); break;
+            case 2: characters[i].drawVFlip(x, y, work); break;
+        }
+    }
+
+    /* the effects only show up inside the middle of the screen */
+    work.setClipRect(20, 30, WIDTH - 20, HEIGHT - 50);
+    for (unsigned int i = 0; i < effects.size(); i++){
+        int x = (int) (i * 29 + frame * 2) % WIDTH - 20;
+        int y = (int) (i * 37) % (HEIGHT - 40);
+        switch (i % 4){
+            case 0: {
+                effects[i].translucent(0, 0, 0, 128).draw(x, y, work);
+                break;
+            }
+            case 1: {
+                Bitmap::addBlender(0, 0, 0, 255);
+                effects[i].translucent().drawHFlip(x, y, work);
+                break;
+            }
+            case 2: {
+                Bitmap::transBlender(255, 255, 255, 96);
+                effects[i].lit().draw(x, y, work);
+                break;
+            }
+            case 3: {
+                Bitmap::multiplyBlender(0, 0, 0, 200);
+                effects[i].translucent().drawHVFlip(x, y, work);
+                break;
+            }
+        }
+    }
+    work.setClipRect(0, 0, WIDTH, HEIGHT);
+
+    /* a panel drawn through a sub-bitmap of the work bitmap */
+    Bitmap panel(work, WIDTH - 130, 50, 120, 80);
+    panel.fill(makeColor(0, 64, 0));
+    characters[frame % characters.size()].draw(-30, -40, panel);
+
+    /* the scratch bitmap is drawn, changed and drawn again */
+    for (int i = 0; i < 2; i++){
+        scratch.clearToMask();
+        effects[(frame + i) % effects.size()].draw(0, 0, scratch);
+        scratch.draw(100 + i * 80, 60, work);
+    }
+
+    work.rectangleFill(10, HEIGHT - 8, WIDTH / 2, HEIGHT - 2, makeColor(200, 0, 0));
+    Bitmap::transBlender(0, 0, 0, 100);
+    work.translucent().rectangleFill(10, 10, WIDTH - 10, 40, makeColor(0, 0, 64));
+}
+
+static bool same(const Bitmap & a, const Bitmap & b){
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            if (a.getPixel(x, y) != b.getPixel(x, y)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int run(int frames){
+    Bitmap::setFakeGraphicsMode(WIDTH, HEIGHT);
+
+    srand(1);
+    Bitmap background = makeBackground(WIDTH, HEIGHT);
+    std::vector<Bitmap> characters;
+    for (int i = 0; i < CHARACTERS; i++){
+        characters.push_back(makeSprite(120, 180));
+    }
+    std::vector<Bitmap> effects;
+    for (int i = 0; i < EFFECTS; i++){
+        effects.push_back(makeSprite(64, 64));
+    }
+
+    Bitmap scratch(64, 64);
+    Bitmap immediate(WIDTH, HEIGHT);
+    TimeDifference timer;
+    timer.startTime();
+    for (int frame = 0; frame < frames; frame++){
+        drawScene(immediate, scratch, background, characters, effects, frame);
+    }
+    timer.endTime();
+    double single = frames > 0 ? (double) timer.getMicroseconds() / frames : 0;
+    Global::debug(0) << "Immediate: " << single << "us per frame" << std::endl;
+
+    std::vector<int> bands;
+    int cpus = Util::Thread::cpuCount();
+    bands.push_back(1);
+    bands.push_back(2);
+    bands.push_back(3);
+    for (int count = 4; count <= 16 && (count <= 4 || count < cpus * 2); count *= 2){
+        bands.push_back(count);
+    }
+
+    int failed = 0;
+    for (unsigned int i = 0; i < bands.size(); i++){
+        Bitmap recorded(WIDTH, HEIGHT);
+        RenderList list(recorded);
+        unsigned int commands = 0;
+        TimeDifference timer;
+        timer.startTime();
+        for (int frame = 0; frame < frames; frame++){
+            list.start();
+            drawScene(recorded, scratch, background, characters, effects, frame);
+            commands = list.size();
+            list.finish(bands[i]);
+        }
+        timer.endTime();
+
+        double time = frames > 0 ? (double) timer.getMicroseconds() / frames : 0;
+        std::ostringstream out;
+        out << bands[i] << (bands[i] == 1 ? " band: " : " bands: ") << time << "us per frame, " << commands << " commands";
+        if (time > 0){
+            out << ", " << (single / time) << "x";
+        }
+        if (frames > 0 && !same(immediate, recorded)){
+            out << " (differs from immediate)";
+            failed += 1;
+        }
+        Global::debug(0) << out.str() << std::endl;
+    }
+
+    Bitmap::shutdown();
+
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char ** argv){
+    Global::setDebug(0);
+    int frames = 200;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    return run(frames);
+}
@@ -0,0 +1,180 @@
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "fixture.h"
+#include <stdlib.h>
+#include <math.h>
+#include <sstream>
+
+/* Draws shadows of random sprites with drawShadow and with the way it used to
+ * be done: stretch the sprite into a temporary bitmap, color it in with
+ * putPixel and draw that translucent. The sprites, scales, facings, clip
+ * rectangles, positions and intensities are random, and every sprite is drawn
+ * once with its opaque runs encoded and once without. Both have to come out
+ * the same pixel for pixel, in 16-bit and in 32-bit color. The time each way
+ * takes is reported too.
+ * Usage: shadow [cases] [seed]
+ */
+
+using namespace Graphics;
+
+static const int WIDTH = 160;
+static const int HEIGHT = 120;
+
+/* Bitmap::drawShadow before it drew straight into where */
+static void oldDrawShadow(const Bitmap & sprite, Bitmap & where, int x, int y, int intensity, Color color, double scale, bool facingRight){
+    const double newheight = sprite.getHeight() * scale;
+    Bitmap shade(sprite.getWidth(), (int) fabs(newheight));
+    sprite.Stretch(shade);
+
+    for (int h = 0; h < shade.getHeight(); ++h){
+        for (int w = 0; w < shade.getWidth(); ++w){
+            Color pix = shade.getPixel(w, h);
+            if (pix != MaskColor()){
+                shade.putPixel(w, h, color);
+            }
+        }
+    }
+
+    Bitmap::transBlender(0, 0, 0, intensity);
+
+    if (scale > 0){
+        if (facingRight){
+            shade.translucent().drawVFlip(x, y, where);
+        } else {
+            shade.translucent().drawHVFlip(x, y, where);
+        }
+    } else if (scale < 0){
+        y -= fabs(newheight);
+        if (facingRight){
+            shade.translucent().draw(x + 3, y, where);
+        } else {
+            shade.translucent().drawHFlip(x - 3, y, where);
+        }
+    }
+}
+
+struct Shadow{
+    int x, y;
+    int intensity;
+    Color color;
+    double scale;
+    bool facingRight;
+    int clipX1, clipY1, clipX2, clipY2;
+};
+
+static Shadow randomShadow(const Bitmap & sprite){
+    Shadow shadow;
+    shadow.x = rand() % (WIDTH + sprite.getWidth()) - sprite.getWidth();
+    shadow.y = rand() % (HEIGHT + sprite.getHeight()) - sprite.getHeight() / 2;
+    shadow.intensity = rand() % 256;
+    do{
+        shadow.color = Fixture::randomColor();
+    } while (shadow.color == MaskColor());
+    /* the old way can't make a bitmap with no rows */
+    do{
+        shadow.scale = (rand() % 400 - 200) / 100.0;
+    } while ((int) fabs(sprite.getHeight() * shadow.scale) < 1);
+    shadow.facingRight = rand() % 2 == 0;
+    shadow.clipX1 = rand() % (WIDTH / 2);
+    shadow.clipY1 = rand() % (HEIGHT / 2);
+    shadow.clipX2 = WIDTH / 2 + rand() % (WIDTH / 2 + 1);
+    shadow.clipY2 = HEIGHT / 2 + rand() % (HEIGHT / 2 + 1);
+    return shadow;
+}
+
+static int compare(const Bitmap & work, const Bitmap & expected){
+    int wrong = 0;
+    for (int y = 0; y < HEIGHT; y++){
+        for (int x = 0; x < WIDTH; x++){
+            if (work.getPixel(x, y) != expected.getPixel(x, y)){
+                wrong += 1;
+            }
+        }
+    }
+    return wrong;
+}
+
+/* returns how many cases came out different and adds the microseconds each
+ * way took to oldTime and newTime
+ */
+static int runDepth(int depth, int cases, unsigned int seed, double & oldTime, double & newTime){
+    setRenderDepth(depth);
+    Bitmap::setFakeGraphicsMode(WIDTH, HEIGHT);
+    srand(seed);
+
+    int failed = 0;
+    {
+        /* the bitmaps have to be gone before shutdown */
+        Bitmap background = Fixture::makeBackground(WIDTH, HEIGHT);
+        Bitmap work(WIDTH, HEIGHT);
+        Bitmap expected(WIDTH, HEIGHT);
+        for (int i = 0; i < cases; i++){
+            Bitmap encoded = Fixture::makeSprite(1 + rand() % 60, 1 + rand() % 80);
+            /* a deep copy doesn't have the runs */
+            Bitmap plain(encoded, true);
+            Shadow shadow = randomShadow(encoded);
+            const Bitmap & sprite = i % 2 == 0 ? encoded : plain;
+
+            background.Blit(work);
+            background.Blit(expected);
+            work.setClipRect(shadow.clipX1, shadow.clipY1, shadow.clipX2, shadow.clipY2);
+            expected.setClipRect(shadow.clipX1, shadow.clipY1, shadow.clipX2, shadow.clipY2);
+
+            TimeDifference timer;
+            timer.startTime();
+            oldDrawShadow(sprite, expected, shadow.x, shadow.y, shadow.intensity, shadow.color, shadow.scale, shadow.facingRight);
+            timer.endTime();
+            oldTime += timer.getMicroseconds();
+
+            timer.startTime();
+            sprite.drawShadow(work, shadow.x, shadow.y, shadow.intensity, shadow.color, shadow.scale, shadow.facingRight);
+            timer.endTime();
+            newTime += timer.getMicroseconds();
+
+            int wrong = compare(work, expected);
+            if (wrong != 0){
+                std::ostringstream out;
+                out << depth << "-bit case " << i << ": " << wrong << " pixels differ. Sprite " << sprite.getWidth() << "x" << sprite.getHeight()
+                    << (i % 2 == 0 ? " with runs" : " without runs") << " at " << shadow.x << ", " << shadow.y << " scale " << shadow.scale
+                    << (shadow.facingRight ? " facing right" : " facing left") << " intensity " << shadow.intensity;
+                Global::debug(0) << out.str() << std::endl;
+                failed += 1;
+            }
+        }
+    }
+
+    Bitmap::shutdown();
+
+    return failed;
+}
+
+static int run(int cases, unsigned int seed){
+    int failed = 0;
+    for (int depth = 16; depth <= 32; depth += 16){
+        double oldTime = 0;
+        double newTime = 0;
+        int wrong = runDepth(depth, cases, seed, oldTime, newTime);
+        std::ostringstream out;
+        out << depth << "-bit: " << (cases - wrong) << " of " << cases << " shadows match. "
+            << (cases > 0 ? oldTime / cases : 0) << "us per shadow before, "
+            << (cases > 0 ? newTime / cases : 0) << "us now";
+        Global::debug(0) << out.str() << std::endl;
+        failed += wrong;
+    }
+
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char ** argv){
+    Global::setDebug(0);
+    int cases = 500;
+    unsigned int seed = 1;
+    if (argc > 1){
+        cases = atoi(argv[1]);
+    }
+    if (argc > 2){
+        seed = atoi(argv[2]);
+    }
+    return run(cases, seed);
+}
@@ -1,62 +1,99 @@
 #include "util/debug.h"
 #include "util/init.h"
+#include "util/thread.h"
 #include "util/graphics/bitmap.h"
 #include "util/timedifference.h"
 #include <stdlib.h>
 
-#include <math.h>
 #include <string>
+#include <vector>
+#include <sstream>
+
+/* Scales an image with each hqx and xbr filter using 1, 2, 4, ... threads (up
+ * to at least the number of cpus) and reports the time per frame and the
+ * speedup over one thread.
+ * Usage: performance [image] [frames]
+ */
 
 using std::string;
 
-static void testhqx(Graphics::Bitmap input, string size, int increase){
-    Graphics::Bitmap output(input.getWidth() * increase, input.getHeight() * increase);
-    for (int i = 1; i < 4; i++){
-        TimeDifference timer;
-        int max = pow(10, i);
-        timer.startTime();
-        for (int x = 0; x < max; x++){
+enum Filter{
+    Hqx,
+    Xbr
+};
+
+static double timeFilter(const Graphics::Bitmap & input, const Graphics::Bitmap & output, Filter filter, int frames){
+    TimeDifference timer;
+    timer.startTime();
+    for (int frame = 0; frame < frames; frame++){
+        if (filter == Hqx){
             input.StretchHqx(output);
+        } else {
+            input.StretchXbr(output);
         }
-        timer.endTime();
-        Global::debug(0) << timer.printAverageTime(size, max) << std::endl;
     }
+    timer.endTime();
+    return frames > 0 ? timer.getMicroseconds() / 1000.0 / frames : 0;
 }
 
-static void testxbr(Graphics::Bitmap input, string size, int increase){
+static void test(const Graphics::Bitmap & input, Filter filter, const string & name, int increase, const std::vector<int> & threads, int frames){
     Graphics::Bitmap output(input.getWidth() * increase, input.getHeight() * increase);
-    for (int i = 1; i < 4; i++){
-        TimeDifference timer;
-        int max = pow(10, i);
-        timer.startTime();
-        for (int x = 0; x < max; x++){
-            input.StretchXbr(output);
+
+    /* once up front so the tables are built before timing */
+    Graphics::setScaleThreads(1);
+    timeFilter(input, output, filter, 1);
+
+    double single = 0;
+    for (unsigned int i = 0; i < threads.size(); i++){
+        Graphics::setScaleThreads(threads[i]);
+        double time = timeFilter(input, output, filter, frames);
+        if (threads[i] == 1){
+            single = time;
         }
-        timer.endTime();
-        Global::debug(0) << timer.printAverageTime(size, max) << std::endl;
+
+        std::ostringstream out;
+        out << name << " " << threads[i] << (threads[i] == 1 ? " thread: " : " threads: ") << time << "ms per frame";
+        if (single > 0 && time > 0){
+            out << ", " << (single / time) << "x";
+        }
+        Global::debug(0) << out.str() << std::endl;
     }
 }
 
-static void run(string path){
+static void run(const string & path, int frames){
     Graphics::Bitmap image(path);
 
-    testhqx(image, "hq2x", 2);
-    testhqx(image, "hq3x", 3);
-    testhqx(image, "hq4x", 4);
-    
-    testxbr(image, "2xbr", 2);
-    testxbr(image, "3xbr", 3);
-    testxbr(image, "4xbr", 4);
+    std::vector<int> threads;
+    int cpus = Util::Thread::cpuCount();
+    for (int count = 1; count <= 16 && (count <= 4 || count < cpus * 2); count *= 2){
+        threads.push_back(count);
+    }
+
+    Global::debug(0) << "Image is " << image.getWidth() << "x" << image.getHeight() << ", " << cpus << " cpus" << std::endl;
+
+    test(image, Hqx, "hq2x", 2, threads, frames);
+    test(image, Hqx, "hq3x", 3, threads, frames);
+    test(image, Hqx, "hq4x", 4, threads, frames);
+
+    test(image, Xbr, "2xbr", 2, threads, frames);
+    test(image, Xbr, "3xbr", 3, threads, frames);
+    test(image, Xbr, "4xbr", 4, threads, frames);
+
+    Graphics::setScaleThreads(0);
 }
 
 int main(int argc, char ** argv){
     Global::InitConditions conditions;
     Global::init(conditions);
     Global::setDebug(0);
+    string path = "src/test/hqx/test.png";
+    int frames = 100;
     if (argc > 1){
-        run(argv[1]);
-    } else {
-        run("src/test/hqx/test.png");
+        path = argv[1];
+    }
+    if (argc > 2){
+        frames = atoi(argv[2]);
     }
+    run(path, frames);
     return 0;
 }
@@ -0,0 +1,108 @@
+#include <string>
+#include <stdlib.h>
+#include "util/init.h"
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "mugen/character.h"
+#include "mugen/config.h"
+#include "mugen/behavior.h"
+#include "mugen/stage.h"
+#include "mugen/projectile.h"
+#include "mugen/random.h"
+#include "mugen/parse-cache.h"
+#include "util/file-system.h"
+
+using namespace std;
+
+/* Fills a stage with projectiles from both players and reports how many object
+ * pairs the broadphase let through compared to checking every pair.
+ * Usage: collision-stress [projectiles] [ticks]
+ */
+
+/* the standing light punch has attack boxes so the projectiles can hit */
+static const int PROJECTILE_ANIMATION = 200;
+
+static void addProjectiles(Mugen::Stage & stage, Mugen::Character & owner, int count, int id){
+    Mugen::HitDefinition hit;
+    for (int i = 0; i < count; i++){
+        double x = stage.maximumLeft(&owner) + (i * 37) % 320;
+        double y = stage.maximumUp() + (i * 53) % 200;
+        double velocity = (i % 2 == 0) ? 1 : -1;
+        stage.addProjectile(new (stage.getObjectPool()) Mugen::Projectile(x, y, id, &owner, PROJECTILE_ANIMATION, -1, -1,
+                                                  -1, 1, 1, true, -1,
+                                                  velocity, 0, 0, 0,
+                                                  0, 0, 1,
+                                                  1, 1, 0, 1, 3,
+                                                  40, 40, -240, 1, -1,
+                                                  -1, -1, 0, 0,
+                                                  0, 0, Mugen::FacingRight, hit));
+    }
+}
+
+static int run(int projectiles, int ticks){
+    Mugen::ParseCache cache;
+    Mugen::Character player1(Storage::instance().find(Filesystem::RelativePath("mugen/chars/kfm/kfm.def")), Mugen::Stage::Player1Side);
+    Mugen::Character player2(Storage::instance().find(Filesystem::RelativePath("mugen/chars/kfm/kfm.def")), Mugen::Stage::Player2Side);
+    player1.load();
+    player2.load();
+    Mugen::DummyBehavior behavior1;
+    Mugen::DummyBehavior behavior2;
+    player1.setBehavior(&behavior1);
+    player2.setBehavior(&behavior2);
+
+    Mugen::Stage stage(Storage::instance().find(Filesystem::RelativePath("mugen/stages/kfm.def")));
+    stage.addPlayer1(&player1);
+    stage.addPlayer2(&player2);
+    stage.load();
+    stage.reset();
+    stage.setRandom(Mugen::Random());
+
+    addProjectiles(stage, player1, projectiles / 2, 1);
+    addProjectiles(stage, player2, projectiles - projectiles / 2, 2);
+
+    unsigned long long tested = 0;
+    unsigned long long skipped = 0;
+    unsigned long long boxes = 0;
+
+    TimeDifference diff;
+    diff.startTime();
+    for (int tick = 0; tick < ticks; tick++){
+        stage.logic();
+        const Mugen::CollisionStatistics & statistics = stage.getCollisionStatistics();
+        tested += statistics.pairsTested;
+        skipped += statistics.pairsSkipped;
+        boxes += statistics.boxTests;
+    }
+    diff.endTime();
+
+    Global::debug(0, "test") << "Projectiles " << projectiles << " ticks " << ticks << endl;
+    Global::debug(0, "test") << "Pairs tested " << tested << " skipped " << skipped << " box tests " << boxes << endl;
+    if (tested + skipped > 0){
+        Global::debug(0, "test") << "Broadphase removed " << (skipped * 100 / (tested + skipped)) << "% of pairs" << endl;
+    }
+    Global::debug(0, "test") << diff.printTime("Took") << endl;
+
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    InputManager manager;
+    Global::InitConditions conditions;
+    conditions.graphics = Global::InitConditions::Disabled;
+    Global::init(conditions);
+    Global::setDebug(0);
+    int projectiles = 200;
+    int ticks = 600;
+    if (argc > 1){
+        projectiles = atoi(argv[1]);
+    }
+    if (argc > 2){
+        ticks = atoi(argv[2]);
+    }
+    try{
+        return run(projectiles, ticks);
+    } catch (const Exception::Base & fail){
+        Global::debug(0) << "Failed: " << fail.getTrace() << endl;
+    }
+    return 1;
+}
@@ -1,4 +1,5 @@
 #include "mugen/command.h"
+#include "mugen/constraint.h"
 #include "mugen/ast/key.h"
 #include "util/debug.h"
 #include <string>
@@ -110,7 +111,11 @@ Mugen::Input convert(string raw){
     Mugen::Input input;
     
     for (vector<string>::iterator it = keys.begin(); it != keys.end(); it++){
-        parseKey(input, Util::trim(*it));
+        string key = Util::trim(*it);
+        /* a tick with no keys */
+        if (key != ""){
+            parseKey(input, key);
+        }
     }
 
     return input;
@@ -149,6 +154,177 @@ static bool test2(){
     return !a.process(inputs);
 }
 
+/* Command2::handle as it was before the dependency sets were compiled to
+ * bitmasks. Used to check that the compiled version gives the same answers.
+ */
+class ReferenceCommand: public Mugen::Command2 {
+public:
+    ReferenceCommand(const string & name, Ast::KeyList * keys, int maxTime, int bufferTime):
+    Command2(name, keys, maxTime, bufferTime){
+    }
+
+    static bool emptyInput(const Mugen::Input & input){
+        return input == Mugen::Input();
+    }
+
+    bool referenceHandle(const Mugen::Input & input, int ticks){
+        typedef Util::ReferenceCount<Mugen::Constraint> ConstraintRef;
+        if (useBufferTime > 0){
+            useBufferTime -= 1;
+            return true;
+        }
+
+        if (activeTicks(ticks) > maxTime && emptyInput(input)){
+            resetConstraints();
+        }
+
+        bool emit = false;
+        std::set<ConstraintRef> satisfied;
+        for (vector<ConstraintRef>::iterator it = constraints.begin(); it != constraints.end(); it++){
+            bool all = true;
+            ConstraintRef constraint = *it;
+            const std::set<Mugen::ConstraintCompare> & depends = constraint->getDepends();
+            for (std::set<Mugen::ConstraintCompare>::const_iterator it2 = depends.begin(); it2 != depends.end(); it2++){
+                if (satisfied.find(it2->constraint) == satisfied.end()){
+                    all = false;
+                    break;
+                }
+            }
+
+            if (all){
+                if (constraint->satisfy(input, ticks)){
+                    satisfied.insert(constraint);
+                    if (constraint->isEmit()){
+                        emit = true;
+                    }
+                }
+            }
+        }
+
+        if (emitted){
+            emit = false;
+        }
+
+        if (emit){
+            useBufferTime = bufferTime - 1;
+            emitted = true;
+        }
+
+        if (satisfied.size() == constraints.size()){
+            resetConstraints();
+        }
+
+        return emit;
+    }
+};
+
+static Ast::Key * single(const char * name){
+    return new Ast::KeySingle(0, 0, name);
+}
+
+static Ast::Key * modifier(Ast::KeyModifier::ModifierType type, const char * name, int extra = 0){
+    return new Ast::KeyModifier(0, 0, type, single(name), extra);
+}
+
+static Ast::KeyList * keyList(Ast::Key * key1, Ast::Key * key2 = NULL, Ast::Key * key3 = NULL, Ast::Key * key4 = NULL){
+    std::vector<Ast::Key*> keys;
+    keys.push_back(key1);
+    if (key2 != NULL){
+        keys.push_back(key2);
+    }
+    if (key3 != NULL){
+        keys.push_back(key3);
+    }
+    if (key4 != NULL){
+        keys.push_back(key4);
+    }
+    return new Ast::KeyList(0, 0, keys);
+}
+
+/* A made up stream of input where keys are held for a few ticks at a time,
+ * the same way HumanBehavior reports them: `pressed' while held and
+ * `released' on the tick the key comes up.
+ */
+static vector<Mugen::Input> randomInput(int length, unsigned int seed){
+    vector<Mugen::Input> out;
+    bool held[11] = {false};
+    for (int tick = 0; tick < length; tick++){
+        bool was[11];
+        for (int key = 0; key < 11; key++){
+            was[key] = held[key];
+            seed = seed * 1103515245 + 12345;
+            /* directions change more often than buttons */
+            unsigned int chance = key < 4 ? 6 : 12;
+            if ((seed >> 16) % chance == 0){
+                held[key] = !held[key];
+            }
+        }
+
+        Mugen::Input input;
+        bool * pressed[11] = {&input.pressed.up, &input.pressed.down, &input.pressed.forward, &input.pressed.back,
+                              &input.pressed.a, &input.pressed.b, &input.pressed.c,
+                              &input.pressed.x, &input.pressed.y, &input.pressed.z, &input.pressed.start};
+        bool * released[11] = {&input.released.up, &input.released.down, &input.released.forward, &input.released.back,
+                               &input.released.a, &input.released.b, &input.released.c,
+                               &input.released.x, &input.released.y, &input.released.z, &input.released.start};
+        for (int key = 0; key < 11; key++){
+            *pressed[key] = held[key];
+            *released[key] = was[key] && !held[key];
+        }
+        out.push_back(input);
+    }
+
+    return out;
+}
+
+static bool compare(const string & name, Ast::KeyList * keys, const vector<Mugen::Input> & inputs){
+    ReferenceCommand reference(name, keys, 15, 1);
+    Mugen::Command2 compiled(name, keys, 15, 1);
+    int emits = 0;
+    for (unsigned int tick = 0; tick < inputs.size(); tick++){
+        bool expected = reference.referenceHandle(inputs[tick], tick + 1);
+        bool actual = compiled.handle(inputs[tick], tick + 1);
+        if (expected != actual){
+            Global::debug(0) << "Command " << name << " differs at tick " << (tick + 1) << ": expected " << expected << " got " << actual << std::endl;
+            return false;
+        }
+        if (actual){
+            emits += 1;
+        }
+    }
+
+    Global::debug(0) << "Command " << name << " matched for " << inputs.size() << " ticks, " << emits << " emits" << std::endl;
+    return true;
+}
+
+static bool test3(){
+    vector<Mugen::Input> inputs = randomInput(20000, 42);
+    vector<Mugen::Input> recorded = readInput("D; D; D, F; F; F, x; ; D; D, F; F; F; F, a; ; a; ~a; a, b; ~a, ~b; ; F; ; F; ~F; B; B; B; ~B; F, x; ; D; D, F; F; F, x, y; ~x, ~y");
+
+    Ast::KeyList * qcf = keyList(modifier(Ast::KeyModifier::Release, "D"), single("DF"), single("F"), single("x"));
+    Ast::KeyList * both = keyList(new Ast::KeyCombined(0, 0, single("a"), single("b")));
+    Ast::KeyList * hold = keyList(modifier(Ast::KeyModifier::MustBeHeldDown, "F"), single("a"));
+    Ast::KeyList * charge = keyList(modifier(Ast::KeyModifier::Release, "B", 3), single("F"), single("x"));
+    Ast::KeyList * dash = keyList(single("F"), single("F"));
+    Ast::KeyList * super = keyList(single("D"), single("DF"), single("F"), new Ast::KeyCombined(0, 0, single("x"), single("y")));
+
+    bool ok = compare("qcf_x", qcf, inputs) && compare("qcf_x", qcf, recorded) &&
+              compare("a+b", both, inputs) && compare("a+b", both, recorded) &&
+              compare("/F,a", hold, inputs) && compare("/F,a", hold, recorded) &&
+              compare("charge", charge, inputs) && compare("charge", charge, recorded) &&
+              compare("FF", dash, inputs) && compare("FF", dash, recorded) &&
+              compare("super", super, inputs) && compare("super", super, recorded);
+
+    delete qcf;
+    delete both;
+    delete hold;
+    delete charge;
+    delete dash;
+    delete super;
+
+    return ok;
+}
+
 static bool run(bool (*test)(), const string & name){
     bool out = test();
     Global::debug(0) << "Test " << name << " " << out << std::endl;
@@ -158,5 +334,6 @@ static bool run(bool (*test)(), const string & name){
 int main(int argc, char ** argv){
     return !(run(test1, "test1") &&
             run(test2, "test2") &&
+            run(test3, "test3") &&
             1);
 }
@@ -0,0 +1,143 @@
+#include <string>
+#include <vector>
+#include "util/init.h"
+#include "util/debug.h"
+#include "util/thread.h"
+#include "util/timedifference.h"
+#include "mugen/character.h"
+#include "mugen/config.h"
+#include "mugen/behavior.h"
+#include "mugen/stage.h"
+#include "mugen/world.h"
+#include "mugen/random.h"
+#include "mugen/parse-cache.h"
+#include "util/token.h"
+#include "util/file-system.h"
+
+using namespace std;
+
+/* Runs several matches at the same time, one per thread, and checks that they
+ * all end in the same state. Every match starts from the same random state so
+ * any state leaking between stages shows up as a mismatch. Build with tsan=1
+ * to have the thread sanitizer check the same run.
+ */
+
+static const int MATCHES = 8;
+
+struct Match{
+    Match():
+        thread(PaintownUtil::Thread::uninitializedValue),
+        ticks(0),
+        ok(false){
+        }
+
+    Mugen::Random random;
+    string player1;
+    string player2;
+    string stagePath;
+
+    PaintownUtil::Thread::Id thread;
+    string result;
+    int ticks;
+    bool ok;
+};
+
+static void * runMatch(void * arg){
+    Match * match = (Match*) arg;
+    try{
+        Mugen::ParseCache cache;
+        Mugen::Character player1(Storage::instance().find(Filesystem::RelativePath(match->player1)), Mugen::Stage::Player1Side);
+        Mugen::Character player2(Storage::instance().find(Filesystem::RelativePath(match->player2)), Mugen::Stage::Player2Side);
+        player1.load();
+        player2.load();
+        Mugen::LearningAIBehavior player1AIBehavior(Mugen::Data::getInstance().getDifficulty());
+        Mugen::LearningAIBehavior player2AIBehavior(Mugen::Data::getInstance().getDifficulty());
+        player1.setBehavior(&player1AIBehavior);
+        player2.setBehavior(&player2AIBehavior);
+
+        Mugen::Stage stage(Storage::instance().find(Filesystem::RelativePath(match->stagePath)));
+        stage.addPlayer1(&player1);
+        stage.addPlayer2(&player2);
+        stage.load();
+        stage.reset();
+        stage.setRandom(match->random);
+
+        while (!stage.isMatchOver()){
+            stage.logic();
+            match->ticks += 1;
+        }
+
+        Token * serial = stage.snapshotState()->serialize();
+        match->result = serial->toString();
+        delete serial;
+        match->ok = true;
+    } catch (const Exception::Base & fail){
+        Global::debug(0) << "Match failed: " << fail.getTrace() << endl;
+    }
+
+    return NULL;
+}
+
+static int run(const string & path1, const string & path2){
+    vector<Match> matches(MATCHES);
+    Mugen::Random random;
+    for (vector<Match>::iterator it = matches.begin(); it != matches.end(); it++){
+        Match & match = *it;
+        match.random = random;
+        match.player1 = path1;
+        match.player2 = path2;
+        match.stagePath = "mugen/stages/kfm.def";
+    }
+
+    Global::debug(0) << "Running " << MATCHES << " matches" << endl;
+    TimeDifference diff;
+    diff.startTime();
+    for (vector<Match>::iterator it = matches.begin(); it != matches.end(); it++){
+        Match & match = *it;
+        if (!PaintownUtil::Thread::createThread(&match.thread, NULL, (PaintownUtil::Thread::ThreadFunction) runMatch, &match)){
+            Global::debug(0) << "Could not create a thread, running the match directly" << endl;
+            runMatch(&match);
+        }
+    }
+
+    for (vector<Match>::iterator it = matches.begin(); it != matches.end(); it++){
+        Match & match = *it;
+        if (!PaintownUtil::Thread::isUninitialized(match.thread)){
+            PaintownUtil::Thread::joinThread(match.thread);
+        }
+    }
+    diff.endTime();
+    Global::debug(0, "test") << diff.printTime("Took") << endl;
+
+    for (int i = 0; i < MATCHES; i++){
+        if (!matches[i].ok){
+            Global::debug(0) << "Match " << i << " did not finish" << endl;
+            return 1;
+        }
+
+        if (matches[i].ticks != matches[0].ticks || matches[i].result != matches[0].result){
+            Global::debug(0) << "Match " << i << " ended differently than match 0 (" << matches[i].ticks << " ticks vs " << matches[0].ticks << ")" << endl;
+            return 1;
+        }
+    }
+
+    Global::debug(0, "test") << "Success! All matches took " << matches[0].ticks << " ticks" << endl;
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    InputManager manager;
+    Global::InitConditions conditions;
+    conditions.graphics = Global::InitConditions::Disabled;
+    Global::init(conditions);
+    Global::setDebug(0);
+    string path1 = "mugen/chars/kfm/kfm.def";
+    string path2 = "mugen/chars/kfm/kfm.def";
+    if (argc > 1){
+        path1 = argv[1];
+    }
+    if (argc > 2){
+        path2 = argv[2];
+    }
+    return run(path1, path2);
+}
@@ -0,0 +1,109 @@
+#include <string>
+#include <stdlib.h>
+#include "util/init.h"
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "mugen/character.h"
+#include "mugen/config.h"
+#include "mugen/behavior.h"
+#include "mugen/stage.h"
+#include "mugen/effect.h"
+#include "mugen/sprite.h"
+#include "mugen/random.h"
+#include "mugen/parse-cache.h"
+#include "util/file-system.h"
+
+using namespace std;
+
+/* Keeps a stage full of explods spread over several sprite priorities, some
+ * of them scaled, and reports the average time to render a frame and how many
+ * scaled bitmaps were created per frame.
+ * Usage: draw-stress [explods] [frames]
+ */
+
+/* An explod that never goes away, so the count stays the same every frame */
+class Explod: public Mugen::Effect {
+public:
+    Explod(const Mugen::Character * owner, PaintownUtil::ReferenceCount<Mugen::Animation> animation, int x, int y, double scale, int spritePriority):
+    Effect(owner, animation, 1, x, y, scale, scale, spritePriority){
+    }
+
+    virtual bool isDead(){
+        return false;
+    }
+};
+
+static void addExplods(Mugen::Stage & stage, const Mugen::Character & owner, int count){
+    /* the dust from fightfx.air, it exists in every fightfx */
+    PaintownUtil::ReferenceCount<Mugen::Animation> animation = stage.getFightAnimation(120);
+    for (int i = 0; i < count; i++){
+        int x = (i * 37) % 320;
+        int y = 40 + (i * 53) % 160;
+        /* spread them over the usual range of priorities */
+        int priority = i % 11 - 5;
+        double scale = i % 3 == 0 ? 1.5 : 1;
+        stage.addEffect(new (stage.getObjectPool()) Explod(&owner, animation, x, y, scale, priority));
+    }
+}
+
+static int run(int explods, int frames){
+    Mugen::ParseCache cache;
+    Mugen::Character player1(Storage::instance().find(Filesystem::RelativePath("mugen/chars/kfm/kfm.def")), Mugen::Stage::Player1Side);
+    Mugen::Character player2(Storage::instance().find(Filesystem::RelativePath("mugen/chars/kfm/kfm.def")), Mugen::Stage::Player2Side);
+    player1.load();
+    player2.load();
+    Mugen::DummyBehavior behavior1;
+    Mugen::DummyBehavior behavior2;
+    player1.setBehavior(&behavior1);
+    player2.setBehavior(&behavior2);
+
+    Mugen::Stage stage(Storage::instance().find(Filesystem::RelativePath("mugen/stages/kfm.def")));
+    stage.addPlayer1(&player1);
+    stage.addPlayer2(&player2);
+    stage.load();
+    stage.reset();
+    stage.setRandom(Mugen::Random());
+
+    addExplods(stage, player1, explods);
+
+    Graphics::Bitmap work(320, 240);
+    unsigned long long renderTime = 0;
+    unsigned int allocations = Mugen::SpriteV1::getScaledAllocations();
+    for (int frame = 0; frame < frames; frame++){
+        stage.logic();
+
+        TimeDifference diff;
+        diff.startTime();
+        stage.render(&work);
+        diff.endTime();
+        renderTime += diff.getMicroseconds();
+    }
+
+    Global::debug(0, "test") << "Explods " << stage.countExplods(0, &player1) << " frames " << frames << endl;
+    Global::debug(0, "test") << "Average render " << (renderTime / frames) << "us" << endl;
+    Global::debug(0, "test") << "Scaled bitmaps per frame " << ((double) (Mugen::SpriteV1::getScaledAllocations() - allocations) / frames) << endl;
+
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    InputManager manager;
+    Global::InitConditions conditions;
+    Global::init(conditions);
+    Global::setDebug(0);
+    int explods = 150;
+    int frames = 600;
+    if (argc > 1){
+        explods = atoi(argv[1]);
+    }
+    if (argc > 2){
+        frames = atoi(argv[2]);
+    }
+    try{
+        return run(explods, frames);
+    } catch (const Exception::Base & fail){
+        Global::debug(0) << "Failed: " << fail.getTrace() << endl;
+    }
+    return 1;
+}
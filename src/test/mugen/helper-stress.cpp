@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include "util/init.h"
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "mugen/character.h"
+#include "mugen/helper.h"
+#include "mugen/config.h"
+#include "mugen/behavior.h"
+#include "mugen/stage.h"
+#include "mugen/parse-cache.h"
+#include "util/file-system.h"
+
+using namespace std;
+
+/* Spawns and destroys helpers from a loaded character over and over, the way
+ * a character that calls Helper every few ticks would, and reports the
+ * average time to create and to destroy one.
+ * Usage: helper-stress [helpers] [rounds]
+ */
+
+static int run(int helpers, int rounds){
+    Mugen::ParseCache cache;
+    Mugen::Character player1(Storage::instance().find(Filesystem::RelativePath("mugen/chars/kfm/kfm.def")), Mugen::Stage::Player1Side);
+    player1.load();
+    Mugen::DummyBehavior behavior1;
+    player1.setBehavior(&behavior1);
+
+    vector<Mugen::Helper*> spawned;
+    unsigned long long spawnTime = 0;
+    unsigned long long destroyTime = 0;
+    for (int round = 0; round < rounds; round++){
+        TimeDifference spawn;
+        spawn.startTime();
+        for (int i = 0; i < helpers; i++){
+            spawned.push_back(new Mugen::Helper(&player1, &player1, i, "stress"));
+        }
+        spawn.endTime();
+        spawnTime += spawn.getMicroseconds();
+
+        TimeDifference destroy;
+        destroy.startTime();
+        for (vector<Mugen::Helper*>::iterator it = spawned.begin(); it != spawned.end(); it++){
+            delete *it;
+        }
+        destroy.endTime();
+        destroyTime += destroy.getMicroseconds();
+        spawned.clear();
+    }
+
+    double total = (double) helpers * rounds;
+    Global::debug(0, "test") << "Helpers " << helpers << " rounds " << rounds << endl;
+    Global::debug(0, "test") << "States " << player1.getStates().size() << " animations " << player1.getAnimations().size() << endl;
+    Global::debug(0, "test") << "Average spawn " << (spawnTime / total) << "us" << endl;
+    Global::debug(0, "test") << "Average destroy " << (destroyTime / total) << "us" << endl;
+
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    InputManager manager;
+    Global::InitConditions conditions;
+    conditions.graphics = Global::InitConditions::Disabled;
+    Global::init(conditions);
+    Global::setDebug(0);
+    int helpers = 50;
+    int rounds = 200;
+    if (argc > 1){
+        helpers = atoi(argv[1]);
+    }
+    if (argc > 2){
+        rounds = atoi(argv[2]);
+    }
+    try{
+        return run(helpers, rounds);
+    } catch (const Exception::Base & fail){
+        Global::debug(0) << "Failed: " << fail.getTrace() << endl;
+    }
+    return 1;
+}
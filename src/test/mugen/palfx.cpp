@@ -0,0 +1,99 @@
+#include <map>
+#include <stdlib.h>
+#include "util/init.h"
+#include "util/debug.h"
+#include "util/timedifference.h"
+#include "util/graphics/bitmap.h"
+#include "mugen/palette-filter.h"
+
+using namespace std;
+
+/* Draws a full screen bitmap through the PalFX filter, once the way it used to
+ * be done with a filter call per pixel and once with the channel tables, and
+ * reports the average time per frame for both.
+ * Usage: palfx [frames]
+ */
+
+/* The old filter: a virtual call per pixel with a map in front of the math */
+class PerPixel: public Graphics::Bitmap::Filter {
+public:
+    PerPixel(const Graphics::Bitmap::Filter & effects):
+    effects(effects){
+    }
+
+    const Graphics::Bitmap::Filter & effects;
+    mutable map<Graphics::Color, Graphics::Color> cache;
+
+    Graphics::Color filter(Graphics::Color pixel) const {
+        if (cache.find(pixel) != cache.end()){
+            return cache[pixel];
+        }
+
+        Graphics::Color out = effects.filter(pixel);
+        cache[pixel] = out;
+        return out;
+    }
+
+    PaintownUtil::ReferenceCount<Graphics::Shader> getShader(){
+        return PaintownUtil::ReferenceCount<Graphics::Shader>(NULL);
+    }
+
+    void setupShader(const PaintownUtil::ReferenceCount<Graphics::Shader> & shader){
+    }
+};
+
+static unsigned long long drawFrames(const Graphics::Bitmap & source, const Graphics::Bitmap & work, int frames, bool tables){
+    unsigned long long total = 0;
+    for (int frame = 0; frame < frames; frame++){
+        /* the sin term changes every tick so the filter is rebuilt every frame */
+        Mugen::PaletteFilter effects(frame, 30, 10, -20, 256, 200, 240, 40, 40, 40, 30, 0, 200);
+        PerPixel perPixel(effects);
+
+        TimeDifference diff;
+        diff.startTime();
+        if (tables){
+            source.draw(0, 0, &effects, work);
+        } else {
+            source.draw(0, 0, &perPixel, work);
+        }
+        diff.endTime();
+        total += diff.getMicroseconds();
+    }
+    return total;
+}
+
+static int run(int frames){
+    Graphics::Bitmap source(640, 480);
+    Graphics::Bitmap work(640, 480);
+    /* a spread of colors like a busy stage would have */
+    for (int y = 0; y < source.getHeight(); y++){
+        for (int x = 0; x < source.getWidth(); x++){
+            source.putPixel(x, y, Graphics::makeColor(x % 256, y % 256, (x * y) % 256));
+        }
+    }
+
+    unsigned long long perPixel = drawFrames(source, work, frames, false);
+    unsigned long long tables = drawFrames(source, work, frames, true);
+
+    Global::debug(0, "test") << "Frames " << frames << " at " << source.getWidth() << "x" << source.getHeight() << endl;
+    Global::debug(0, "test") << "Per pixel filter " << (perPixel / frames) << "us per frame" << endl;
+    Global::debug(0, "test") << "Channel tables " << (tables / frames) << "us per frame" << endl;
+
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    Global::InitConditions conditions;
+    Global::init(conditions);
+    Global::setDebug(0);
+    int frames = 200;
+    if (argc > 1){
+        frames = atoi(argv[1]);
+    }
+    try{
+        return run(frames);
+    } catch (const Exception::Base & fail){
+        Global::debug(0) << "Failed: " << fail.getTrace() << endl;
+    }
+    return 1;
+}
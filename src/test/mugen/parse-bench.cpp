@@ -0,0 +1,144 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <stdlib.h>
+#include <time.h>
+#include "mugen/parser/all.h"
+#include "mugen/ast/all.h"
+
+using namespace std;
+
+namespace Util{
+string trim(const std::string & str){
+    string s;
+    size_t startpos = str.find_first_not_of(" \t");
+    size_t endpos = str.find_last_not_of(" \t");
+    // if all spaces or empty return an empty string
+    if ((string::npos == startpos) ||
+        (string::npos == endpos)){
+        return "";
+    } else {
+        return str.substr(startpos, endpos-startpos+1);
+    }
+    return str;
+}
+}
+
+/* Parses a set of cmd/cns/def/air files over and over and reports the
+ * throughput of the generated parsers. The files are read into memory first so
+ * only the parse and the destruction of the tree are timed.
+ * Usage: parse-bench [-n runs] file.cns file.cmd ...
+ */
+
+typedef const void * (*Parser)(const char * in, int length, bool stats);
+
+struct Input{
+    string name;
+    string data;
+    Parser parse;
+};
+
+static bool hasExtension(const string & file, const string & extension){
+    return file.find(extension) != string::npos;
+}
+
+static Parser findParser(const string & file){
+    if (hasExtension(file, ".cmd") || hasExtension(file, ".cns") || hasExtension(file, ".st")){
+        return Mugen::Cmd::parse;
+    }
+    if (hasExtension(file, ".def")){
+        return Mugen::Def::parse;
+    }
+    if (hasExtension(file, ".air")){
+        return Mugen::Air::parse;
+    }
+    return NULL;
+}
+
+static bool readFile(const string & file, string & out){
+    ifstream stream(file.c_str(), ios::in | ios::binary);
+    if (!stream){
+        return false;
+    }
+    ostringstream buffer;
+    buffer << stream.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+static void destroy(const void * result){
+    list<Ast::Section*> * sections = (list<Ast::Section*>*) result;
+    for (list<Ast::Section*>::iterator it = sections->begin(); it != sections->end(); it++){
+        delete (*it);
+    }
+    delete sections;
+}
+
+/* returns false if the file did not parse */
+static bool parseOnce(const Input & input){
+    try{
+        destroy(input.parse(input.data.c_str(), input.data.size(), false));
+        return true;
+    } catch (const Mugen::Cmd::ParseException & fail){
+        cout << input.name << ": " << fail.getReason() << endl;
+    } catch (const Mugen::Def::ParseException & fail){
+        cout << input.name << ": " << fail.getReason() << endl;
+    } catch (const Mugen::Air::ParseException & fail){
+        cout << input.name << ": " << fail.getReason() << endl;
+    }
+    return false;
+}
+
+int main(int argc, char ** argv){
+    int runs = 20;
+    vector<Input> inputs;
+    unsigned long long bytes = 0;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc){
+            runs = atoi(argv[i + 1]);
+            i += 1;
+            continue;
+        }
+        Input input;
+        input.name = arg;
+        input.parse = findParser(arg);
+        if (input.parse == NULL){
+            cout << "Don't know how to parse " << arg << endl;
+            continue;
+        }
+        if (!readFile(arg, input.data)){
+            cout << "Could not read " << arg << endl;
+            continue;
+        }
+        /* one run up front to drop files that fail and warm the caches */
+        if (parseOnce(input)){
+            bytes += input.data.size();
+            inputs.push_back(input);
+        }
+    }
+
+    if (inputs.size() == 0){
+        cout << "Give some files to parse (foo.cns, foo.def, foo.air, or foo.cmd)" << endl;
+        return 1;
+    }
+
+    clock_t start = clock();
+    for (int run = 0; run < runs; run++){
+        for (vector<Input>::const_iterator it = inputs.begin(); it != inputs.end(); it++){
+            parseOnce(*it);
+        }
+    }
+    clock_t end = clock();
+
+    double seconds = (double) (end - start) / CLOCKS_PER_SEC;
+    double total = (double) bytes * runs;
+    cout << "Parsed " << inputs.size() << " files (" << bytes << " bytes) " << runs << " times in " << seconds << "s" << endl;
+    if (seconds > 0){
+        cout << "Throughput " << (total / (1024 * 1024) / seconds) << " MB/s" << endl;
+    }
+    return 0;
+}
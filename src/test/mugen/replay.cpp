@@ -63,8 +63,9 @@ public:
 
 int run(string path1 = "mugen/chars/kfm/kfm.def", string path2 = "mugen/chars/kfm/kfm.def"){
     Game game(path1, path2, "mugen/stages/kfm.def");
-    Mugen::Random randomState(*Mugen::Random::getState());
+    Mugen::Random randomState;
     game.load();
+    game.stage->setRandom(randomState);
 
     vector<PaintownUtil::ReferenceCount<Mugen::World> > worlds;
 
@@ -83,8 +84,8 @@ int run(string path1 = "mugen/chars/kfm/kfm.def", string path2 = "mugen/chars/kf
     Global::debug(0, "test") << diff.printTime("Took") << endl;
 
     /* Reset the state */
-    Mugen::Random::setState(randomState);
     game.load();
+    game.stage->setRandom(randomState);
 
     Global::debug(0) << "Rerun match and check states" << std::endl;
     /* Now check that all previous states match what comes out of the new game */
@@ -119,8 +120,8 @@ int run(string path1 = "mugen/chars/kfm/kfm.def", string path2 = "mugen/chars/kf
         Global::debug(0, "test") << diff.printTime("Took") << endl;
     }
     
-    Mugen::Random::setState(randomState);
     game.load();
+    game.stage->setRandom(randomState);
 
     Global::debug(0) << "Set every 50th state." << std::endl;
     /* Now check that all previous states match what comes out of the new game */
@@ -484,7 +485,6 @@ void record(){
 
     string kfm = "mugen/chars/kfm/kfm.def";
     Game game(kfm, kfm, "mugen/stages/kfm.def");
-    Mugen::Random randomState(*Mugen::Random::getState());
     game.load();
 
     RecordHumanBehavior human(Mugen::getPlayer1Keys(), Mugen::getPlayer1InputLeft());
@@ -542,8 +542,9 @@ int play(){
     string kfm = "mugen/chars/kfm/kfm.def";
     Game game(kfm, kfm, "mugen/stages/kfm.def");
     srand(0);
-    Mugen::Random randomState(*Mugen::Random::getState());
+    Mugen::Random randomState;
     game.load();
+    game.stage->setRandom(randomState);
 
     vector<PaintownUtil::ReferenceCount<Mugen::World> > worlds;
 
@@ -562,10 +563,10 @@ int play(){
 
     Global::debug(0) << worlds.size() << " world states" << std::endl;
     
-    Mugen::Random::setState(randomState);
     {
         int count = 200;
         game.load();
+        game.stage->setRandom(randomState);
         PlayBehavior human(REPLAY_FILE);
         game.player1->setBehavior(&human);
         PaintownUtil::ReferenceCount<Mugen::Stage> stage = game.stage;
@@ -36,12 +36,17 @@ void run(string path1 = "mugen/chars/kfm/kfm.def", string path2 = "mugen/chars/k
      * as fast as possible.
      */
     TimeDifference diff;
+    unsigned long long ticks = 0;
     diff.startTime();
     while (!stage.isMatchOver()){
         stage.logic();
+        ticks += 1;
     }
     diff.endTime();
     Global::debug(0, "test") << diff.printTime("Success! Took") << endl;
+    if (diff.getMicroseconds() > 0){
+        Global::debug(0, "test") << ticks << " ticks, " << (unsigned long long) (ticks * 1000000.0 / diff.getMicroseconds()) << " ticks per second" << endl;
+    }
 }
 
 int main(int argc, char ** argv){
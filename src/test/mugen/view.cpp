@@ -295,7 +295,7 @@ void showStage(const string & ourFile, const string &p1_name, const string &p2_n
     }
 
     Global::debug(0) << "Trying to load stage: " << ourFile << "..." << endl;
-    Mugen::Stage stage = Mugen::Stage(Filesystem::AbsolutePath(ourFile));
+    Mugen::Stage stage((Filesystem::AbsolutePath(ourFile)));
     //stage.load();
     Global::debug(0) << "Loaded stage: \"" << stage.getName() << "\" successfully." << endl;
     bool quit = false;
@@ -7,6 +7,7 @@
 
 #include "gif/algif.h"
 #include "util/init.h"
+#include "util/thread.h"
 #include "loadpng/loadpng.h"
 #include <stdarg.h>
 #include <vector>
@@ -655,6 +656,10 @@ void Bitmap::screenBlender( int r, int g, int b, int a ){
 	set_screen_blender( r, g, b, a );
 }
 
+/* the runs are only used by the SDL blitter */
+void Bitmap::encodeMask(){
+}
+
 void Bitmap::replaceColor(const Color & original, const Color & replaced){
     int height = getHeight();
     int width = getWidth();
@@ -670,6 +675,60 @@ void Bitmap::replaceColor(const Color & original, const Color & replaced){
     }
 }
 
+/* allegro picks the color depth itself */
+void setRenderDepth(int bits){
+}
+
+int getRenderDepth(){
+    return get_color_depth();
+}
+
+/* there are no hqx/xbr filters here */
+void setScaleThreads(int threads){
+}
+
+int getScaleThreads(){
+    return 1;
+}
+
+/* frames are always presented on the calling thread */
+void setPresentThread(bool enabled){
+}
+
+bool getPresentThread(){
+    return false;
+}
+
+SurfacePoolStatistics getSurfacePoolStatistics(){
+    return SurfacePoolStatistics();
+}
+
+void clearSurfacePool(){
+}
+
+struct RenderCommands{
+};
+
+RenderList::RenderList(const Bitmap & where):
+commands(NULL){
+}
+
+RenderList::~RenderList(){
+}
+
+void RenderList::start(){
+}
+
+void RenderList::flush(int bands){
+}
+
+void RenderList::finish(int bands){
+}
+
+unsigned int RenderList::size() const {
+    return 0;
+}
+
 int changeGraphicsMode(int mode, int width, int height){
     return setGraphicsMode(mode, width, height);
 }
@@ -925,6 +984,52 @@ void TranslucentBitmap::hLine( const int x1, const int y, const int x2, const Co
     ::hline(getData()->getBitmap(), x1, y, x2, color.color);
     drawingMode(MODE_SOLID);
 }
+
+/* Draws each opaque run of the squashed sprite as a translucent line straight
+ * into where, instead of stretching and coloring in a temporary bitmap.
+ */
+void Bitmap::drawShadow(Bitmap & where, int x, int y, int intensity, Color color, double scale, bool facingRight) const {
+    const double newheight = getHeight() * scale;
+    const int height = (int) fabs(newheight);
+
+    transBlender(0, 0, 0, intensity);
+
+    if (height <= 0 || color == MaskColor()){
+        return;
+    }
+
+    /* a positive scale hangs the shadow upside down below y */
+    bool vflip = true;
+    if (scale < 0){
+        vflip = false;
+        y -= fabs(newheight);
+        x += facingRight ? 3 : -3;
+    }
+
+    TranslucentBitmap shade = where.translucent();
+    const int width = getWidth();
+    for (int row = 0; row < height; row++){
+        int sourceY = row * getHeight() / height;
+        int destY = y + (vflip ? height - 1 - row : row);
+        int column = 0;
+        while (column < width){
+            while (column < width && getPixel(column, sourceY) == MaskColor()){
+                column += 1;
+            }
+            int start = column;
+            while (column < width && getPixel(column, sourceY) != MaskColor()){
+                column += 1;
+            }
+            if (column > start){
+                if (facingRight){
+                    shade.hLine(x + start, destY, x + column - 1, color);
+                } else {
+                    shade.hLine(x + width - column, destY, x + width - 1 - start, color);
+                }
+            }
+        }
+    }
+}
 	
 void Bitmap::vLine( const int y1, const int x, const int y2, const Color color ) const{
 	::vline( getData()->getBitmap(), x, y1, y2, color.color );
@@ -284,6 +284,10 @@ static bool isVideoBitmap(ALLEGRO_BITMAP * bitmap){
            !(al_get_bitmap_flags(bitmap) & ALLEGRO_MEMORY_BITMAP);
 }
 
+/* the runs are only used by the SDL blitter */
+void Bitmap::encodeMask(){
+}
+
 void Bitmap::replaceColor(const Color & original, const Color & replaced){
     changeTarget(this, this);
 
@@ -574,6 +578,60 @@ ALLEGRO_SHADER * create_shader(const std::string & vertex, const std::string & p
     return shader;
 }
 
+/* allegro picks the color depth itself */
+void setRenderDepth(int bits){
+}
+
+int getRenderDepth(){
+    return 32;
+}
+
+/* there are no hqx/xbr filters here */
+void setScaleThreads(int threads){
+}
+
+int getScaleThreads(){
+    return 1;
+}
+
+/* frames are always presented on the calling thread */
+void setPresentThread(bool enabled){
+}
+
+bool getPresentThread(){
+    return false;
+}
+
+SurfacePoolStatistics getSurfacePoolStatistics(){
+    return SurfacePoolStatistics();
+}
+
+void clearSurfacePool(){
+}
+
+struct RenderCommands{
+};
+
+RenderList::RenderList(const Bitmap & where):
+commands(NULL){
+}
+
+RenderList::~RenderList(){
+}
+
+void RenderList::start(){
+}
+
+void RenderList::flush(int bands){
+}
+
+void RenderList::finish(int bands){
+}
+
+unsigned int RenderList::size() const {
+    return 0;
+}
+
 int changeGraphicsMode(int mode, int width, int height){
     switch (mode){
         case FULLSCREEN: {
@@ -95,6 +95,62 @@ QualityFilter qualityFilterName(const std::string & type){
     return NoFilter;
 }
 
+Bitmap::ChannelFilter::ChannelFilter(const unsigned char * red, const unsigned char * green, const unsigned char * blue):
+red(red),
+green(green),
+blue(blue){
+}
+
+Color Bitmap::ChannelFilter::filter(Color pixel) const {
+    return makeColor(red[getRed(pixel)], green[getGreen(pixel)], blue[getBlue(pixel)]);
+}
+
+Bitmap::ColorMapFilter::ColorMapFilter():
+table(1),
+mask(0),
+count(0){
+}
+
+Bitmap::ColorMapFilter::ColorMapFilter(const std::map<Color, Color> & colors):
+table(1),
+mask(0),
+count(0){
+    setColors(colors);
+}
+
+void Bitmap::ColorMapFilter::setColors(const std::map<Color, Color> & colors){
+    /* keep the table at most half full so probes stay short */
+    unsigned int size = 1;
+    while (size < colors.size() * 2){
+        size *= 2;
+    }
+
+    table.assign(size, Entry());
+    mask = size - 1;
+    count = 0;
+    for (std::map<Color, Color>::const_iterator it = colors.begin(); it != colors.end(); it++){
+        unsigned int slot = hash(it->first) & mask;
+        while (table[slot].used){
+            slot = (slot + 1) & mask;
+        }
+        table[slot].from = it->first;
+        table[slot].to = it->second;
+        table[slot].used = true;
+        count += 1;
+    }
+}
+
+Color Bitmap::ColorMapFilter::filter(Color pixel) const {
+    return lookup(pixel);
+}
+
+Util::ReferenceCount<Shader> Bitmap::ColorMapFilter::getShader(){
+    return Util::ReferenceCount<Shader>(NULL);
+}
+
+void Bitmap::ColorMapFilter::setupShader(const Util::ReferenceCount<Shader> & shader){
+}
+
 Bitmap::~Bitmap(){
     if (mustResize){
         for (std::vector<Bitmap*>::iterator it = needResize.begin(); it != needResize.end(); it++){
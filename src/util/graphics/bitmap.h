@@ -138,6 +138,61 @@ int setGfxModeWindowed( int x, int y );
 int setGraphicsMode(int mode, int width, int height);
 int changeGraphicsMode(int mode, int width, int height);
 
+/* Bits per pixel to render in, 16 or 32. Only the SDL backend looks at this
+ * and it has to be called before setGraphicsMode or any bitmap is made.
+ */
+void setRenderDepth(int bits);
+int getRenderDepth();
+
+/* How many threads the hqx and xbr filters split a frame between, 0 means one
+ * per cpu. Only the SDL backend has those filters.
+ */
+void setScaleThreads(int threads);
+int getScaleThreads();
+
+/* When on, BlitToScreen hands the frame to another thread that puts it on
+ * the screen while the caller goes on with the next frame. Drawing onto the
+ * frame waits until it is on the screen. Only the SDL backend does this.
+ */
+void setPresentThread(bool enabled);
+bool getPresentThread();
+
+/* What the pool of surfaces behind Bitmap(width, height) did during the last
+ * frame put on the screen. Only the SDL backend pools surfaces.
+ */
+struct SurfacePoolStatistics{
+    SurfacePoolStatistics():
+    created(0),
+    reused(0),
+    returned(0),
+    freed(0),
+    subBitmaps(0),
+    surfaces(0),
+    bytes(0){
+    }
+
+    /* allocated since the pool had no surface of the size */
+    unsigned int created;
+    /* allocations avoided by taking a surface from the pool */
+    unsigned int reused;
+    /* surfaces put back into the pool */
+    unsigned int returned;
+    /* surfaces freed because the pool was full */
+    unsigned int freed;
+    /* surfaces made for sub-bitmaps, which don't come from the pool. Only
+     * the surface header is allocated, the pixels are the parent's.
+     */
+    unsigned int subBitmaps;
+    /* what is sitting in the pool at the end of the frame */
+    unsigned int surfaces;
+    unsigned int bytes;
+};
+
+SurfacePoolStatistics getSurfacePoolStatistics();
+
+/* free the surfaces in the pool */
+void clearSurfacePool();
+
 /* get color components */
 int getRed(Color x);
 int getBlue(Color x);
@@ -212,6 +267,88 @@ public:
             virtual ~Filter(){
             }
         };
+
+        /* A filter that changes the red, green and blue channels independently
+         * of each other, given as a 256 entry table per channel. The tables are
+         * owned by whoever creates the filter. Software blitters that know
+         * their pixel format can use the tables directly instead of calling
+         * filter() for every pixel.
+         */
+        class ChannelFilter: public Filter {
+        public:
+            ChannelFilter(const unsigned char * red, const unsigned char * green, const unsigned char * blue);
+
+            virtual Color filter(Color pixel) const;
+
+            const unsigned char * red;
+            const unsigned char * green;
+            const unsigned char * blue;
+        };
+
+        /* A filter that swaps some colors for others and leaves the rest
+         * alone, like a palette swap. The pairs are kept in an open addressed
+         * hash table keyed on the color so software blitters can look up each
+         * pixel with lookup() instead of calling filter().
+         */
+        class ColorMapFilter: public Filter {
+        public:
+            ColorMapFilter();
+            ColorMapFilter(const std::map<Color, Color> & colors);
+
+            virtual Color filter(Color pixel) const;
+
+            /* no shader, only software rendering uses the table */
+            virtual Util::ReferenceCount<Shader> getShader();
+            virtual void setupShader(const Util::ReferenceCount<Shader> & shader);
+
+            /* the color that replaces pixel, or pixel itself */
+            inline Color lookup(const Color & pixel) const {
+                unsigned int slot = hash(pixel) & mask;
+                while (true){
+                    const Entry & entry = table[slot];
+                    if (!entry.used){
+                        return pixel;
+                    }
+                    if (entry.from == pixel){
+                        return entry.to;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+            }
+
+            /* number of colors that are replaced */
+            inline unsigned int size() const {
+                return count;
+            }
+
+        protected:
+            void setColors(const std::map<Color, Color> & colors);
+
+            static inline unsigned int hash(const Color & color){
+                /* FNV-1a over the bytes of the color */
+                const unsigned char * bytes = (const unsigned char *) &color.color;
+                unsigned int value = 2166136261u;
+                for (unsigned int i = 0; i < sizeof(INTERNAL_COLOR); i++){
+                    value = (value ^ bytes[i]) * 16777619u;
+                }
+                return value;
+            }
+
+            struct Entry{
+                Entry():
+                used(false){
+                }
+
+                Color from;
+                Color to;
+                bool used;
+            };
+
+            /* always has at least one unused entry so lookups stop */
+            std::vector<Entry> table;
+            unsigned int mask;
+            unsigned int count;
+        };
         	
 	/* default constructor makes 10x10 bitmap */
 	Bitmap();
@@ -289,6 +426,15 @@ public:
         void set8BitMaskColor(const Color & color);
         Color get8BitMaskColor();
 
+        /* Remembers where the non-mask pixels are in each row so masked
+         * draws can skip the transparent parts. Only for bitmaps that are done
+         * being changed, like loaded sprites. fill() and replaceColor() drop
+         * the runs but drawing onto the bitmap does not, so call this again
+         * after changing the pixels some other way.
+         * Only the SDL backend uses the runs.
+         */
+        void encodeMask();
+
         /* Blend between source pixel and destination pixel.
          * Source and dest should be 0-255.
          * source = 64, dest = 128
@@ -659,6 +805,8 @@ protected:
 #endif
 };
 
+class RenderList;
+
 class StretchedBitmap: public Bitmap {
 public:
     /* How to initialize the bitmap */
@@ -674,6 +822,9 @@ public:
     };
 
     StretchedBitmap(int width, int height, const Bitmap & where, Clear = NoClear, QualityFilter filter = NoFilter);
+    /* With more than one cpu the drawing between start and finish is
+     * recorded and then drawn in bands, one per cpu.
+     */
     void finish();
     void start();
     virtual int getWidth() const;
@@ -691,6 +842,7 @@ protected:
     const QualityFilter filter;
     const Clear clearKind;
     Bitmap scaleToFilter;
+    Util::ReferenceCount<RenderList> record;
 };
 
 class TranslatedBitmap: public Bitmap {
@@ -785,6 +937,47 @@ protected:
     const Clear clearKind;
 };
 
+struct RenderCommands;
+
+/* Records drawing onto a bitmap instead of doing it straight away, then draws
+ * the list in horizontal bands with one thread per band. Each command keeps
+ * the blender that was set when it was recorded so the result is the same as
+ * drawing immediately.
+ *
+ * Sprites (without a filter), fills, translucent rectangle fills and blits
+ * are recorded. Everything else, including reading pixels, draws the list
+ * first and then runs straight away. So does drawing onto a sub-bitmap of the
+ * bitmap, or onto a bitmap the list draws from.
+ *
+ * Starting a list while another one records on the same thread draws the
+ * other one, which carries on recording when this one finishes.
+ *
+ * Only the SDL backend records, the others draw everything immediately. On
+ * the ports without thread local storage the list is drawn in one band.
+ */
+class RenderList{
+public:
+    RenderList(const Bitmap & where);
+    virtual ~RenderList();
+
+    /* start recording drawing onto the bitmap on this thread */
+    void start();
+    /* draw what has been recorded so far, 0 bands means one per cpu */
+    void flush(int bands = 0);
+    /* stop recording and draw the rest */
+    void finish(int bands = 0);
+
+    /* number of commands waiting to be drawn */
+    unsigned int size() const;
+
+protected:
+    RenderCommands * commands;
+
+private:
+    RenderList(const RenderList &);
+    RenderList & operator=(const RenderList &);
+};
+
 }
 
 #endif
@@ -2,8 +2,10 @@
 #include "util/debug.h"
 #include "util/system.h"
 #include "util/init.h"
+#include "util/thread.h"
 #include "hqx.h"
 #include "xbr.h"
+#include "span.h"
 #include "sprig/sprig.h"
 #include "stretch/SDL_stretch.h"
 #include <SDL.h>
@@ -13,16 +15,35 @@
 #include "util/exceptions/exception.h"
 #include <string>
 #include <sstream>
+#include <set>
 
 namespace Graphics{
 
 static const int WINDOWED = 0;
 static const int FULLSCREEN = 1;
-/* bits per pixel */
+/* bits per pixel of every surface we render to, 16 or 32. Set once by
+ * setRenderDepth() before the graphics mode is set.
+ */
 static int SCREEN_DEPTH = 16;
+/* threads for StretchHqx and StretchXbr, 0 is one per cpu */
+static int SCALE_THREADS = 0;
+/* BlitToScreen hands the frame to a present thread */
+static bool PRESENT_THREAD = false;
+static void waitForPresent();
+/* the pixels the present thread is putting on the screen, NULL when it is idle */
+static const BitmapData * presentPixels = NULL;
 static SDL_Surface * screen;
 
 static SDL_PixelFormat format565;
+/* 8 bits per channel, the top byte is unused */
+static SDL_PixelFormat format8888;
+
+static inline SDL_PixelFormat * renderFormat(){
+    if (SCREEN_DEPTH == 32){
+        return &format8888;
+    }
+    return &format565;
+}
 
 /* FIXME: try to get rid of these two variables */
 /*
@@ -32,47 +53,117 @@ static int SCALE_Y;
 
 typedef unsigned int (*blender)(unsigned int color1, unsigned int color2, unsigned int alpha);
 
-/* taken from allegro 4.2: src/colblend.c, _blender_trans16 */
-/* this function performs a psuedo-SIMD operation on the pixel
- * components in RGB 5-6-5 format. To get this to work for some
- * other format probably all that needs to happen is to change
- * the 0x7E0F81F constant to something else. 5-5-5:
- * binary: 0011 1110 000 0111 1100 0001 1111
- * hex:    0x174076037
+/* How to get at the channels of a pixel in each render depth. The blenders
+ * and the software blitters below are templates over these.
  */
-static inline unsigned int transBlender(unsigned int x, unsigned int y, unsigned int n){
-    unsigned long result;
+struct Pixel16{
+    typedef Uint16 Type;
+
+    enum{
+        RedShift = 11,
+        GreenShift = 5,
+        BlueShift = 0,
+        RedLevels = 32,
+        GreenLevels = 64,
+        BlueLevels = 32
+    };
 
-    if (n)
-        n = (n + 1) / 8;
+    static inline void unpack(unsigned int color, Uint8 & red, Uint8 & green, Uint8 & blue){
+        SDL_GetRGB(color, &format565, &red, &green, &blue);
+    }
+
+    static inline unsigned int pack(Uint8 red, Uint8 green, Uint8 blue){
+        return SDL_MapRGB(&format565, red, green, blue);
+    }
 
-    /* hex:    0x7E0F81F
-     * binary: 0111 1110 0000 1111 1000 0001 1111
+    /* taken from allegro 4.2: src/colblend.c, _blender_trans16 */
+    /* this function performs a psuedo-SIMD operation on the pixel
+     * components in RGB 5-6-5 format. To get this to work for some
+     * other format probably all that needs to happen is to change
+     * the 0x7E0F81F constant to something else. 5-5-5:
+     * binary: 0011 1110 000 0111 1100 0001 1111
+     * hex:    0x174076037
      */
-    x = ((x & 0xFFFF) | (x << 16)) & 0x7E0F81F;
-    y = ((y & 0xFFFF) | (y << 16)) & 0x7E0F81F;
+    static inline unsigned int trans(unsigned int x, unsigned int y, unsigned int n){
+        unsigned long result;
 
-    result = ((x - y) * n / 32 + y) & 0x7E0F81F;
+        if (n)
+            n = (n + 1) / 8;
 
-    return ((result & 0xFFFF) | (result >> 16));
+        /* hex:    0x7E0F81F
+         * binary: 0111 1110 0000 1111 1000 0001 1111
+         */
+        x = ((x & 0xFFFF) | (x << 16)) & 0x7E0F81F;
+        y = ((y & 0xFFFF) | (y << 16)) & 0x7E0F81F;
+
+        result = ((x - y) * n / 32 + y) & 0x7E0F81F;
+
+        return ((result & 0xFFFF) | (result >> 16));
+    }
+};
+
+struct Pixel32{
+    typedef Uint32 Type;
+
+    enum{
+        RedShift = 16,
+        GreenShift = 8,
+        BlueShift = 0,
+        RedLevels = 256,
+        GreenLevels = 256,
+        BlueLevels = 256
+    };
+
+    static inline void unpack(unsigned int color, Uint8 & red, Uint8 & green, Uint8 & blue){
+        red = (color >> 16) & 0xff;
+        green = (color >> 8) & 0xff;
+        blue = color & 0xff;
+    }
+
+    static inline unsigned int pack(Uint8 red, Uint8 green, Uint8 blue){
+        return (red << 16) | (green << 8) | blue;
+    }
+
+    /* Red and blue are blended together and then green. Each channel times
+     * 256 still fits in 16 bits so the channels can't run into each other.
+     */
+    static inline unsigned int trans(unsigned int x, unsigned int y, unsigned int n){
+        if (n)
+            n += 1;
+        /* mugen passes 256 for fully opaque */
+        if (n > 256)
+            n = 256;
+
+        unsigned int redBlue = ((x & 0xFF00FF) * n + (y & 0xFF00FF) * (256 - n)) >> 8;
+        unsigned int green = ((x & 0xFF00) * n + (y & 0xFF00) * (256 - n)) >> 8;
+
+        return (redBlue & 0xFF00FF) | (green & 0xFF00);
+    }
+};
+
+template <class Format>
+static inline unsigned int transBlender(unsigned int x, unsigned int y, unsigned int n){
+    return Format::trans(x, y, n);
 }
 
+template <class Format>
 static inline unsigned int multiplyBlender(unsigned int x, unsigned int y, unsigned int n){
     Uint8 redX = 0;
     Uint8 greenX = 0;
     Uint8 blueX = 0;
-    SDL_GetRGB(x, &format565, &redX, &greenX, &blueX);
+    Format::unpack(x, redX, greenX, blueX);
     Uint8 redY = 0;
     Uint8 greenY = 0;
     Uint8 blueY = 0;
-    SDL_GetRGB(y, &format565, &redY, &greenY, &blueY);
+    Format::unpack(y, redY, greenY, blueY);
 
     int r = redX * redY / 256;
     int g = greenX * greenY / 256;
     int b = blueX * blueY / 256;
-    return transBlender(makeColor(r, g, b).color, y, n);
+    return Format::trans(Format::pack(r, g, b), y, n);
 }
 
+template <class Format>
 static inline unsigned int alphaBlender(unsigned int x, unsigned int y, unsigned int n){
     Uint8 source = n >> 8;
     Uint8 dest = n & 0xff;
@@ -91,11 +182,11 @@ static inline unsigned int alphaBlender(unsigned int x, unsigned int y, unsigned
     Uint8 redX = 0;
     Uint8 greenX = 0;
     Uint8 blueX = 0;
-    SDL_GetRGB(x, &format565, &redX, &greenX, &blueX);
+    Format::unpack(x, redX, greenX, blueX);
     Uint8 redY = 0;
     Uint8 greenY = 0;
     Uint8 blueY = 0;
-    SDL_GetRGB(y, &format565, &redY, &greenY, &blueY);
+    Format::unpack(y, redY, greenY, blueY);
 
     int r = (redY * dest + redX * source) / 256;
     int g = (greenY * dest + greenX * source) / 256;
@@ -107,19 +198,20 @@ static inline unsigned int alphaBlender(unsigned int x, unsigned int y, unsigned
 
     // return transBlender(makeColor(r, g, b), y, dest);
 
-    return makeColor(r, g, b).color;
+    return Format::pack(r, g, b);
     // return y;
 }
 
+template <class Format>
 static inline unsigned int addBlender(unsigned int x, unsigned int y, unsigned int n){
     Uint8 redX = 0;
     Uint8 greenX = 0;
     Uint8 blueX = 0;
-    SDL_GetRGB(x, &format565, &redX, &greenX, &blueX);
+    Format::unpack(x, redX, greenX, blueX);
     Uint8 redY = 0;
     Uint8 greenY = 0;
     Uint8 blueY = 0;
-    SDL_GetRGB(y, &format565, &redY, &greenY, &blueY);
+    Format::unpack(y, redY, greenY, blueY);
 
     int r = redY + redX * n / 256;
     int g = greenY + greenX * n / 256;
@@ -129,22 +221,23 @@ static inline unsigned int addBlender(unsigned int x, unsigned int y, unsigned i
     g = Util::min(g, 255);
     b = Util::min(b, 255);
 
-    return makeColor(r, g, b).color;
+    return Format::pack(r, g, b);
 }
 
 static inline int iabs(int x){
     return x < 0 ? -x : x;
 }
 
+template <class Format>
 static inline unsigned int differenceBlender(unsigned int x, unsigned int y, unsigned int n){
     Uint8 redX = 0;
     Uint8 greenX = 0;
     Uint8 blueX = 0;
-    SDL_GetRGB(x, &format565, &redX, &greenX, &blueX);
+    Format::unpack(x, redX, greenX, blueX);
     Uint8 redY = 0;
     Uint8 greenY = 0;
     Uint8 blueY = 0;
-    SDL_GetRGB(y, &format565, &redY, &greenY, &blueY);
+    Format::unpack(y, redY, greenY, blueY);
 
     // int r = iabs(redY - redX);
     // int g = iabs(greenY - greenX);
@@ -161,18 +254,19 @@ static inline unsigned int differenceBlender(unsigned int x, unsigned int y, uns
     if (b < 0){
         b = 0;
     }
-    return transBlender(makeColor(r, g, b).color, y, n);
+    return Format::trans(Format::pack(r, g, b), y, n);
 }
 
+template <class Format>
 static inline unsigned int burnBlender(unsigned int x, unsigned int y, unsigned int n){
     Uint8 redX = 0;
     Uint8 greenX = 0;
     Uint8 blueX = 0;
-    SDL_GetRGB(x, &format565, &redX, &greenX, &blueX);
+    Format::unpack(x, redX, greenX, blueX);
     Uint8 redY = 0;
     Uint8 greenY = 0;
     Uint8 blueY = 0;
-    SDL_GetRGB(y, &format565, &redY, &greenY, &blueY);
+    Format::unpack(y, redY, greenY, blueY);
 
     int r = redX - redY;
     int g = greenX - greenY;
@@ -186,28 +280,236 @@ static inline unsigned int burnBlender(unsigned int x, unsigned int y, unsigned
     if (b < 0){
         g = 0;
     }
-    return transBlender(makeColor(r, g, b).color, y, n);
+    return Format::trans(Format::pack(r, g, b), y, n);
 }
 
 static inline unsigned int noBlender(unsigned int a, unsigned int b, unsigned int c){
     return a;
 }
 
+/* Plain data (no constructor) so it can be thread local */
 struct BlendingData{
-    BlendingData():
-        red(0), green(0), blue(0), alpha(0), currentBlender(noBlender){}
-
     int red, green, blue, alpha;
     blender currentBlender;
 };
 
+/* Surfaces made by Bitmap(width, height) go back to this pool when their
+ * bitmap is destroyed, and the next bitmap of the same size and format takes
+ * one instead of allocating. Bitmaps made every frame (stretch buffers,
+ * scaled sprites and the like) stop allocating once the pool has a surface
+ * of each size they use. A Bitmap holds its surface like a lease, it goes
+ * back when the last copy of the bitmap goes away.
+ */
+struct SurfacePoolKey{
+    int width, height;
+    Uint32 red, green, blue;
+    int bits;
+
+    bool operator<(const SurfacePoolKey & him) const {
+        if (width != him.width) return width < him.width;
+        if (height != him.height) return height < him.height;
+        if (bits != him.bits) return bits < him.bits;
+        if (red != him.red) return red < him.red;
+        if (green != him.green) return green < him.green;
+        return blue < him.blue;
+    }
+};
+
+/* don't keep more than this many surfaces of one size, or this many bytes */
+static const unsigned int SurfacePoolPerSize = 8;
+static const unsigned int SurfacePoolBytes = 32 * 1024 * 1024;
+
+static std::map<SurfacePoolKey, std::vector<SDL_Surface*> > surfacePool;
+static unsigned int surfacePoolCount = 0;
+static unsigned int surfacePoolBytes = 0;
+static SurfacePoolStatistics surfacePoolFrame;
+static SurfacePoolStatistics surfacePoolLastFrame;
+/* bitmaps are created and destroyed by loading threads too */
+static Util::Thread::LockObject surfacePoolLock;
+
+static SurfacePoolKey surfacePoolKey(int width, int height, const SDL_PixelFormat * format){
+    SurfacePoolKey key;
+    key.width = width;
+    key.height = height;
+    key.bits = format->BitsPerPixel;
+    key.red = format->Rmask;
+    key.green = format->Gmask;
+    key.blue = format->Bmask;
+    return key;
+}
+
+static unsigned int surfaceBytes(const SDL_Surface * surface){
+    return surface->pitch * surface->h;
+}
+
+/* a surface from the pool that looks like it was just created, or NULL */
+static SDL_Surface * takePooledSurface(int width, int height, const SDL_PixelFormat * format){
+    SDL_Surface * surface = NULL;
+    {
+        Util::Thread::ScopedLock scoped(surfacePoolLock);
+        std::map<SurfacePoolKey, std::vector<SDL_Surface*> >::iterator found = surfacePool.find(surfacePoolKey(width, height, format));
+        if (found == surfacePool.end() || found->second.empty()){
+            surfacePoolFrame.created += 1;
+            return NULL;
+        }
+        surface = found->second.back();
+        found->second.pop_back();
+        surfacePoolCount -= 1;
+        surfacePoolBytes -= surfaceBytes(surface);
+        surfacePoolFrame.reused += 1;
+    }
+
+    /* what SDL_CreateRGBSurface would have given us */
+    SDL_SetColorKey(surface, 0, 0);
+    SDL_SetAlpha(surface, 0, SDL_ALPHA_OPAQUE);
+    SDL_SetClipRect(surface, NULL);
+    memset(surface->pixels, 0, surfaceBytes(surface));
+    return surface;
+}
+
+static void returnPooledSurface(SDL_Surface * surface){
+    {
+        Util::Thread::ScopedLock scoped(surfacePoolLock);
+        std::vector<SDL_Surface*> & surfaces = surfacePool[surfacePoolKey(surface->w, surface->h, surface->format)];
+        if (surfaces.size() < SurfacePoolPerSize && surfacePoolBytes + surfaceBytes(surface) <= SurfacePoolBytes){
+            surfaces.push_back(surface);
+            surfacePoolCount += 1;
+            surfacePoolBytes += surfaceBytes(surface);
+            surfacePoolFrame.returned += 1;
+            return;
+        }
+        surfacePoolFrame.freed += 1;
+    }
+    SDL_FreeSurface(surface);
+}
+
+/* called once a frame is on the screen */
+static void finishSurfacePoolFrame(){
+    Util::Thread::ScopedLock scoped(surfacePoolLock);
+    surfacePoolFrame.surfaces = surfacePoolCount;
+    surfacePoolFrame.bytes = surfacePoolBytes;
+    surfacePoolLastFrame = surfacePoolFrame;
+    surfacePoolFrame = SurfacePoolStatistics();
+}
+
+SurfacePoolStatistics getSurfacePoolStatistics(){
+    Util::Thread::ScopedLock scoped(surfacePoolLock);
+    return surfacePoolLastFrame;
+}
+
+void clearSurfacePool(){
+    Util::Thread::ScopedLock scoped(surfacePoolLock);
+    for (std::map<SurfacePoolKey, std::vector<SDL_Surface*> >::iterator it = surfacePool.begin(); it != surfacePool.end(); it++){
+        std::vector<SDL_Surface*> & surfaces = it->second;
+        for (std::vector<SDL_Surface*>::iterator surface = surfaces.begin(); surface != surfaces.end(); surface++){
+            SDL_FreeSurface(*surface);
+        }
+    }
+    surfacePool.clear();
+    surfacePoolCount = 0;
+    surfacePoolBytes = 0;
+}
+
+/* The color and alpha of each column of a light only depend on its width,
+ * alphas, colors and the pixel format, and a level draws the same few lights
+ * every frame, so the tables are kept instead of being worked out per draw.
+ * They are mirrored around the middle column so one row of the cone is one
+ * contiguous piece of each table.
+ */
+struct LightMask{
+    int width;
+    int focusAlpha, edgeAlpha;
+    int focusColor, edgeColor;
+    int bytes;
+    unsigned int used;
+    /* 2 * width - 1 entries, the middle column is entry width - 1 */
+    std::vector<unsigned char> alphas;
+    /* pixels in the format of the bitmap */
+    std::vector<Uint8> colors;
+};
+
+static const unsigned int LightMaskCount = 16;
+static std::vector<LightMask> lightMasks;
+static unsigned int lightMaskClock = 0;
+/* held while a light is drawn so its tables stay put */
+static Util::Thread::LockObject lightMaskLock;
+
+/* the tables for a light, the least recently used ones are replaced. Call it
+ * with lightMaskLock held.
+ */
+template <class Format>
+static const LightMask & findLightMask(int width, int focusAlpha, int edgeAlpha, int focusColor, int edgeColor){
+    typedef typename Format::Type Pixel;
+    lightMaskClock += 1;
+    LightMask * oldest = NULL;
+    for (std::vector<LightMask>::iterator it = lightMasks.begin(); it != lightMasks.end(); it++){
+        LightMask & mask = *it;
+        if (mask.width == width && mask.focusAlpha == focusAlpha && mask.edgeAlpha == edgeAlpha &&
+            mask.focusColor == focusColor && mask.edgeColor == edgeColor && mask.bytes == (int) sizeof(Pixel)){
+            mask.used = lightMaskClock;
+            return mask;
+        }
+        if (oldest == NULL || mask.used < oldest->used){
+            oldest = &mask;
+        }
+    }
+
+    LightMask * mask = oldest;
+    if (lightMasks.size() < LightMaskCount){
+        lightMasks.push_back(LightMask());
+        mask = &lightMasks.back();
+    }
+
+    mask->width = width;
+    mask->focusAlpha = focusAlpha;
+    mask->edgeAlpha = edgeAlpha;
+    mask->focusColor = focusColor;
+    mask->edgeColor = edgeColor;
+    mask->bytes = sizeof(Pixel);
+    mask->used = lightMaskClock;
+
+    std::vector<Color> palette(width);
+    blend_palette(&palette[0], width, Color(focusColor), Color(edgeColor));
+    mask->alphas.resize(width * 2 - 1);
+    mask->colors.resize((width * 2 - 1) * sizeof(Pixel));
+    Pixel * colors = (Pixel*) &mask->colors[0];
+    for (int column = 0; column < width; column++){
+        unsigned char alpha = (unsigned char)((double)(edgeAlpha - focusAlpha) * (double) column / (double) width + focusAlpha);
+        mask->alphas[width - 1 - column] = alpha;
+        mask->alphas[width - 1 + column] = alpha;
+        colors[width - 1 - column] = palette[column].color;
+        colors[width - 1 + column] = palette[column].color;
+    }
+
+    return *mask;
+}
+
+static void clearLightMasks(){
+    Util::Thread::ScopedLock scoped(lightMaskLock);
+    lightMasks.clear();
+}
+
 BitmapData::~BitmapData(){
+    delete runs;
     if (surface != NULL && destroy){
-        SDL_FreeSurface(surface);
+        if (pooled){
+            returnPooledSurface(surface);
+        } else {
+            SDL_FreeSurface(surface);
+        }
     }
 }
 
-static BlendingData globalBlend;
+void BitmapData::setRuns(Span::Runs * runs){
+    delete this->runs;
+    this->runs = runs;
+}
+
+/* The blender set by transBlender() and friends only applies to the thread
+ * that set it, so two threads rendering separate matches don't clobber each
+ * other's blend state.
+ */
+static PAINTOWN_THREAD_LOCAL BlendingData globalBlend = {0, 0, 0, 0, noBlender};
 // static int drawingMode = Bitmap::MODE_SOLID;
 
 /*
@@ -222,15 +524,395 @@ static int drawingAlpha(){
 }
 */
 
-static void paintown_applyTrans16(SDL_Surface * dst, const int color);
-static void paintown_replace16(SDL_Surface * dst, const int original, const int replace);
-static void paintown_draw_sprite_ex16(SDL_Surface * dst, SDL_Surface * src, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter);
-static void paintown_draw_sprite_filter_ex16(SDL_Surface * dst, SDL_Surface * src, long long x, long long y, Bitmap::Filter * filter);
-static void paintown_light16(SDL_Surface * dst, const int x, const int y, int width, int height, const int start_y, const int focus_alpha, const int edge_alpha, const int focus_color, const int edge_color);
+/* the blenders for the current render depth */
+struct Blenders{
+    blender trans;
+    blender add;
+    blender multiply;
+    blender difference;
+    blender burn;
+    blender alpha;
+};
+
+static const Blenders & currentBlenders(){
+    static const Blenders blenders16 = {transBlender<Pixel16>, addBlender<Pixel16>, multiplyBlender<Pixel16>, differenceBlender<Pixel16>, burnBlender<Pixel16>, alphaBlender<Pixel16>};
+    static const Blenders blenders32 = {transBlender<Pixel32>, addBlender<Pixel32>, multiplyBlender<Pixel32>, differenceBlender<Pixel32>, burnBlender<Pixel32>, alphaBlender<Pixel32>};
+    if (SCREEN_DEPTH == 32){
+        return blenders32;
+    }
+    return blenders16;
+}
+
+template <class Format> static void paintown_applyTrans(SDL_Surface * dst, const int color);
+template <class Format> static void paintown_replace(SDL_Surface * dst, const int original, const int replace);
+template <class Format> static void paintown_draw_sprite_ex(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter);
+template <class Format> static void paintown_draw_sprite_filter_ex(SDL_Surface * dst, SDL_Surface * src, long long x, long long y, Bitmap::Filter * filter);
+template <class Format> static void paintown_light(SDL_Surface * dst, const int x, const int y, int width, int height, const int start_y, const int focus_alpha, const int edge_alpha, const int focus_color, const int edge_color);
+static void drawSprite(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter);
+
+/* One drawing call recorded by a RenderList. The blender that was set when
+ * it was recorded is kept with it so the list can be drawn later, on other
+ * threads, and still look the same.
+ */
+struct RenderCommand{
+    enum Kind{
+        /* source drawn at x, y with mode and flip */
+        Sprite,
+        /* x, y to x2, y2 filled with color */
+        Fill,
+        /* same as Fill but blended with the alpha of the blender */
+        TranslucentFill,
+        /* width by height pixels of source at x2, y2 copied to x, y */
+        Copy
+    };
+
+    RenderCommand(Kind kind, const Util::ReferenceCount<BitmapData> & source, const SDL_Rect & clip):
+    kind(kind),
+    source(source),
+    clip(clip),
+    x(0), y(0), x2(0), y2(0),
+    width(0), height(0),
+    mode(0), flip(0),
+    color(0),
+    blend(globalBlend){
+    }
+
+    Kind kind;
+    /* keeps the sprite or blit source alive until the list is drawn */
+    Util::ReferenceCount<BitmapData> source;
+    /* the clip rectangle of the target at the time */
+    SDL_Rect clip;
+    int x, y, x2, y2;
+    int width, height;
+    int mode, flip;
+    int color;
+    BlendingData blend;
+};
+
+struct RenderCommands{
+    RenderCommands(const Bitmap & where):
+    target(where.getData()),
+    previous(NULL){
+    }
+
+    Util::ReferenceCount<BitmapData> target;
+    std::vector<RenderCommand> commands;
+    /* the pixel owners of the bitmaps the commands draw from */
+    std::set<const BitmapData*> sources;
+    /* the list that was recording on this thread when this one started */
+    RenderCommands * previous;
+};
+
+/* The list that drawing onto its target is being recorded into. Like the
+ * blender it only applies to the thread that started recording.
+ */
+static PAINTOWN_THREAD_LOCAL RenderCommands * recording = NULL;
+
+/* drawing onto bitmap can be recorded */
+static inline bool isRecording(const Bitmap & bitmap){
+    return recording != NULL && bitmap.getData().raw() == recording->target.raw();
+}
+
+/* the bitmap that owns the pixels, a sub-bitmap uses the ones of its parent */
+static inline const BitmapData * pixelOwner(const Util::ReferenceCount<BitmapData> & data){
+    const BitmapData * owner = data.raw();
+    while (owner->parent != NULL){
+        owner = owner->parent.raw();
+    }
+    return owner;
+}
+
+/* bitmap has pixels in common with the one being recorded, like a
+ * sub-bitmap of it or the bitmap it is a sub-bitmap of
+ */
+static inline bool sharesRecording(const Bitmap & bitmap){
+    return recording != NULL && pixelOwner(bitmap.getData()) == pixelOwner(recording->target);
+}
+
+/* What SDL_BlitSurface does between two surfaces with the same format and no
+ * color key, without going through the blit map of the source.
+ */
+static void copyArea(SDL_Surface * source, int mx, int my, int width, int height, SDL_Surface * destination, int wx, int wy){
+    if (mx < 0){
+        width += mx;
+        wx -= mx;
+        mx = 0;
+    }
+    if (my < 0){
+        height += my;
+        wy -= my;
+        my = 0;
+    }
+    if (mx + width > source->w){
+        width = source->w - mx;
+    }
+    if (my + height > source->h){
+        height = source->h - my;
+    }
+
+    const SDL_Rect & clip = destination->clip_rect;
+    if (wx < clip.x){
+        mx += clip.x - wx;
+        width -= clip.x - wx;
+        wx = clip.x;
+    }
+    if (wy < clip.y){
+        my += clip.y - wy;
+        height -= clip.y - wy;
+        wy = clip.y;
+    }
+    if (wx + width > clip.x + clip.w){
+        width = clip.x + clip.w - wx;
+    }
+    if (wy + height > clip.y + clip.h){
+        height = clip.y + clip.h - wy;
+    }
+    if (width <= 0 || height <= 0){
+        return;
+    }
+
+    int bpp = destination->format->BytesPerPixel;
+    for (int y = 0; y < height; y++){
+        memcpy((Uint8*) destination->pixels + (wy + y) * destination->pitch + wx * bpp,
+               (Uint8*) source->pixels + (my + y) * source->pitch + mx * bpp,
+               width * bpp);
+    }
+}
+
+struct RenderBand{
+    SDL_Surface * target;
+    const std::vector<RenderCommand> * commands;
+};
+
+/* Draws every command into rows [first, last) of the target. The band is a
+ * copy of the target's SDL_Surface that starts at row `first', so each
+ * thread clips to its own rows without touching the target's clip rectangle.
+ */
+static void renderBand(void * data, int first, int last){
+    const RenderBand & work = *(const RenderBand *) data;
+    SDL_Surface * target = work.target;
+
+    SDL_Surface band = *target;
+    band.flags = SDL_SWSURFACE | SDL_PREALLOC;
+    band.offset = 0;
+    band.pixels = (Uint8*) target->pixels + first * target->pitch;
+    band.h = last - first;
+
+    const std::vector<RenderCommand> & commands = *work.commands;
+    for (std::vector<RenderCommand>::const_iterator it = commands.begin(); it != commands.end(); it++){
+        const RenderCommand & command = *it;
+        SDL_Rect clip = command.clip;
+        clip.y -= first;
+        if (!SDL_SetClipRect(&band, &clip)){
+            continue;
+        }
+
+        globalBlend = command.blend;
+        switch (command.kind){
+            case RenderCommand::Sprite: {
+                drawSprite(&band, command.source->getSurface(), command.source->getRuns(), command.x, command.y - first, command.mode, command.flip, NULL);
+                break;
+            }
+            case RenderCommand::Fill: {
+                SPG_RectFilled(&band, command.x, command.y - first, command.x2, command.y2 - first, command.color);
+                break;
+            }
+            case RenderCommand::TranslucentFill: {
+                SPG_RectFilledBlend(&band, command.x, command.y - first, command.x2, command.y2 - first, command.color, command.blend.alpha);
+                break;
+            }
+            case RenderCommand::Copy: {
+                copyArea(command.source->getSurface(), command.x2, command.y2, command.width, command.height, &band, command.x, command.y - first);
+                break;
+            }
+        }
+    }
+}
+
+/* the frame being presented can't be touched until it is on the screen */
+static inline void waitForPresent(const Util::ReferenceCount<BitmapData> & data){
+    if (presentPixels != NULL && pixelOwner(data) == presentPixels){
+        waitForPresent();
+    }
+}
+
+/* draws and empties the list, 0 bands means one per cpu */
+static void renderCommands(RenderCommands & list, int bands){
+    if (list.commands.empty()){
+        return;
+    }
+
+    waitForPresent(list.target);
+
+    SDL_Surface * target = list.target->getSurface();
+#ifdef PAINTOWN_HAS_THREAD_LOCAL
+    if (bands <= 0){
+        bands = Util::Thread::cpuCount();
+    }
+#else
+    /* every band sets globalBlend, which is shared by all threads here */
+    bands = 1;
+#endif
+
+    if (SDL_MUSTLOCK(target)){
+        SDL_LockSurface(target);
+    }
+
+    /* the calling thread draws a band too, which changes its blender */
+    BlendingData blend = globalBlend;
+    RenderBand work;
+    work.target = target;
+    work.commands = &list.commands;
+    Util::Thread::runBands(target->h, bands, renderBand, &work);
+    globalBlend = blend;
+
+    if (SDL_MUSTLOCK(target)){
+        SDL_UnlockSurface(target);
+    }
+
+    list.commands.clear();
+    list.sources.clear();
+}
+
+/* Anything that draws onto a bitmap without recording has to have the
+ * recorded commands drawn first if they draw onto the same pixels or draw
+ * from them.
+ */
+static void drawNow(const Bitmap & bitmap){
+    waitForPresent(bitmap.getData());
+    if (recording != NULL &&
+        (sharesRecording(bitmap) || recording->sources.count(pixelOwner(bitmap.getData())) > 0)){
+        renderCommands(*recording, 0);
+    }
+}
+
+/* reading a bitmap only has to wait for the commands that draw onto it.
+ * Blits from the frame being presented still wait since they change the
+ * color key and blit map of its surface.
+ */
+static void readNow(const Bitmap & bitmap){
+    waitForPresent(bitmap.getData());
+    if (sharesRecording(bitmap)){
+        renderCommands(*recording, 0);
+    }
+}
+
+/* Draws a sprite onto where, or records it if where is being recorded. A
+ * filter can't be kept until the list is drawn so filtered sprites are drawn
+ * right away, after what was recorded before them.
+ */
+static void drawSprite(const Bitmap & where, const Bitmap & sprite, long long x, long long y, int mode, int flip, Bitmap::Filter * filter){
+    if (recording != NULL){
+        if (isRecording(where) && filter == NULL && !sharesRecording(sprite)){
+            RenderCommand command(RenderCommand::Sprite, sprite.getData(), where.getData()->getSurface()->clip_rect);
+            command.x = x;
+            command.y = y;
+            command.mode = mode;
+            command.flip = flip;
+            recording->commands.push_back(command);
+            recording->sources.insert(pixelOwner(sprite.getData()));
+            return;
+        }
+    }
+    drawNow(where);
+    readNow(sprite);
+
+    drawSprite(where.getData()->getSurface(), sprite.getData()->getSurface(), sprite.getData()->getRuns(), x, y, mode, flip, filter);
+}
+
+static void recordFill(const Bitmap & where, RenderCommand::Kind kind, int x1, int y1, int x2, int y2, int color){
+    RenderCommand command(kind, where.getData(), where.getData()->getSurface()->clip_rect);
+    command.x = x1;
+    command.y = y1;
+    command.x2 = x2;
+    command.y2 = y2;
+    command.color = color;
+    recording->commands.push_back(command);
+}
+
+/* returns false if the blit can't be recorded */
+static bool recordCopy(const Bitmap & source, int mx, int my, int width, int height, int wx, int wy, const Bitmap & where){
+    SDL_PixelFormat * from = source.getData()->getSurface()->format;
+    SDL_PixelFormat * to = where.getData()->getSurface()->format;
+    if (sharesRecording(source) ||
+        from->BytesPerPixel != to->BytesPerPixel ||
+        from->Rmask != to->Rmask ||
+        from->Gmask != to->Gmask ||
+        from->Bmask != to->Bmask){
+        return false;
+    }
+
+    RenderCommand command(RenderCommand::Copy, source.getData(), where.getData()->getSurface()->clip_rect);
+    command.x = wx;
+    command.y = wy;
+    command.x2 = mx;
+    command.y2 = my;
+    command.width = width;
+    command.height = height;
+    recording->commands.push_back(command);
+    recording->sources.insert(pixelOwner(source.getData()));
+    return true;
+}
+
+RenderList::RenderList(const Bitmap & where):
+commands(new RenderCommands(where)){
+}
+
+RenderList::~RenderList(){
+    finish();
+    delete commands;
+}
+
+/* takes the list out of the ones recording on this thread */
+static void stopRecording(RenderCommands * list){
+    for (RenderCommands ** link = &recording; *link != NULL; link = &(*link)->previous){
+        if (*link == list){
+            *link = list->previous;
+            break;
+        }
+    }
+    list->previous = NULL;
+}
+
+void RenderList::start(){
+    if (recording != commands){
+        stopRecording(commands);
+        /* only one list records on a thread at a time, the one before
+         * carries on when this one finishes
+         */
+        if (recording != NULL){
+            renderCommands(*recording, 0);
+        }
+        commands->previous = recording;
+        recording = commands;
+    }
+}
+
+void RenderList::flush(int bands){
+    renderCommands(*commands, bands);
+}
+
+void RenderList::finish(int bands){
+    stopRecording(commands);
+    renderCommands(*commands, bands);
+}
+
+unsigned int RenderList::size() const {
+    return commands->commands.size();
+}
 
 Color MaskColor(){
-    static Color mask = makeColor(255, 0, 255);
-    return mask;
+    static Color mask16 = Color(Pixel16::pack(255, 0, 255));
+    static Color mask32 = Color(Pixel32::pack(255, 0, 255));
+    if (SCREEN_DEPTH == 32){
+        return mask32;
+    }
+    return mask16;
+}
+
+static SDL_Surface * createSurface(int width, int height){
+    SDL_PixelFormat * format = renderFormat();
+    return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, format->BitsPerPixel, format->Rmask, format->Gmask, format->Bmask, format->Amask);
 }
 
 static SDL_Surface * optimizedSurface(SDL_Surface * in){
@@ -238,10 +920,10 @@ static SDL_Surface * optimizedSurface(SDL_Surface * in){
      * like if a test is running instead of the real game.
      */
     // SDL_Surface * out = SDL_DisplayFormat(in);
-    SDL_Surface * out = SDL_ConvertSurface(in, &format565, SDL_SWSURFACE);
+    SDL_Surface * out = SDL_ConvertSurface(in, renderFormat(), SDL_SWSURFACE);
     if (out == NULL){
         // out = SDL_CreateRGBSurface(SDL_SWSURFACE, in->w, in->h, in->format->BitsPerPixel, 0, 0, 0, 0);
-        out = SDL_CreateRGBSurface(SDL_SWSURFACE, in->w, in->h, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+        out = createSurface(in->w, in->h);
         if (out == NULL){
             std::ostringstream out;
             out << "Could not create RGB surface of size " << in->w << ", " << in->h << ". Memory usage: " << System::memoryUsage();
@@ -268,11 +950,14 @@ static Bitmap * Scaler = NULL;
     
 BitmapData::BitmapData(SDL_Surface * surface):
 surface(surface),
-destroy(true){
+destroy(true),
+pooled(false),
+runs(0){
     setSurface(surface);
 }
 
 void BitmapData::setSurface(SDL_Surface * surface){
+    setRuns(NULL);
     this->surface = surface;
     clip_left = 0;
     clip_top = 0;
@@ -290,7 +975,7 @@ mustResize(false),
 bit8MaskColor(0){
     int width = 1;
     int height = 1;
-    SDL_Surface * surface = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+    SDL_Surface * surface = createSurface(width, height);
     setData(Util::ReferenceCount<BitmapData>(new BitmapData(surface)));
 }
 
@@ -304,7 +989,7 @@ Bitmap::Bitmap(SDL_Surface * who, bool deep_copy):
 mustResize(false),
 bit8MaskColor(0){
     if (deep_copy){
-        SDL_Surface * surface = SDL_CreateRGBSurface(SDL_SWSURFACE, who->w, who->h, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+        SDL_Surface * surface = createSurface(who->w, who->h);
         SDL_Rect source;
         SDL_Rect destination;
         source.w = surface->w;
@@ -333,13 +1018,18 @@ bit8MaskColor(0){
     if (h < 1){
         h = 1;
     }
-    SDL_Surface * surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+    SDL_Surface * surface = takePooledSurface(w, h, renderFormat());
+    if (surface == NULL){
+        surface = createSurface(w, h);
+    }
     if (surface == NULL){
         std::ostringstream out;
         out << "Could not create surface with dimensions " << w << ", " << h;
         throw BitmapException(__FILE__, __LINE__, out.str());
     }
-    setData(Util::ReferenceCount<BitmapData>(new BitmapData(surface)));
+    BitmapData * data = new BitmapData(surface);
+    data->pooled = true;
+    setData(Util::ReferenceCount<BitmapData>(data));
 }
 
 Bitmap::Bitmap( const char * load_file ):
@@ -357,7 +1047,7 @@ Bitmap::Bitmap( const char * load_file, int sx, int sy ):
 mustResize(false),
 bit8MaskColor(0){
     Bitmap temp(load_file);
-    SDL_Surface * surface = SDL_CreateRGBSurface(SDL_SWSURFACE, sx, sy, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+    SDL_Surface * surface = createSurface(sx, sy);
     setData(Util::ReferenceCount<BitmapData>(new BitmapData(surface)));
 
     temp.Stretch(*this);
@@ -375,7 +1065,7 @@ mustResize(false),
 bit8MaskColor(copy.bit8MaskColor){
     if (deep_copy){
         SDL_Surface * who = copy.getData()->getSurface();
-        SDL_Surface * surface = SDL_CreateRGBSurface(SDL_SWSURFACE, who->w, who->h, SCREEN_DEPTH, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
+        SDL_Surface * surface = createSurface(who->w, who->h);
         SDL_Rect source;
         SDL_Rect destination;
         source.w = surface->w;
@@ -452,8 +1142,14 @@ bit8MaskColor(copy.bit8MaskColor){
     if (height + y > his->h)
         height = his->h - y;
 
-    SDL_Surface * sub = SDL_CreateRGBSurfaceFrom(computeOffset(his, x, y), width, height, SCREEN_DEPTH, his->pitch, format565.Rmask, format565.Gmask, format565.Bmask, format565.Amask);
-    setData(Util::ReferenceCount<BitmapData>(new BitmapData(sub)));
+    SDL_Surface * sub = SDL_CreateRGBSurfaceFrom(computeOffset(his, x, y), width, height, his->format->BitsPerPixel, his->pitch, his->format->Rmask, his->format->Gmask, his->format->Bmask, his->format->Amask);
+    {
+        Util::Thread::ScopedLock scoped(surfacePoolLock);
+        surfacePoolFrame.subBitmaps += 1;
+    }
+    BitmapData * data = new BitmapData(sub);
+    data->parent = copy.getData();
+    setData(Util::ReferenceCount<BitmapData>(data));
 }
 
 void Bitmap::internalLoadFile(const char * path){
@@ -489,7 +1185,7 @@ int getRed(Color c){
     Uint8 red = 0;
     Uint8 green = 0;
     Uint8 blue = 0;
-    SDL_GetRGB(c.color, &format565, &red, &green, &blue);
+    SDL_GetRGB(c.color, renderFormat(), &red, &green, &blue);
     return red;
 }
 
@@ -497,7 +1193,7 @@ int getBlue(Color c){
     Uint8 red = 0;
     Uint8 green = 0;
     Uint8 blue = 0;
-    SDL_GetRGB(c.color, &format565, &red, &green, &blue);
+    SDL_GetRGB(c.color, renderFormat(), &red, &green, &blue);
     return blue;
 }
 
@@ -505,12 +1201,15 @@ int getGreen(Color c){
     Uint8 red = 0;
     Uint8 green = 0;
     Uint8 blue = 0;
-    SDL_GetRGB(c.color, &format565, &red, &green, &blue);
+    SDL_GetRGB(c.color, renderFormat(), &red, &green, &blue);
     return green;
 }
 
 Color makeColor(int red, int blue, int green){
-    return Color(SDL_MapRGB(&format565, red, blue, green));
+    if (SCREEN_DEPTH == 32){
+        return Color(Pixel32::pack(red, blue, green));
+    }
+    return Color(Pixel16::pack(red, blue, green));
 }
 
 void initializeExtraStuff(){
@@ -534,6 +1233,72 @@ void initializeExtraStuff(){
     format565.colorkey = 0;
     format565.alpha = 255;
 #endif
+
+    format8888.palette = 0;
+    format8888.BitsPerPixel = 32;
+    format8888.BytesPerPixel = 4;
+    format8888.Rloss = 0;
+    format8888.Gloss = 0;
+    format8888.Bloss = 0;
+    format8888.Aloss = 8;
+    format8888.Rshift = 16;
+    format8888.Gshift = 8;
+    format8888.Bshift = 0;
+    format8888.Ashift = 0;
+    format8888.Rmask = 0xff0000;
+    format8888.Gmask = 0xff00;
+    format8888.Bmask = 0xff;
+    /* no alpha mask, otherwise SDL would alpha blend every blit */
+    format8888.Amask = 0;
+#if !SDL_VERSION_ATLEAST(1, 3, 0)
+    format8888.colorkey = 0;
+    format8888.alpha = 255;
+#endif
+}
+
+void setRenderDepth(int bits){
+    if (bits == 32){
+        SCREEN_DEPTH = 32;
+    } else {
+        SCREEN_DEPTH = 16;
+    }
+}
+
+int getRenderDepth(){
+    return SCREEN_DEPTH;
+}
+
+void setScaleThreads(int threads){
+    SCALE_THREADS = threads;
+}
+
+int getScaleThreads(){
+    if (SCALE_THREADS > 0){
+        return SCALE_THREADS;
+    }
+    return Util::Thread::cpuCount();
+}
+
+void setPresentThread(bool enabled){
+    if (!enabled){
+        waitForPresent();
+    }
+    PRESENT_THREAD = enabled;
+}
+
+bool getPresentThread(){
+    return PRESENT_THREAD;
+}
+
+/* The 16-bit path asks for a 16-bit screen like it always has. The 32-bit path
+ * takes whatever the display has and lets the blit to the screen do the one
+ * conversion per frame.
+ */
+static Uint32 videoFlags(Uint32 flags){
+    if (SCREEN_DEPTH == 32){
+        return flags | SDL_ANYFORMAT;
+    }
+    return flags;
 }
 
 /* This code isn't used but leave it here for reference */
@@ -557,11 +1322,13 @@ int changeGraphicsMode(int mode, int width, int height){
 
 int setGraphicsMode(int mode, int width, int height){
     initializeExtraStuff();
+    /* the screen surface is about to go away */
+    waitForPresent();
 
     switch (mode){
         case WINDOWED : {
             // screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, SDL_HWSURFACE | SDL_DOUBLEBUF | SDL_RESIZABLE);
-            screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, SDL_SWSURFACE | SDL_RESIZABLE);
+            screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, videoFlags(SDL_SWSURFACE | SDL_RESIZABLE));
             SDL_ShowCursor(0);
             // screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, SDL_SWSURFACE | SDL_DOUBLEBUF);
             if (!screen){
@@ -570,7 +1337,7 @@ int setGraphicsMode(int mode, int width, int height){
             break;
         }
         case FULLSCREEN : {
-            screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, SDL_HWSURFACE | SDL_DOUBLEBUF | SDL_FULLSCREEN);
+            screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, videoFlags(SDL_HWSURFACE | SDL_DOUBLEBUF | SDL_FULLSCREEN));
             SDL_ShowCursor(0);
             // screen = SDL_SetVideoMode(width, height, SCREEN_DEPTH, SDL_SWSURFACE | SDL_DOUBLEBUF);
             if (!screen){
@@ -658,11 +1425,16 @@ Bitmap * getScreenBuffer(){
     return Scaler;
 }
 
+static void stopPresentThread();
+
 void Bitmap::shutdown(){
+    stopPresentThread();
     delete Screen;
     Screen = NULL;
     delete Scaler;
     Scaler = NULL;
+    clearSurfacePool();
+    clearLightMasks();
 }
 
 void Bitmap::addBlender( int r, int g, int b, int a ){
@@ -670,7 +1442,7 @@ void Bitmap::addBlender( int r, int g, int b, int a ){
     globalBlend.green = g;
     globalBlend.blue = b;
     globalBlend.alpha = a;
-    globalBlend.currentBlender = Graphics::addBlender;
+    globalBlend.currentBlender = currentBlenders().add;
 }
 
 void Bitmap::multiplyBlender( int r, int g, int b, int a ){
@@ -678,7 +1450,7 @@ void Bitmap::multiplyBlender( int r, int g, int b, int a ){
     globalBlend.green = g;
     globalBlend.blue = b;
     globalBlend.alpha = a;
-    globalBlend.currentBlender = Graphics::multiplyBlender;
+    globalBlend.currentBlender = currentBlenders().multiply;
 }
 	
 void Bitmap::differenceBlender( int r, int g, int b, int a ){
@@ -686,7 +1458,7 @@ void Bitmap::differenceBlender( int r, int g, int b, int a ){
     globalBlend.green = g;
     globalBlend.blue = b;
     globalBlend.alpha = a;
-    globalBlend.currentBlender = Graphics::differenceBlender;
+    globalBlend.currentBlender = currentBlenders().difference;
 }
 
 void Bitmap::burnBlender(int r, int g, int b, int a){
@@ -694,7 +1466,7 @@ void Bitmap::burnBlender(int r, int g, int b, int a){
     globalBlend.green = g;
     globalBlend.blue = b;
     globalBlend.alpha = a;
-    globalBlend.currentBlender = Graphics::burnBlender;
+    globalBlend.currentBlender = currentBlenders().burn;
 }
         
 int setGfxModeText(){
@@ -728,7 +1500,7 @@ void Bitmap::alphaBlender(int source, int dest){
         dest = 255;
     }
     globalBlend.alpha = ((source & 0xff) << 8) + (dest & 0xff);
-    globalBlend.currentBlender = Graphics::alphaBlender;
+    globalBlend.currentBlender = currentBlenders().alpha;
 }
 
 void Bitmap::transBlender( int r, int g, int b, int a ){
@@ -736,7 +1508,7 @@ void Bitmap::transBlender( int r, int g, int b, int a ){
     globalBlend.green = g;
     globalBlend.blue = b;
     globalBlend.alpha = a;
-    globalBlend.currentBlender = Graphics::transBlender;
+    globalBlend.currentBlender = currentBlenders().trans;
 }
 
 void Bitmap::setClipRect( int x1, int y1, int x2, int y2 ) const {
@@ -792,7 +1564,11 @@ static void doPutPixel(SDL_Surface * surface, int x, int y, int pixel, bool tran
             }
             break;
         case 4:
-            *(Uint32 *)p = pixel;
+            if (translucent){
+                *(Uint32 *)p = globalBlend.currentBlender(pixel, *(Uint32*)p, globalBlend.alpha);
+            } else {
+                *(Uint32 *)p = pixel;
+            }
             break;
     }
 
@@ -803,6 +1579,7 @@ static void doPutPixel(SDL_Surface * surface, int x, int y, int pixel, bool tran
 }
 
 void Bitmap::putPixel(int x, int y, Color pixel) const {
+    drawNow(*this);
     /* clip it */
     if (getData()->isClipped(x, y)){
         return;
@@ -817,6 +1594,7 @@ void Bitmap::putPixelNormal(int x, int y, Color col) const {
 }
     
 void TranslucentBitmap::putPixelNormal(int x, int y, Color color) const {
+    drawNow(*this);
     if (getData()->isClipped(x, y)){
         return;
     }
@@ -831,29 +1609,43 @@ bool Bitmap::getError(){
 }
 
 void Bitmap::rectangle( int x1, int y1, int x2, int y2, Color color) const {
+    drawNow(*this);
     SPG_Rect(getData()->getSurface(), x1, y1, x2, y2, color.color);
 }
 
 void TranslucentBitmap::rectangle( int x1, int y1, int x2, int y2, Color color) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_RectBlend(getData()->getSurface(), x1, y1, x2, y2, color.color, alpha);
 }
 
 void Bitmap::rectangleFill( int x1, int y1, int x2, int y2, Color color) const {
+    if (isRecording(*this)){
+        recordFill(*this, RenderCommand::Fill, x1, y1, x2, y2, color.color);
+        return;
+    }
+    drawNow(*this);
     SPG_RectFilled(getData()->getSurface(), x1, y1, x2, y2, color.color);
 }
 
 void TranslucentBitmap::rectangleFill(int x1, int y1, int x2, int y2, Color color) const {
+    if (isRecording(*this)){
+        recordFill(*this, RenderCommand::TranslucentFill, x1, y1, x2, y2, color.color);
+        return;
+    }
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_RectFilledBlend(getData()->getSurface(), x1, y1, x2, y2, color.color, alpha);
 }
     
 void TranslucentBitmap::ellipseFill( int x, int y, int rx, int ry, Color color) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_EllipseFilledBlend(getData()->getSurface(), x, y, rx, ry, color.color, alpha);
 }
 
 void Bitmap::circleFill(int x, int y, int radius, Color color) const {
+    drawNow(*this);
     SPG_CircleFilled(getData()->getSurface(), x, y, radius, color.color);
 
     /*
@@ -867,11 +1659,13 @@ void Bitmap::circleFill(int x, int y, int radius, Color color) const {
 }
 
 void TranslucentBitmap::circleFill(int x, int y, int radius, Color color) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_CircleFilledBlend(getData()->getSurface(), x, y, radius, color.color, alpha);
 }
 
 void Bitmap::circle(int x, int y, int radius, Color color) const {
+    drawNow(*this);
     // Uint8 red, green, blue;
     // SDL_GetRGB(color, getData().getSurface()->format, &red, &green, &blue);
     // int alpha = 255;
@@ -891,6 +1685,7 @@ void Bitmap::circle(int x, int y, int radius, Color color) const {
 
 extern "C" unsigned short spg_thickness;
 void Bitmap::circle(int x, int y, int radius, int thickness, Color color) const {
+    drawNow(*this);
     int old = spg_thickness;
     spg_thickness = thickness;
     SPG_Circle(getData()->getSurface(), x, y, radius, color.color);
@@ -898,6 +1693,7 @@ void Bitmap::circle(int x, int y, int radius, int thickness, Color color) const
 }
 
 void Bitmap::line( const int x1, const int y1, const int x2, const int y2, const Color color) const {
+    drawNow(*this);
     SPG_Line(getData()->getSurface(), x1, y1, x2, y2, color.color);
     /*
     if (Graphics::drawingMode == MODE_SOLID){
@@ -910,13 +1706,14 @@ void Bitmap::line( const int x1, const int y1, const int x2, const int y2, const
 }
 
 void TranslucentBitmap::line(const int x1, const int y1, const int x2, const int y2, const Color color ) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_LineBlend(getData()->getSurface(), x1, y1, x2, y2, color.color, alpha);
 }
 
 void Bitmap::draw(const int x, const int y, const Bitmap & where) const {
     if (getData()->getSurface() != NULL){
-	paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_NO_FLIP, NULL);
+	drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_NO_FLIP, NULL);
         /*
         SDL_SetColorKey(getData().getSurface(), SDL_SRCCOLORKEY, makeColor(255, 0, 255));
         Blit(x, y, where);
@@ -925,63 +1722,64 @@ void Bitmap::draw(const int x, const int y, const Bitmap & where) const {
 }
 
 void Bitmap::drawHFlip(const int x, const int y, const Bitmap & where) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_H_FLIP, NULL);
 }
 
 void Bitmap::drawHFlip(const int x, const int y, Filter * filter, const Bitmap & where) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_H_FLIP, filter);
 }
 
 void Bitmap::drawVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_V_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_V_FLIP, NULL);
 }
 
 void Bitmap::drawVFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_V_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_V_FLIP, filter);
 }
 
 void Bitmap::drawHVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
 }
 
 void Bitmap::drawHVFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
 }
 
 void TranslucentBitmap::draw(const int x, const int y, const Bitmap & where) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_NO_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_NO_FLIP, NULL);
 }
 
 void TranslucentBitmap::draw( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_NO_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_NO_FLIP, filter);
 }
 
 void TranslucentBitmap::drawHFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_H_FLIP, NULL);
 }
 
 void TranslucentBitmap::drawHFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_H_FLIP, filter);
 }
 
 void TranslucentBitmap::drawVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_V_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_V_FLIP, NULL);
 }
 
 void TranslucentBitmap::drawVFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_V_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_V_FLIP, filter);
 }
 
 void TranslucentBitmap::drawHVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
 }
 
 void TranslucentBitmap::drawHVFlip( const int x, const int y, Filter * filter,const Bitmap & where ) const {
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_TRANS, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_TRANS, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
 }
 
 void Bitmap::drawStretched( const int x, const int y, const int new_width, const int new_height, const Bitmap & who ) const {
-
+    drawNow(who);
+    drawNow(*this);
     if (getData()->getSurface() != NULL){
         SDL_SetColorKey(getData()->getSurface(), SDL_SRCCOLORKEY, MaskColor().color);
 
@@ -1033,7 +1831,115 @@ static void doBlit(SDL_Surface * mine, const int mx, const int my, const int wid
     SDL_BlitSurface(mine, &source, where.getData()->getSurface(), &destination);
 }
 
+/* Only one frame is presented at a time. The present thread is started the
+ * first time BlitToScreen uses it and then sleeps on a semaphore between
+ * frames. BlitToScreen hands it the frame itself instead of a copy, so the
+ * caller can go on with the next logic tick while the frame is blitted to the
+ * screen and flipped. Drawing onto the frame or reading from it waits for the
+ * thread first, as does anything else that touches the screen.
+ */
+static Util::Thread::Id presentThread;
+static SDL_sem * presentStart = NULL;
+static SDL_sem * presentDone = NULL;
+static bool presentQuit = false;
+/* keeps the frame alive while it is presented */
+static Util::ReferenceCount<BitmapData> presentFrame;
+static int presentX = 0;
+static int presentY = 0;
+static int presentWidth = 0;
+static int presentHeight = 0;
+
+static void * presentLoop(void * arg){
+    while (true){
+        SDL_SemWait(presentStart);
+        if (presentQuit){
+            return NULL;
+        }
+        doBlit(presentFrame->getSurface(), 0, 0, presentWidth, presentHeight, presentX, presentY, *Screen);
+        SDL_Flip(Screen->getData()->getSurface());
+        SDL_SemPost(presentDone);
+    }
+    return NULL;
+}
+
+/* false if there is no thread to present on */
+static bool startPresentThread(){
+    if (presentStart != NULL){
+        return true;
+    }
+
+    presentStart = SDL_CreateSemaphore(0);
+    presentDone = SDL_CreateSemaphore(0);
+    presentQuit = false;
+    if (presentStart != NULL && presentDone != NULL &&
+        Util::Thread::createThread(&presentThread, NULL, (Util::Thread::ThreadFunction) presentLoop, NULL)){
+        return true;
+    }
+
+    if (presentStart != NULL){
+        SDL_DestroySemaphore(presentStart);
+        presentStart = NULL;
+    }
+    if (presentDone != NULL){
+        SDL_DestroySemaphore(presentDone);
+        presentDone = NULL;
+    }
+    return false;
+}
+
+static void waitForPresent(){
+    if (presentPixels != NULL){
+        SDL_SemWait(presentDone);
+        presentPixels = NULL;
+        presentFrame = Util::ReferenceCount<BitmapData>(NULL);
+    }
+}
+
+static void stopPresentThread(){
+    waitForPresent();
+    if (presentStart != NULL){
+        presentQuit = true;
+        SDL_SemPost(presentStart);
+        Util::Thread::joinThread(presentThread);
+        SDL_DestroySemaphore(presentStart);
+        SDL_DestroySemaphore(presentDone);
+        presentStart = NULL;
+        presentDone = NULL;
+    }
+}
+
+static void presentOnThread(const Bitmap & frame, int x, int y){
+    waitForPresent();
+    if (!startPresentThread()){
+        frame.Blit(x, y, *Screen);
+        return;
+    }
+
+    /* whatever is still recorded onto the frame has to be in it */
+    readNow(frame);
+    SDL_SetColorKey(frame.getData()->getSurface(), 0, MaskColor().color);
+    presentFrame = frame.getData();
+    presentPixels = pixelOwner(presentFrame);
+    presentX = x;
+    presentY = y;
+    presentWidth = frame.getWidth();
+    presentHeight = frame.getHeight();
+    SDL_SemPost(presentStart);
+}
+
 void Bitmap::Blit( const int mx, const int my, const int width, const int height, const int wx, const int wy, const Bitmap & where ) const {
+    if (recording != NULL){
+        if (&where != Screen && isRecording(where) && recordCopy(*this, mx, my, width, height, wx, wy, where)){
+            return;
+        }
+    }
+    drawNow(where);
+    readNow(*this);
+
+    if (&where == Screen){
+        waitForPresent();
+    }
+
     SDL_SetColorKey(getData()->getSurface(), 0, MaskColor().color);
     doBlit(getData()->getSurface(), mx, my, width, height, wx, wy, where);
 
@@ -1046,6 +1952,12 @@ void Bitmap::Blit( const int mx, const int my, const int width, const int height
 }
 
 void Bitmap::BlitMasked( const int mx, const int my, const int width, const int height, const int wx, const int wy, const Bitmap & where ) const {
+    drawNow(where);
+    drawNow(*this);
+    if (&where == Screen){
+        waitForPresent();
+    }
+
     SDL_SetColorKey(getData()->getSurface(), SDL_SRCCOLORKEY, MaskColor().color);
 
     doBlit(getData()->getSurface(),mx, my, width, height, wx, wy, where);
@@ -1073,7 +1985,13 @@ void Bitmap::BlitToScreen(const int upper_left_x, const int upper_left_y) const
         this->Blit( upper_left_x, upper_left_y, *Screen );
     }
 #endif
-    this->Blit(upper_left_x, upper_left_y, *Screen);
+    if (PRESENT_THREAD){
+        presentOnThread(*this, upper_left_x, upper_left_y);
+    } else {
+        this->Blit(upper_left_x, upper_left_y, *Screen);
+    }
+
+    finishSurfacePoolFrame();
 
     /*
     if ( Scaler == NULL ){
@@ -1130,13 +2048,32 @@ void Bitmap::Stretch( const Bitmap & where ) const {
 }
 */
 
+/* A sub-bitmap allocates a surface for itself, so an area that covers all of
+ * the bitmap is the bitmap itself. The scalers don't look at the clip rect of
+ * either.
+ */
+static Bitmap areaOf(const Bitmap & bitmap, int x, int y, int width, int height){
+    if (x == 0 && y == 0 && width == bitmap.getWidth() && height == bitmap.getHeight()){
+        return Bitmap(bitmap);
+    }
+    return Bitmap(bitmap, x, y, width, height);
+}
+
 void Bitmap::StretchXbr(const Bitmap & where, const int sourceX, const int sourceY, const int sourceWidth, const int sourceHeight, const int destX, const int destY, const int destWidth, const int destHeight) const {
-    Bitmap subSource(*this, sourceX, sourceY, sourceWidth, sourceHeight);
-    Bitmap subDestination(where, destX, destY, destWidth, destHeight);
+    drawNow(where);
+    drawNow(*this);
+    Bitmap subSource = areaOf(*this, sourceX, sourceY, sourceWidth, sourceHeight);
+    Bitmap subDestination = areaOf(where, destX, destY, destWidth, destHeight);
 
     SDL_Surface * source = subSource.getData()->getSurface();
     SDL_Surface * destination = subDestination.getData()->getSurface();
 
+    /* the scalers only know about 5-6-5 pixels */
+    if (source->format->BytesPerPixel != 2 || destination->format->BytesPerPixel != 2){
+        subSource.Stretch(subDestination);
+        return;
+    }
+
     if (SDL_MUSTLOCK(source)){
         SDL_LockSurface(source);
     }
@@ -1146,11 +2083,11 @@ void Bitmap::StretchXbr(const Bitmap & where, const int sourceX, const int sourc
     }
 
     if (sourceWidth * 4 == destWidth && sourceHeight * 4 == destHeight){
-        xbr::xbr4x(source, destination);
+        xbr::xbr4x(source, destination, getScaleThreads());
     } else if (sourceWidth * 3 == destWidth && sourceHeight * 3 == destHeight){
-        xbr::xbr3x(source, destination);
+        xbr::xbr3x(source, destination, getScaleThreads());
     } else if (sourceWidth * 2 == destWidth && sourceHeight * 2 == destHeight){
-        xbr::xbr2x(source, destination);
+        xbr::xbr2x(source, destination, getScaleThreads());
     } else {
         if (SDL_MUSTLOCK(source)){
             SDL_UnlockSurface(source);
@@ -1173,12 +2110,20 @@ void Bitmap::StretchXbr(const Bitmap & where, const int sourceX, const int sourc
 }
 
 void Bitmap::StretchHqx(const Bitmap & where, const int sourceX, const int sourceY, const int sourceWidth, const int sourceHeight, const int destX, const int destY, const int destWidth, const int destHeight) const {
-    Bitmap subSource(*this, sourceX, sourceY, sourceWidth, sourceHeight);
-    Bitmap subDestination(where, destX, destY, destWidth, destHeight);
+    drawNow(where);
+    drawNow(*this);
+    Bitmap subSource = areaOf(*this, sourceX, sourceY, sourceWidth, sourceHeight);
+    Bitmap subDestination = areaOf(where, destX, destY, destWidth, destHeight);
 
     SDL_Surface * source = subSource.getData()->getSurface();
     SDL_Surface * destination = subDestination.getData()->getSurface();
 
+    /* the scalers only know about 5-6-5 pixels */
+    if (source->format->BytesPerPixel != 2 || destination->format->BytesPerPixel != 2){
+        subSource.Stretch(subDestination);
+        return;
+    }
+
     if (SDL_MUSTLOCK(source)){
         SDL_LockSurface(source);
     }
@@ -1188,11 +2133,11 @@ void Bitmap::StretchHqx(const Bitmap & where, const int sourceX, const int sourc
     }
 
     if (sourceWidth * 4 == destWidth && sourceHeight * 4 == destHeight){
-        hqx::hq4x(source, destination);
+        hqx::hq4x(source, destination, getScaleThreads());
     } else if (sourceWidth * 3 == destWidth && sourceHeight * 3 == destHeight){
-        hqx::hq3x(source, destination);
+        hqx::hq3x(source, destination, getScaleThreads());
     } else if (sourceWidth * 2 == destWidth && sourceHeight * 2 == destHeight){
-        hq2x::hq2x(source, destination);
+        hq2x::hq2x(source, destination, getScaleThreads());
     } else {
         if (SDL_MUSTLOCK(source)){
             SDL_UnlockSurface(source);
@@ -1215,6 +2160,8 @@ void Bitmap::StretchHqx(const Bitmap & where, const int sourceX, const int sourc
 }
 
 void Bitmap::Stretch( const Bitmap & where, const int sourceX, const int sourceY, const int sourceWidth, const int sourceHeight, const int destX, const int destY, const int destWidth, const int destHeight ) const {
+    drawNow(where);
+    drawNow(*this);
 
     /* TODO: if souceWidth == destWidth && souceHeight == destHeight then
      * just do a normal blit. check if sdl already does this optimization
@@ -1225,8 +2172,8 @@ void Bitmap::Stretch( const Bitmap & where, const int sourceX, const int sourceY
         return;
     }
 
-    Bitmap subSource(*this, sourceX, sourceY, sourceWidth, sourceHeight);
-    Bitmap subDestination(where, destX, destY, destWidth, destHeight);
+    Bitmap subSource = areaOf(*this, sourceX, sourceY, sourceWidth, sourceHeight);
+    Bitmap subDestination = areaOf(where, destX, destY, destWidth, destHeight);
 
     SDL_Surface * src = subSource.getData()->getSurface();
     SDL_Surface * dst = subDestination.getData()->getSurface();
@@ -1300,12 +2247,13 @@ void Bitmap::Stretch( const Bitmap & where, const int sourceX, const int sourceY
 }
 
 void Bitmap::save(const std::string & str) const {
+    drawNow(*this);
     /* always saves as a png for now */
     IMG_SavePNG(str.c_str(), getData()->getSurface(), IMG_COMPRESS_DEFAULT);
 }
 	
 void Bitmap::triangle( int x1, int y1, int x2, int y2, int x3, int y3, Color color ) const {
-
+    drawNow(*this);
     SPG_TrigonFilled(getData()->getSurface(), x1, y1, x2, y2, x3, y3, color.color);
     /*
     if (Graphics::drawingMode == MODE_SOLID){
@@ -1318,6 +2266,7 @@ void Bitmap::triangle( int x1, int y1, int x2, int y2, int x3, int y3, Color col
 }
 
 void Bitmap::ellipse( int x, int y, int rx, int ry, Color color ) const {
+    drawNow(*this);
     SPG_Ellipse(getData()->getSurface(), x, y, rx, ry, color.color);
     /*
     if (Graphics::drawingMode == MODE_SOLID){
@@ -1330,23 +2279,38 @@ void Bitmap::ellipse( int x, int y, int rx, int ry, Color color ) const {
 }
 
 void TranslucentBitmap::ellipse( int x, int y, int rx, int ry, Color color ) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_EllipseBlend(getData()->getSurface(), x, y, rx, ry, color.color, alpha);
 }
 
 void Bitmap::ellipseFill( int x, int y, int rx, int ry, Color color ) const {
+    drawNow(*this);
     SPG_EllipseFilled(getData()->getSurface(), x, y, rx, ry, color.color);
 }
 
 void Bitmap::light(int x, int y, int width, int height, int start_y, int focus_alpha, int edge_alpha, Color focus_color, Color edge_color) const {
-    paintown_light16(getData()->getSurface(), x, y, width, height, start_y, focus_alpha, edge_alpha, focus_color.color, edge_color.color);
+    drawNow(*this);
+    SDL_Surface * surface = getData()->getSurface();
+    if (surface->format->BytesPerPixel == 4){
+        paintown_light<Pixel32>(surface, x, y, width, height, start_y, focus_alpha, edge_alpha, focus_color.color, edge_color.color);
+    } else {
+        paintown_light<Pixel16>(surface, x, y, width, height, start_y, focus_alpha, edge_alpha, focus_color.color, edge_color.color);
+    }
 }
 
 void Bitmap::applyTrans(const Color color) const {
-    paintown_applyTrans16(getData()->getSurface(), color.color);
+    drawNow(*this);
+    SDL_Surface * surface = getData()->getSurface();
+    if (surface->format->BytesPerPixel == 4){
+        paintown_applyTrans<Pixel32>(surface, color.color);
+    } else {
+        paintown_applyTrans<Pixel16>(surface, color.color);
+    }
 }
 	
 void Bitmap::floodfill( const int x, const int y, const Color color ) const {
+    drawNow(*this);
     SPG_FloodFill(getData()->getSurface(), x, y, color.color);
 }
 
@@ -1357,19 +2321,23 @@ void Bitmap::horizontalLine( const int x1, const int y, const int x2, const int
 */
 
 void Bitmap::hLine( const int x1, const int y, const int x2, const Color color ) const {
+    drawNow(*this);
     SPG_LineH(getData()->getSurface(), x1, y, x2, color.color);
 }
 
 void TranslucentBitmap::hLine( const int x1, const int y, const int x2, const Color color ) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_LineHBlend(getData()->getSurface(), x1, y, x2, color.color, alpha);
 }
 
 void Bitmap::vLine( const int y1, const int x, const int y2, const Color color ) const {
+    drawNow(*this);
     SPG_LineV(getData()->getSurface(), x, y1, y2, color.color);
 }
 	
 void Bitmap::polygon( const int * verts, const int nverts, const Color color ) const {
+    drawNow(*this);
     SPG_Point * points = new SPG_Point[nverts];
     for (int i = 0; i < nverts; i++){
         points[i].x = verts[i*2];
@@ -1390,19 +2358,23 @@ static const double arcPhase = -Util::pi / 2;
 
 /* 0 = right. pi/2 = up. pi = left. 3pi/2 = down */
 void Bitmap::arc(const int x, const int y, const double ang1, const double ang2, const int radius, const Color color ) const {
+    drawNow(*this);
     SPG_Arc(getData()->getSurface(), x, y, radius, toDegrees(ang1 + arcPhase), toDegrees(ang2 + arcPhase), color.color);
 }
 
 void Bitmap::arcFilled(const int x, const int y, const double ang1, const double ang2, const int radius, const Color color ) const {
+    drawNow(*this);
     SPG_ArcFilled(getData()->getSurface(), x, y, radius, toDegrees(ang1 + arcPhase), toDegrees(ang2 + arcPhase), color.color);
 }
 
 void TranslucentBitmap::arc(const int x, const int y, const double ang1, const double ang2, const int radius, const Color color ) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_ArcBlend(getData()->getSurface(), x, y, radius, toDegrees(ang1 + arcPhase), toDegrees(ang2 + arcPhase), color.color, alpha);
 }
 
 void TranslucentBitmap::arcFilled(const int x, const int y, const double ang1, const double ang2, const int radius, const Color color ) const {
+    drawNow(*this);
     int alpha = globalBlend.alpha;
     SPG_ArcFilledBlend(getData()->getSurface(), x, y, radius, toDegrees(ang1 + arcPhase), toDegrees(ang2 + arcPhase), color.color, alpha);
 }
@@ -1413,6 +2385,12 @@ void Bitmap::fill(Color color) const {
     area.y = 0;
     area.w = getWidth();
     area.h = getHeight();
+    getData()->setRuns(NULL);
+    if (isRecording(*this)){
+        recordFill(*this, RenderCommand::Fill, 0, 0, area.w - 1, area.h - 1, color.color);
+        return;
+    }
+    drawNow(*this);
     SDL_FillRect(getData()->getSurface(), &area, color.color);
 }
 
@@ -1429,6 +2407,8 @@ void Bitmap::drawCharacter( const int x, const int y, const Color color, const i
 }
 
 void Bitmap::drawRotate( const int x, const int y, const int angle, const Bitmap & where ){
+    drawNow(where);
+    drawNow(*this);
     SDL_SetColorKey(getData()->getSurface(), SDL_SRCCOLORKEY, MaskColor().color);
     SDL_Surface * src = getData()->getSurface();
     SDL_Surface * dst = where.getData()->getSurface();
@@ -1441,6 +2421,8 @@ static int fixAngle(int angle){
 }
 
 void Bitmap::drawPivot( const int centerX, const int centerY, const int x, const int y, const int angle, const Bitmap & where ){
+    drawNow(where);
+    drawNow(*this);
     SDL_SetColorKey(getData()->getSurface(), SDL_SRCCOLORKEY, MaskColor().color);
     SDL_Surface * src = getData()->getSurface();
     SDL_Surface * dst = where.getData()->getSurface();
@@ -1448,6 +2430,8 @@ void Bitmap::drawPivot( const int centerX, const int centerY, const int x, const
 }
 
 void Bitmap::drawPivot( const int centerX, const int centerY, const int x, const int y, const int angle, const double scale, const Bitmap & where ){
+    drawNow(where);
+    drawNow(*this);
     SDL_SetColorKey(getData()->getSurface(), SDL_SRCCOLORKEY, MaskColor().color);
     SDL_Surface * src = getData()->getSurface();
     SDL_Surface * dst = where.getData()->getSurface();
@@ -1455,7 +2439,29 @@ void Bitmap::drawPivot( const int centerX, const int centerY, const int x, const
 }
         
 void Bitmap::replaceColor(const Color & original, const Color & replaced){
-    paintown_replace16(getData()->getSurface(), original.color, replaced.color);
+    drawNow(*this);
+    getData()->setRuns(NULL);
+    SDL_Surface * surface = getData()->getSurface();
+    if (surface->format->BytesPerPixel == 4){
+        paintown_replace<Pixel32>(surface, original.color, replaced.color);
+    } else {
+        paintown_replace<Pixel16>(surface, original.color, replaced.color);
+    }
+}
+
+void Bitmap::encodeMask(){
+    drawNow(*this);
+    SDL_Surface * surface = getData()->getSurface();
+    if (surface == NULL || surface->format->BytesPerPixel != 2){
+        return;
+    }
+    if (SDL_MUSTLOCK(surface)){
+        SDL_LockSurface(surface);
+    }
+    getData()->setRuns(new Span::Runs((const Span::Pixel*) surface->pixels, surface->w, surface->h, surface->pitch / 2, MaskColor().color));
+    if (SDL_MUSTLOCK(surface)){
+        SDL_UnlockSurface(surface);
+    }
 }
 
 static SDL_Color pcxMaskColor(unsigned char * data, const int length){
@@ -1717,6 +2723,7 @@ Bitmap memoryPCX(unsigned char * const data, const int length, const bool mask){
 }
 	
 Color Bitmap::getPixel( const int x, const int y ) const {
+    drawNow(*this);
     return Color(SPG_GetPixel(getData()->getSurface(), x, y));
 }
 	
@@ -1735,40 +2742,40 @@ void Bitmap::StretchBy4( const Bitmap & where ){
 }
 	
 void Bitmap::draw(const int x, const int y, Filter * filter, const Bitmap & where) const {
-    // paintown_draw_sprite_filter_ex16(where.getData().getSurface(), getData().getSurface(), x, y, filter);
-    paintown_draw_sprite_ex16(where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_NORMAL, SPRITE_NO_FLIP, filter);
+    // paintown_draw_sprite_filter_ex<Pixel16>(where.getData().getSurface(), getData().getSurface(), x, y, filter);
+    drawSprite(where, *this, x, y, SPRITE_NORMAL, SPRITE_NO_FLIP, filter);
 }
 
 void LitBitmap::draw( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_NO_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_NO_FLIP, NULL);
 }
 
 void LitBitmap::draw( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_NO_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_NO_FLIP, filter);
 }
 
 void LitBitmap::drawHFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_H_FLIP, NULL);
 }
 
 void LitBitmap::drawHFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_H_FLIP, filter);
 }
 
 void LitBitmap::drawVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_V_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_V_FLIP, NULL);
 }
 
 void LitBitmap::drawVFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_V_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_V_FLIP, filter);
 }
 
 void LitBitmap::drawHVFlip( const int x, const int y, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_V_FLIP | SPRITE_H_FLIP, NULL);
 }
 
 void LitBitmap::drawHVFlip( const int x, const int y, Filter * filter, const Bitmap & where ) const {
-    paintown_draw_sprite_ex16( where.getData()->getSurface(), getData()->getSurface(), x, y, SPRITE_LIT, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
+    drawSprite(where, *this, x, y, SPRITE_LIT, SPRITE_V_FLIP | SPRITE_H_FLIP, filter);
 }
 
 /*
@@ -1790,7 +2797,35 @@ void LitBitmap::drawHVFlip( const int x, const int y, Filter * filter, const Bit
 #define PAINTOWN_SET_ALPHA(a)           (globalBlend.alpha = (a))
 */
 
-static void paintown_applyTrans16(SDL_Surface * dst, const int color){
+/* Trans blends a row at a time. 16-bit rows go through the span kernels and
+ * 32-bit rows call Pixel32::trans directly, which the compiler can inline and
+ * vectorize where a call through the blender pointer can't be.
+ */
+static inline void transFillRow(Uint16 * line, int count, unsigned int color, unsigned int mask, unsigned int alpha){
+    Span::fillKernel()(line, count, color, mask, alpha);
+}
+
+static inline void transFillRow(Uint32 * line, int count, unsigned int color, unsigned int mask, unsigned int alpha){
+    for (int x = 0; x < count; x++){
+        if (line[x] != mask){
+            line[x] = Pixel32::trans(color, line[x], alpha);
+        }
+    }
+}
+
+static inline void transShadeRow(Uint16 * line, const Uint16 * colors, const unsigned char * alphas, int count){
+    Span::shadeKernel()(line, colors, alphas, count);
+}
+
+static inline void transShadeRow(Uint32 * line, const Uint32 * colors, const unsigned char * alphas, int count){
+    for (int x = 0; x < count; x++){
+        line[x] = Pixel32::trans(colors[x], line[x], alphas[x]);
+    }
+}
+
+template <class Format>
+static void paintown_applyTrans(SDL_Surface * dst, const int color){
+    typedef typename Format::Type Pixel;
     int y1 = 0;
     int y2 = dst->h;
     int x1 = 0;
@@ -1803,20 +2838,31 @@ static void paintown_applyTrans16(SDL_Surface * dst, const int color){
 
     int bpp = dst->format->BytesPerPixel;
     unsigned int mask = MaskColor().color;
+    if (globalBlend.currentBlender == transBlender<Format>){
+        for (int y = y1; y < y2; y++){
+            transFillRow((Pixel*) computeOffset(dst, x1, y), x2 - x1, color, mask, globalBlend.alpha);
+        }
+        return;
+    }
+
     for (int y = y1; y < y2; y++) {
         Uint8 * sourceLine = computeOffset(dst, x1, y);
 
         for (int x = x2 - 1; x >= x1; sourceLine += bpp, x--) {
-            unsigned long sourcePixel = *(Uint16*) sourceLine;
+            unsigned long sourcePixel = *(Pixel*) sourceLine;
             if (!(sourcePixel == mask)){
                 sourcePixel = globalBlend.currentBlender(color, sourcePixel, globalBlend.alpha);
-                *(Uint16 *)sourceLine = sourcePixel;
+                *(Pixel *)sourceLine = sourcePixel;
             }
         }
     }
 }
 
-static void paintown_replace16(SDL_Surface * dst, const int original, const int replace){
+template <class Format>
+static void paintown_replace(SDL_Surface * dst, const int originalColor, const int replaceColor){
+    typedef typename Format::Type Pixel;
+    const Pixel original = (Pixel) originalColor;
+    const Pixel replace = (Pixel) replaceColor;
     int y1 = 0;
     int y2 = dst->h;
     int x1 = 0;
@@ -1959,9 +3005,9 @@ static void paintown_replace16(SDL_Surface * dst, const int original, const int
         Uint8 * sourceLine = computeOffset(dst, x1, y);
 
         for (int x = x2 - 1; x >= x1; sourceLine += bpp, x--) {
-            Uint16 sourcePixel = *(Uint16*) sourceLine;
+            Pixel sourcePixel = *(Pixel*) sourceLine;
             if (sourcePixel == original){
-                *(Uint16 *)sourceLine = replace;
+                *(Pixel *)sourceLine = replace;
             }
         }
     }
@@ -1971,7 +3017,66 @@ static void paintown_replace16(SDL_Surface * dst, const int original, const int
     }
 }
 
-static void paintown_draw_sprite_filter_ex16(SDL_Surface * dst, SDL_Surface * src, long long dx, long long dy, Bitmap::Filter * filter){
+/* Runs a filter over pixels. A ChannelFilter is turned into a table per
+ * channel once per blit, so each pixel costs three lookups instead of a
+ * virtual call and a round trip through the 8-bit channel values. A
+ * ColorMapFilter is looked up in its own hash table.
+ */
+template <class Format>
+class PixelFilter{
+public:
+    typedef typename Format::Type Pixel;
+
+    PixelFilter(Bitmap::Filter * filter):
+    filter(filter),
+    channels(false),
+    colors(dynamic_cast<const Bitmap::ColorMapFilter*>(filter)){
+        const Bitmap::ChannelFilter * channel = dynamic_cast<const Bitmap::ChannelFilter*>(filter);
+        if (channel != NULL){
+            channels = true;
+            /* go through the same conversions filter() would use so the
+             * output is identical
+             */
+            for (int i = 0; i < Format::RedLevels; i++){
+                red[i] = makeColor(channel->red[getRed(Color(i << Format::RedShift))], 0, 0).color;
+            }
+            for (int i = 0; i < Format::GreenLevels; i++){
+                green[i] = makeColor(0, channel->green[getGreen(Color(i << Format::GreenShift))], 0).color;
+            }
+            for (int i = 0; i < Format::BlueLevels; i++){
+                blue[i] = makeColor(0, 0, channel->blue[getBlue(Color(i << Format::BlueShift))]).color;
+            }
+        }
+    }
+
+    inline bool active() const {
+        return filter != NULL;
+    }
+
+    inline Pixel apply(Pixel pixel) const {
+        if (channels){
+            return red[(pixel >> Format::RedShift) & (Format::RedLevels - 1)] |
+                   green[(pixel >> Format::GreenShift) & (Format::GreenLevels - 1)] |
+                   blue[(pixel >> Format::BlueShift) & (Format::BlueLevels - 1)];
+        }
+        if (colors != NULL){
+            return colors->lookup(Color(pixel)).color;
+        }
+        return filter->filter(Color(pixel)).color;
+    }
+
+protected:
+    Bitmap::Filter * filter;
+    bool channels;
+    const Bitmap::ColorMapFilter * colors;
+    Pixel red[Format::RedLevels];
+    Pixel green[Format::GreenLevels];
+    Pixel blue[Format::BlueLevels];
+};
+
+template <class Format>
+static void paintown_draw_sprite_filter_ex(SDL_Surface * dst, SDL_Surface * src, long long dx, long long dy, Bitmap::Filter * filter){
+    typedef typename Format::Type Pixel;
     int x, y, w, h;
     int x_dir = 1, y_dir = 1;
     int dxbeg, dybeg;
@@ -2004,17 +3109,18 @@ static void paintown_draw_sprite_filter_ex16(SDL_Surface * dst, SDL_Surface * sr
     }
 
     unsigned int mask = MaskColor().color;
+    PixelFilter<Format> pixels(filter);
     int bpp = src->format->BytesPerPixel;
     for (y = 0; y < h; y++) {
         Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
         Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
 
         for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
-            unsigned long sourcePixel = *(Uint16*) sourceLine;
+            unsigned long sourcePixel = *(Pixel*) sourceLine;
             if (!(sourcePixel == mask)){
-                *(Uint16 *)destLine = filter->filter(Color(sourcePixel)).color;
+                *(Pixel *)destLine = pixels.apply(sourcePixel);
             } else {
-                *(Uint16 *)destLine = mask;
+                *(Pixel *)destLine = mask;
             }
         }
     }
@@ -2024,11 +3130,174 @@ static void paintown_draw_sprite_filter_ex16(SDL_Surface * dst, SDL_Surface * sr
     }
 }
 
-static void paintown_draw_sprite_ex16(SDL_Surface * dst, SDL_Surface * src, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter){
+/* finds the row kernel that does the same thing as the current blender */
+static bool spanBlender(blender function, Span::Mode * mode){
+    if (function == transBlender<Pixel16>){
+        *mode = Span::Trans;
+        return true;
+    }
+    if (function == addBlender<Pixel16>){
+        *mode = Span::Add;
+        return true;
+    }
+    if (function == multiplyBlender<Pixel16>){
+        *mode = Span::Multiply;
+        return true;
+    }
+    if (function == differenceBlender<Pixel16>){
+        *mode = Span::Difference;
+        return true;
+    }
+    return false;
+}
+
+/* draws the sprite a row at a time with the span kernels, if the sprite has
+ * its opaque runs encoded then only those are drawn
+ */
+static void drawSpans(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, Span::Mode mode, int sxbeg, int sybeg, int dxbeg, int dybeg, int w, int h, int x_dir, int y_dir){
+    Span::Pixel mask = MaskColor().color;
+    if (runs != NULL && runs->getMask() == mask && runs->getWidth() == src->w && runs->getHeight() == src->h){
+        for (int y = 0; y < h; y++){
+            Span::Pixel * sourceLine = (Span::Pixel*) computeOffset(src, 0, sybeg + y);
+            Span::Pixel * destLine = (Span::Pixel*) computeOffset(dst, dxbeg, dybeg + y * y_dir);
+            runs->draw(sybeg + y, sxbeg, w, sourceLine, destLine, mode, x_dir < 0, globalBlend.alpha);
+        }
+        return;
+    }
+
+    Span::Kernel kernel = Span::kernel(mode, x_dir < 0);
+    for (int y = 0; y < h; y++){
+        Span::Pixel * sourceLine = (Span::Pixel*) computeOffset(src, sxbeg, sybeg + y);
+        Span::Pixel * destLine = (Span::Pixel*) computeOffset(dst, dxbeg, dybeg + y * y_dir);
+        kernel(destLine, sourceLine, w, mask, globalBlend.alpha);
+    }
+}
+
+/* blends the shadow color over the destination pixels that columns
+ * [first, last) of a sprite drawn at dx land on
+ */
+template <class Format>
+static inline void shadowSpan(typename Format::Type * line, const SDL_Rect & clip, int dx, int width, int first, int last, bool hflip, unsigned int color, unsigned int alpha){
+    int start = hflip ? dx + width - last : dx + first;
+    int stop = hflip ? dx + width - first : dx + last;
+    if (start < clip.x){
+        start = clip.x;
+    }
+    if (stop > clip.x + clip.w){
+        stop = clip.x + clip.w;
+    }
+    for (int x = start; x < stop; x++){
+        line[x] = Format::trans(color, line[x], alpha);
+    }
+}
+
+/* Draws the silhouette of src in one color, squashed or stretched to `height'
+ * rows and blended with the trans blender. Each row comes from source row
+ * row * src->h / height, the same one SDL_StretchSurfaceRect would pick, so
+ * this looks the same as stretching the sprite into a temporary bitmap,
+ * coloring it in and drawing that translucent. If the sprite has its opaque
+ * runs encoded only those are looked at.
+ */
+template <class Format>
+static void paintown_draw_shadow(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, int dx, int dy, int height, bool hflip, bool vflip, unsigned int color, unsigned int alpha){
+    typedef typename Format::Type Pixel;
+    const Pixel mask = MaskColor().color;
+    const SDL_Rect & clip = dst->clip_rect;
+    bool useRuns = runs != NULL && runs->getMask() == mask && runs->getWidth() == src->w && runs->getHeight() == src->h;
+
+    if (SDL_MUSTLOCK(src)){
+        SDL_LockSurface(src);
+    }
+
+    if (SDL_MUSTLOCK(dst)){
+        SDL_LockSurface(dst);
+    }
+
+    for (int row = 0; row < height; row++){
+        int y = dy + (vflip ? height - 1 - row : row);
+        if (y < clip.y || y >= clip.y + clip.h){
+            continue;
+        }
+
+        int sourceY = (int) ((long long) row * src->h / height);
+        Pixel * line = (Pixel*) computeOffset(dst, 0, y);
+        if (useRuns){
+            unsigned int count = 0;
+            const Span::Run * run = runs->row(sourceY, count);
+            for (unsigned int i = 0; i < count; i++){
+                shadowSpan<Format>(line, clip, dx, src->w, run[i].start, run[i].start + run[i].length, hflip, color, alpha);
+            }
+        } else {
+            const Pixel * source = (const Pixel*) computeOffset(src, 0, sourceY);
+            int x = 0;
+            while (x < src->w){
+                while (x < src->w && source[x] == mask){
+                    x += 1;
+                }
+                int start = x;
+                while (x < src->w && source[x] != mask){
+                    x += 1;
+                }
+                if (x > start){
+                    shadowSpan<Format>(line, clip, dx, src->w, start, x, hflip, color, alpha);
+                }
+            }
+        }
+    }
+
+    if (SDL_MUSTLOCK(src)){
+        SDL_UnlockSurface(src);
+    }
+
+    if (SDL_MUSTLOCK(dst)){
+        SDL_UnlockSurface(dst);
+    }
+}
+
+void Bitmap::drawShadow(Bitmap & where, int x, int y, int intensity, Color color, double scale, bool facingRight) const {
+    const double newheight = getHeight() * scale;
+    const int height = (int) fabs(newheight);
+
+    transBlender(0, 0, 0, intensity);
+    drawNow(where);
+    drawNow(*this);
+
+    SDL_Surface * src = getData()->getSurface();
+    SDL_Surface * dst = where.getData()->getSurface();
+    if (height <= 0 || src == NULL || dst == NULL || color == MaskColor()){
+        return;
+    }
+
+    /* a positive scale hangs the shadow upside down below y, a negative one
+     * stands it up on top of y
+     */
+    bool vflip = true;
+    if (scale < 0){
+        vflip = false;
+        y -= fabs(newheight);
+        x += facingRight ? 3 : -3;
+    }
+
+    int bpp = src->format->BytesPerPixel;
+    if (bpp != dst->format->BytesPerPixel){
+        return;
+    }
+
+    if (bpp == 4){
+        paintown_draw_shadow<Pixel32>(dst, src, getData()->getRuns(), x, y, height, !facingRight, vflip, color.color, globalBlend.alpha);
+    } else if (bpp == 2){
+        paintown_draw_shadow<Pixel16>(dst, src, getData()->getRuns(), x, y, height, !facingRight, vflip, color.color, globalBlend.alpha);
+    }
+}
+
+template <class Format>
+static void paintown_draw_sprite_ex(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter){
+    typedef typename Format::Type Pixel;
     int x, y, w, h;
     int x_dir = 1, y_dir = 1;
     int dxbeg, dybeg;
     int sxbeg, sybeg;
+    PixelFilter<Format> pixels(filter);
     /*
     PAINTOWN_DLS_BLENDER lit_blender;
     PAINTOWN_DTS_BLENDER trans_blender;
@@ -2191,77 +3460,88 @@ static void paintown_draw_sprite_ex16(SDL_Surface * dst, SDL_Surface * src, long
 #endif
         {
 
-        switch (mode){
-            case SPRITE_NORMAL : {
-                unsigned int mask = MaskColor().color;
-                int bpp = src->format->BytesPerPixel;
-                for (y = 0; y < h; y++) {
-                    Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
-                    Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
-
-                    for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
-                        unsigned long sourcePixel = *(Uint16*) sourceLine;
-                        if (!(sourcePixel == mask)){
-                            // unsigned int destPixel = *(Uint16*) destLine;
-                            // sourcePixel = globalBlend.currentBlender(destPixel, sourcePixel, globalBlend.alpha);
-                            if (filter != NULL){
-                                *(Uint16 *)destLine = filter->filter(Color(sourcePixel)).color;
-                            } else {
-                                *(Uint16 *)destLine = sourcePixel;
+        /* Filters and the other blenders still go pixel by pixel */
+        Span::Mode spanMode = Span::Copy;
+        bool spans = !pixels.active() &&
+                     src->format->BytesPerPixel == 2 &&
+                     dst->format->BytesPerPixel == 2 &&
+                     (mode == SPRITE_NORMAL ||
+                      (mode == SPRITE_TRANS && spanBlender(globalBlend.currentBlender, &spanMode)));
+        if (spans){
+            drawSpans(dst, src, runs, spanMode, sxbeg, sybeg, dxbeg, dybeg, w, h, x_dir, y_dir);
+        } else {
+            switch (mode){
+                case SPRITE_NORMAL : {
+                    unsigned int mask = MaskColor().color;
+                    int bpp = src->format->BytesPerPixel;
+                    for (y = 0; y < h; y++) {
+                        Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
+                        Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
+
+                        for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
+                            unsigned long sourcePixel = *(Pixel*) sourceLine;
+                            if (!(sourcePixel == mask)){
+                                // unsigned int destPixel = *(Uint16*) destLine;
+                                // sourcePixel = globalBlend.currentBlender(destPixel, sourcePixel, globalBlend.alpha);
+                                if (pixels.active()){
+                                    *(Pixel *)destLine = pixels.apply(sourcePixel);
+                                } else {
+                                    *(Pixel *)destLine = sourcePixel;
+                                }
                             }
                         }
                     }
-                }
-                break;
-             }
-             case SPRITE_LIT : {
-                int bpp = src->format->BytesPerPixel;
-                int litColor = makeColor(globalBlend.red, globalBlend.green, globalBlend.blue).color;
-                unsigned int mask = MaskColor().color;
-                for (y = 0; y < h; y++) {
-                    Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
-                    Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
-
-                    for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
-                        unsigned long sourcePixel = *(Uint16*) sourceLine;
-                        if (!(sourcePixel == mask)){
-                            // unsigned int destPixel = *(Uint16*) destLine;
-                            if (filter != NULL){
-                                sourcePixel = globalBlend.currentBlender(litColor, filter->filter(Color(sourcePixel)).color, globalBlend.alpha);
-                                *(Uint16 *)destLine = sourcePixel;
-                            } else {
-                                sourcePixel = globalBlend.currentBlender(litColor, sourcePixel, globalBlend.alpha);
-                                *(Uint16 *)destLine = sourcePixel;
+                    break;
+                 }
+                 case SPRITE_LIT : {
+                    int bpp = src->format->BytesPerPixel;
+                    int litColor = makeColor(globalBlend.red, globalBlend.green, globalBlend.blue).color;
+                    unsigned int mask = MaskColor().color;
+                    for (y = 0; y < h; y++) {
+                        Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
+                        Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
+
+                        for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
+                            unsigned long sourcePixel = *(Pixel*) sourceLine;
+                            if (!(sourcePixel == mask)){
+                                // unsigned int destPixel = *(Uint16*) destLine;
+                                if (pixels.active()){
+                                    sourcePixel = globalBlend.currentBlender(litColor, pixels.apply(sourcePixel), globalBlend.alpha);
+                                    *(Pixel *)destLine = sourcePixel;
+                                } else {
+                                    sourcePixel = globalBlend.currentBlender(litColor, sourcePixel, globalBlend.alpha);
+                                    *(Pixel *)destLine = sourcePixel;
+                                }
                             }
                         }
                     }
+                    break;
                 }
-                break;
-            }
-            case SPRITE_TRANS : {
-                int bpp = src->format->BytesPerPixel;
-                unsigned int mask = MaskColor().color;
-                for (y = 0; y < h; y++) {
-                    Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
-                    Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
-
-                    for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
-                        unsigned long sourcePixel = *(Uint16*) sourceLine;
-                        if (!(sourcePixel == mask)){
-                            unsigned int destPixel = *(Uint16*) destLine;
-                            if (filter != NULL){
-                                sourcePixel = globalBlend.currentBlender(filter->filter(Color(sourcePixel)).color, destPixel, globalBlend.alpha);
-                                *(Uint16 *)destLine = sourcePixel;
-                            } else {
-                                sourcePixel = globalBlend.currentBlender(sourcePixel, destPixel, globalBlend.alpha);
-                                *(Uint16 *)destLine = sourcePixel;
+                case SPRITE_TRANS : {
+                    int bpp = src->format->BytesPerPixel;
+                    unsigned int mask = MaskColor().color;
+                    for (y = 0; y < h; y++) {
+                        Uint8 * sourceLine = computeOffset(src, sxbeg, sybeg + y);
+                        Uint8 * destLine = computeOffset(dst, dxbeg, dybeg + y * y_dir);
+
+                        for (x = w - 1; x >= 0; sourceLine += bpp, destLine += bpp * x_dir, x--) {
+                            unsigned long sourcePixel = *(Pixel*) sourceLine;
+                            if (!(sourcePixel == mask)){
+                                unsigned int destPixel = *(Pixel*) destLine;
+                                if (pixels.active()){
+                                    sourcePixel = globalBlend.currentBlender(pixels.apply(sourcePixel), destPixel, globalBlend.alpha);
+                                    *(Pixel *)destLine = sourcePixel;
+                                } else {
+                                    sourcePixel = globalBlend.currentBlender(sourcePixel, destPixel, globalBlend.alpha);
+                                    *(Pixel *)destLine = sourcePixel;
+                                }
                             }
                         }
                     }
+                    break;
                 }
-                break;
+                default : { break; }
             }
-            default : { break; }
         }
 
 #if 0
@@ -2299,10 +3579,28 @@ static void paintown_draw_sprite_ex16(SDL_Surface * dst, SDL_Surface * src, long
     }
 }
 
+/* Every surface is made in the render depth, so the sprite and what it is
+ * drawn on always agree. The screen itself can be in another format but it
+ * is only ever blitted to.
+ */
+static void drawSprite(SDL_Surface * dst, SDL_Surface * src, const Span::Runs * runs, long long dx, long long dy, int mode, int flip, Bitmap::Filter * filter){
+    int bpp = src->format->BytesPerPixel;
+    if (bpp != dst->format->BytesPerPixel){
+        return;
+    }
+    if (bpp == 4){
+        paintown_draw_sprite_ex<Pixel32>(dst, src, runs, dx, dy, mode, flip, filter);
+    } else if (bpp == 2){
+        paintown_draw_sprite_ex<Pixel16>(dst, src, runs, dx, dy, mode, flip, filter);
+    }
+}
+
 /* ultra special-case for drawing a light (like from a lamp).
  * center of light is x,y and shines in a perfect isosolese triangle.
  */
-static void paintown_light16(SDL_Surface * dst, const int x, const int y, int width, int height, const int start_y, const int focus_alpha, const int edge_alpha, const int focus_color, const int edge_color){
+template <class Format>
+static void paintown_light(SDL_Surface * dst, const int x, const int y, int width, int height, const int start_y, const int focus_alpha, const int edge_alpha, const int focus_color, const int edge_color){
+    typedef typename Format::Type Pixel;
 
     if (width > dst->w){
         width = dst->w;
@@ -2312,14 +3610,9 @@ static void paintown_light16(SDL_Surface * dst, const int x, const int y, int wi
         height = dst->h;
     }
 
-    int dxbeg = x - width;
-    int x_dir = 1;
-    unsigned char * alphas = new unsigned char[width];
-    Color * colors = new Color[width];
-    for (int i = 0; i < width; i++){
-        alphas[i] = (unsigned char)((double)(edge_alpha - focus_alpha) * (double)i / (double)width + focus_alpha);
+    if (width <= 0 || height <= 0){
+        return;
     }
-    blend_palette(colors, width, Color(focus_color), Color(edge_color));
 
     if (SDL_MUSTLOCK(dst)){
         SDL_LockSurface(dst);
@@ -2330,14 +3623,18 @@ static void paintown_light16(SDL_Surface * dst, const int x, const int y, int wi
     max_y = dst->clip_rect.y + dst->clip_rect.h - 1;
     min_x = dst->clip_rect.x;
     max_x = dst->clip_rect.x + dst->clip_rect.w - 1;
-            
-    int dybeg = y;
+
+    Util::Thread::ScopedLock scoped(lightMaskLock);
+    const LightMask & mask = findLightMask<Format>(width, focus_alpha, edge_alpha, focus_color, edge_color);
+    /* column sx of the cone, -width < sx < width */
+    const unsigned char * alphas = &mask.alphas[width - 1];
+    const Pixel * colors = (const Pixel*) &mask.colors[0] + width - 1;
+    bool trans = globalBlend.currentBlender == transBlender<Format>;
 
     /* tan(theta) = y / x */
     double xtan = (double) height / (double) width;
-    int bpp = dst->format->BytesPerPixel;
     for (int sy = start_y; sy < height; sy++) {
-        if (dybeg + sy < min_y || dybeg + sy > max_y){
+        if (y + sy < min_y || y + sy > max_y){
             continue;
         }
         /* x = y / tan(theta) */
@@ -2346,31 +3643,29 @@ static void paintown_light16(SDL_Surface * dst, const int x, const int y, int wi
             continue;
         }
 
-        dxbeg = x - top_width;
-        Uint8* line = computeOffset(dst, dxbeg, dybeg + y);
+        /* the part of the row inside the clip rectangle */
+        int first = -top_width;
+        int last = top_width;
+        if (x + first < min_x){
+            first = min_x - x;
+        }
+        if (x + last > max_x){
+            last = max_x - x;
+        }
+        if (first > last){
+            continue;
+        }
 
-        for (int sx = -top_width; sx <= top_width; line += x_dir * bpp, sx++) {
-            if (sx + x < min_x || sx + x > max_x){
-                continue;
+        Pixel * line = (Pixel*) computeOffset(dst, x + first, y + sy);
+        int count = last - first + 1;
+        if (trans){
+            transShadeRow(line, colors + first, alphas + first, count);
+        } else {
+            for (int sx = 0; sx < count; sx++){
+                line[sx] = globalBlend.currentBlender(colors[first + sx], line[sx], alphas[first + sx]);
             }
-
-            unsigned long c = *(Uint16*) line;
-
-            /* TODO:
-             * converting to a double and calling fabs is overkill, just
-             * write an integer abs() function.
-             */
-            int sx_abs = (int) fabs((double) sx);
-            int alphaUse = alphas[sx_abs];
-            int color = colors[sx_abs].color;
-
-            c = globalBlend.currentBlender(color, c, alphaUse);
-
-            *(Uint16*) line = c;
         }
     }
-    delete[] alphas;
-    delete[] colors;
 
     if (SDL_MUSTLOCK(dst)){
         SDL_UnlockSurface(dst);
@@ -1,6 +1,11 @@
 struct SDL_Surface;
 
 namespace Graphics{
+
+namespace Span{
+    class Runs;
+}
+
 struct BitmapData{
     BitmapData():
         surface(0),
@@ -8,7 +13,9 @@ struct BitmapData{
         clip_right(0),
         clip_top(0),
         clip_bottom(0),
-        destroy(true){}
+        destroy(true),
+        pooled(false),
+        runs(0){}
 
     BitmapData(SDL_Surface * surface);
 
@@ -34,10 +41,29 @@ struct BitmapData{
 
     void setSurface(SDL_Surface * surface);
 
+    /* takes ownership, NULL drops the current runs */
+    void setRuns(Span::Runs * runs);
+
+    inline const Span::Runs * getRuns() const {
+        return runs;
+    }
+
     SDL_Surface * surface;
     mutable int clip_left, clip_right;
     mutable int clip_top, clip_bottom;
     bool destroy;
+    /* the surface goes back to the surface pool instead of being freed */
+    bool pooled;
+
+    /* opaque runs of the surface, only set by Bitmap::encodeMask */
+    Span::Runs * runs;
+
+    /* the bitmap a sub-bitmap was made from, whose pixels it draws on */
+    Util::ReferenceCount<BitmapData> parent;
+
+private:
+    BitmapData(const BitmapData &);
+    BitmapData & operator=(const BitmapData &);
 };
 
 typedef int INTERNAL_COLOR;
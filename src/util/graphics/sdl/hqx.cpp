@@ -6,7 +6,9 @@
  */
 
 #include <stdint.h>
+#include <vector>
 #include <SDL.h>
+#include "util/thread.h"
 
 static void rgb555_to_rgb888(uint8_t red, uint8_t green, uint8_t blue,
                              uint8_t & red_output, uint8_t & green_output, uint8_t & blue_output){
@@ -62,6 +64,102 @@ static void yuv888_to_rgb888(double y, double u, double v,
 static void grow(uint32_t &n) { n |= n << 16; n &= RGB32_565; }
 static uint16_t pack(uint32_t n) { n &= RGB32_565; return n | (n >> 16); }
 
+/* The pattern of a pixel has a bit set for each of its 8 neighbors that looks
+ * different from it, from the upper left (bit 0) to the lower right (bit 7).
+ * The YUV values of the rows above, at and below the current one are kept so
+ * each pixel is looked up once instead of nine times, and a whole row of
+ * patterns is worked out with branchless compares the compiler can vectorize.
+ * Past the edges of the image the nearest pixel is used.
+ *
+ * Compare::yuv(pixel) gives the YUV value of a 16-bit pixel and
+ * Compare::different(center, other) is 1 if two of them count as different.
+ */
+template <class Compare>
+class PatternRows{
+public:
+    PatternRows(const unsigned char * pixels, int width, int height, int pitch):
+    pixels(pixels),
+    width(width),
+    height(height),
+    pitch(pitch),
+    current(-2),
+    yuv((width + 2) * 3),
+    patterns(width){
+        /* one pixel of padding on each side of a row */
+        above = &yuv[1];
+        middle = &yuv[width + 3];
+        below = &yuv[width * 2 + 5];
+    }
+
+    /* patterns of row y. going down one row at a time only reads one new row */
+    const unsigned char * compute(int y){
+        if (y == current + 1){
+            uint32_t * top = above;
+            above = middle;
+            middle = below;
+            below = top;
+            load(below, y + 1);
+        } else {
+            load(above, y - 1);
+            load(middle, y);
+            load(below, y + 1);
+        }
+        current = y;
+
+        const uint32_t * up = above;
+        const uint32_t * row = middle;
+        const uint32_t * down = below;
+        unsigned char * out = &patterns[0];
+        for (int x = 0; x < width; x++){
+            uint32_t center = row[x];
+            out[x] = Compare::different(center, up[x - 1]) |
+                     Compare::different(center, up[x]) << 1 |
+                     Compare::different(center, up[x + 1]) << 2 |
+                     Compare::different(center, row[x - 1]) << 3 |
+                     Compare::different(center, row[x + 1]) << 4 |
+                     Compare::different(center, down[x - 1]) << 5 |
+                     Compare::different(center, down[x]) << 6 |
+                     Compare::different(center, down[x + 1]) << 7;
+        }
+
+        return out;
+    }
+
+private:
+    void load(uint32_t * row, int y){
+        if (y < 0){
+            y = 0;
+        }
+        if (y > height - 1){
+            y = height - 1;
+        }
+        const uint16_t * line = (const uint16_t*) (pixels + y * pitch);
+        for (int x = 0; x < width; x++){
+            row[x] = Compare::yuv(line[x]);
+        }
+        row[-1] = row[0];
+        row[width] = row[width - 1];
+    }
+
+    const unsigned char * pixels;
+    int width;
+    int height;
+    int pitch;
+    /* row the patterns are for */
+    int current;
+    std::vector<uint32_t> yuv;
+    std::vector<unsigned char> patterns;
+    uint32_t * above;
+    uint32_t * middle;
+    uint32_t * below;
+};
+
+/* what the scalers hand to each band of rows */
+struct Scale{
+    SDL_Surface * input;
+    SDL_Surface * output;
+};
+
 namespace hq2x{
 
 enum {
@@ -137,9 +235,15 @@ static bool same(uint16_t x, uint16_t y) {
   return !((yuvTable[x] - yuvTable[y] + diff_offset) & diff_mask);
 }
 
-static bool diff(uint32_t x, uint16_t y) {
-  return ((x - yuvTable[y]) & diff_mask);
-}
+struct Compare{
+    static inline uint32_t yuv(uint16_t pixel){
+        return yuvTable[pixel];
+    }
+
+    static inline int different(uint32_t center, uint32_t other){
+        return ((center + diff_offset - other) & diff_mask) != 0;
+    }
+};
 
 static uint16_t blend1(uint32_t A, uint32_t B) {
   grow(A); grow(B);
@@ -204,16 +308,19 @@ void filter_size(unsigned &width, unsigned &height) {
     height *= 2;
 }
 
-void hq2x(SDL_Surface * input, SDL_Surface * output){
-    initialize();
+static void hq2xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
     /* pitch is adjusted by the bit depth (2 bytes per pixel) so we
      * divide by two since we are using int16_t
      */
     int pitch = input->pitch / 2;
     int outpitch = output->pitch / 2;
 
-    //#pragma omp parallel for
-    for (unsigned int y = 0; y < input->h; y++){
+    PatternRows<Compare> rows((const unsigned char*) input->pixels, input->w, input->h, input->pitch);
+
+    for (int y = first; y < last; y++){
+        const unsigned char * patterns = rows.compute(y);
         const uint16_t * in = (uint16_t*) input->pixels + y * pitch;
         uint16_t *out0 = (uint16_t*) output->pixels + y * outpitch * 2;
         uint16_t *out1 = (uint16_t*) output->pixels + y * outpitch * 2 + outpitch;
@@ -236,17 +343,8 @@ void hq2x(SDL_Surface * input, SDL_Surface * output){
             uint16_t G = *(in + nextline - 1);
             uint16_t H = *(in + nextline + 0);
             uint16_t I = *(in + nextline + 1);
-            uint32_t e = yuvTable[E] + diff_offset;
-
-            uint8_t pattern;
-            pattern  = diff(e, A) << 0;
-            pattern |= diff(e, B) << 1;
-            pattern |= diff(e, C) << 2;
-            pattern |= diff(e, D) << 3;
-            pattern |= diff(e, F) << 4;
-            pattern |= diff(e, G) << 5;
-            pattern |= diff(e, H) << 6;
-            pattern |= diff(e, I) << 7;
+
+            uint8_t pattern = patterns[x];
 
             /* upper left */
             *(out0 + 0) = blend(hqTable[pattern], E, A, B, D, F, H); pattern = rotate[pattern];
@@ -268,6 +366,14 @@ void hq2x(SDL_Surface * input, SDL_Surface * output){
     }
 }
 
+void hq2x(SDL_Surface * input, SDL_Surface * output, int threads){
+    initialize();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, hq2xRows, &scale);
+}
+
 }
 
 namespace hqx{
@@ -292,7 +398,6 @@ namespace hqx{
 
 // static int   LUT16to32[65536];
 static int   RGBtoYUV[65536];
-static int   YUV1, YUV2;
 static const  int   Ymask = 0x00FF0000;
 static const  int   Umask = 0x0000FF00;
 static const  int   Vmask = 0x000000FF;
@@ -556,13 +661,28 @@ inline void Interp8(unsigned char * pc, uint32_t c1, uint32_t c2){
 #define PIXEL33_82    Interp8(pOut+BpL+BpL+BpL+sizeof(PIXEL_TYPE)*3, c[5], c[8]);
 
 inline bool Diff(unsigned int w1, unsigned int w2){
-  YUV1 = RGBtoYUV[w1];
-  YUV2 = RGBtoYUV[w2];
+  int YUV1 = RGBtoYUV[w1];
+  int YUV2 = RGBtoYUV[w2];
   return ((abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY) ||
           (abs((YUV1 & Umask) - (YUV2 & Umask)) > trU) ||
           (abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV));
 }
 
+struct Compare{
+    static inline uint32_t yuv(uint16_t pixel){
+        return RGBtoYUV[pixel];
+    }
+
+    /* the same test as Diff() */
+    static inline int different(uint32_t center, uint32_t other){
+        int YUV1 = center;
+        int YUV2 = other;
+        return (abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY) |
+               (abs((YUV1 & Umask) - (YUV2 & Umask)) > trU) |
+               (abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV);
+    }
+};
+
 void InitLUTs(void){
     static bool initialized = false;
     if (initialized){
@@ -616,7 +736,8 @@ void InitLUTs(void){
   */
 }
 
-void hq4x_16(unsigned char * input, unsigned char * output, int Xres, int Yres, int inputPitch, int outputPitch){
+/* scales rows [firstRow, lastRow) of the input */
+void hq4x_16(unsigned char * input, unsigned char * output, int Xres, int Yres, int inputPitch, int outputPitch, int firstRow, int lastRow){
   //   +----+----+----+
   //   |    |    |    |
   //   | w1 | w2 | w3 |
@@ -629,8 +750,10 @@ void hq4x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
   //   +----+----+----+
 
   const int BpL = outputPitch;
+  PatternRows<Compare> rows(input, Xres, Yres, inputPitch);
 
-  for (int j=0; j<Yres; j++){
+  for (int j=firstRow; j<lastRow; j++){
+    const unsigned char * patterns = rows.compute(j);
     int prevline, nextline;
     if (j>0)      prevline = -inputPitch; else prevline = 0;
     if (j<Yres-1) nextline =  inputPitch; else nextline = 0;
@@ -666,24 +789,7 @@ void hq4x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
         w[9] = w[8];
       }
 
-      int pattern = 0;
-      int flag = 1;
-
-      YUV1 = RGBtoYUV[w[5]];
-
-      for (int k=1; k<=9; k++){
-        if (k==5) continue;
-
-        if ( w[k] != w[5] )
-        {
-          YUV2 = RGBtoYUV[w[k]];
-          if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-               ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-               ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-            pattern |= flag;
-        }
-        flag <<= 1;
-      }
+      int pattern = patterns[i];
 
       for (int k = 1; k <= 9; k++){
         // c[k] = LUT16to32[w[k]];
@@ -5811,10 +5917,20 @@ void hq4x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
 #undef PIXEL33_81   
 #undef PIXEL33_82   
 
-void hq4x(SDL_Surface * input, SDL_Surface * output){
-    InitLUTs();
+static void hq4xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
     hq4x_16((unsigned char*) input->pixels, (unsigned char*) output->pixels,
-            input->w, input->h, input->pitch, output->pitch);
+            input->w, input->h, input->pitch, output->pitch, first, last);
+}
+
+void hq4x(SDL_Surface * input, SDL_Surface * output, int threads){
+    /* the tables have to be filled in before any band starts */
+    InitLUTs();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, hq4xRows, &scale);
 }
 
 //hq3x filter demo program
@@ -5933,7 +6049,8 @@ inline bool Diff(unsigned int w1, unsigned int w2){
 }
 */
 
-void hq3x_16(unsigned char * input, unsigned char * output, int Xres, int Yres, int inputPitch, int outputPitch){
+/* scales rows [firstRow, lastRow) of the input */
+void hq3x_16(unsigned char * input, unsigned char * output, int Xres, int Yres, int inputPitch, int outputPitch, int firstRow, int lastRow){
   //   +----+----+----+
   //   |    |    |    |
   //   | w1 | w2 | w3 |
@@ -5946,7 +6063,10 @@ void hq3x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
   //   +----+----+----+
 
   const int BpL = outputPitch;
-  for (int j=0; j<Yres; j++){
+  PatternRows<Compare> rows(input, Xres, Yres, inputPitch);
+
+  for (int j=firstRow; j<lastRow; j++){
+      const unsigned char * patterns = rows.compute(j);
       int prevline, nextline;
     if (j>0)      prevline = -inputPitch; else prevline = 0;
     if (j<Yres-1) nextline =  inputPitch; else nextline = 0;
@@ -5988,25 +6108,7 @@ void hq3x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
         w[9] = w[8];
       }
 
-      int pattern = 0;
-      int flag = 1;
-
-      YUV1 = RGBtoYUV[w[5]];
-
-      for (int k=1; k<=9; k++)
-      {
-        if (k==5) continue;
-
-        if ( w[k] != w[5] )
-        {
-          YUV2 = RGBtoYUV[w[k]];
-          if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-               ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-               ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-            pattern |= flag;
-        }
-        flag <<= 1;
-      }
+      int pattern = patterns[i];
 
       for (int k=1; k<=9; k++)
         c[k] = w[k];
@@ -9687,10 +9789,20 @@ void hq3x_16(unsigned char * input, unsigned char * output, int Xres, int Yres,
 
 
 
-void hq3x(SDL_Surface * input, SDL_Surface * output){
-    InitLUTs();
+static void hq3xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
     hq3x_16((unsigned char*) input->pixels, (unsigned char*) output->pixels,
-            input->w, input->h, input->pitch, output->pitch);
+            input->w, input->h, input->pitch, output->pitch, first, last);
+}
+
+void hq3x(SDL_Surface * input, SDL_Surface * output, int threads){
+    /* the tables have to be filled in before any band starts */
+    InitLUTs();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, hq3xRows, &scale);
 }
 
 }
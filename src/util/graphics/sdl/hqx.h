@@ -3,13 +3,17 @@
 
 struct SDL_Surface;
 
+/* The scalers take 16-bit surfaces. The rows are split into `threads' bands
+ * that are scaled at the same time.
+ */
+
 namespace hq2x{
-    void hq2x(SDL_Surface * input, SDL_Surface * output);
+    void hq2x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
 }
 
 namespace hqx{
-    void hq3x(SDL_Surface * input, SDL_Surface * output);
-    void hq4x(SDL_Surface * input, SDL_Surface * output);
+    void hq3x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
+    void hq4x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
 }
 
 #endif
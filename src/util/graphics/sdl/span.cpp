@@ -0,0 +1,728 @@
+#include "span.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+/* gcc 4.9 is the first to allow intrinsics inside functions marked with the
+ * target attribute without compiling the whole file with -mavx2
+ */
+#define PAINTOWN_SPAN_X86
+#include <immintrin.h>
+#define PAINTOWN_SSE2 __attribute__((target("sse2")))
+#define PAINTOWN_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Graphics{
+namespace Span{
+
+/* Scalar versions of the 16-bit blenders in bitmap.cpp. The components are
+ * expanded to 8 bits the way SDL_GetRGB does it, by repeating the top bits.
+ */
+
+static inline unsigned int transFactor(unsigned int alpha){
+    if (alpha){
+        return (alpha + 1) / 8;
+    }
+    return 0;
+}
+
+/* allegro's _blender_trans16, n is already divided down to 0-32 */
+static inline unsigned int blendTrans(unsigned int x, unsigned int y, unsigned int n){
+    x = ((x & 0xFFFF) | (x << 16)) & 0x7E0F81F;
+    y = ((y & 0xFFFF) | (y << 16)) & 0x7E0F81F;
+    unsigned int result = ((x - y) * n / 32 + y) & 0x7E0F81F;
+    return (result & 0xFFFF) | (result >> 16);
+}
+
+static inline unsigned int red(unsigned int pixel){
+    unsigned int value = (pixel >> 11) & 31;
+    return (value << 3) | (value >> 2);
+}
+
+static inline unsigned int green(unsigned int pixel){
+    unsigned int value = (pixel >> 5) & 63;
+    return (value << 2) | (value >> 4);
+}
+
+static inline unsigned int blue(unsigned int pixel){
+    unsigned int value = pixel & 31;
+    return (value << 3) | (value >> 2);
+}
+
+static inline unsigned int pack(unsigned int red, unsigned int green, unsigned int blue){
+    return ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3);
+}
+
+static inline unsigned int clamp(unsigned int value){
+    return value > 255 ? 255 : value;
+}
+
+static inline unsigned int subtract(unsigned int a, unsigned int b){
+    return a > b ? a - b : 0;
+}
+
+struct CopyBlend{
+    static inline unsigned int factor(unsigned int alpha){
+        return alpha;
+    }
+
+    static inline bool vectorizable(unsigned int alpha){
+        return true;
+    }
+
+    static inline unsigned int apply(unsigned int x, unsigned int y, unsigned int factor){
+        return x;
+    }
+};
+
+struct TransBlend{
+    static inline unsigned int factor(unsigned int alpha){
+        return transFactor(alpha);
+    }
+
+    static inline bool vectorizable(unsigned int alpha){
+        return true;
+    }
+
+    static inline unsigned int apply(unsigned int x, unsigned int y, unsigned int factor){
+        return blendTrans(x, y, factor);
+    }
+};
+
+struct AddBlend{
+    static inline unsigned int factor(unsigned int alpha){
+        return alpha;
+    }
+
+    /* the vector code multiplies in 16 bits */
+    static inline bool vectorizable(unsigned int alpha){
+        return alpha <= 256;
+    }
+
+    static inline unsigned int apply(unsigned int x, unsigned int y, unsigned int alpha){
+        return pack(clamp(red(y) + red(x) * alpha / 256),
+                    clamp(green(y) + green(x) * alpha / 256),
+                    clamp(blue(y) + blue(x) * alpha / 256));
+    }
+};
+
+struct MultiplyBlend{
+    static inline unsigned int factor(unsigned int alpha){
+        return transFactor(alpha);
+    }
+
+    static inline bool vectorizable(unsigned int alpha){
+        return true;
+    }
+
+    static inline unsigned int apply(unsigned int x, unsigned int y, unsigned int factor){
+        return blendTrans(pack(red(x) * red(y) / 256,
+                               green(x) * green(y) / 256,
+                               blue(x) * blue(y) / 256), y, factor);
+    }
+};
+
+struct DifferenceBlend{
+    static inline unsigned int factor(unsigned int alpha){
+        return transFactor(alpha);
+    }
+
+    static inline bool vectorizable(unsigned int alpha){
+        return true;
+    }
+
+    static inline unsigned int apply(unsigned int x, unsigned int y, unsigned int factor){
+        return blendTrans(pack(subtract(red(y), red(x)),
+                               subtract(green(y), green(x)),
+                               subtract(blue(y), blue(x))), y, factor);
+    }
+};
+
+template <class Blend>
+static void scalarForward(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    unsigned int factor = Blend::factor(alpha);
+    for (int i = 0; i < count; i++){
+        if (src[i] != mask){
+            dst[i] = Blend::apply(src[i], dst[i], factor);
+        }
+    }
+}
+
+template <class Blend>
+static void scalarReverse(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    unsigned int factor = Blend::factor(alpha);
+    for (int i = 0; i < count; i++){
+        if (src[i] != mask){
+            dst[-i] = Blend::apply(src[i], dst[-i], factor);
+        }
+    }
+}
+
+static void scalarFill(Pixel * dst, int count, Pixel color, Pixel mask, unsigned int alpha){
+    unsigned int factor = transFactor(alpha);
+    for (int i = 0; i < count; i++){
+        if (dst[i] != mask){
+            dst[i] = blendTrans(color, dst[i], factor);
+        }
+    }
+}
+
+static void scalarShade(Pixel * dst, const Pixel * colors, const unsigned char * alphas, int count){
+    for (int i = 0; i < count; i++){
+        dst[i] = blendTrans(colors[i], dst[i], transFactor(alphas[i]));
+    }
+}
+
+#ifdef PAINTOWN_SPAN_X86
+
+/* The vector code works on 8 (SSE2) or 16 (AVX2) pixels at a time. A whole
+ * vector of the destination is always written back, with the masked pixels
+ * put back the way they were, and whatever is left at the end of the row goes
+ * through the scalar kernel.
+ *
+ * The trans blend is done the same way as the scalar one: each pixel is spread
+ * out to 32 bits so green sits in the upper half. The 32 bit multiply by the
+ * 0-32 factor is built out of 16 bit multiplies since SSE2 doesn't have one.
+ */
+
+PAINTOWN_SSE2 static inline __m128i sse2TransHalf(__m128i x, __m128i y, __m128i factor){
+    const __m128i spread = _mm_set1_epi32(0x7E0F81F);
+    __m128i difference = _mm_sub_epi32(x, y);
+    __m128i low = _mm_mullo_epi16(difference, factor);
+    __m128i high = _mm_mulhi_epu16(difference, factor);
+    __m128i product = _mm_add_epi32(low, _mm_slli_epi32(high, 16));
+    __m128i result = _mm_and_si128(_mm_add_epi32(_mm_srli_epi32(product, 5), y), spread);
+    return _mm_or_si128(_mm_and_si128(result, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(result, 16));
+}
+
+/* packs 32 bit lanes that hold 16 bit values, packs_epi32 saturates so sign
+ * extend them first
+ */
+PAINTOWN_SSE2 static inline __m128i sse2Pack32(__m128i low, __m128i high){
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16),
+                           _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Trans(__m128i x, __m128i y, __m128i factor){
+    const __m128i spread = _mm_set1_epi32(0x7E0F81F);
+    __m128i xLow = _mm_and_si128(_mm_unpacklo_epi16(x, x), spread);
+    __m128i xHigh = _mm_and_si128(_mm_unpackhi_epi16(x, x), spread);
+    __m128i yLow = _mm_and_si128(_mm_unpacklo_epi16(y, y), spread);
+    __m128i yHigh = _mm_and_si128(_mm_unpackhi_epi16(y, y), spread);
+    return sse2Pack32(sse2TransHalf(xLow, yLow, factor), sse2TransHalf(xHigh, yHigh, factor));
+}
+
+/* same as sse2Trans but every pixel has its own factor */
+PAINTOWN_SSE2 static inline __m128i sse2TransEach(__m128i x, __m128i y, __m128i factors){
+    const __m128i spread = _mm_set1_epi32(0x7E0F81F);
+    __m128i xLow = _mm_and_si128(_mm_unpacklo_epi16(x, x), spread);
+    __m128i xHigh = _mm_and_si128(_mm_unpackhi_epi16(x, x), spread);
+    __m128i yLow = _mm_and_si128(_mm_unpacklo_epi16(y, y), spread);
+    __m128i yHigh = _mm_and_si128(_mm_unpackhi_epi16(y, y), spread);
+    return sse2Pack32(sse2TransHalf(xLow, yLow, _mm_unpacklo_epi16(factors, factors)),
+                      sse2TransHalf(xHigh, yHigh, _mm_unpackhi_epi16(factors, factors)));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Red(__m128i pixels){
+    __m128i value = _mm_srli_epi16(pixels, 11);
+    return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Green(__m128i pixels){
+    __m128i value = _mm_and_si128(_mm_srli_epi16(pixels, 5), _mm_set1_epi16(63));
+    return _mm_or_si128(_mm_slli_epi16(value, 2), _mm_srli_epi16(value, 4));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Blue(__m128i pixels){
+    __m128i value = _mm_and_si128(pixels, _mm_set1_epi16(31));
+    return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Pack(__m128i red, __m128i green, __m128i blue){
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(red, 3), 11),
+                                     _mm_slli_epi16(_mm_srli_epi16(green, 2), 5)),
+                        _mm_srli_epi16(blue, 3));
+}
+
+PAINTOWN_SSE2 static inline __m128i sse2Reverse(__m128i pixels){
+    pixels = _mm_shufflelo_epi16(pixels, 0x1B);
+    pixels = _mm_shufflehi_epi16(pixels, 0x1B);
+    return _mm_shuffle_epi32(pixels, 0x4E);
+}
+
+struct Sse2Copy: public CopyBlend {
+    PAINTOWN_SSE2 static inline __m128i vector(__m128i x, __m128i y, __m128i factor){
+        return x;
+    }
+};
+
+struct Sse2Trans: public TransBlend {
+    PAINTOWN_SSE2 static inline __m128i vector(__m128i x, __m128i y, __m128i factor){
+        return sse2Trans(x, y, factor);
+    }
+};
+
+struct Sse2Add: public AddBlend {
+    PAINTOWN_SSE2 static inline __m128i channel(__m128i x, __m128i y, __m128i alpha){
+        __m128i sum = _mm_add_epi16(y, _mm_srli_epi16(_mm_mullo_epi16(x, alpha), 8));
+        return _mm_min_epi16(sum, _mm_set1_epi16(255));
+    }
+
+    PAINTOWN_SSE2 static inline __m128i vector(__m128i x, __m128i y, __m128i alpha){
+        return sse2Pack(channel(sse2Red(x), sse2Red(y), alpha),
+                        channel(sse2Green(x), sse2Green(y), alpha),
+                        channel(sse2Blue(x), sse2Blue(y), alpha));
+    }
+};
+
+struct Sse2Multiply: public MultiplyBlend {
+    PAINTOWN_SSE2 static inline __m128i vector(__m128i x, __m128i y, __m128i factor){
+        __m128i product = sse2Pack(_mm_srli_epi16(_mm_mullo_epi16(sse2Red(x), sse2Red(y)), 8),
+                                   _mm_srli_epi16(_mm_mullo_epi16(sse2Green(x), sse2Green(y)), 8),
+                                   _mm_srli_epi16(_mm_mullo_epi16(sse2Blue(x), sse2Blue(y)), 8));
+        return sse2Trans(product, y, factor);
+    }
+};
+
+struct Sse2Difference: public DifferenceBlend {
+    PAINTOWN_SSE2 static inline __m128i vector(__m128i x, __m128i y, __m128i factor){
+        __m128i difference = sse2Pack(_mm_subs_epu16(sse2Red(y), sse2Red(x)),
+                                      _mm_subs_epu16(sse2Green(y), sse2Green(x)),
+                                      _mm_subs_epu16(sse2Blue(y), sse2Blue(x)));
+        return sse2Trans(difference, y, factor);
+    }
+};
+
+template <class Blend>
+PAINTOWN_SSE2 static void sse2Forward(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    if (!Blend::vectorizable(alpha)){
+        scalarForward<Blend>(dst, src, count, mask, alpha);
+        return;
+    }
+    const __m128i masks = _mm_set1_epi16((short) mask);
+    const __m128i factor = _mm_set1_epi16((short) Blend::factor(alpha));
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m128i source = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i dest = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i keep = _mm_cmpeq_epi16(source, masks);
+        __m128i out = Blend::vector(source, dest, factor);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(keep, dest), _mm_andnot_si128(keep, out)));
+    }
+    scalarForward<Blend>(dst + i, src + i, count - i, mask, alpha);
+}
+
+template <class Blend>
+PAINTOWN_SSE2 static void sse2Reverse(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    if (!Blend::vectorizable(alpha)){
+        scalarReverse<Blend>(dst, src, count, mask, alpha);
+        return;
+    }
+    const __m128i masks = _mm_set1_epi16((short) mask);
+    const __m128i factor = _mm_set1_epi16((short) Blend::factor(alpha));
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m128i source = sse2Reverse(_mm_loadu_si128((const __m128i*)(src + i)));
+        Pixel * where = dst - i - 7;
+        __m128i dest = _mm_loadu_si128((const __m128i*) where);
+        __m128i keep = _mm_cmpeq_epi16(source, masks);
+        __m128i out = Blend::vector(source, dest, factor);
+        _mm_storeu_si128((__m128i*) where, _mm_or_si128(_mm_and_si128(keep, dest), _mm_andnot_si128(keep, out)));
+    }
+    scalarReverse<Blend>(dst - i, src + i, count - i, mask, alpha);
+}
+
+PAINTOWN_SSE2 static void sse2Fill(Pixel * dst, int count, Pixel color, Pixel mask, unsigned int alpha){
+    const __m128i colors = _mm_set1_epi16((short) color);
+    const __m128i masks = _mm_set1_epi16((short) mask);
+    const __m128i factor = _mm_set1_epi16((short) transFactor(alpha));
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m128i dest = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i keep = _mm_cmpeq_epi16(dest, masks);
+        __m128i out = sse2Trans(colors, dest, factor);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(keep, dest), _mm_andnot_si128(keep, out)));
+    }
+    scalarFill(dst + i, count - i, color, mask, alpha);
+}
+
+/* (alpha + 1) / 8 is transFactor without the branch, it is 0 for 0 anyway */
+PAINTOWN_SSE2 static void sse2Shade(Pixel * dst, const Pixel * colors, const unsigned char * alphas, int count){
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    int i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m128i source = _mm_loadu_si128((const __m128i*)(colors + i));
+        __m128i dest = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i factors = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(alphas + i)), zero);
+        factors = _mm_srli_epi16(_mm_add_epi16(factors, one), 3);
+        _mm_storeu_si128((__m128i*)(dst + i), sse2TransEach(source, dest, factors));
+    }
+    scalarShade(dst + i, colors + i, alphas + i, count - i);
+}
+
+/* The AVX2 versions are the same with twice the width. unpack and pack work
+ * inside each 128 bit half so they undo each other and need no permutes.
+ */
+
+PAINTOWN_AVX2 static inline __m256i avx2TransHalf(__m256i x, __m256i y, __m256i factor){
+    const __m256i spread = _mm256_set1_epi32(0x7E0F81F);
+    __m256i difference = _mm256_sub_epi32(x, y);
+    __m256i low = _mm256_mullo_epi16(difference, factor);
+    __m256i high = _mm256_mulhi_epu16(difference, factor);
+    __m256i product = _mm256_add_epi32(low, _mm256_slli_epi32(high, 16));
+    __m256i result = _mm256_and_si256(_mm256_add_epi32(_mm256_srli_epi32(product, 5), y), spread);
+    return _mm256_or_si256(_mm256_and_si256(result, _mm256_set1_epi32(0xFFFF)), _mm256_srli_epi32(result, 16));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Trans(__m256i x, __m256i y, __m256i factor){
+    const __m256i spread = _mm256_set1_epi32(0x7E0F81F);
+    __m256i xLow = _mm256_and_si256(_mm256_unpacklo_epi16(x, x), spread);
+    __m256i xHigh = _mm256_and_si256(_mm256_unpackhi_epi16(x, x), spread);
+    __m256i yLow = _mm256_and_si256(_mm256_unpacklo_epi16(y, y), spread);
+    __m256i yHigh = _mm256_and_si256(_mm256_unpackhi_epi16(y, y), spread);
+    /* every lane is at most 0xFFFF so packus doesn't clip anything */
+    return _mm256_packus_epi32(avx2TransHalf(xLow, yLow, factor), avx2TransHalf(xHigh, yHigh, factor));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2TransEach(__m256i x, __m256i y, __m256i factors){
+    const __m256i spread = _mm256_set1_epi32(0x7E0F81F);
+    __m256i xLow = _mm256_and_si256(_mm256_unpacklo_epi16(x, x), spread);
+    __m256i xHigh = _mm256_and_si256(_mm256_unpackhi_epi16(x, x), spread);
+    __m256i yLow = _mm256_and_si256(_mm256_unpacklo_epi16(y, y), spread);
+    __m256i yHigh = _mm256_and_si256(_mm256_unpackhi_epi16(y, y), spread);
+    return _mm256_packus_epi32(avx2TransHalf(xLow, yLow, _mm256_unpacklo_epi16(factors, factors)),
+                               avx2TransHalf(xHigh, yHigh, _mm256_unpackhi_epi16(factors, factors)));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Red(__m256i pixels){
+    __m256i value = _mm256_srli_epi16(pixels, 11);
+    return _mm256_or_si256(_mm256_slli_epi16(value, 3), _mm256_srli_epi16(value, 2));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Green(__m256i pixels){
+    __m256i value = _mm256_and_si256(_mm256_srli_epi16(pixels, 5), _mm256_set1_epi16(63));
+    return _mm256_or_si256(_mm256_slli_epi16(value, 2), _mm256_srli_epi16(value, 4));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Blue(__m256i pixels){
+    __m256i value = _mm256_and_si256(pixels, _mm256_set1_epi16(31));
+    return _mm256_or_si256(_mm256_slli_epi16(value, 3), _mm256_srli_epi16(value, 2));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Pack(__m256i red, __m256i green, __m256i blue){
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(red, 3), 11),
+                                           _mm256_slli_epi16(_mm256_srli_epi16(green, 2), 5)),
+                           _mm256_srli_epi16(blue, 3));
+}
+
+PAINTOWN_AVX2 static inline __m256i avx2Reverse(__m256i pixels){
+    const __m256i order = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                           14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+    return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(pixels, order), 0x4E);
+}
+
+struct Avx2Copy: public CopyBlend {
+    PAINTOWN_AVX2 static inline __m256i vector(__m256i x, __m256i y, __m256i factor){
+        return x;
+    }
+};
+
+struct Avx2Trans: public TransBlend {
+    PAINTOWN_AVX2 static inline __m256i vector(__m256i x, __m256i y, __m256i factor){
+        return avx2Trans(x, y, factor);
+    }
+};
+
+struct Avx2Add: public AddBlend {
+    PAINTOWN_AVX2 static inline __m256i channel(__m256i x, __m256i y, __m256i alpha){
+        __m256i sum = _mm256_add_epi16(y, _mm256_srli_epi16(_mm256_mullo_epi16(x, alpha), 8));
+        return _mm256_min_epi16(sum, _mm256_set1_epi16(255));
+    }
+
+    PAINTOWN_AVX2 static inline __m256i vector(__m256i x, __m256i y, __m256i alpha){
+        return avx2Pack(channel(avx2Red(x), avx2Red(y), alpha),
+                        channel(avx2Green(x), avx2Green(y), alpha),
+                        channel(avx2Blue(x), avx2Blue(y), alpha));
+    }
+};
+
+struct Avx2Multiply: public MultiplyBlend {
+    PAINTOWN_AVX2 static inline __m256i vector(__m256i x, __m256i y, __m256i factor){
+        __m256i product = avx2Pack(_mm256_srli_epi16(_mm256_mullo_epi16(avx2Red(x), avx2Red(y)), 8),
+                                   _mm256_srli_epi16(_mm256_mullo_epi16(avx2Green(x), avx2Green(y)), 8),
+                                   _mm256_srli_epi16(_mm256_mullo_epi16(avx2Blue(x), avx2Blue(y)), 8));
+        return avx2Trans(product, y, factor);
+    }
+};
+
+struct Avx2Difference: public DifferenceBlend {
+    PAINTOWN_AVX2 static inline __m256i vector(__m256i x, __m256i y, __m256i factor){
+        __m256i difference = avx2Pack(_mm256_subs_epu16(avx2Red(y), avx2Red(x)),
+                                      _mm256_subs_epu16(avx2Green(y), avx2Green(x)),
+                                      _mm256_subs_epu16(avx2Blue(y), avx2Blue(x)));
+        return avx2Trans(difference, y, factor);
+    }
+};
+
+template <class Blend>
+PAINTOWN_AVX2 static void avx2Forward(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    if (!Blend::vectorizable(alpha)){
+        scalarForward<Blend>(dst, src, count, mask, alpha);
+        return;
+    }
+    const __m256i masks = _mm256_set1_epi16((short) mask);
+    const __m256i factor = _mm256_set1_epi16((short) Blend::factor(alpha));
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m256i source = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i dest = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i keep = _mm256_cmpeq_epi16(source, masks);
+        __m256i out = Blend::vector(source, dest, factor);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(out, dest, keep));
+    }
+    scalarForward<Blend>(dst + i, src + i, count - i, mask, alpha);
+}
+
+template <class Blend>
+PAINTOWN_AVX2 static void avx2Reverse(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha){
+    if (!Blend::vectorizable(alpha)){
+        scalarReverse<Blend>(dst, src, count, mask, alpha);
+        return;
+    }
+    const __m256i masks = _mm256_set1_epi16((short) mask);
+    const __m256i factor = _mm256_set1_epi16((short) Blend::factor(alpha));
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m256i source = avx2Reverse(_mm256_loadu_si256((const __m256i*)(src + i)));
+        Pixel * where = dst - i - 15;
+        __m256i dest = _mm256_loadu_si256((const __m256i*) where);
+        __m256i keep = _mm256_cmpeq_epi16(source, masks);
+        __m256i out = Blend::vector(source, dest, factor);
+        _mm256_storeu_si256((__m256i*) where, _mm256_blendv_epi8(out, dest, keep));
+    }
+    scalarReverse<Blend>(dst - i, src + i, count - i, mask, alpha);
+}
+
+PAINTOWN_AVX2 static void avx2Fill(Pixel * dst, int count, Pixel color, Pixel mask, unsigned int alpha){
+    const __m256i colors = _mm256_set1_epi16((short) color);
+    const __m256i masks = _mm256_set1_epi16((short) mask);
+    const __m256i factor = _mm256_set1_epi16((short) transFactor(alpha));
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m256i dest = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i keep = _mm256_cmpeq_epi16(dest, masks);
+        __m256i out = avx2Trans(colors, dest, factor);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(out, dest, keep));
+    }
+    scalarFill(dst + i, count - i, color, mask, alpha);
+}
+
+PAINTOWN_AVX2 static void avx2Shade(Pixel * dst, const Pixel * colors, const unsigned char * alphas, int count){
+    const __m256i one = _mm256_set1_epi16(1);
+    int i = 0;
+    for (; i + 16 <= count; i += 16){
+        __m256i source = _mm256_loadu_si256((const __m256i*)(colors + i));
+        __m256i dest = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i factors = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(alphas + i)));
+        factors = _mm256_srli_epi16(_mm256_add_epi16(factors, one), 3);
+        _mm256_storeu_si256((__m256i*)(dst + i), avx2TransEach(source, dest, factors));
+    }
+    scalarShade(dst + i, colors + i, alphas + i, count - i);
+}
+
+#endif
+
+static const Kernel scalarKernels[2][ModeCount] = {
+    {scalarForward<CopyBlend>, scalarForward<TransBlend>, scalarForward<AddBlend>,
+     scalarForward<MultiplyBlend>, scalarForward<DifferenceBlend>},
+    {scalarReverse<CopyBlend>, scalarReverse<TransBlend>, scalarReverse<AddBlend>,
+     scalarReverse<MultiplyBlend>, scalarReverse<DifferenceBlend>}
+};
+
+#ifdef PAINTOWN_SPAN_X86
+static const Kernel sse2Kernels[2][ModeCount] = {
+    {sse2Forward<Sse2Copy>, sse2Forward<Sse2Trans>, sse2Forward<Sse2Add>,
+     sse2Forward<Sse2Multiply>, sse2Forward<Sse2Difference>},
+    {sse2Reverse<Sse2Copy>, sse2Reverse<Sse2Trans>, sse2Reverse<Sse2Add>,
+     sse2Reverse<Sse2Multiply>, sse2Reverse<Sse2Difference>}
+};
+
+static const Kernel avx2Kernels[2][ModeCount] = {
+    {avx2Forward<Avx2Copy>, avx2Forward<Avx2Trans>, avx2Forward<Avx2Add>,
+     avx2Forward<Avx2Multiply>, avx2Forward<Avx2Difference>},
+    {avx2Reverse<Avx2Copy>, avx2Reverse<Avx2Trans>, avx2Reverse<Avx2Add>,
+     avx2Reverse<Avx2Multiply>, avx2Reverse<Avx2Difference>}
+};
+#endif
+
+bool supported(Isa isa){
+    switch (isa){
+        case Scalar: return true;
+#ifdef PAINTOWN_SPAN_X86
+        case SSE2: {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        }
+        case AVX2: {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }
+#endif
+        default: return false;
+    }
+}
+
+const char * name(Isa isa){
+    switch (isa){
+        case Scalar: return "scalar";
+        case SSE2: return "sse2";
+        case AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+const char * name(Mode mode){
+    switch (mode){
+        case Copy: return "copy";
+        case Trans: return "trans";
+        case Add: return "add";
+        case Multiply: return "multiply";
+        case Difference: return "difference";
+        default: return "unknown";
+    }
+}
+
+Isa best(){
+    if (supported(AVX2)){
+        return AVX2;
+    }
+    if (supported(SSE2)){
+        return SSE2;
+    }
+    return Scalar;
+}
+
+static Kernel lookup(Isa isa, Mode mode, bool reverse){
+    if (mode < 0 || mode >= ModeCount){
+        return NULL;
+    }
+    int direction = reverse ? 1 : 0;
+    switch (isa){
+        case Scalar: return scalarKernels[direction][mode];
+#ifdef PAINTOWN_SPAN_X86
+        case SSE2: return sse2Kernels[direction][mode];
+        case AVX2: return avx2Kernels[direction][mode];
+#endif
+        default: return NULL;
+    }
+}
+
+Kernel kernel(Isa isa, Mode mode, bool reverse){
+    if (!supported(isa)){
+        return NULL;
+    }
+    return lookup(isa, mode, reverse);
+}
+
+Kernel kernel(Mode mode, bool reverse){
+    /* checking the cpu isn't free so only do it once */
+    static const Isa fastest = best();
+    return lookup(fastest, mode, reverse);
+}
+
+FillKernel fillKernel(Isa isa){
+    if (!supported(isa)){
+        return NULL;
+    }
+    switch (isa){
+        case Scalar: return scalarFill;
+#ifdef PAINTOWN_SPAN_X86
+        case SSE2: return sse2Fill;
+        case AVX2: return avx2Fill;
+#endif
+        default: return NULL;
+    }
+}
+
+FillKernel fillKernel(){
+    static const FillKernel fastest = fillKernel(best());
+    return fastest;
+}
+
+ShadeKernel shadeKernel(Isa isa){
+    if (!supported(isa)){
+        return NULL;
+    }
+    switch (isa){
+        case Scalar: return scalarShade;
+#ifdef PAINTOWN_SPAN_X86
+        case SSE2: return sse2Shade;
+        case AVX2: return avx2Shade;
+#endif
+        default: return NULL;
+    }
+}
+
+ShadeKernel shadeKernel(){
+    static const ShadeKernel fastest = shadeKernel(best());
+    return fastest;
+}
+
+Runs::Runs(const Pixel * pixels, int width, int height, int pitch, Pixel mask):
+width(width),
+height(height),
+mask(mask){
+    rows.reserve(height + 1);
+    for (int y = 0; y < height; y++){
+        rows.push_back(runs.size());
+        const Pixel * line = pixels + y * pitch;
+        int x = 0;
+        while (x < width){
+            while (x < width && line[x] == mask){
+                x += 1;
+            }
+            int start = x;
+            while (x < width && line[x] != mask){
+                x += 1;
+            }
+            if (x > start){
+                Run run;
+                run.start = start;
+                run.length = x - start;
+                runs.push_back(run);
+            }
+        }
+    }
+    rows.push_back(runs.size());
+}
+
+void Runs::draw(int row, int sourceX, int width, const Pixel * source, Pixel * destination, Mode mode, bool reverse, unsigned int alpha) const {
+    if (row < 0 || row >= height){
+        return;
+    }
+    Kernel use = kernel(mode, reverse);
+    int end = sourceX + width;
+    for (unsigned int index = rows[row]; index < rows[row + 1]; index++){
+        const Run & run = runs[index];
+        if (run.start >= end){
+            break;
+        }
+        int start = run.start > sourceX ? run.start : sourceX;
+        int stop = run.start + run.length < end ? run.start + run.length : end;
+        if (start >= stop){
+            continue;
+        }
+        Pixel * out = reverse ? destination - (start - sourceX) : destination + (start - sourceX);
+        /* nothing in a run is masked so a forward copy is just a copy */
+        if (mode == Copy && !reverse){
+            memcpy(out, source + start, (stop - start) * sizeof(Pixel));
+        } else {
+            use(out, source + start, stop - start, mask, alpha);
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,134 @@
+#ifndef _paintown_sdl_span_h
+#define _paintown_sdl_span_h
+
+#include <stddef.h>
+#include <vector>
+
+/* Row kernels for the 16-bit (5-6-5) software sprite blitter.
+ *
+ * A kernel reads `count' source pixels left to right and writes them to dst,
+ * skipping source pixels equal to the mask color. The reverse kernels write
+ * right to left starting at dst, which is how a horizontally flipped sprite is
+ * drawn. Vertical flips only change which rows are passed in.
+ *
+ * The scalar kernels are the reference. The SSE2 and AVX2 kernels give the
+ * same result bit for bit and are picked at runtime if the cpu has them.
+ */
+
+namespace Graphics{
+namespace Span{
+
+typedef unsigned short Pixel;
+
+enum Mode{
+    /* plain masked copy */
+    Copy,
+    /* the blenders from bitmap.cpp, source is the first argument and the
+     * destination the second
+     */
+    Trans,
+    Add,
+    Multiply,
+    Difference,
+    ModeCount
+};
+
+enum Isa{
+    Scalar,
+    SSE2,
+    AVX2,
+    IsaCount
+};
+
+typedef void (*Kernel)(Pixel * dst, const Pixel * src, int count, Pixel mask, unsigned int alpha);
+
+/* true if this cpu (and this build) can run kernels for the instruction set */
+bool supported(Isa isa);
+
+const char * name(Isa isa);
+const char * name(Mode mode);
+
+/* the fastest instruction set this cpu supports */
+Isa best();
+
+/* kernels for a specific instruction set, NULL if it isn't supported */
+Kernel kernel(Isa isa, Mode mode, bool reverse);
+
+/* the kernel for the fastest supported instruction set */
+Kernel kernel(Mode mode, bool reverse);
+
+/* Trans blends that don't come from a sprite, for full screen tints and
+ * lights. A fill kernel blends one color over count pixels and leaves the
+ * ones equal to the mask color alone. A shade kernel blends colors[i] over
+ * dst[i] with alphas[i] and has no mask. The alphas are the same 0-255 values
+ * the sprite kernels take.
+ */
+typedef void (*FillKernel)(Pixel * dst, int count, Pixel color, Pixel mask, unsigned int alpha);
+typedef void (*ShadeKernel)(Pixel * dst, const Pixel * colors, const unsigned char * alphas, int count);
+
+FillKernel fillKernel(Isa isa);
+FillKernel fillKernel();
+ShadeKernel shadeKernel(Isa isa);
+ShadeKernel shadeKernel();
+
+struct Run{
+    int start;
+    int length;
+};
+
+/* Where the non-mask pixels are in each row of a sprite, so a masked draw can
+ * skip the transparent parts without looking at them.
+ */
+class Runs{
+public:
+    /* pitch is in pixels */
+    Runs(const Pixel * pixels, int width, int height, int pitch, Pixel mask);
+
+    /* Draws columns [sourceX, sourceX + width) of one row. source is the start
+     * of the row and destination is where column sourceX goes, reverse is the
+     * same as for the kernels.
+     */
+    void draw(int row, int sourceX, int width, const Pixel * source, Pixel * destination, Mode mode, bool reverse, unsigned int alpha) const;
+
+    inline int getWidth() const {
+        return width;
+    }
+
+    inline int getHeight() const {
+        return height;
+    }
+
+    inline Pixel getMask() const {
+        return mask;
+    }
+
+    /* number of opaque runs in the whole sprite */
+    inline unsigned int size() const {
+        return runs.size();
+    }
+
+    /* the runs of one row, left to right. count is set to how many there are */
+    inline const Run * row(int y, unsigned int & count) const {
+        if (y < 0 || y >= height || rows[y] == rows[y + 1]){
+            count = 0;
+            return NULL;
+        }
+        count = rows[y + 1] - rows[y];
+        return &runs[rows[y]];
+    }
+
+protected:
+    int width;
+    int height;
+    Pixel mask;
+    /* rows[y] is the index of the first run in row y, with an extra entry at
+     * the end
+     */
+    std::vector<unsigned int> rows;
+    std::vector<Run> runs;
+};
+
+}
+}
+
+#endif
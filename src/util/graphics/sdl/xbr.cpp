@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <SDL.h>
+#include "util/thread.h"
 
 namespace xbr{
 
@@ -282,8 +283,15 @@ static void initialize(){
     }
 }
 
-void xbr2x(SDL_Surface * input, SDL_Surface * output){
-    initialize();
+/* what the scalers hand to each band of rows */
+struct Scale{
+    SDL_Surface * input;
+    SDL_Surface * output;
+};
+
+static void xbr2xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
 
     unsigned int e, i, p[10], px;
     unsigned int ex, ex2, ex3;
@@ -292,7 +300,7 @@ void xbr2x(SDL_Surface * input, SDL_Surface * output){
 
     int nextOutputLine = output->pitch / 2;
 
-    for (int y = 0; y < input->h; y++){
+    for (int y = first; y < last; y++){
         unsigned short int * E = (unsigned short *)((char*) output->pixels + y * output->pitch * 2);
 
         /* middle. the -4 just makes the offsets later on work out */
@@ -413,6 +421,15 @@ void xbr2x(SDL_Surface * input, SDL_Surface * output){
         }
     }
 }
+
+void xbr2x(SDL_Surface * input, SDL_Surface * output, int threads){
+    /* the table has to be filled in before any band starts */
+    initialize();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, xbr2xRows, &scale);
+}
 #undef FILTRO
 
 #define LEFT_UP_2_3X(N7, N5, N6, N2, N8, PIXEL)\
@@ -473,14 +490,15 @@ void xbr2x(SDL_Surface * input, SDL_Surface * output){
           }\
      }\
 
-void xbr3x(SDL_Surface * input, SDL_Surface * output){
-    initialize();
+static void xbr3xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
 
     const int nl = output->pitch / 2;
     const int nl1 = nl + nl;
     unsigned int ts, td;
 
-    for (int y = 0; y < input->h; y++){
+    for (int y = first; y < last; y++){
         unsigned short int * E = (unsigned short *)((char*) output->pixels + y * output->pitch * 3);
 
         /* middle. the -4 just makes the offsets later on work out */
@@ -601,6 +619,15 @@ void xbr3x(SDL_Surface * input, SDL_Surface * output){
         }
     }
 }
+
+void xbr3x(SDL_Surface * input, SDL_Surface * output, int threads){
+    /* the table has to be filled in before any band starts */
+    initialize();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, xbr3xRows, &scale);
+}
 #undef FILTRO
 
 #define LEFT_UP_2(N15, N14, N11, N13, N12, N10, N7, N3, PIXEL)\
@@ -664,15 +691,16 @@ void xbr3x(SDL_Surface * input, SDL_Surface * output){
           }\
      }\
 
-void xbr4x(SDL_Surface * input, SDL_Surface * output){
-    initialize();
+static void xbr4xRows(void * data, int first, int last){
+    SDL_Surface * input = ((Scale*) data)->input;
+    SDL_Surface * output = ((Scale*) data)->output;
 
     const int nl = output->pitch / 2;
     const int nl1 = nl + nl;
     const int nl2 = nl1 + nl;
     unsigned int ts, td;
 
-    for (int y = 0; y < input->h; y++){
+    for (int y = first; y < last; y++){
         unsigned short int * E = (unsigned short *)((char*) output->pixels + y * output->pitch * 4);
 
         /* middle. the -4 just makes the offsets later on work out */
@@ -794,6 +822,15 @@ void xbr4x(SDL_Surface * input, SDL_Surface * output){
         }
     }
 }
+
+void xbr4x(SDL_Surface * input, SDL_Surface * output, int threads){
+    /* the table has to be filled in before any band starts */
+    initialize();
+    Scale scale;
+    scale.input = input;
+    scale.output = output;
+    Util::Thread::runBands(input->h, threads, xbr4xRows, &scale);
+}
 #undef FILTRO
 
 }
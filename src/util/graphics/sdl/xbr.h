@@ -3,10 +3,12 @@
 
 struct SDL_Surface;
 
+/* Same as the hqx scalers, 16-bit surfaces and `threads' bands of rows at once */
+
 namespace xbr{
-    void xbr2x(SDL_Surface * input, SDL_Surface * output);
-    void xbr3x(SDL_Surface * input, SDL_Surface * output);
-    void xbr4x(SDL_Surface * input, SDL_Surface * output);
+    void xbr2x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
+    void xbr3x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
+    void xbr4x(SDL_Surface * input, SDL_Surface * output, int threads = 1);
 }
 
 #endif
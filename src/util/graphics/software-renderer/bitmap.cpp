@@ -24,39 +24,6 @@ Bitmap Bitmap::createMemoryBitmap(int width, int height){
     return Bitmap(width, height);
 }
 
-void Bitmap::drawShadow(Bitmap & where, int x, int y, int intensity, Color color, double scale, bool facingRight) const {
-    const double newheight = getHeight() * scale;
-    Bitmap shade(getWidth(), (int) fabs(newheight));
-    Stretch(shade);
-
-    /* Could be slow, but meh, lets do it for now to make it look like a real shadow */
-    for (int h = 0; h < shade.getHeight(); ++h){
-        for (int w = 0; w < shade.getWidth(); ++w){
-            Color pix = shade.getPixel(w, h);
-            if (pix != MaskColor()){
-                shade.putPixel(w, h, color);
-            }
-        }
-    }
-
-    transBlender(0, 0, 0, intensity);
-
-    if (scale > 0){
-        if (facingRight){
-            shade.translucent().drawVFlip(x, y, where);
-        } else { 
-            shade.translucent().drawHVFlip(x, y, where);
-        }
-    } else if (scale < 0){
-        y -= fabs(newheight);
-        if (facingRight){
-            shade.translucent().draw(x + 3, y, where);
-        } else { 
-            shade.translucent().drawHFlip(x - 3, y, where);
-        }
-    }
-}
-
 void TranslucentBitmap::roundRect(int radius, int x1, int y1, int x2, int y2, Color color) const {
     Bitmap::roundRect(radius, x1, y1, x2, y2, color);
 }
@@ -194,9 +161,19 @@ scaleToFilter(1, 1){
 }
 
 void StretchedBitmap::start(){
+    if (Util::Thread::cpuCount() > 1){
+        if (record == NULL){
+            record = Util::ReferenceCount<RenderList>(new RenderList(*this));
+        }
+        record->start();
+    }
 }
 
 void StretchedBitmap::finish(){
+    if (record != NULL){
+        record->finish();
+    }
+
     if (getData() != where.getData()){
         /* FIXME: make scalers understand the masking color. I kinf of doubt this is possible.. */
         if (clearKind == Mask){
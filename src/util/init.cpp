@@ -336,6 +336,9 @@ bool Global::init(const InitConditions & conditions){
             case InitConditions::Fullscreen: mode = FULLSCREEN; break;
         }
 
+        Graphics::setRenderDepth(Configuration::getProperty("graphics/render-depth", 16));
+        Graphics::setScaleThreads(Configuration::getProperty("graphics/scale-threads", 0));
+        Graphics::setPresentThread(Configuration::getProperty("graphics/present-thread", false));
         int gfxCode = Graphics::setGraphicsMode(mode, sx, sy);
         if (gfxCode == 0){
             out << "Set graphics mode: Ok" << endl;
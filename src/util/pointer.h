@@ -95,6 +95,11 @@ public:
         return data;
     }
 
+    /* true if another ReferenceCount points at the same data */
+    bool shared() const {
+        return *count > 1;
+    }
+
     bool operator<(const ReferenceCount<Data> & him) const {
         return data < him.data;
     }
@@ -7,12 +7,33 @@
 #include "pcre/pcre.h"
 /* our regex header */
 #include "regex.h"
+#include "thread.h"
 
 using namespace std;
 
 namespace Util{
 
-static map<string, pcre*> cachedPatterns;
+/* Each thread keeps its own compiled patterns so concurrent loaders don't
+ * race on the map. The patterns are never freed, same as before.
+ */
+static PAINTOWN_THREAD_LOCAL map<string, pcre*> * cachedPatterns = NULL;
+
+static pcre * compilePattern(const Regex & pattern){
+    if (cachedPatterns == NULL){
+        cachedPatterns = new map<string, pcre*>();
+    }
+    pcre * regex = (*cachedPatterns)[pattern.get()];
+    if (regex == NULL){
+        const char * error;
+        int errorOffset;
+        regex = pcre_compile(pattern.get().c_str(), 0, &error, &errorOffset, NULL);
+        if (regex == NULL){
+            return NULL;
+        }
+        (*cachedPatterns)[pattern.get()] = regex;
+    }
+    return regex;
+}
 
 Regex::Regex(const string & data):
 data(data){
@@ -24,17 +45,10 @@ const std::string & Regex::get() const {
     
 /* http://www.gnu.org/s/libc/manual/html_node/Regular-Expressions.html */
 bool matchRegex(const string & str, const Regex & pattern){
-    pcre * regex;
-    const char * error;
-    int errorOffset;
     int count;
-    regex = cachedPatterns[pattern.get()];
+    pcre * regex = compilePattern(pattern);
     if (regex == NULL){
-        regex = pcre_compile(pattern.get().c_str(), 0, &error, &errorOffset, NULL);
-        if (regex == NULL){
-            return false;
-        }
-        cachedPatterns[pattern.get()] = regex;
+        return false;
     }
 
     count = pcre_exec(regex, NULL, str.c_str(), str.size(), 0, 0, NULL, 0);
@@ -43,19 +57,12 @@ bool matchRegex(const string & str, const Regex & pattern){
 }
     
 string captureRegex(const string & str, const Regex & pattern, int capture){
-    pcre * regex;
-    const char * error;
-    int errorOffset;
     int count;
     const int captureMax = 100;
     int captures[captureMax];
-    regex = cachedPatterns[pattern.get()];
+    pcre * regex = compilePattern(pattern);
     if (regex == NULL){
-        regex = pcre_compile(pattern.get().c_str(), 0, &error, &errorOffset, NULL);
-        if (regex == NULL){
-            return "";
-        }
-        cachedPatterns[pattern.get()] = regex;
+        return "";
     }
 
     count = pcre_exec(regex, NULL, str.c_str(), str.size(), 0, 0, captures, captureMax);
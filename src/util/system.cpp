@@ -72,13 +72,11 @@ void System::makeDirectory(const std::string & path){
     mkdir(path.c_str(), 0777);
 }
 
-/*
 uint64_t System::currentMicroseconds(){
     struct timeval hold;
     gettimeofday(&hold, NULL);
-    return hold.tv_sec * 1000 * 1000 + hold.tv_usec;
+    return (uint64_t) hold.tv_sec * 1000 * 1000 + hold.tv_usec;
 }
-*/
     
 uint64_t System::currentMilliseconds(){
 #ifdef USE_SDL
@@ -1,10 +1,17 @@
 #include "thread.h"
+#include <vector>
 
 #ifdef WII
 /* So we can call ogc's create thread directly */
 #include <ogc/lwp.h>
 #endif
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace Util{
 
 namespace Thread{
@@ -376,6 +383,70 @@ void destroyLock(Lock * lock){
 
 #endif
 
+int cpuCount(){
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    int count = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    int count = 1;
+#endif
+    if (count < 1){
+        return 1;
+    }
+    return count;
+}
+
+struct Band{
+    BandFunction function;
+    void * data;
+    int first;
+    int last;
+};
+
+static void * runBand(void * arg){
+    Band * band = (Band*) arg;
+    band->function(band->data, band->first, band->last);
+    return NULL;
+}
+
+void runBands(int count, int bands, BandFunction function, void * data){
+    if (bands > count){
+        bands = count;
+    }
+
+    if (bands <= 1){
+        if (count > 0){
+            function(data, 0, count);
+        }
+        return;
+    }
+
+    std::vector<Band> work(bands);
+    for (int i = 0; i < bands; i++){
+        work[i].function = function;
+        work[i].data = data;
+        work[i].first = count * i / bands;
+        work[i].last = count * (i + 1) / bands;
+    }
+
+    std::vector<Id> threads(bands - 1, uninitializedValue);
+    for (int i = 0; i < bands - 1; i++){
+        if (!createThread(&threads[i], NULL, (ThreadFunction) runBand, &work[i])){
+            threads[i] = uninitializedValue;
+            runBand(&work[i]);
+        }
+    }
+
+    runBand(&work[bands - 1]);
+
+    for (int i = 0; i < bands - 1; i++){
+        joinThread(threads[i]);
+    }
+}
+
 }
 
 WaitThread::WaitThread():
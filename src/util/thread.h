@@ -25,6 +25,23 @@
 // #include "funcs.h"
 #include "debug.h"
 
+/* Gives each thread its own copy of a variable. Only use this for plain data
+ * (pointers, ints, structs without constructors) since the initializer must be
+ * a constant. The console ports don't have working TLS and only ever run one
+ * game loop at a time so there it is just a normal static, and anything that
+ * would hand such a variable to worker threads has to check
+ * PAINTOWN_HAS_THREAD_LOCAL first.
+ */
+#if defined(WII) || defined(MINPSPW) || defined(PS3) || defined(NDS) || defined(XENON)
+#define PAINTOWN_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define PAINTOWN_THREAD_LOCAL __declspec(thread)
+#define PAINTOWN_HAS_THREAD_LOCAL
+#else
+#define PAINTOWN_THREAD_LOCAL __thread
+#define PAINTOWN_HAS_THREAD_LOCAL
+#endif
+
 /* 9/10/2012: Condition variables have been removed. There are no use-cases in the code
  * where multiple threads are waiting for producer thread to signal them so a simpler
  * solution is just to use a mutex and poll. The main motivation to remove condition
@@ -83,6 +100,18 @@ namespace Thread{
     void joinThread(Id thread);
     void cancelThread(Id thread);
 
+    /* number of cpus threads can run on, at least 1 */
+    int cpuCount();
+
+    typedef void (*BandFunction)(void * data, int first, int last);
+
+    /* Splits [0, count) into `bands' pieces and calls function(data, first, last)
+     * for all of them at once, each on its own thread. The calling thread does the
+     * last band itself and this returns when every band is done. If a thread
+     * can't be started its band is run on the calling thread instead.
+     */
+    void runBands(int count, int bands, BandFunction function, void * data);
+
     /* wraps a Lock in a c++ class */
     class LockObject{
     public:
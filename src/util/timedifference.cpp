@@ -14,11 +14,11 @@ end(0){
 }
 
 void TimeDifference::startTime(){
-    start = System::currentMilliseconds();
+    start = System::currentMicroseconds();
 }
 
 void TimeDifference::endTime(){
-    end = System::currentMilliseconds();
+    end = System::currentMicroseconds();
 }
 
 const string TimeDifference::printTime(){
@@ -26,6 +26,10 @@ const string TimeDifference::printTime(){
 }
 
 unsigned long long int TimeDifference::getTime(){
+    return getMicroseconds() / 1000;
+}
+
+unsigned long long int TimeDifference::getMicroseconds(){
     unsigned long long int g = end - start;
     return g;
 }
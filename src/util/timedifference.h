@@ -12,7 +12,9 @@ public:
     void startTime();
     void endTime();
 
+    /* milliseconds between startTime and endTime */
     unsigned long long int getTime();
+    unsigned long long int getMicroseconds();
 
     const std::string printTime();
     const std::string printTime(const std::string & description, int runs = 1);
@@ -22,6 +24,7 @@ public:
     ~TimeDifference();
 
 protected:
+    /* in microseconds */
     unsigned long long start, end;
 
 };
@@ -39,6 +39,14 @@ void makeDirectory(const std::string & path){
     mkdir(path.c_str());
 }
 
+uint64_t currentMicroseconds(){
+    LARGE_INTEGER ticksPerSecond;
+    LARGE_INTEGER tick;  
+    QueryPerformanceFrequency(&ticksPerSecond);
+    QueryPerformanceCounter(&tick);
+    return (tick.QuadPart)/(ticksPerSecond.QuadPart/1000000);
+}
+
 uint64_t currentMilliseconds(){
     LARGE_INTEGER ticksPerSecond;
     LARGE_INTEGER tick;  